@@ -31,6 +31,7 @@ extern "C" {
 /* text helpers */
 #include "text/text_base64.h"
 #include "text/text_format.h"
+#include "text/text_number.h"
 #include "text/text_string.h"
 
 /*----------------------------------------------------------------------*/
@@ -42,6 +43,12 @@ extern "C" {
 /* hashing */
 #include "hash/hash_sha1.h"
 #include "hash/hash_hmacsha1.h"
+#include "hash/hash_sha256.h"
+#include "hash/hash_hmacsha256.h"
+#include "hash/hash_fnv.h"
+#include "hash/hash_fast.h"
+#include "hash/hash_crc32.h"
+#include "hash/hash_adler32.h"
 
 /*----------------------------------------------------------------------*/
 /* http */
@@ -67,6 +74,10 @@ extern "C" {
 #include "encoders/json_encode.h"
 #include "encoders/xml_encode.h"
 
+/*----------------------------------------------------------------------*/
+/* transcoders */
+#include "wbxml/wbxml_transcode.h"
+
 /*----------------------------------------------------------------------*/
 /* common functions */
 const char* elib_version();
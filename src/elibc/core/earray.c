@@ -27,6 +27,24 @@ void    earray_init(earray_t* earr, size_t item_size)
     }
 }
 
+void    earray_init_inline(earray_t* earr, size_t item_size, void* inline_items, size_t inline_size)
+{
+    EASSERT(earr);
+    EASSERT(inline_items);
+    if(earr)
+    {
+        earray_init(earr, item_size);
+
+        /* use inline storage until items don't fit */
+        if(inline_items && inline_size >= item_size)
+        {
+            earr->items = (char*)inline_items;
+            earr->inline_items = (char*)inline_items;
+            earr->alloc_size = inline_size - inline_size % item_size;
+        }
+    }
+}
+
 void    earray_reset(earray_t* earr)
 {
     EASSERT(earr);
@@ -41,8 +59,8 @@ void    earray_free(earray_t* earr)
 {
     if(earr)
     {
-        /* free memory */
-        efree(earr->items);
+        /* free memory (inline storage belongs to owner) */
+        if(earr->items != earr->inline_items) efree(earr->items);
 
         /* reset all fields */
         ememset(earr, 0, sizeof(earray_t));
@@ -61,8 +79,19 @@ int     earray_reserve(earray_t* earr, size_t item_count)
     if(earr->item_size * item_count <= earr->alloc_size) return ELIBC_SUCCESS;
 
     /* allocate memory */
-    tmp = erealloc(earr->items, earr->item_size * item_count);
-    if(tmp == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+    if(earray_is_inline(earr))
+    {
+        /* move items from inline storage to heap */
+        tmp = emalloc(earr->item_size * item_count);
+        if(tmp == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+        ememcpy(tmp, earr->items, earr->item_size * earr->item_count);
+
+    } else
+    {
+        tmp = erealloc(earr->items, earr->item_size * item_count);
+        if(tmp == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+    }
 
     /* update buffer */
     earr->items = (char*)tmp;
@@ -171,10 +200,17 @@ void earray_swap(earray_t* earr_left, earray_t* earr_right)
     /* arrays must be of the same item size */
     EASSERT1(earr_left->item_size == earr_right->item_size, "earray: trying to swap arrays of different item size");
 
-    /* swap */
+    /* items in inline storage can't change owner */
+    EASSERT1(!earray_is_inline(earr_left) && !earray_is_inline(earr_right), "earray: trying to swap arrays with inline items");
+    if(earray_is_inline(earr_left) || earray_is_inline(earr_right)) return;
+
+    /* swap (inline storage stays with owner) */
     tmp = *earr_left;
     *earr_left = *earr_right;
     *earr_right = tmp;
+
+    earr_right->inline_items = earr_left->inline_items;
+    earr_left->inline_items = tmp.inline_items;
 }
 
 /*----------------------------------------------------------------------*/
@@ -14,13 +14,24 @@ typedef struct
     size_t      alloc_size;         /* allocated buffer size in bytes */
     size_t      item_size;          /* single item size */
     size_t      item_count;         /* number of items */
+    char*       inline_items;       /* storage in owning struct (optional) */
 
 } earray_t;
 
+/*
+    Array initialized with inline storage keeps items in memory provided by
+    owner (usually array in the same struct) and moves them to heap only when
+    they don't fit, so short arrays (e.g. parser stacks) don't allocate at all.
+
+    NOTE: array with inline storage must not be copied or moved to other
+          memory while its items are inline and it can't be swapped.
+*/
+
 /*----------------------------------------------------------------------*/
 
 /* init and close */
 void    earray_init(earray_t* earr, size_t item_size);
+void    earray_init_inline(earray_t* earr, size_t item_size, void* inline_items, size_t inline_size);
 void    earray_reset(earray_t* earr);
 void    earray_free(earray_t* earr);
 
@@ -41,6 +52,7 @@ void    earray_swap(earray_t* earr_left, earray_t* earr_right);
 #define earray_item_size(earr)      ((earr)->item_size)
 #define earray_items(earr)          ((earr)->items)
 #define earray_at(earr, index)      ((earr)->items + (index)*(earr)->item_size)
+#define earray_is_inline(earr)      ((earr)->items != 0 && (earr)->items == (earr)->inline_items)
 
 /* common types */
 #define earray_int_at(earr, index)      (*(int*)((earr)->items))
@@ -0,0 +1,152 @@
+/*
+    Atomic operations
+*/
+
+#ifndef _EATOMIC_H_
+#define _EATOMIC_H_
+
+/*
+    Loads have acquire and stores release semantics unless marked relaxed,
+    add and compare-and-swap are sequentially consistent. Compare-and-swap
+    returns non zero if value was replaced.
+
+    C11 atomics are used when compiled as C11 and compiler intrinsics
+    otherwise (C++ and older compilers), both have the same size and layout.
+
+    NOTE: msvc version relies on x86 and x64 memory ordering
+*/
+
+/*----------------------------------------------------------------------*/
+
+/* keep frequently written atomics on separate cache lines */
+#define EATOMIC_CACHE_LINE_SIZE                     64
+
+/*----------------------------------------------------------------------*/
+#if !defined(__cplusplus) && defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && \
+    !defined(__STDC_NO_ATOMICS__) && !defined(_ELIBC_NO_C11_ATOMICS)
+
+#include <stdatomic.h>
+
+/* atomic integer and pointer */
+typedef _Atomic(eint64_t)       eatomic_t;
+typedef _Atomic(void*)          eatomic_ptr_t;
+
+/* integer */
+#define eatomic_load(ptr)                           atomic_load_explicit((ptr), memory_order_acquire)
+#define eatomic_load_relaxed(ptr)                   atomic_load_explicit((ptr), memory_order_relaxed)
+#define eatomic_store(ptr, value)                   atomic_store_explicit((ptr), (value), memory_order_release)
+#define eatomic_store_relaxed(ptr, value)           atomic_store_explicit((ptr), (value), memory_order_relaxed)
+#define eatomic_add(ptr, value)                     atomic_fetch_add((ptr), (value))
+#define eatomic_cas(ptr, expected, desired)         _eatomic_cas((ptr), (expected), (desired))
+
+/* pointer */
+#define eatomic_load_ptr                            eatomic_load
+#define eatomic_load_ptr_relaxed                    eatomic_load_relaxed
+#define eatomic_store_ptr                           eatomic_store
+#define eatomic_store_ptr_relaxed                   eatomic_store_relaxed
+#define eatomic_cas_ptr(ptr, expected, desired)     _eatomic_cas_ptr((ptr), (expected), (desired))
+
+/* full memory barrier */
+#define eatomic_fence()                             atomic_thread_fence(memory_order_seq_cst)
+
+/* earlier loads are not reordered with later loads and stores */
+#define eatomic_fence_acquire()                     atomic_thread_fence(memory_order_acquire)
+
+/* earlier loads and stores are not reordered with later stores */
+#define eatomic_fence_release()                     atomic_thread_fence(memory_order_release)
+
+/* compare-and-swap with expected value passed by value */
+static ELIBC_FORCE_INLINE int _eatomic_cas(eatomic_t* ptr, eint64_t expected, eint64_t desired)
+{
+    return atomic_compare_exchange_strong(ptr, &expected, desired);
+}
+
+static ELIBC_FORCE_INLINE int _eatomic_cas_ptr(eatomic_ptr_t* ptr, void* expected, void* desired)
+{
+    return atomic_compare_exchange_strong(ptr, &expected, desired);
+}
+
+/*----------------------------------------------------------------------*/
+#elif defined(_MSC_VER)
+
+/* atomic integer and pointer */
+typedef volatile eint64_t       eatomic_t;
+typedef void* volatile          eatomic_ptr_t;
+
+#include <intrin.h>
+
+/* integer */
+#define eatomic_load(ptr)                           (*(ptr))
+#define eatomic_load_relaxed(ptr)                   (*(ptr))
+#define eatomic_store(ptr, value)                   (*(ptr) = (value))
+#define eatomic_store_relaxed(ptr, value)           (*(ptr) = (value))
+#define eatomic_add(ptr, value)                     _InterlockedExchangeAdd64((ptr), (value))
+#define eatomic_cas(ptr, expected, desired)         (_InterlockedCompareExchange64((ptr), (desired), (expected)) == (expected))
+
+/* pointer */
+#define eatomic_load_ptr(ptr)                       (*(ptr))
+#define eatomic_load_ptr_relaxed(ptr)               (*(ptr))
+#define eatomic_store_ptr(ptr, value)               (*(ptr) = (value))
+#define eatomic_store_ptr_relaxed(ptr, value)       (*(ptr) = (value))
+#define eatomic_cas_ptr(ptr, expected, desired)     (_InterlockedCompareExchangePointer((ptr), (desired), (expected)) == (expected))
+
+/* full memory barrier */
+#define eatomic_fence()                             _mm_mfence()
+
+/* earlier loads are not reordered with later loads and stores (x86 keeps load order) */
+#define eatomic_fence_acquire()                     _ReadWriteBarrier()
+
+/* earlier loads and stores are not reordered with later stores (x86 keeps store order) */
+#define eatomic_fence_release()                     _ReadWriteBarrier()
+
+/*----------------------------------------------------------------------*/
+#elif defined(__GNUC__)
+
+/* atomic integer and pointer */
+typedef volatile eint64_t       eatomic_t;
+typedef void* volatile          eatomic_ptr_t;
+
+/* integer */
+#define eatomic_load(ptr)                           __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define eatomic_load_relaxed(ptr)                   __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define eatomic_store(ptr, value)                   __atomic_store_n((ptr), (value), __ATOMIC_RELEASE)
+#define eatomic_store_relaxed(ptr, value)           __atomic_store_n((ptr), (value), __ATOMIC_RELAXED)
+#define eatomic_add(ptr, value)                     __atomic_fetch_add((ptr), (value), __ATOMIC_SEQ_CST)
+#define eatomic_cas(ptr, expected, desired)         __sync_bool_compare_and_swap((ptr), (expected), (desired))
+
+/* pointer */
+#define eatomic_load_ptr                            eatomic_load
+#define eatomic_load_ptr_relaxed                    eatomic_load_relaxed
+#define eatomic_store_ptr                           eatomic_store
+#define eatomic_store_ptr_relaxed                   eatomic_store_relaxed
+#define eatomic_cas_ptr                             eatomic_cas
+
+/* full memory barrier */
+#define eatomic_fence()                             __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+/* earlier loads are not reordered with later loads and stores */
+#define eatomic_fence_acquire()                     __atomic_thread_fence(__ATOMIC_ACQUIRE)
+
+/* earlier loads and stores are not reordered with later stores */
+#define eatomic_fence_release()                     __atomic_thread_fence(__ATOMIC_RELEASE)
+
+/*----------------------------------------------------------------------*/
+#else
+#error "eatomic: atomic operations are not supported by compiler"
+#endif
+
+/*----------------------------------------------------------------------*/
+
+/* spin loop hint */
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define eatomic_pause()                             _mm_pause()
+#elif defined(__GNUC__) && defined(_ELIBC_ARCH_X86)
+#define eatomic_pause()                             __builtin_ia32_pause()
+#else
+#define eatomic_pause()                             ((void)0)
+#endif
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _EATOMIC_H_ */
@@ -0,0 +1,459 @@
+/*
+    Segmented memory buffer
+*/
+
+#include "../elibc_config.h"
+#include "../stdlib/estdlib.h"
+
+#include "eassert.h"
+#include "etrace.h"
+#include "eerror.h"
+#include "eatomic.h"
+#include "earray.h"
+#include "ebuffer.h"
+#include "ebuffer_chain.h"
+
+/*----------------------------------------------------------------------*/
+/* types */
+/*----------------------------------------------------------------------*/
+
+/* segment, data follows header unless it was adopted */
+typedef struct
+{
+    eatomic_t       refs;
+    char*           data;
+    size_t          capacity;
+    size_t          used;           /* bytes written */
+
+} ebuffer_segment_t;
+
+/* part of segment */
+typedef struct
+{
+    ebuffer_segment_t*  segment;
+    char*               data;
+    size_t              size;
+
+} ebuffer_chain_view_t;
+
+/*----------------------------------------------------------------------*/
+/* segments */
+/*----------------------------------------------------------------------*/
+ebuffer_segment_t* _ebuffer_segment_alloc(size_t capacity)
+{
+    ebuffer_segment_t* segment;
+
+    segment = (ebuffer_segment_t*)emalloc(sizeof(ebuffer_segment_t) + capacity);
+    if(segment == 0) return 0;
+
+    segment->refs = 1;
+    segment->data = (char*)(segment + 1);
+    segment->capacity = capacity;
+    segment->used = 0;
+
+    return segment;
+}
+
+void _ebuffer_segment_release(ebuffer_segment_t* segment)
+{
+    /* last reference */
+    if(eatomic_add(&segment->refs, -1) != 1) return;
+
+    if(segment->data != (char*)(segment + 1)) efree(segment->data);
+    efree(segment);
+}
+
+#define _ebuffer_chain_view(chain, idx)     ((ebuffer_chain_view_t*)earray_at(&(chain)->views, (idx)))
+
+/* add view (caller owns one segment reference for it) */
+int _ebuffer_chain_add_view(ebuffer_chain_t* chain, ebuffer_segment_t* segment, char* data, size_t size)
+{
+    ebuffer_chain_view_t view;
+    int err;
+
+    view.segment = segment;
+    view.data = data;
+    view.size = size;
+
+    err = earray_append(&chain->views, &view);
+    if(err != ELIBC_SUCCESS) return err;
+
+    chain->size += size;
+
+    return ELIBC_SUCCESS;
+}
+
+/* free space in last segment, only if chain is its single user */
+size_t _ebuffer_chain_tail_space(ebuffer_chain_t* chain)
+{
+    ebuffer_chain_view_t* view;
+
+    if(earray_size(&chain->views) == 0) return 0;
+
+    view = _ebuffer_chain_view(chain, earray_size(&chain->views) - 1);
+
+    if(eatomic_load(&view->segment->refs) != 1 ||
+       view->data + view->size != view->segment->data + view->segment->used) return 0;
+
+    return view->segment->capacity - view->segment->used;
+}
+
+/* start new segment with at least data_size free bytes */
+int _ebuffer_chain_add_segment(ebuffer_chain_t* chain, size_t data_size)
+{
+    ebuffer_segment_t* segment;
+    int err;
+
+    segment = _ebuffer_segment_alloc(data_size > chain->segment_size ? data_size : chain->segment_size);
+    if(segment == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    err = _ebuffer_chain_add_view(chain, segment, segment->data, 0);
+    if(err != ELIBC_SUCCESS) efree(segment);
+
+    return err;
+}
+
+/* commit bytes written to free space of the last segment */
+char* _ebuffer_chain_commit(ebuffer_chain_t* chain, size_t data_size)
+{
+    ebuffer_chain_view_t* view = _ebuffer_chain_view(chain, earray_size(&chain->views) - 1);
+    char* data = view->data + view->size;
+
+    view->size += data_size;
+    view->segment->used += data_size;
+    chain->size += data_size;
+
+    return data;
+}
+
+/*----------------------------------------------------------------------*/
+/* init and close */
+/*----------------------------------------------------------------------*/
+void ebuffer_chain_init(ebuffer_chain_t* chain, size_t segment_size)
+{
+    EASSERT(chain);
+    if(chain)
+    {
+        /* reset all fields */
+        ememset(chain, 0, sizeof(ebuffer_chain_t));
+
+        earray_init(&chain->views, sizeof(ebuffer_chain_view_t));
+        chain->segment_size = (segment_size > 0) ? segment_size : EBUFFER_CHAIN_SEGMENT_SIZE;
+    }
+}
+
+void ebuffer_chain_reset(ebuffer_chain_t* chain)
+{
+    size_t idx;
+
+    EASSERT(chain);
+    if(chain == 0) return;
+
+    /* release segments */
+    for(idx = 0; idx < earray_size(&chain->views); ++idx)
+    {
+        _ebuffer_segment_release(_ebuffer_chain_view(chain, idx)->segment);
+    }
+
+    earray_reset(&chain->views);
+    chain->size = 0;
+}
+
+void ebuffer_chain_free(ebuffer_chain_t* chain)
+{
+    if(chain)
+    {
+        ebuffer_chain_reset(chain);
+        earray_free(&chain->views);
+
+        /* keep segment size, chain can be used again */
+        earray_init(&chain->views, sizeof(ebuffer_chain_view_t));
+    }
+}
+
+/*----------------------------------------------------------------------*/
+/* append */
+/*----------------------------------------------------------------------*/
+int ebuffer_chain_append(ebuffer_chain_t* chain, const void* data, size_t data_size)
+{
+    const char* src = (const char*)data;
+    size_t space;
+    int err;
+
+    EASSERT(chain);
+    EASSERT(data || data_size == 0);
+    if(chain == 0 || (data == 0 && data_size > 0)) return ELIBC_ERROR_ARGUMENT;
+
+    while(data_size > 0)
+    {
+        space = _ebuffer_chain_tail_space(chain);
+
+        /* the rest goes to single new segment */
+        if(space == 0)
+        {
+            err = _ebuffer_chain_add_segment(chain, data_size);
+            if(err != ELIBC_SUCCESS) return err;
+
+            space = data_size;
+        }
+
+        if(space > data_size) space = data_size;
+
+        ememcpy(_ebuffer_chain_commit(chain, space), src, space);
+
+        src += space;
+        data_size -= space;
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+char* ebuffer_chain_append_ptr(ebuffer_chain_t* chain, size_t data_size)
+{
+    EASSERT(chain);
+    if(chain == 0) return 0;
+
+    /* space must be continuous */
+    if(_ebuffer_chain_tail_space(chain) < data_size || earray_size(&chain->views) == 0)
+    {
+        if(_ebuffer_chain_add_segment(chain, data_size) != ELIBC_SUCCESS) return 0;
+    }
+
+    return _ebuffer_chain_commit(chain, data_size);
+}
+
+int ebuffer_chain_adopt(ebuffer_chain_t* chain, char* data, size_t data_size)
+{
+    ebuffer_segment_t* segment;
+    int err;
+
+    EASSERT(chain);
+    EASSERT(data);
+    if(chain == 0 || data == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* segment header only */
+    segment = _ebuffer_segment_alloc(0);
+    if(segment == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    segment->data = data;
+    segment->capacity = data_size;
+    segment->used = data_size;
+
+    err = _ebuffer_chain_add_view(chain, segment, data, data_size);
+    if(err != ELIBC_SUCCESS) efree(segment);
+
+    return err;
+}
+
+int ebuffer_chain_append_ebuffer(ebuffer_chain_t* chain, ebuffer_t* ebuff)
+{
+    int err;
+
+    EASSERT(chain);
+    EASSERT(ebuff);
+    if(chain == 0 || ebuff == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* nothing to move, keep ebuffer memory */
+    if(ebuffer_pos(ebuff) == 0) return ELIBC_SUCCESS;
+
+    err = ebuffer_chain_adopt(chain, ebuffer_data(ebuff), ebuffer_pos(ebuff));
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* unused ebuffer memory can be appended to */
+    _ebuffer_chain_view(chain, earray_size(&chain->views) - 1)->segment->capacity = ebuffer_size(ebuff);
+
+    ebuffer_init(ebuff);
+
+    return ELIBC_SUCCESS;
+}
+
+int ebuffer_chain_append_chain(ebuffer_chain_t* chain, const ebuffer_chain_t* chain_from)
+{
+    ebuffer_chain_view_t* view;
+    size_t idx;
+    int err;
+
+    EASSERT(chain);
+    EASSERT(chain_from);
+    EASSERT(chain != chain_from);
+    if(chain == 0 || chain_from == 0 || chain == chain_from) return ELIBC_ERROR_ARGUMENT;
+
+    for(idx = 0; idx < earray_size(&chain_from->views); ++idx)
+    {
+        view = _ebuffer_chain_view(chain_from, idx);
+        if(view->size == 0) continue;
+
+        err = _ebuffer_chain_add_view(chain, view->segment, view->data, view->size);
+        if(err != ELIBC_SUCCESS) return err;
+
+        eatomic_add(&view->segment->refs, 1);
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+/*----------------------------------------------------------------------*/
+/* slices */
+/*----------------------------------------------------------------------*/
+int ebuffer_chain_slice(const ebuffer_chain_t* chain, size_t offset, size_t size, ebuffer_chain_t* slice_out)
+{
+    ebuffer_chain_view_t* view;
+    size_t idx, part;
+    int err = ELIBC_SUCCESS;
+
+    EASSERT(chain);
+    EASSERT(slice_out);
+    EASSERT(chain != slice_out);
+    if(chain == 0 || slice_out == 0 || chain == slice_out) return ELIBC_ERROR_ARGUMENT;
+
+    ebuffer_chain_init(slice_out, chain->segment_size);
+
+    EASSERT(offset <= chain->size && size <= chain->size - offset);
+    if(offset > chain->size || size > chain->size - offset) return ELIBC_ERROR_ARGUMENT;
+
+    for(idx = 0; idx < earray_size(&chain->views) && size > 0 && err == ELIBC_SUCCESS; ++idx)
+    {
+        view = _ebuffer_chain_view(chain, idx);
+
+        /* skip views before offset */
+        if(offset >= view->size)
+        {
+            offset -= view->size;
+            continue;
+        }
+
+        part = view->size - offset;
+        if(part > size) part = size;
+
+        err = _ebuffer_chain_add_view(slice_out, view->segment, view->data + offset, part);
+        if(err == ELIBC_SUCCESS) eatomic_add(&view->segment->refs, 1);
+
+        size -= part;
+        offset = 0;
+    }
+
+    if(err != ELIBC_SUCCESS) ebuffer_chain_free(slice_out);
+
+    return err;
+}
+
+int ebuffer_chain_consume(ebuffer_chain_t* chain, size_t size)
+{
+    ebuffer_chain_view_t* view;
+    size_t idx, view_count;
+
+    EASSERT(chain);
+    EASSERT(chain == 0 || size <= chain->size);
+    if(chain == 0 || size > chain->size) return ELIBC_ERROR_ARGUMENT;
+
+    view_count = earray_size(&chain->views);
+
+    /* release whole views */
+    for(idx = 0; idx < view_count; ++idx)
+    {
+        view = _ebuffer_chain_view(chain, idx);
+        if(view->size > size) break;
+
+        size -= view->size;
+        chain->size -= view->size;
+
+        _ebuffer_segment_release(view->segment);
+    }
+
+    /* part of the first remaining view */
+    if(idx < view_count && size > 0)
+    {
+        view = _ebuffer_chain_view(chain, idx);
+
+        view->data += size;
+        view->size -= size;
+        chain->size -= size;
+    }
+
+    /* move remaining views to the front */
+    if(idx > 0)
+    {
+        ememmove(earray_items(&chain->views), earray_at(&chain->views, idx), (view_count - idx) * sizeof(ebuffer_chain_view_t));
+        earray_resize(&chain->views, view_count - idx);
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+/*----------------------------------------------------------------------*/
+/* export */
+/*----------------------------------------------------------------------*/
+size_t ebuffer_chain_iovec(const ebuffer_chain_t* chain, ebuffer_iovec_t* iovec, size_t iovec_count)
+{
+    ebuffer_chain_view_t* view;
+    size_t idx, count = 0;
+
+    EASSERT(chain);
+    EASSERT(iovec || iovec_count == 0);
+    if(chain == 0 || iovec == 0) return 0;
+
+    for(idx = 0; idx < earray_size(&chain->views) && count < iovec_count; ++idx)
+    {
+        view = _ebuffer_chain_view(chain, idx);
+        if(view->size == 0) continue;
+
+        iovec[count].base = view->data;
+        iovec[count].size = view->size;
+        count++;
+    }
+
+    return count;
+}
+
+int ebuffer_chain_read(const ebuffer_chain_t* chain, size_t offset, void* data_out, size_t size)
+{
+    ebuffer_chain_view_t* view;
+    char* dst = (char*)data_out;
+    size_t idx, part;
+
+    EASSERT(chain);
+    EASSERT(data_out || size == 0);
+    if(chain == 0 || (data_out == 0 && size > 0)) return ELIBC_ERROR_ARGUMENT;
+
+    EASSERT(offset <= chain->size && size <= chain->size - offset);
+    if(offset > chain->size || size > chain->size - offset) return ELIBC_ERROR_ARGUMENT;
+
+    for(idx = 0; idx < earray_size(&chain->views) && size > 0; ++idx)
+    {
+        view = _ebuffer_chain_view(chain, idx);
+
+        if(offset >= view->size)
+        {
+            offset -= view->size;
+            continue;
+        }
+
+        part = view->size - offset;
+        if(part > size) part = size;
+
+        ememcpy(dst, view->data + offset, part);
+
+        dst += part;
+        size -= part;
+        offset = 0;
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+int ebuffer_chain_flatten(const ebuffer_chain_t* chain, ebuffer_t* ebuff)
+{
+    EASSERT(chain);
+    EASSERT(ebuff);
+    if(chain == 0 || ebuff == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* single allocation */
+    if(ebuffer_pos(ebuff) + chain->size > ebuffer_size(ebuff))
+    {
+        if(ebuffer_reserve(ebuff, ebuffer_pos(ebuff) + chain->size) != ELIBC_SUCCESS) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    return ebuffer_chain_read(chain, 0, ebuffer_append_ptr(ebuff, chain->size), chain->size);
+}
+
+/*----------------------------------------------------------------------*/
@@ -0,0 +1,92 @@
+/*
+    Segmented memory buffer
+*/
+
+#ifndef _EBUFFER_CHAIN_H_
+#define _EBUFFER_CHAIN_H_
+
+/*
+    NOTE: chain is a list of views into reference counted segments. Appended
+          data is copied to free space at the end of the last segment or to
+          new segment, written data is never moved. Memory allocated by caller
+          (or ebuffer_t data) can be adopted as segment without copy.
+
+          Slices and chains appended to other chains share segments, data is
+          released with the last view. Segment reference counts are atomic,
+          so slices can be passed to other threads, but single chain must not
+          be used from several threads at once.
+
+          Encoders writing to ebuffer_t can target chain by moving encoded
+          data with ebuffer_chain_append_ebuffer between encoder calls, and
+          parsers can be fed with segments exported by ebuffer_chain_iovec.
+*/
+
+/*----------------------------------------------------------------------*/
+/* constants */
+
+/* default size of new segments */
+#define EBUFFER_CHAIN_SEGMENT_SIZE      8192
+
+/*----------------------------------------------------------------------*/
+
+/* segment chain */
+typedef struct
+{
+    earray_t        views;          /* segment views */
+    size_t          size;           /* data size in bytes */
+    size_t          segment_size;   /* size of new segments */
+
+} ebuffer_chain_t;
+
+/* exported segment (the same layout as POSIX struct iovec) */
+typedef struct
+{
+    void*           base;
+    size_t          size;
+
+} ebuffer_iovec_t;
+
+/*----------------------------------------------------------------------*/
+
+/* init and close (segment_size zero selects default size) */
+void    ebuffer_chain_init(ebuffer_chain_t* chain, size_t segment_size);
+void    ebuffer_chain_reset(ebuffer_chain_t* chain);
+void    ebuffer_chain_free(ebuffer_chain_t* chain);
+
+/* chain properties */
+#define ebuffer_chain_size(chain)           ((chain)->size)
+#define ebuffer_chain_view_count(chain)     earray_size(&(chain)->views)
+
+/* append copy of data */
+int     ebuffer_chain_append(ebuffer_chain_t* chain, const void* data, size_t data_size);
+
+/* reserve continuous space at the end, returns zero if memory can't be allocated */
+char*   ebuffer_chain_append_ptr(ebuffer_chain_t* chain, size_t data_size);
+
+/* take ownership of memory allocated with emalloc (it is released with efree) */
+int     ebuffer_chain_adopt(ebuffer_chain_t* chain, char* data, size_t data_size);
+
+/* take ebuffer data (ebuffer is reset to empty state without memory) */
+int     ebuffer_chain_append_ebuffer(ebuffer_chain_t* chain, ebuffer_t* ebuff);
+
+/* share data of other chain */
+int     ebuffer_chain_append_chain(ebuffer_chain_t* chain, const ebuffer_chain_t* chain_from);
+
+/* new chain sharing part of data (slice_out is initialized by function) */
+int     ebuffer_chain_slice(const ebuffer_chain_t* chain, size_t offset, size_t size, ebuffer_chain_t* slice_out);
+
+/* release data from the beginning */
+int     ebuffer_chain_consume(ebuffer_chain_t* chain, size_t size);
+
+/* export data segments, returns number of filled items */
+size_t  ebuffer_chain_iovec(const ebuffer_chain_t* chain, ebuffer_iovec_t* iovec, size_t iovec_count);
+
+/* copy data out */
+int     ebuffer_chain_read(const ebuffer_chain_t* chain, size_t offset, void* data_out, size_t size);
+
+/* append all data to ebuffer in one continuous block */
+int     ebuffer_chain_flatten(const ebuffer_chain_t* chain, ebuffer_t* ebuff);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _EBUFFER_CHAIN_H_ */
@@ -0,0 +1,578 @@
+/*
+    Hash map
+*/
+
+#include "../elibc_config.h"
+#include "../stdlib/estdlib.h"
+
+#include "eassert.h"
+#include "etrace.h"
+#include "eerror.h"
+#include "ehashmap.h"
+
+#include "../../hash/hash_fast.h"
+
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define _EHASHMAP_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*----------------------------------------------------------------------*/
+/* constants */
+/*----------------------------------------------------------------------*/
+
+/* control byte for empty slot, full slots have high bit cleared */
+#define EHASHMAP_CTRL_EMPTY         0x80
+
+/* maximum load is 7/8 */
+#define EHASHMAP_MAX_LOAD(capacity) ((capacity) - (capacity) / 8)
+
+/*----------------------------------------------------------------------*/
+/* types */
+/*----------------------------------------------------------------------*/
+
+/* byte string key stored in slot */
+typedef struct
+{
+    char*       data;
+    size_t      size;
+
+} ehashmap_key_t;
+
+/*----------------------------------------------------------------------*/
+/* slot layout: hash, key (or ehashmap_key_t), value */
+/*----------------------------------------------------------------------*/
+#define _ehashmap_slot(ehashmap, idx)       ((ehashmap)->slots + (idx) * (ehashmap)->slot_size)
+#define _ehashmap_slot_hash(slot)           (*(euint64_t*)(slot))
+#define _ehashmap_slot_key(slot)            ((slot) + sizeof(euint64_t))
+#define _ehashmap_slot_value(ehashmap, slot) ((slot) + (ehashmap)->value_offset)
+
+#define _ehashmap_h1(hash)                  ((size_t)((hash) >> 7))
+#define _ehashmap_h2(hash)                  ((euint8_t)((hash) & 0x7F))
+
+#define _ehashmap_align(size)               (((size) + sizeof(euint64_t) - 1) & ~(sizeof(euint64_t) - 1))
+
+/*----------------------------------------------------------------------*/
+/* control groups */
+/*----------------------------------------------------------------------*/
+
+/* bit mask of group slots with the same control byte */
+ELIBC_FORCE_INLINE euint32_t _ehashmap_match(const euint8_t* group, euint8_t h2)
+{
+#ifdef _EHASHMAP_SSE2
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+
+    return (euint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)h2)));
+#else
+    euint32_t mask = 0;
+    int idx;
+
+    for(idx = 0; idx < EHASHMAP_GROUP_SIZE; ++idx)
+    {
+        if(group[idx] == h2) mask |= (euint32_t)1 << idx;
+    }
+
+    return mask;
+#endif
+}
+
+/* bit mask of empty group slots */
+ELIBC_FORCE_INLINE euint32_t _ehashmap_match_empty(const euint8_t* group)
+{
+#ifdef _EHASHMAP_SSE2
+    /* only empty marker has high bit set */
+    return (euint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+    return _ehashmap_match(group, EHASHMAP_CTRL_EMPTY);
+#endif
+}
+
+ELIBC_FORCE_INLINE unsigned int _ehashmap_lowest_bit(euint32_t mask)
+{
+#if defined(__GNUC__)
+    return (unsigned int)__builtin_ctz(mask);
+#elif defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return (unsigned int)idx;
+#else
+    unsigned int idx = 0;
+    while((mask & 1) == 0) { mask >>= 1; ++idx; }
+    return idx;
+#endif
+}
+
+ELIBC_FORCE_INLINE void _ehashmap_set_ctrl(ehashmap_t* ehashmap, size_t idx, euint8_t ctrl)
+{
+    ehashmap->ctrl[idx] = ctrl;
+
+    /* keep copy of the first group after the last slot */
+    if(idx < EHASHMAP_GROUP_SIZE) ehashmap->ctrl[ehashmap->capacity + idx] = ctrl;
+}
+
+/*----------------------------------------------------------------------*/
+/* helper functions */
+/*----------------------------------------------------------------------*/
+ELIBC_FORCE_INLINE euint64_t _ehashmap_hash(ehashmap_t* ehashmap, const void* key, size_t key_size)
+{
+    if(ehashmap->key_size > 0) key_size = ehashmap->key_size;
+
+    return ehashmap->hash_func((const euint8_t*)key, key_size, ehashmap->seed);
+}
+
+ELIBC_FORCE_INLINE ebool_t _ehashmap_key_equal(ehashmap_t* ehashmap, const char* slot, const void* key, size_t key_size)
+{
+    const ehashmap_key_t* slot_key;
+
+    if(ehashmap->key_size > 0) return ememcmp(_ehashmap_slot_key(slot), key, ehashmap->key_size) == 0 ? ELIBC_TRUE : ELIBC_FALSE;
+
+    slot_key = (const ehashmap_key_t*)_ehashmap_slot_key(slot);
+
+    return (slot_key->size == key_size && (key_size == 0 || ememcmp(slot_key->data, key, key_size) == 0)) ? ELIBC_TRUE : ELIBC_FALSE;
+}
+
+/* slot index or capacity if not found */
+size_t _ehashmap_find(ehashmap_t* ehashmap, const void* key, size_t key_size, euint64_t hash)
+{
+    size_t mask = ehashmap->capacity - 1;
+    size_t pos, idx;
+    euint32_t match;
+    euint8_t h2 = _ehashmap_h2(hash);
+    char* slot;
+
+    if(ehashmap->item_count == 0) return ehashmap->capacity;
+
+    for(pos = _ehashmap_h1(hash) & mask; ; pos = (pos + EHASHMAP_GROUP_SIZE) & mask)
+    {
+        for(match = _ehashmap_match(ehashmap->ctrl + pos, h2); match != 0; match &= match - 1)
+        {
+            idx = (pos + _ehashmap_lowest_bit(match)) & mask;
+            slot = _ehashmap_slot(ehashmap, idx);
+
+            if(_ehashmap_slot_hash(slot) == hash && _ehashmap_key_equal(ehashmap, slot, key, key_size)) return idx;
+        }
+
+        /* probe sequence has no gaps, key would be before empty slot */
+        if(_ehashmap_match_empty(ehashmap->ctrl + pos) != 0) return ehashmap->capacity;
+    }
+}
+
+/* first empty slot from hash position */
+size_t _ehashmap_find_empty(const euint8_t* ctrl, size_t capacity, euint64_t hash)
+{
+    size_t mask = capacity - 1;
+    size_t pos;
+    euint32_t match;
+
+    for(pos = _ehashmap_h1(hash) & mask; ; pos = (pos + EHASHMAP_GROUP_SIZE) & mask)
+    {
+        match = _ehashmap_match_empty(ctrl + pos);
+        if(match != 0) return (pos + _ehashmap_lowest_bit(match)) & mask;
+    }
+}
+
+int _ehashmap_resize(ehashmap_t* ehashmap, size_t capacity)
+{
+    euint8_t* old_ctrl = ehashmap->ctrl;
+    char* old_slots = ehashmap->slots;
+    size_t old_capacity = ehashmap->capacity;
+    size_t idx, new_idx;
+    euint64_t hash;
+
+    /* new buffers */
+    ehashmap->ctrl = (euint8_t*)emalloc(capacity + EHASHMAP_GROUP_SIZE);
+    ehashmap->slots = (char*)emalloc(capacity * ehashmap->slot_size);
+
+    if(ehashmap->ctrl == 0 || ehashmap->slots == 0)
+    {
+        efree(ehashmap->ctrl);
+        efree(ehashmap->slots);
+
+        ehashmap->ctrl = old_ctrl;
+        ehashmap->slots = old_slots;
+
+        return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    ememset(ehashmap->ctrl, EHASHMAP_CTRL_EMPTY, capacity + EHASHMAP_GROUP_SIZE);
+    ehashmap->capacity = capacity;
+
+    /* move items using stored hashes */
+    for(idx = 0; idx < old_capacity; ++idx)
+    {
+        if(old_ctrl[idx] & EHASHMAP_CTRL_EMPTY) continue;
+
+        hash = _ehashmap_slot_hash(old_slots + idx * ehashmap->slot_size);
+        new_idx = _ehashmap_find_empty(ehashmap->ctrl, capacity, hash);
+
+        ememcpy(_ehashmap_slot(ehashmap, new_idx), old_slots + idx * ehashmap->slot_size, ehashmap->slot_size);
+        _ehashmap_set_ctrl(ehashmap, new_idx, _ehashmap_h2(hash));
+    }
+
+    ehashmap->growth_left = EHASHMAP_MAX_LOAD(capacity) - ehashmap->item_count;
+
+    efree(old_ctrl);
+    efree(old_slots);
+
+    return ELIBC_SUCCESS;
+}
+
+/* remove item in slot by shifting following items back, returns ELIBC_TRUE if slot was refilled */
+ebool_t _ehashmap_erase(ehashmap_t* ehashmap, size_t idx)
+{
+    size_t mask = ehashmap->capacity - 1;
+    size_t hole = idx;
+    size_t next, home;
+    char* slot;
+
+    /* release byte string key */
+    if(ehashmap->key_size == 0)
+    {
+        efree(((ehashmap_key_t*)_ehashmap_slot_key(_ehashmap_slot(ehashmap, idx)))->data);
+    }
+
+    for(next = (hole + 1) & mask; !(ehashmap->ctrl[next] & EHASHMAP_CTRL_EMPTY); next = (next + 1) & mask)
+    {
+        slot = _ehashmap_slot(ehashmap, next);
+        home = _ehashmap_h1(_ehashmap_slot_hash(slot)) & mask;
+
+        /* item can be moved if hole is between its home and current slot */
+        if(((next - home) & mask) >= ((next - hole) & mask))
+        {
+            ememcpy(_ehashmap_slot(ehashmap, hole), slot, ehashmap->slot_size);
+            _ehashmap_set_ctrl(ehashmap, hole, ehashmap->ctrl[next]);
+
+            hole = next;
+        }
+    }
+
+    _ehashmap_set_ctrl(ehashmap, hole, EHASHMAP_CTRL_EMPTY);
+
+    ehashmap->item_count--;
+    ehashmap->growth_left++;
+
+    return (hole != idx) ? ELIBC_TRUE : ELIBC_FALSE;
+}
+
+/* move iterator to the next full slot */
+int _ehashmap_advance(ehashmap_t* ehashmap, ehashmap_iter_t* iter)
+{
+    while(iter->slots_left > 0)
+    {
+        iter->slot = (iter->slot + 1) & (ehashmap->capacity - 1);
+        iter->slots_left--;
+
+        if(!(ehashmap->ctrl[iter->slot] & EHASHMAP_CTRL_EMPTY)) return ELIBC_TRUE;
+    }
+
+    return ELIBC_FALSE;
+}
+
+/*----------------------------------------------------------------------*/
+/* init and close */
+/*----------------------------------------------------------------------*/
+void ehashmap_init(ehashmap_t* ehashmap, size_t key_size, size_t value_size)
+{
+    EASSERT(ehashmap);
+    if(ehashmap)
+    {
+        /* reset all fields */
+        ememset(ehashmap, 0, sizeof(ehashmap_t));
+
+        ehashmap->key_size = key_size;
+        ehashmap->value_size = value_size;
+
+        /* slot layout */
+        ehashmap->value_offset = sizeof(euint64_t) + _ehashmap_align(key_size > 0 ? key_size : sizeof(ehashmap_key_t));
+        ehashmap->slot_size = _ehashmap_align(ehashmap->value_offset + value_size);
+
+        ehashmap->hash_func = hash_fast64_seed;
+    }
+}
+
+void ehashmap_free(ehashmap_t* ehashmap)
+{
+    if(ehashmap)
+    {
+        /* release keys */
+        ehashmap_reset(ehashmap);
+
+        /* free memory */
+        efree(ehashmap->ctrl);
+        efree(ehashmap->slots);
+
+        /* keep layout and hash function */
+        ehashmap->ctrl = 0;
+        ehashmap->slots = 0;
+        ehashmap->capacity = 0;
+        ehashmap->growth_left = 0;
+    }
+}
+
+void ehashmap_reset(ehashmap_t* ehashmap)
+{
+    size_t idx;
+
+    EASSERT(ehashmap);
+    if(ehashmap == 0 || ehashmap->capacity == 0) return;
+
+    /* release byte string keys */
+    if(ehashmap->key_size == 0)
+    {
+        for(idx = 0; idx < ehashmap->capacity; ++idx)
+        {
+            if(!(ehashmap->ctrl[idx] & EHASHMAP_CTRL_EMPTY))
+                efree(((ehashmap_key_t*)_ehashmap_slot_key(_ehashmap_slot(ehashmap, idx)))->data);
+        }
+    }
+
+    ememset(ehashmap->ctrl, EHASHMAP_CTRL_EMPTY, ehashmap->capacity + EHASHMAP_GROUP_SIZE);
+
+    ehashmap->item_count = 0;
+    ehashmap->growth_left = EHASHMAP_MAX_LOAD(ehashmap->capacity);
+}
+
+void ehashmap_set_hash(ehashmap_t* ehashmap, ehashmap_hash_func_t hash_func, euint64_t seed)
+{
+    EASSERT(ehashmap);
+    EASSERT(hash_func);
+    EASSERT(ehashmap == 0 || ehashmap->item_count == 0);
+    if(ehashmap == 0 || hash_func == 0 || ehashmap->item_count > 0) return;
+
+    ehashmap->hash_func = hash_func;
+    ehashmap->seed = seed;
+}
+
+int ehashmap_reserve(ehashmap_t* ehashmap, size_t item_count)
+{
+    size_t capacity;
+
+    EASSERT(ehashmap);
+    if(ehashmap == 0) return ELIBC_ERROR_ARGUMENT;
+
+    capacity = (ehashmap->capacity > 0) ? ehashmap->capacity : EHASHMAP_GROUP_SIZE;
+    while(EHASHMAP_MAX_LOAD(capacity) < item_count)
+    {
+        capacity <<= 1;
+    }
+
+    if(capacity <= ehashmap->capacity) return ELIBC_SUCCESS;
+
+    return _ehashmap_resize(ehashmap, capacity);
+}
+
+/*----------------------------------------------------------------------*/
+/* items */
+/*----------------------------------------------------------------------*/
+char* ehashmap_get(ehashmap_t* ehashmap, const void* key, size_t key_size)
+{
+    size_t idx;
+
+    EASSERT(ehashmap);
+    EASSERT(key || key_size == 0);
+    if(ehashmap == 0 || (key == 0 && key_size > 0)) return 0;
+
+    idx = _ehashmap_find(ehashmap, key, key_size, _ehashmap_hash(ehashmap, key, key_size));
+    if(idx == ehashmap->capacity) return 0;
+
+    return _ehashmap_slot_value(ehashmap, _ehashmap_slot(ehashmap, idx));
+}
+
+ebool_t ehashmap_has_key(ehashmap_t* ehashmap, const void* key, size_t key_size)
+{
+    EASSERT(ehashmap);
+    if(ehashmap == 0 || (key == 0 && key_size > 0)) return ELIBC_FALSE;
+
+    return (_ehashmap_find(ehashmap, key, key_size, _ehashmap_hash(ehashmap, key, key_size)) != ehashmap->capacity) ? ELIBC_TRUE : ELIBC_FALSE;
+}
+
+int ehashmap_set(ehashmap_t* ehashmap, const void* key, size_t key_size, const void* value)
+{
+    char* value_ptr;
+
+    EASSERT(ehashmap);
+    EASSERT(value || ehashmap == 0 || ehashmap->value_size == 0);
+    if(ehashmap == 0 || (value == 0 && ehashmap->value_size > 0)) return ELIBC_ERROR_ARGUMENT;
+
+    value_ptr = ehashmap_set_ptr(ehashmap, key, key_size, 0);
+    if(value_ptr == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    if(ehashmap->value_size > 0) ememcpy(value_ptr, value, ehashmap->value_size);
+
+    return ELIBC_SUCCESS;
+}
+
+char* ehashmap_set_ptr(ehashmap_t* ehashmap, const void* key, size_t key_size, ebool_t* created_out)
+{
+    ehashmap_key_t* slot_key;
+    euint64_t hash;
+    size_t idx;
+    char* slot;
+    char* key_copy = 0;
+
+    EASSERT(ehashmap);
+    EASSERT(key || key_size == 0);
+    if(ehashmap == 0 || (key == 0 && key_size > 0)) return 0;
+
+    if(created_out) *created_out = ELIBC_FALSE;
+
+    /* existing item */
+    hash = _ehashmap_hash(ehashmap, key, key_size);
+    idx = _ehashmap_find(ehashmap, key, key_size, hash);
+    if(idx != ehashmap->capacity) return _ehashmap_slot_value(ehashmap, _ehashmap_slot(ehashmap, idx));
+
+    /* grow */
+    if(ehashmap->growth_left == 0)
+    {
+        if(_ehashmap_resize(ehashmap, ehashmap->capacity > 0 ? ehashmap->capacity * 2 : EHASHMAP_GROUP_SIZE) != ELIBC_SUCCESS) return 0;
+    }
+
+    /* copy byte string key */
+    if(ehashmap->key_size == 0 && key_size > 0)
+    {
+        key_copy = (char*)emalloc(key_size);
+        if(key_copy == 0) return 0;
+
+        ememcpy(key_copy, key, key_size);
+    }
+
+    /* new item */
+    idx = _ehashmap_find_empty(ehashmap->ctrl, ehashmap->capacity, hash);
+    slot = _ehashmap_slot(ehashmap, idx);
+
+    _ehashmap_slot_hash(slot) = hash;
+
+    if(ehashmap->key_size > 0)
+    {
+        ememcpy(_ehashmap_slot_key(slot), key, ehashmap->key_size);
+
+    } else
+    {
+        slot_key = (ehashmap_key_t*)_ehashmap_slot_key(slot);
+        slot_key->data = key_copy;
+        slot_key->size = key_size;
+    }
+
+    ememset(_ehashmap_slot_value(ehashmap, slot), 0, ehashmap->value_size);
+    _ehashmap_set_ctrl(ehashmap, idx, _ehashmap_h2(hash));
+
+    ehashmap->item_count++;
+    ehashmap->growth_left--;
+
+    if(created_out) *created_out = ELIBC_TRUE;
+
+    return _ehashmap_slot_value(ehashmap, slot);
+}
+
+int ehashmap_remove(ehashmap_t* ehashmap, const void* key, size_t key_size)
+{
+    size_t idx;
+
+    EASSERT(ehashmap);
+    EASSERT(key || key_size == 0);
+    if(ehashmap == 0 || (key == 0 && key_size > 0)) return ELIBC_ERROR_ARGUMENT;
+
+    idx = _ehashmap_find(ehashmap, key, key_size, _ehashmap_hash(ehashmap, key, key_size));
+    if(idx == ehashmap->capacity) return ELIBC_ERROR_NOT_FOUND;
+
+    _ehashmap_erase(ehashmap, idx);
+
+    return ELIBC_SUCCESS;
+}
+
+/*----------------------------------------------------------------------*/
+/* iteration */
+/*----------------------------------------------------------------------*/
+
+/*
+    NOTE: iteration starts after empty slot, items are shifted back only within
+          runs of full slots, so removing current item can only move items that
+          were not visited yet into its slot
+*/
+
+int ehashmap_first(ehashmap_t* ehashmap, ehashmap_iter_t* iter)
+{
+    size_t idx;
+
+    EASSERT(ehashmap);
+    EASSERT(iter);
+    if(ehashmap == 0 || iter == 0) return ELIBC_FALSE;
+
+    iter->slot = 0;
+    iter->slots_left = 0;
+
+    if(ehashmap->item_count == 0) return ELIBC_FALSE;
+
+    /* map is never full */
+    for(idx = 0; !(ehashmap->ctrl[idx] & EHASHMAP_CTRL_EMPTY); ++idx);
+
+    iter->slot = idx;
+    iter->slots_left = ehashmap->capacity;
+
+    return _ehashmap_advance(ehashmap, iter);
+}
+
+int ehashmap_next(ehashmap_t* ehashmap, ehashmap_iter_t* iter)
+{
+    EASSERT(ehashmap);
+    EASSERT(iter);
+    if(ehashmap == 0 || iter == 0) return ELIBC_FALSE;
+
+    return _ehashmap_advance(ehashmap, iter);
+}
+
+int ehashmap_remove_iter(ehashmap_t* ehashmap, ehashmap_iter_t* iter)
+{
+    EASSERT(ehashmap);
+    EASSERT(iter);
+    if(ehashmap == 0 || iter == 0 || ehashmap->capacity == 0) return ELIBC_FALSE;
+
+    EASSERT(!(ehashmap->ctrl[iter->slot] & EHASHMAP_CTRL_EMPTY));
+    if(ehashmap->ctrl[iter->slot] & EHASHMAP_CTRL_EMPTY) return ELIBC_FALSE;
+
+    /* next item was shifted into current slot */
+    if(_ehashmap_erase(ehashmap, iter->slot)) return ELIBC_TRUE;
+
+    return _ehashmap_advance(ehashmap, iter);
+}
+
+const void* ehashmap_iter_key(ehashmap_t* ehashmap, const ehashmap_iter_t* iter)
+{
+    char* slot;
+
+    EASSERT(ehashmap);
+    EASSERT(iter);
+    if(ehashmap == 0 || iter == 0 || ehashmap->capacity == 0) return 0;
+
+    slot = _ehashmap_slot(ehashmap, iter->slot);
+    if(ehashmap->key_size > 0) return _ehashmap_slot_key(slot);
+
+    return ((ehashmap_key_t*)_ehashmap_slot_key(slot))->data;
+}
+
+size_t ehashmap_iter_key_size(ehashmap_t* ehashmap, const ehashmap_iter_t* iter)
+{
+    EASSERT(ehashmap);
+    EASSERT(iter);
+    if(ehashmap == 0 || iter == 0 || ehashmap->capacity == 0) return 0;
+
+    if(ehashmap->key_size > 0) return ehashmap->key_size;
+
+    return ((ehashmap_key_t*)_ehashmap_slot_key(_ehashmap_slot(ehashmap, iter->slot)))->size;
+}
+
+char* ehashmap_iter_value(ehashmap_t* ehashmap, const ehashmap_iter_t* iter)
+{
+    EASSERT(ehashmap);
+    EASSERT(iter);
+    if(ehashmap == 0 || iter == 0 || ehashmap->capacity == 0) return 0;
+
+    return _ehashmap_slot_value(ehashmap, _ehashmap_slot(ehashmap, iter->slot));
+}
+
+/*----------------------------------------------------------------------*/
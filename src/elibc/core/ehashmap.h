@@ -0,0 +1,120 @@
+/*
+    Hash map
+*/
+
+#ifndef _EHASHMAP_H_
+#define _EHASHMAP_H_
+
+/*----------------------------------------------------------------------*/
+
+/*
+    NOTE: open addressing hash map (Swiss table layout). Every slot has one
+          control byte which is either empty marker or 7 bits of key hash,
+          lookup compares 16 control bytes at once (SSE2 when available) and
+          compares keys only for matching bytes. Slots are probed linearly,
+          so removed items are replaced by shifting following items back and
+          there are no tombstones slowing down lookups.
+
+          Keys are either of fixed size (copied into slot) or byte strings of
+          any size (key_size is zero in init, keys are copied to separate
+          allocations). Values are of fixed size and stored in slots, value
+          pointers are valid until map is modified.
+
+          Hash function is hash_fast64_seed from src/hash unless set with
+          ehashmap_set_hash, use random seed for keys coming from network.
+*/
+
+/*----------------------------------------------------------------------*/
+/* constants */
+
+/* slots compared at once */
+#define EHASHMAP_GROUP_SIZE         16
+
+/*----------------------------------------------------------------------*/
+
+/* hash function (key, key size, seed) */
+typedef euint64_t (*ehashmap_hash_func_t)(const euint8_t*, size_t, euint64_t);
+
+/* hash map */
+typedef struct
+{
+    euint8_t*               ctrl;           /* control bytes, first group is repeated at the end */
+    char*                   slots;
+
+    size_t                  capacity;       /* power of two or zero */
+    size_t                  item_count;
+    size_t                  growth_left;    /* items to insert before resize */
+
+    size_t                  key_size;       /* zero for byte string keys */
+    size_t                  value_size;
+    size_t                  value_offset;
+    size_t                  slot_size;
+
+    ehashmap_hash_func_t    hash_func;
+    euint64_t               seed;
+
+} ehashmap_t;
+
+/* hash map iterator */
+typedef struct
+{
+    size_t                  slot;
+    size_t                  slots_left;
+
+} ehashmap_iter_t;
+
+/*----------------------------------------------------------------------*/
+
+/* init and close */
+void    ehashmap_init(ehashmap_t* ehashmap, size_t key_size, size_t value_size);
+void    ehashmap_free(ehashmap_t* ehashmap);
+void    ehashmap_reset(ehashmap_t* ehashmap);
+
+/* hash function must be set before first item is added */
+void    ehashmap_set_hash(ehashmap_t* ehashmap, ehashmap_hash_func_t hash_func, euint64_t seed);
+
+/* reserve memory for items */
+int     ehashmap_reserve(ehashmap_t* ehashmap, size_t item_count);
+
+/* map properties */
+#define ehashmap_size(ehashmap)         ((ehashmap)->item_count)
+#define ehashmap_key_size(ehashmap)     ((ehashmap)->key_size)
+#define ehashmap_value_size(ehashmap)   ((ehashmap)->value_size)
+
+/*
+    NOTE: key_size is ignored for fixed size keys
+*/
+
+/* find value, returns zero if key is not found */
+char*   ehashmap_get(ehashmap_t* ehashmap, const void* key, size_t key_size);
+ebool_t ehashmap_has_key(ehashmap_t* ehashmap, const void* key, size_t key_size);
+
+/* add or replace value (value is copied) */
+int     ehashmap_set(ehashmap_t* ehashmap, const void* key, size_t key_size, const void* value);
+
+/* value for in place update, new values are zero filled (created_out may be zero) */
+char*   ehashmap_set_ptr(ehashmap_t* ehashmap, const void* key, size_t key_size, ebool_t* created_out);
+
+/* remove item, returns ELIBC_ERROR_NOT_FOUND if there is no such key */
+int     ehashmap_remove(ehashmap_t* ehashmap, const void* key, size_t key_size);
+
+/*
+    NOTE: iteration order is not defined, map must not be modified during
+          iteration except with ehashmap_remove_iter
+*/
+
+/* iterate items, functions return ELIBC_FALSE when there are no more items */
+int     ehashmap_first(ehashmap_t* ehashmap, ehashmap_iter_t* iter);
+int     ehashmap_next(ehashmap_t* ehashmap, ehashmap_iter_t* iter);
+
+/* remove current item and move to the next one */
+int     ehashmap_remove_iter(ehashmap_t* ehashmap, ehashmap_iter_t* iter);
+
+/* current item */
+const void* ehashmap_iter_key(ehashmap_t* ehashmap, const ehashmap_iter_t* iter);
+size_t      ehashmap_iter_key_size(ehashmap_t* ehashmap, const ehashmap_iter_t* iter);
+char*       ehashmap_iter_value(ehashmap_t* ehashmap, const ehashmap_iter_t* iter);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _EHASHMAP_H_ */
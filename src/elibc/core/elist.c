@@ -5,6 +5,7 @@
 #include "../elibc_config.h"
 #include "../stdlib/estdlib.h"
 
+#include "ecore_types.h"
 #include "eassert.h"
 #include "etrace.h"
 #include "eerror.h"
@@ -602,6 +603,104 @@ int elist_replace(elist_t* elist, const eliter_t eliter, const void* item)
     return ELIBC_SUCCESS;
 }
 
+/*----------------------------------------------------------------------*/
+/* sort items */
+/*----------------------------------------------------------------------*/
+int elist_sort(elist_t* elist, eless_func_t eless_func)
+{
+    size_t merge_size, merge_count, left_size, right_size, idx;
+    size_t list, left, right, node, tail, prev;
+
+    /* check input */
+    if(!_elist_validate_list(elist)) return ELIBC_ERROR_ARGUMENT;
+
+    EASSERT(eless_func);
+    if(eless_func == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* ignore if there is one or zero items */
+    if(elist->items_count <= 1) return ELIBC_SUCCESS;
+
+    /*
+        NOTE: bottom-up merge sort, on every pass neighbouring runs of merge_size
+              nodes are merged using next offsets only. Previous offsets, head
+              and tail are restored when list is sorted.
+    */
+
+    list = elist->buffer[ELIST_HEAD_OFFSET_INDEX];
+
+    for(merge_size = 1; ; merge_size *= 2)
+    {
+        left = list;
+        list = ELIST_NULL_ITERATOR;
+        tail = ELIST_NULL_ITERATOR;
+        merge_count = 0;
+
+        while(left != ELIST_NULL_ITERATOR)
+        {
+            merge_count++;
+
+            /* right run starts after merge_size nodes */
+            right = left;
+            for(left_size = 0; left_size < merge_size && right != ELIST_NULL_ITERATOR; ++left_size)
+            {
+                right = (elist->buffer + right)[ELIST_NEXT_OFFSET_INDEX];
+            }
+
+            right_size = merge_size;
+
+            /* merge runs */
+            while(left_size > 0 || (right_size > 0 && right != ELIST_NULL_ITERATOR))
+            {
+                /* take left node unless right one is less (keeps order of equal items) */
+                if(left_size > 0 && (right_size == 0 || right == ELIST_NULL_ITERATOR ||
+                   !eless_func(elist->buffer + right + ELIST_NODE_DATA_OFFSET, elist->buffer + left + ELIST_NODE_DATA_OFFSET)))
+                {
+                    node = left;
+                    left = (elist->buffer + left)[ELIST_NEXT_OFFSET_INDEX];
+                    left_size--;
+
+                } else
+                {
+                    node = right;
+                    right = (elist->buffer + right)[ELIST_NEXT_OFFSET_INDEX];
+                    right_size--;
+                }
+
+                /* append to merged list */
+                if(tail != ELIST_NULL_ITERATOR)
+                    (elist->buffer + tail)[ELIST_NEXT_OFFSET_INDEX] = node;
+                else
+                    list = node;
+
+                tail = node;
+            }
+
+            left = right;
+        }
+
+        (elist->buffer + tail)[ELIST_NEXT_OFFSET_INDEX] = ELIST_NULL_ITERATOR;
+
+        /* single merge means list is sorted */
+        if(merge_count <= 1) break;
+    }
+
+    /* restore previous offsets */
+    prev = ELIST_NULL_ITERATOR;
+    for(node = list, idx = 0; node != ELIST_NULL_ITERATOR; node = (elist->buffer + node)[ELIST_NEXT_OFFSET_INDEX], ++idx)
+    {
+        (elist->buffer + node)[ELIST_PREV_OFFSET_INDEX] = prev;
+        prev = node;
+    }
+
+    EASSERT(idx == elist->items_count);
+
+    /* new head and tail */
+    elist->buffer[ELIST_HEAD_OFFSET_INDEX] = list;
+    elist->buffer[ELIST_TAIL_OFFSET_INDEX] = prev;
+
+    return ELIBC_SUCCESS;
+}
+
 /*----------------------------------------------------------------------*/
 /* items data  */
 /*----------------------------------------------------------------------*/
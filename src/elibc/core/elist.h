@@ -78,6 +78,14 @@ int elist_insert(elist_t* elist, const eliter_t eliter, const void* item, eliter
 /* modify items */
 int elist_replace(elist_t* elist, const eliter_t eliter, const void* item);
 
+/*
+    NOTE: sort is stable and only relinks nodes, items are not copied and
+          iterators keep pointing to the same items
+*/
+
+/* sort items */
+int elist_sort(elist_t* elist, eless_func_t eless_func);
+
 /* items data */
 void* elist_item(elist_t* elist, const eliter_t eliter);
 
@@ -0,0 +1,465 @@
+/*
+    Fixed size object pool
+*/
+
+#include "../elibc_config.h"
+#include "../stdlib/estdlib.h"
+
+#include "eassert.h"
+#include "etrace.h"
+#include "eerror.h"
+#include "eatomic.h"
+#include "ethread.h"
+#include "epool.h"
+
+/*----------------------------------------------------------------------*/
+
+/* object alignment */
+#define EPOOL_ALIGN                     16
+#define _epool_align(size)              (((size) + EPOOL_ALIGN - 1) & ~((size_t)EPOOL_ALIGN - 1))
+
+/*----------------------------------------------------------------------*/
+
+/* thread heap */
+typedef struct epool_heap_s
+{
+    /* owner side */
+    struct epool_object_s*  objects;        /* free objects */
+    epool_t*                epool;
+    struct epool_heap_s*    next;           /* all pool heaps */
+    struct epool_heap_s*    next_detached;
+    char                    padding0[EATOMIC_CACHE_LINE_SIZE - 4 * sizeof(void*)];
+
+    /* objects released by other threads */
+    eatomic_ptr_t           released;
+    char                    padding1[EATOMIC_CACHE_LINE_SIZE - sizeof(eatomic_ptr_t)];
+
+} epool_heap_t;
+
+/* object header (object content is kept while it is free) */
+typedef struct epool_object_s
+{
+    epool_heap_t*           heap;
+    struct epool_object_s*  next;
+
+} epool_object_t;
+
+/* slab header */
+typedef struct epool_slab_s
+{
+    struct epool_slab_s*    next;
+    size_t                  count;
+
+} epool_slab_t;
+
+#define _EPOOL_OBJECT_HEADER            _epool_align(sizeof(epool_object_t))
+#define _EPOOL_SLAB_HEADER              _epool_align(sizeof(epool_slab_t))
+
+#define _epool_object_data(object)      ((char*)(object) + _EPOOL_OBJECT_HEADER)
+#define _epool_data_object(data)        ((epool_object_t*)((char*)(data) - _EPOOL_OBJECT_HEADER))
+#define _epool_slab_object(epool, slab, idx) \
+    ((epool_object_t*)((char*)(slab) + _EPOOL_SLAB_HEADER + (idx) * (epool)->object_stride))
+
+/* heap used by thread (pool may be already freed) */
+typedef struct
+{
+    eint64_t                pool_id;
+    epool_t*                epool;
+    epool_heap_t*           heap;
+
+} epool_thread_heap_t;
+
+/*----------------------------------------------------------------------*/
+
+/* pool ids are never reused, so heaps of freed pools are never found */
+static eatomic_t _epool_last_id = 0;
+
+/* pools with heaps (heap forgotten by thread is returned only if pool is in list) */
+static eatomic_t _epool_live_lock = 0;
+static epool_t* _epool_live = 0;
+
+/* heaps of current thread */
+static ELIBC_THREAD_LOCAL epool_thread_heap_t _epool_thread_heaps[EPOOL_THREAD_POOLS];
+static ELIBC_THREAD_LOCAL unsigned int _epool_thread_replace = 0;
+
+/*----------------------------------------------------------------------*/
+/* live pools */
+/*----------------------------------------------------------------------*/
+void _epool_live_lock_acquire()
+{
+    while(!eatomic_cas(&_epool_live_lock, 0, 1)) eatomic_pause();
+}
+
+void _epool_live_lock_release()
+{
+    eatomic_store(&_epool_live_lock, 0);
+}
+
+void _epool_live_add(epool_t* epool)
+{
+    _epool_live_lock_acquire();
+
+    epool->next_live = _epool_live;
+    _epool_live = epool;
+
+    _epool_live_lock_release();
+}
+
+void _epool_live_remove(epool_t* epool)
+{
+    epool_t** live;
+
+    _epool_live_lock_acquire();
+
+    for(live = &_epool_live; *live; live = (epool_t**)&(*live)->next_live)
+    {
+        if(*live == epool)
+        {
+            *live = (epool_t*)epool->next_live;
+            break;
+        }
+    }
+
+    _epool_live_lock_release();
+}
+
+/* give heap forgotten by thread to other threads if its pool still exists */
+void _epool_live_detach(epool_thread_heap_t* thread_heap)
+{
+    epool_t* epool;
+
+    _epool_live_lock_acquire();
+
+    for(epool = _epool_live; epool; epool = (epool_t*)epool->next_live)
+    {
+        if(epool == thread_heap->epool && epool->id == thread_heap->pool_id)
+        {
+            /* pool can't be freed while it is in list */
+            emutex_lock(epool->mutex);
+            thread_heap->heap->next_detached = (epool_heap_t*)epool->detached;
+            epool->detached = thread_heap->heap;
+            emutex_unlock(epool->mutex);
+
+            break;
+        }
+    }
+
+    _epool_live_lock_release();
+}
+
+/*----------------------------------------------------------------------*/
+/* heaps */
+/*----------------------------------------------------------------------*/
+epool_heap_t* _epool_thread_heap(epool_t* epool)
+{
+    int idx;
+
+    for(idx = 0; idx < EPOOL_THREAD_POOLS; ++idx)
+    {
+        if(_epool_thread_heaps[idx].pool_id == epool->id) return _epool_thread_heaps[idx].heap;
+    }
+
+    return 0;
+}
+
+epool_heap_t* _epool_attach_heap(epool_t* epool)
+{
+    epool_heap_t* heap;
+    int idx;
+
+    /* reuse heap left by other thread */
+    emutex_lock(epool->mutex);
+
+    heap = (epool_heap_t*)epool->detached;
+    if(heap) epool->detached = heap->next_detached;
+
+    emutex_unlock(epool->mutex);
+
+    if(heap == 0)
+    {
+        heap = (epool_heap_t*)emalloc(sizeof(epool_heap_t));
+        if(heap == 0) return 0;
+
+        ememset(heap, 0, sizeof(epool_heap_t));
+        heap->epool = epool;
+
+        emutex_lock(epool->mutex);
+        heap->next = (epool_heap_t*)epool->heaps;
+        epool->heaps = heap;
+        emutex_unlock(epool->mutex);
+
+        /* pool doesn't move once it is used, register it with first heap */
+        if(eatomic_cas(&epool->live, 0, 1)) _epool_live_add(epool);
+    }
+
+    heap->next_detached = 0;
+
+    /* remember heap in free slot or replace the oldest one */
+    for(idx = 0; idx < EPOOL_THREAD_POOLS; ++idx)
+    {
+        if(_epool_thread_heaps[idx].pool_id == 0) break;
+    }
+
+    if(idx == EPOOL_THREAD_POOLS)
+    {
+        idx = (int)(_epool_thread_replace++ % EPOOL_THREAD_POOLS);
+        ETRACE("epool: thread uses too many pools, oldest heap is given to other threads");
+
+        /* objects in forgotten heap are reused by the next thread attaching to its pool */
+        _epool_live_detach(&_epool_thread_heaps[idx]);
+    }
+
+    _epool_thread_heaps[idx].pool_id = epool->id;
+    _epool_thread_heaps[idx].epool = epool;
+    _epool_thread_heaps[idx].heap = heap;
+
+    return heap;
+}
+
+/* take all objects released by other threads */
+epool_object_t* _epool_take_released(epool_heap_t* heap)
+{
+    void* objects;
+
+    /* only owner removes objects, so list can't change back to the same head */
+    objects = eatomic_load_ptr(&heap->released);
+    while(objects && !eatomic_cas_ptr(&heap->released, objects, (void*)0))
+    {
+        objects = eatomic_load_ptr(&heap->released);
+    }
+
+    return (epool_object_t*)objects;
+}
+
+/*----------------------------------------------------------------------*/
+/* slabs */
+/*----------------------------------------------------------------------*/
+int _epool_alloc_slab(epool_t* epool, epool_heap_t* heap)
+{
+    epool_object_t* object;
+    epool_slab_t* slab;
+    size_t idx;
+    int err;
+
+    slab = (epool_slab_t*)emalloc(_EPOOL_SLAB_HEADER + epool->slab_objects * epool->object_stride);
+    if(slab == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    slab->count = epool->slab_objects;
+
+    /* init objects and add them to heap in memory order */
+    for(idx = epool->slab_objects; idx > 0; --idx)
+    {
+        object = _epool_slab_object(epool, slab, idx - 1);
+        object->heap = heap;
+
+        if(epool->object_init)
+        {
+            err = epool->object_init(_epool_object_data(object), epool->object_arg);
+            if(err != ELIBC_SUCCESS)
+            {
+                ETRACE("epool: failed to init pool object");
+
+                /* free objects that were initialized */
+                if(epool->object_free)
+                {
+                    for(; idx < epool->slab_objects; ++idx)
+                    {
+                        epool->object_free(_epool_object_data(_epool_slab_object(epool, slab, idx)), epool->object_arg);
+                    }
+                }
+
+                efree(slab);
+                return err;
+            }
+        }
+
+        object->next = heap->objects;
+        heap->objects = object;
+    }
+
+    emutex_lock(epool->mutex);
+    slab->next = (epool_slab_t*)epool->slabs;
+    epool->slabs = slab;
+    emutex_unlock(epool->mutex);
+
+    return ELIBC_SUCCESS;
+}
+
+/*----------------------------------------------------------------------*/
+/* init and close */
+/*----------------------------------------------------------------------*/
+int epool_init(epool_t* epool, size_t object_size, size_t slab_objects)
+{
+    int err;
+
+    EASSERT(epool);
+    EASSERT(object_size > 0);
+    if(epool == 0 || object_size == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* reset all fields */
+    ememset(epool, 0, sizeof(epool_t));
+
+    err = emutex_create(&epool->mutex);
+    if(err != ELIBC_SUCCESS) return err;
+
+    epool->object_size = object_size;
+    epool->object_stride = _EPOOL_OBJECT_HEADER + _epool_align(object_size);
+    epool->slab_objects = slab_objects ? slab_objects : EPOOL_DEFAULT_SLAB_OBJECTS;
+    epool->id = eatomic_add(&_epool_last_id, 1) + 1;
+
+    return ELIBC_SUCCESS;
+}
+
+void epool_free(epool_t* epool)
+{
+    epool_slab_t* slab;
+    epool_heap_t* heap;
+    size_t idx;
+
+    if(epool == 0) return;
+
+    /* forgotten heaps can't be returned to pool any more */
+    if(epool->live) _epool_live_remove(epool);
+
+    /* free objects and slabs */
+    while(epool->slabs)
+    {
+        slab = (epool_slab_t*)epool->slabs;
+        epool->slabs = slab->next;
+
+        if(epool->object_free)
+        {
+            for(idx = 0; idx < slab->count; ++idx)
+            {
+                epool->object_free(_epool_object_data(_epool_slab_object(epool, slab, idx)), epool->object_arg);
+            }
+        }
+
+        efree(slab);
+    }
+
+    /* free heaps */
+    while(epool->heaps)
+    {
+        heap = (epool_heap_t*)epool->heaps;
+        epool->heaps = heap->next;
+        efree(heap);
+    }
+
+    /* forget heap of current thread */
+    for(idx = 0; idx < EPOOL_THREAD_POOLS; ++idx)
+    {
+        if(_epool_thread_heaps[idx].pool_id == epool->id) ememset(&_epool_thread_heaps[idx], 0, sizeof(epool_thread_heap_t));
+    }
+
+    if(epool->mutex) emutex_destroy(epool->mutex);
+
+    /* reset all fields */
+    ememset(epool, 0, sizeof(epool_t));
+}
+
+int epool_set_object_funcs(epool_t* epool, epool_object_init_t object_init, epool_object_free_t object_free, void* arg)
+{
+    EASSERT(epool);
+    if(epool == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* existing objects were not initialized */
+    EASSERT1(epool->slabs == 0, "epool: object functions must be set before first allocation");
+    if(epool->slabs) return ELIBC_ERROR_INVALID_STATE;
+
+    epool->object_init = object_init;
+    epool->object_free = object_free;
+    epool->object_arg = arg;
+
+    return ELIBC_SUCCESS;
+}
+
+/*----------------------------------------------------------------------*/
+/* objects */
+/*----------------------------------------------------------------------*/
+void* epool_alloc(epool_t* epool)
+{
+    epool_object_t* object;
+    epool_heap_t* heap;
+
+    EASSERT(epool);
+    if(epool == 0) return 0;
+
+    heap = _epool_thread_heap(epool);
+    if(heap == 0)
+    {
+        heap = _epool_attach_heap(epool);
+        if(heap == 0) return 0;
+    }
+
+    /* refill from objects released by other threads and then from new slab */
+    if(heap->objects == 0)
+    {
+        heap->objects = _epool_take_released(heap);
+        if(heap->objects == 0 && _epool_alloc_slab(epool, heap) != ELIBC_SUCCESS) return 0;
+    }
+
+    object = heap->objects;
+    heap->objects = object->next;
+
+    return _epool_object_data(object);
+}
+
+void epool_release(epool_t* epool, void* data)
+{
+    epool_object_t* object;
+    epool_heap_t* heap;
+    void* head;
+
+    EASSERT(epool);
+    if(epool == 0 || data == 0) return;
+
+    object = _epool_data_object(data);
+    heap = object->heap;
+
+    EASSERT1(heap->epool == epool, "epool: object belongs to other pool");
+
+    /* own heap */
+    if(heap == _epool_thread_heap(epool))
+    {
+        object->next = heap->objects;
+        heap->objects = object;
+        return;
+    }
+
+    /* push to heap owner */
+    do
+    {
+        head = eatomic_load_ptr_relaxed(&heap->released);
+        object->next = (epool_object_t*)head;
+
+    } while(!eatomic_cas_ptr(&heap->released, head, (void*)object));
+}
+
+void epool_thread_detach(epool_t* epool)
+{
+    epool_heap_t* heap;
+    int idx;
+
+    EASSERT(epool);
+    if(epool == 0) return;
+
+    for(idx = 0; idx < EPOOL_THREAD_POOLS; ++idx)
+    {
+        if(_epool_thread_heaps[idx].pool_id == epool->id)
+        {
+            heap = _epool_thread_heaps[idx].heap;
+            ememset(&_epool_thread_heaps[idx], 0, sizeof(epool_thread_heap_t));
+
+            /* free objects go with heap to the next thread */
+            emutex_lock(epool->mutex);
+            heap->next_detached = (epool_heap_t*)epool->detached;
+            epool->detached = heap;
+            emutex_unlock(epool->mutex);
+
+            return;
+        }
+    }
+}
+
+/*----------------------------------------------------------------------*/
@@ -0,0 +1,89 @@
+/*
+    Fixed size object pool
+*/
+
+#ifndef _EPOOL_H_
+#define _EPOOL_H_
+
+/*
+    Objects are carved from slabs, every thread using the pool gets its own
+    heap with free list that is used without locks or atomics. Object released
+    by other thread is pushed to free list of heap it belongs to with single
+    compare-and-swap, heap owner takes whole list when its own list is empty.
+    Memory is allocated only when all heap objects are in use and is not
+    returned to system until pool is freed.
+
+    Pool can cache initialized objects (e.g. parsers with reserved stacks and
+    buffers): init function is called for all slab objects when slab is
+    allocated and free function when pool is freed. Released objects keep their
+    content, so user resets object state after alloc.
+
+    NOTE: pool must not be moved in memory after first allocation, all objects
+          must be released and all threads must stop using pool before it is
+          freed. Thread remembers heaps of EPOOL_THREAD_POOLS most recent pools,
+          the oldest heap is given to other threads when it is replaced. Thread
+          that stops using pool (e.g. before it exits) should call
+          epool_thread_detach so other threads can reuse its heap.
+*/
+
+/*----------------------------------------------------------------------*/
+
+/* default number of objects in slab */
+#define EPOOL_DEFAULT_SLAB_OBJECTS      64
+
+/* pools remembered by thread */
+#define EPOOL_THREAD_POOLS              8
+
+/*----------------------------------------------------------------------*/
+
+/* object init and free functions (object, argument) */
+typedef int (*epool_object_init_t)(void*, void*);
+typedef void (*epool_object_free_t)(void*, void*);
+
+/* object pool */
+typedef struct
+{
+    size_t                  object_size;
+    size_t                  object_stride;  /* object with header */
+    size_t                  slab_objects;
+    eint64_t                id;             /* unique pool id */
+
+    /* cached objects */
+    epool_object_init_t     object_init;
+    epool_object_free_t     object_free;
+    void*                   object_arg;
+
+    /* slabs and heaps */
+    emutex_t                mutex;
+    void*                   slabs;
+    void*                   heaps;
+    void*                   detached;       /* heaps without owner thread */
+
+    /* live pools list */
+    eatomic_t               live;
+    void*                   next_live;
+
+} epool_t;
+
+/*----------------------------------------------------------------------*/
+
+/* init and close (slab_objects zero selects default) */
+int epool_init(epool_t* epool, size_t object_size, size_t slab_objects);
+void epool_free(epool_t* epool);
+
+/* cache initialized objects (must be set before first allocation) */
+int epool_set_object_funcs(epool_t* epool, epool_object_init_t object_init, epool_object_free_t object_free, void* arg);
+
+/* pool properties */
+#define epool_object_size(epool)        ((epool)->object_size)
+
+/* objects (may be released from any thread) */
+void* epool_alloc(epool_t* epool);
+void epool_release(epool_t* epool, void* object);
+
+/* give heap of current thread to other threads */
+void epool_thread_detach(epool_t* epool);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _EPOOL_H_ */
@@ -0,0 +1,289 @@
+/*
+    Lock-free bounded queues
+*/
+
+#include "../elibc_config.h"
+#include "../stdlib/estdlib.h"
+
+#include "eassert.h"
+#include "etrace.h"
+#include "eerror.h"
+#include "eatomic.h"
+#include "equeue.h"
+
+/*----------------------------------------------------------------------*/
+/* helper functions */
+/*----------------------------------------------------------------------*/
+
+/* capacity rounded up to power of two */
+size_t _equeue_capacity(size_t capacity)
+{
+    size_t size = 2;
+
+    while(size < capacity && size < ((size_t)1 << (sizeof(size_t) * 8 - 2)))
+    {
+        size <<= 1;
+    }
+
+    return size;
+}
+
+ELIBC_FORCE_INLINE void _equeue_copy(char* dst, const char* src, size_t item_size)
+{
+    /* common item sizes are copied with fixed size moves */
+    switch(item_size)
+    {
+    case 4:  ememcpy(dst, src, 4); break;
+    case 8:  ememcpy(dst, src, 8); break;
+    case 16: ememcpy(dst, src, 16); break;
+    default: ememcpy(dst, src, item_size); break;
+    }
+}
+
+/* cell sequence number */
+#define _equeue_mpmc_cell(equeue, pos)      ((equeue)->cells + ((size_t)(pos) & (equeue)->mask) * (equeue)->cell_size)
+#define _equeue_mpmc_sequence(cell)         ((eatomic_t*)(cell))
+#define _equeue_mpmc_item(cell)             ((cell) + sizeof(eatomic_t))
+
+/*----------------------------------------------------------------------*/
+/* single producer single consumer */
+/*----------------------------------------------------------------------*/
+int equeue_spsc_init(equeue_spsc_t* equeue, size_t item_size, size_t capacity)
+{
+    EASSERT(equeue);
+    EASSERT(item_size > 0);
+    if(equeue == 0 || item_size == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* reset all fields */
+    ememset(equeue, 0, sizeof(equeue_spsc_t));
+
+    capacity = _equeue_capacity(capacity);
+
+    equeue->items = (char*)emalloc(capacity * item_size);
+    if(equeue->items == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    equeue->item_size = item_size;
+    equeue->mask = capacity - 1;
+
+    return ELIBC_SUCCESS;
+}
+
+void equeue_spsc_free(equeue_spsc_t* equeue)
+{
+    if(equeue)
+    {
+        /* free memory */
+        efree(equeue->items);
+
+        /* reset all fields */
+        ememset(equeue, 0, sizeof(equeue_spsc_t));
+    }
+}
+
+int equeue_spsc_push(equeue_spsc_t* equeue, const void* item)
+{
+    eint64_t tail;
+
+    EASSERT(equeue);
+    EASSERT(item);
+    if(equeue == 0 || item == 0) return ELIBC_FALSE;
+
+    tail = eatomic_load_relaxed(&equeue->tail);
+
+    /* check consumer index only if ring looks full */
+    if(tail - equeue->head_cache > (eint64_t)equeue->mask)
+    {
+        equeue->head_cache = eatomic_load(&equeue->head);
+        if(tail - equeue->head_cache > (eint64_t)equeue->mask) return ELIBC_FALSE;
+    }
+
+    _equeue_copy(equeue->items + ((size_t)tail & equeue->mask) * equeue->item_size, (const char*)item, equeue->item_size);
+
+    /* publish item */
+    eatomic_store(&equeue->tail, tail + 1);
+
+    return ELIBC_TRUE;
+}
+
+char* equeue_spsc_front(equeue_spsc_t* equeue)
+{
+    eint64_t head;
+
+    EASSERT(equeue);
+    if(equeue == 0) return 0;
+
+    head = eatomic_load_relaxed(&equeue->head);
+
+    /* check producer index only if ring looks empty */
+    if(head >= equeue->tail_cache)
+    {
+        equeue->tail_cache = eatomic_load(&equeue->tail);
+        if(head >= equeue->tail_cache) return 0;
+    }
+
+    return equeue->items + ((size_t)head & equeue->mask) * equeue->item_size;
+}
+
+int equeue_spsc_pop(equeue_spsc_t* equeue, void* item)
+{
+    char* front;
+
+    front = equeue_spsc_front(equeue);
+    if(front == 0) return ELIBC_FALSE;
+
+    if(item) _equeue_copy((char*)item, front, equeue->item_size);
+
+    /* release slot */
+    eatomic_store(&equeue->head, eatomic_load_relaxed(&equeue->head) + 1);
+
+    return ELIBC_TRUE;
+}
+
+size_t equeue_spsc_size(equeue_spsc_t* equeue)
+{
+    eint64_t head, tail;
+
+    EASSERT(equeue);
+    if(equeue == 0) return 0;
+
+    head = eatomic_load(&equeue->head);
+    tail = eatomic_load(&equeue->tail);
+
+    return (tail > head) ? (size_t)(tail - head) : 0;
+}
+
+/*----------------------------------------------------------------------*/
+/* multiple producers multiple consumers */
+/*----------------------------------------------------------------------*/
+int equeue_mpmc_init(equeue_mpmc_t* equeue, size_t item_size, size_t capacity)
+{
+    size_t idx;
+
+    EASSERT(equeue);
+    EASSERT(item_size > 0);
+    if(equeue == 0 || item_size == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* reset all fields */
+    ememset(equeue, 0, sizeof(equeue_mpmc_t));
+
+    capacity = _equeue_capacity(capacity);
+
+    /* keep sequence numbers aligned */
+    equeue->cell_size = (sizeof(eatomic_t) + item_size + sizeof(eatomic_t) - 1) & ~(sizeof(eatomic_t) - 1);
+
+    equeue->cells = (char*)emalloc(capacity * equeue->cell_size);
+    if(equeue->cells == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    equeue->item_size = item_size;
+    equeue->mask = capacity - 1;
+
+    /* cell is free for position equal to its sequence number */
+    for(idx = 0; idx < capacity; ++idx)
+    {
+        eatomic_store_relaxed(_equeue_mpmc_sequence(_equeue_mpmc_cell(equeue, idx)), (eint64_t)idx);
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+void equeue_mpmc_free(equeue_mpmc_t* equeue)
+{
+    if(equeue)
+    {
+        /* free memory */
+        efree(equeue->cells);
+
+        /* reset all fields */
+        ememset(equeue, 0, sizeof(equeue_mpmc_t));
+    }
+}
+
+int equeue_mpmc_push(equeue_mpmc_t* equeue, const void* item)
+{
+    char* cell;
+    eint64_t pos, diff;
+
+    EASSERT(equeue);
+    EASSERT(item);
+    if(equeue == 0 || item == 0) return ELIBC_FALSE;
+
+    pos = eatomic_load_relaxed(&equeue->tail);
+    for(;;)
+    {
+        cell = _equeue_mpmc_cell(equeue, pos);
+        diff = eatomic_load(_equeue_mpmc_sequence(cell)) - pos;
+
+        if(diff == 0)
+        {
+            /* cell is free, claim position */
+            if(eatomic_cas(&equeue->tail, pos, pos + 1)) break;
+
+        } else if(diff < 0)
+        {
+            /* cell was not read yet, queue is full */
+            return ELIBC_FALSE;
+        }
+
+        /* other producer was faster */
+        pos = eatomic_load_relaxed(&equeue->tail);
+    }
+
+    _equeue_copy(_equeue_mpmc_item(cell), (const char*)item, equeue->item_size);
+
+    /* ready for consumer */
+    eatomic_store(_equeue_mpmc_sequence(cell), pos + 1);
+
+    return ELIBC_TRUE;
+}
+
+int equeue_mpmc_pop(equeue_mpmc_t* equeue, void* item)
+{
+    char* cell;
+    eint64_t pos, diff;
+
+    EASSERT(equeue);
+    if(equeue == 0) return ELIBC_FALSE;
+
+    pos = eatomic_load_relaxed(&equeue->head);
+    for(;;)
+    {
+        cell = _equeue_mpmc_cell(equeue, pos);
+        diff = eatomic_load(_equeue_mpmc_sequence(cell)) - (pos + 1);
+
+        if(diff == 0)
+        {
+            /* cell is written, claim position */
+            if(eatomic_cas(&equeue->head, pos, pos + 1)) break;
+
+        } else if(diff < 0)
+        {
+            /* cell was not written yet, queue is empty */
+            return ELIBC_FALSE;
+        }
+
+        /* other consumer was faster */
+        pos = eatomic_load_relaxed(&equeue->head);
+    }
+
+    if(item) _equeue_copy((char*)item, _equeue_mpmc_item(cell), equeue->item_size);
+
+    /* free for producer on next lap */
+    eatomic_store(_equeue_mpmc_sequence(cell), pos + (eint64_t)equeue->mask + 1);
+
+    return ELIBC_TRUE;
+}
+
+size_t equeue_mpmc_size(equeue_mpmc_t* equeue)
+{
+    eint64_t head, tail;
+
+    EASSERT(equeue);
+    if(equeue == 0) return 0;
+
+    head = eatomic_load(&equeue->head);
+    tail = eatomic_load(&equeue->tail);
+
+    return (tail > head) ? (size_t)(tail - head) : 0;
+}
+
+/*----------------------------------------------------------------------*/
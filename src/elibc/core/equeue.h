@@ -0,0 +1,100 @@
+/*
+    Lock-free bounded queues
+*/
+
+#ifndef _EQUEUE_H_
+#define _EQUEUE_H_
+
+/*
+    Both queues store copies of fixed size items (like earray) in a ring with
+    capacity rounded up to power of two, nothing is allocated after init.
+
+    equeue_spsc_t - single producer and single consumer ring, each side keeps
+                    cached copy of the other side index and reads shared index
+                    only when cached one says ring is full or empty.
+
+    equeue_mpmc_t - any number of producers and consumers (Dmitry Vyukov's
+                    bounded queue), every cell carries sequence number telling
+                    whether it is ready to be written or read.
+
+    Push and pop return ELIBC_TRUE on success and ELIBC_FALSE if queue is full
+    or empty, they never block.
+*/
+
+/*----------------------------------------------------------------------*/
+
+/* single producer single consumer queue */
+typedef struct
+{
+    char*       items;              /* ring buffer */
+    size_t      item_size;          /* single item size */
+    size_t      mask;               /* capacity - 1 */
+    char        padding0[EATOMIC_CACHE_LINE_SIZE - sizeof(char*) - 2 * sizeof(size_t)];
+
+    /* producer side */
+    eatomic_t   tail;
+    eint64_t    head_cache;
+    char        padding1[EATOMIC_CACHE_LINE_SIZE - sizeof(eatomic_t) - sizeof(eint64_t)];
+
+    /* consumer side */
+    eatomic_t   head;
+    eint64_t    tail_cache;
+    char        padding2[EATOMIC_CACHE_LINE_SIZE - sizeof(eatomic_t) - sizeof(eint64_t)];
+
+} equeue_spsc_t;
+
+/* multiple producers multiple consumers queue */
+typedef struct
+{
+    char*       cells;              /* sequence number followed by item */
+    size_t      cell_size;
+    size_t      item_size;          /* single item size */
+    size_t      mask;               /* capacity - 1 */
+    char        padding0[EATOMIC_CACHE_LINE_SIZE - sizeof(char*) - 3 * sizeof(size_t)];
+
+    /* producers */
+    eatomic_t   tail;
+    char        padding1[EATOMIC_CACHE_LINE_SIZE - sizeof(eatomic_t)];
+
+    /* consumers */
+    eatomic_t   head;
+    char        padding2[EATOMIC_CACHE_LINE_SIZE - sizeof(eatomic_t)];
+
+} equeue_mpmc_t;
+
+/*----------------------------------------------------------------------*/
+
+/*
+    NOTE: queues must not be moved in memory or reset while other threads
+          are using them
+*/
+
+/* single producer single consumer */
+int     equeue_spsc_init(equeue_spsc_t* equeue, size_t item_size, size_t capacity);
+void    equeue_spsc_free(equeue_spsc_t* equeue);
+
+int     equeue_spsc_push(equeue_spsc_t* equeue, const void* item);
+int     equeue_spsc_pop(equeue_spsc_t* equeue, void* item);
+
+/* first item without removing it (consumer only), pop with zero item drops it */
+char*   equeue_spsc_front(equeue_spsc_t* equeue);
+
+/* multiple producers multiple consumers */
+int     equeue_mpmc_init(equeue_mpmc_t* equeue, size_t item_size, size_t capacity);
+void    equeue_mpmc_free(equeue_mpmc_t* equeue);
+
+int     equeue_mpmc_push(equeue_mpmc_t* equeue, const void* item);
+int     equeue_mpmc_pop(equeue_mpmc_t* equeue, void* item);
+
+/* queue properties (size is approximate while queue is used) */
+#define equeue_spsc_capacity(equeue)    ((equeue)->mask + 1)
+#define equeue_spsc_item_size(equeue)   ((equeue)->item_size)
+size_t  equeue_spsc_size(equeue_spsc_t* equeue);
+
+#define equeue_mpmc_capacity(equeue)    ((equeue)->mask + 1)
+#define equeue_mpmc_item_size(equeue)   ((equeue)->item_size)
+size_t  equeue_mpmc_size(equeue_mpmc_t* equeue);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _EQUEUE_H_ */
@@ -0,0 +1,228 @@
+/*
+    Byte ring buffer
+*/
+
+#include "../elibc_config.h"
+#include "../stdlib/estdlib.h"
+
+#include "eassert.h"
+#include "etrace.h"
+#include "eerror.h"
+#include "ering.h"
+
+/*----------------------------------------------------------------------*/
+/* helper functions */
+/*----------------------------------------------------------------------*/
+
+/* capacity rounded up to power of two */
+size_t _ering_capacity(size_t capacity)
+{
+    size_t size = 1;
+
+    while(size < capacity && size < ((size_t)1 << (sizeof(size_t) * 8 - 2)))
+    {
+        size <<= 1;
+    }
+
+    return size;
+}
+
+#define _ering_offset(ering, pos)   ((pos) & ((ering)->capacity - 1))
+
+/*----------------------------------------------------------------------*/
+/* init and close */
+/*----------------------------------------------------------------------*/
+int ering_init(ering_t* ering, size_t capacity)
+{
+    EASSERT(ering);
+    EASSERT(capacity > 0);
+    if(ering == 0 || capacity == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* reset all fields */
+    ememset(ering, 0, sizeof(ering_t));
+
+    capacity = _ering_capacity(capacity);
+
+    ering->data = (char*)emalloc(capacity);
+    if(ering->data == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    ering->capacity = capacity;
+
+    return ELIBC_SUCCESS;
+}
+
+int ering_init_mirrored(ering_t* ering, size_t capacity)
+{
+    int err;
+
+    EASSERT(ering);
+    EASSERT(capacity > 0);
+    if(ering == 0 || capacity == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* reset all fields */
+    ememset(ering, 0, sizeof(ering_t));
+
+    err = _ering_map_mirrored(ering, _ering_capacity(capacity));
+    if(err != ELIBC_SUCCESS)
+    {
+        ETRACE("ering: failed to map mirrored ring");
+        ememset(ering, 0, sizeof(ering_t));
+        return err;
+    }
+
+    ering->mirrored = ELIBC_TRUE;
+
+    return ELIBC_SUCCESS;
+}
+
+void ering_free(ering_t* ering)
+{
+    if(ering)
+    {
+        /* free memory */
+        if(ering->mirrored)
+            _ering_unmap_mirrored(ering);
+        else
+            efree(ering->data);
+
+        /* reset all fields */
+        ememset(ering, 0, sizeof(ering_t));
+    }
+}
+
+void ering_reset(ering_t* ering)
+{
+    EASSERT(ering);
+    if(ering)
+    {
+        ering->read_pos = 0;
+        ering->write_pos = 0;
+    }
+}
+
+/*----------------------------------------------------------------------*/
+/* continuous regions */
+/*----------------------------------------------------------------------*/
+char* ering_write_ptr(ering_t* ering, size_t* size_out)
+{
+    size_t offset, size;
+
+    EASSERT(ering);
+    EASSERT(size_out);
+    if(ering == 0 || size_out == 0) return 0;
+
+    offset = _ering_offset(ering, ering->write_pos);
+    size = ering_space(ering);
+
+    /* normal ring stops at the end of buffer */
+    if(!ering->mirrored && offset + size > ering->capacity) size = ering->capacity - offset;
+
+    *size_out = size;
+
+    return ering->data + offset;
+}
+
+int ering_commit(ering_t* ering, size_t size)
+{
+    EASSERT(ering);
+    EASSERT(ering == 0 || size <= ering_space(ering));
+    if(ering == 0 || size > ering_space(ering)) return ELIBC_ERROR_ARGUMENT;
+
+    ering->write_pos += size;
+
+    return ELIBC_SUCCESS;
+}
+
+char* ering_read_ptr(ering_t* ering, size_t* size_out)
+{
+    size_t offset, size;
+
+    EASSERT(ering);
+    EASSERT(size_out);
+    if(ering == 0 || size_out == 0) return 0;
+
+    offset = _ering_offset(ering, ering->read_pos);
+    size = ering_size(ering);
+
+    /* normal ring stops at the end of buffer */
+    if(!ering->mirrored && offset + size > ering->capacity) size = ering->capacity - offset;
+
+    *size_out = size;
+
+    return ering->data + offset;
+}
+
+int ering_consume(ering_t* ering, size_t size)
+{
+    EASSERT(ering);
+    EASSERT(ering == 0 || size <= ering_size(ering));
+    if(ering == 0 || size > ering_size(ering)) return ELIBC_ERROR_ARGUMENT;
+
+    ering->read_pos += size;
+
+    /* start from the beginning when empty, keeps normal ring regions whole */
+    if(ering->read_pos == ering->write_pos)
+    {
+        ering->read_pos = 0;
+        ering->write_pos = 0;
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+/*----------------------------------------------------------------------*/
+/* copy */
+/*----------------------------------------------------------------------*/
+size_t ering_write(ering_t* ering, const void* data, size_t size)
+{
+    const char* src = (const char*)data;
+    size_t part, written = 0;
+    char* dst;
+
+    EASSERT(ering);
+    EASSERT(data || size == 0);
+    if(ering == 0 || data == 0) return 0;
+
+    /* at most two parts */
+    while(written < size)
+    {
+        dst = ering_write_ptr(ering, &part);
+        if(part == 0) break;
+
+        if(part > size - written) part = size - written;
+
+        ememcpy(dst, src + written, part);
+        ering->write_pos += part;
+        written += part;
+    }
+
+    return written;
+}
+
+size_t ering_read(ering_t* ering, void* data_out, size_t size)
+{
+    char* dst = (char*)data_out;
+    size_t part, copied = 0;
+    char* src;
+
+    EASSERT(ering);
+    EASSERT(data_out || size == 0);
+    if(ering == 0 || data_out == 0) return 0;
+
+    /* at most two parts */
+    while(copied < size)
+    {
+        src = ering_read_ptr(ering, &part);
+        if(part == 0) break;
+
+        if(part > size - copied) part = size - copied;
+
+        ememcpy(dst + copied, src, part);
+        ering_consume(ering, part);
+        copied += part;
+    }
+
+    return copied;
+}
+
+/*----------------------------------------------------------------------*/
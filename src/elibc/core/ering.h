@@ -0,0 +1,69 @@
+/*
+    Byte ring buffer
+*/
+
+#ifndef _ERING_H_
+#define _ERING_H_
+
+/*
+    NOTE: ring keeps written bytes until they are consumed, so streaming
+          parsers can be called on data in ring and leftover bytes don't
+          have to be moved before next read.
+
+          Readable and writable regions of normal ring are split in two
+          parts when they wrap around the end of buffer. Mirrored ring maps
+          the same memory twice one after another, so both regions are
+          always continuous. Mirrored ring capacity is rounded to page
+          (allocation granularity on Windows) size.
+*/
+
+/*----------------------------------------------------------------------*/
+
+/* ring buffer */
+typedef struct
+{
+    char*       data;
+    size_t      capacity;           /* power of two */
+    size_t      read_pos;           /* positions are not wrapped */
+    size_t      write_pos;
+
+    void*       mapping;            /* system handle of mirrored ring */
+    ebool_t     mirrored;
+
+} ering_t;
+
+/*----------------------------------------------------------------------*/
+
+/* init and close (capacity is rounded up to power of two) */
+int     ering_init(ering_t* ering, size_t capacity);
+int     ering_init_mirrored(ering_t* ering, size_t capacity);
+void    ering_free(ering_t* ering);
+void    ering_reset(ering_t* ering);
+
+/* ring properties */
+#define ering_capacity(ering)       ((ering)->capacity)
+#define ering_size(ering)           ((ering)->write_pos - (ering)->read_pos)
+#define ering_space(ering)          ((ering)->capacity - ering_size(ering))
+#define ering_is_mirrored(ering)    ((ering)->mirrored)
+
+/* continuous free space for writing (e.g. socket read), followed by commit */
+char*   ering_write_ptr(ering_t* ering, size_t* size_out);
+int     ering_commit(ering_t* ering, size_t size);
+
+/* continuous readable data (e.g. parser input), followed by consume */
+char*   ering_read_ptr(ering_t* ering, size_t* size_out);
+int     ering_consume(ering_t* ering, size_t size);
+
+/* copy data in and out, return number of bytes copied */
+size_t  ering_write(ering_t* ering, const void* data, size_t size);
+size_t  ering_read(ering_t* ering, void* data_out, size_t size);
+
+/*----------------------------------------------------------------------*/
+
+/* system specific mapping of mirrored ring (internal) */
+int     _ering_map_mirrored(ering_t* ering, size_t capacity);
+void    _ering_unmap_mirrored(ering_t* ering);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _ERING_H_ */
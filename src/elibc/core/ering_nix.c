@@ -0,0 +1,91 @@
+/*
+    Byte ring buffer (mirrored mapping)
+*/
+
+#include <unistd.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#include "../elibc_config.h"
+#include "../stdlib/estdlib.h"
+
+#include "eassert.h"
+#include "etrace.h"
+#include "eerror.h"
+#include "ering.h"
+
+/*----------------------------------------------------------------------*/
+
+/* anonymous file for ring memory */
+int _ering_create_file()
+{
+    int fd;
+
+#if defined(SYS_memfd_create)
+    /* MFD_CLOEXEC */
+    fd = (int)syscall(SYS_memfd_create, "ering", 1U);
+    if(fd >= 0) return fd;
+#endif
+
+    /* temporary file removed right after it is opened */
+    {
+        char file_name[] = "/tmp/ering-XXXXXX";
+
+        fd = mkstemp(file_name);
+        if(fd >= 0) unlink(file_name);
+    }
+
+    return fd;
+}
+
+int _ering_map_mirrored(ering_t* ering, size_t capacity)
+{
+    long page_size = sysconf(_SC_PAGESIZE);
+    char* base;
+    int fd;
+
+    /* whole pages (page size is power of two) */
+    if(page_size > 0 && capacity < (size_t)page_size) capacity = (size_t)page_size;
+
+    fd = _ering_create_file();
+    if(fd < 0) return ELIBC_ERROR_NOT_SUPPORTED;
+
+    if(ftruncate(fd, (off_t)capacity) != 0)
+    {
+        close(fd);
+        return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    /* reserve address range for both copies */
+    base = (char*)mmap(0, 2 * capacity, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(base == (char*)MAP_FAILED)
+    {
+        close(fd);
+        return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    /* map file twice */
+    if(mmap(base, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+       mmap(base + capacity, capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED)
+    {
+        munmap(base, 2 * capacity);
+        close(fd);
+        return ELIBC_ERROR_NOT_SUPPORTED;
+    }
+
+    /* mappings keep memory */
+    close(fd);
+
+    ering->data = base;
+    ering->capacity = capacity;
+
+    return ELIBC_SUCCESS;
+}
+
+void _ering_unmap_mirrored(ering_t* ering)
+{
+    if(ering->data) munmap(ering->data, 2 * ering->capacity);
+}
+
+/*----------------------------------------------------------------------*/
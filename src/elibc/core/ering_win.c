@@ -0,0 +1,77 @@
+/*
+    Byte ring buffer (mirrored mapping)
+*/
+
+#include <windows.h>
+
+#include "../elibc_config.h"
+#include "../stdlib/estdlib.h"
+
+#include "eassert.h"
+#include "etrace.h"
+#include "eerror.h"
+#include "ering.h"
+
+/*----------------------------------------------------------------------*/
+
+/* attempts to find free address range */
+#define ERING_MAP_ATTEMPTS          16
+
+/*----------------------------------------------------------------------*/
+
+int _ering_map_mirrored(ering_t* ering, size_t capacity)
+{
+    SYSTEM_INFO system_info;
+    HANDLE mapping;
+    char* base;
+    void* first;
+    void* second;
+    int attempt;
+
+    /* views must be aligned to allocation granularity (power of two) */
+    GetSystemInfo(&system_info);
+    if(capacity < (size_t)system_info.dwAllocationGranularity) capacity = (size_t)system_info.dwAllocationGranularity;
+
+    mapping = CreateFileMappingW(INVALID_HANDLE_VALUE, 0, PAGE_READWRITE,
+                                 (DWORD)((euint64_t)capacity >> 32), (DWORD)(capacity & 0xFFFFFFFF), 0);
+    if(mapping == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    for(attempt = 0; attempt < ERING_MAP_ATTEMPTS; ++attempt)
+    {
+        /* find free range and release it, other thread may take it before it is mapped */
+        base = (char*)VirtualAlloc(0, 2 * capacity, MEM_RESERVE, PAGE_NOACCESS);
+        if(base == 0) break;
+        VirtualFree(base, 0, MEM_RELEASE);
+
+        first = MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, capacity, base);
+        second = first ? MapViewOfFileEx(mapping, FILE_MAP_ALL_ACCESS, 0, 0, capacity, base + capacity) : 0;
+
+        if(first && second)
+        {
+            ering->data = base;
+            ering->capacity = capacity;
+            ering->mapping = mapping;
+
+            return ELIBC_SUCCESS;
+        }
+
+        if(first) UnmapViewOfFile(first);
+    }
+
+    CloseHandle(mapping);
+
+    return ELIBC_ERROR_NOT_SUPPORTED;
+}
+
+void _ering_unmap_mirrored(ering_t* ering)
+{
+    if(ering->data)
+    {
+        UnmapViewOfFile(ering->data + ering->capacity);
+        UnmapViewOfFile(ering->data);
+    }
+
+    if(ering->mapping) CloseHandle((HANDLE)ering->mapping);
+}
+
+/*----------------------------------------------------------------------*/
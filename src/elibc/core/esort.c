@@ -12,355 +12,393 @@
 #include "elist.h"
 #include "esort.h"
 
-/*----------------------------------------------------------------------*/
-/* constants */
-/*----------------------------------------------------------------------*/
-
-#define ESORT_CUTOFF_THRESHOLD              8
-#define ESORT_LIST_CUTOFF_THRESHOLD         8
-
 /*----------------------------------------------------------------------*/
 /* helper functions */
 /*----------------------------------------------------------------------*/
-ELIBC_FORCE_INLINE void _eswap_items(char* items, size_t item_size, size_t left_pos, size_t right_pos, char* swap_buffer)
-{
-    /* left item to temp */
-    ememcpy(swap_buffer, items + left_pos * item_size, item_size);
-
-    /* right item to left */
-    ememcpy(items + left_pos * item_size, items + right_pos * item_size, item_size);
-
-    /* temp to right item */
-    ememcpy(items + right_pos * item_size, swap_buffer, item_size);
-}
-
-void _einsertsort(char* items, size_t item_size, size_t start_pos, size_t end_pos, eless_func_t eless_func, char* swap_buffer)
+/* number of unbalanced partitions allowed before heapsort */
+static int _esort_bad_partitions(size_t item_count)
 {
-    size_t pos, cmp_pos;
+    int bad_allowed = 0;
 
-    /* loop over all elements */
-    for(pos = start_pos + 1; pos < end_pos; ++pos)
+    /* log2 of item count */
+    while(item_count > 1)
     {
-        /* move to the beginning */
-        for(cmp_pos = pos; cmp_pos > start_pos; --cmp_pos)
-        {
-            /* check order */
-            if(eless_func(items + (cmp_pos-1) * item_size, items + cmp_pos * item_size)) break;
-            
-            /* sawp */
-            _eswap_items(items, item_size, cmp_pos-1, cmp_pos, swap_buffer);
-        }
+        item_count >>= 1;
+        ++bad_allowed;
     }
+
+    return bad_allowed;
 }
 
-void _esort_iteration(char* items, size_t item_size, size_t start_pos, size_t end_pos, eless_func_t eless_func, char* swap_buffer)
+void _eswap_items(char* left, char* right, size_t item_size)
 {
-    size_t pivot, low, high;
+    euint32_t item32;
+    euint64_t item64;
+    char item8;
 
-    /* check if ready*/
-    if(end_pos - start_pos <= ESORT_CUTOFF_THRESHOLD) 
+    /* common sizes are swapped with single move */
+    if(item_size == sizeof(euint32_t))
     {
-        /* finish with insertion sort */
-        _einsertsort(items, item_size, start_pos, end_pos, eless_func, swap_buffer);
-
-        /* stop */
-        return; 
+        ememcpy(&item32, left, sizeof(euint32_t));
+        ememcpy(left, right, sizeof(euint32_t));
+        ememcpy(right, &item32, sizeof(euint32_t));
+        return;
     }
 
-    /* use median as pivot */
-    pivot = start_pos + (end_pos - start_pos) / 2;
-
-    /* move pivot point to the end */
-    _eswap_items(items, item_size, pivot, end_pos - 1, swap_buffer);
-
-    /* adjust pivot iterator */
-    pivot = end_pos - 1;
-
-    /* borders */
-    low = start_pos;
-    high = pivot - 1; /* ignore pivot value */
-
-    /* sort */
-    while(low < high)
+    /* swap larger items by words */
+    for( ; item_size >= sizeof(euint64_t); item_size -= sizeof(euint64_t), left += sizeof(euint64_t), right += sizeof(euint64_t))
     {
-        /* find low swap point */
-        while(low < high && eless_func(items + low * item_size, items + pivot * item_size)) ++low;
-
-        /* find high swap point */
-        while(low < high && eless_func(items + pivot * item_size, items + high * item_size)) --high;
-
-        /* swap if needed */
-        if(low < high)
-        {
-            _eswap_items(items, item_size, low, high, swap_buffer);
-            ++low;
-            --high;
-        }
+        ememcpy(&item64, left, sizeof(euint64_t));
+        ememcpy(left, right, sizeof(euint64_t));
+        ememcpy(right, &item64, sizeof(euint64_t));
     }
 
-    /* check if we need to move intersection point */
-    if(eless_func(items + low * item_size, items + pivot * item_size))
+    for( ; item_size > 0; --item_size, ++left, ++right)
     {
-        ++low;
+        item8 = *left;
+        *left = *right;
+        *right = item8;
     }
-    
-    /* move pivot at intersection point */
-    _eswap_items(items, item_size, low, pivot, swap_buffer);
+}
 
-    /* sort parts */
-    _esort_iteration(items, item_size, start_pos, low, eless_func, swap_buffer);
-    _esort_iteration(items, item_size, high + 1, end_pos, eless_func, swap_buffer);
+ELIBC_FORCE_INLINE void _esort2(char* left, char* right, size_t item_size, eless_func_t eless_func)
+{
+    if(eless_func(right, left)) _eswap_items(left, right, item_size);
 }
 
 /*----------------------------------------------------------------------*/
 /* generic array sort */
 /*----------------------------------------------------------------------*/
-int esort(char* items, size_t item_size, size_t item_count, eless_func_t eless_func, char* swap_buffer)
+void _einsertsort(char* begin, char* end, size_t item_size, eless_func_t eless_func, char* swap_buffer)
 {
-    char* temp_buffer=0;
+    char* pos;
+    char* cur;
 
-    /* check input */
-    EASSERT(items);
-    EASSERT(item_size);
-    EASSERT(eless_func);
-    if(items == 0 || item_size == 0 || eless_func == 0) return ELIBC_ERROR_ARGUMENT;
+    for(pos = begin + item_size; pos < end; pos += item_size)
+    {
+        /* skip if already in place */
+        if(!eless_func(pos, pos - item_size)) continue;
 
-    /* ignore if there is one or zero items */
-    if(item_count <= 1) return ELIBC_SUCCESS;
+        /* shift greater items right */
+        ememcpy(swap_buffer, pos, item_size);
+        cur = pos;
+        do
+        {
+            ememcpy(cur, cur - item_size, item_size);
+            cur -= item_size;
 
-    /* alloc swap buffer if not provided */
-    if(swap_buffer == 0)
-    {
-        temp_buffer = (char*)emalloc(item_size);
-        if(temp_buffer == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+        } while(cur > begin && eless_func(swap_buffer, cur - item_size));
 
-        /* set reference */
-        swap_buffer = temp_buffer;
+        ememcpy(cur, swap_buffer, item_size);
     }
+}
 
-    /* sort */
-    _esort_iteration(items, item_size, 0, item_count, eless_func, swap_buffer);
+int _epartial_insertsort(char* begin, char* end, size_t item_size, eless_func_t eless_func, char* swap_buffer)
+{
+    char* pos;
+    char* cur;
+    size_t moves = 0;
 
-    /* release swap buffer if any */
-    if(temp_buffer)
+    for(pos = begin + item_size; pos < end; pos += item_size)
     {
-        efree(temp_buffer);
-        temp_buffer = 0;
+        /* skip if already in place */
+        if(!eless_func(pos, pos - item_size)) continue;
+
+        /* shift greater items right */
+        ememcpy(swap_buffer, pos, item_size);
+        cur = pos;
+        do
+        {
+            ememcpy(cur, cur - item_size, item_size);
+            cur -= item_size;
+
+        } while(cur > begin && eless_func(swap_buffer, cur - item_size));
+
+        ememcpy(cur, swap_buffer, item_size);
+
+        /* give up if range is not almost sorted */
+        moves += (size_t)(pos - cur) / item_size;
+        if(moves > ESORT_PARTIAL_INSERTION_LIMIT) return ELIBC_FALSE;
     }
 
-    return ELIBC_SUCCESS;
+    return ELIBC_TRUE;
 }
 
-/*----------------------------------------------------------------------*/
-/* sort list */
-/*----------------------------------------------------------------------*/
-int _einsertsort_list(elist_t* elist, const eliter_t start_pos, const eliter_t end_pos, eless_func_t eless_func)
+void _eheapsort(char* begin, char* end, size_t item_size, eless_func_t eless_func)
 {
-    size_t cmp_pos;
-    int err = ELIBC_SUCCESS;
-
-    EASSERT(start_pos);
-    EASSERT(end_pos);
+    size_t item_count = (size_t)(end - begin) / item_size;
+    size_t start, root, child;
 
-    /* check if something to sort */
-    if(start_pos == end_pos) return ELIBC_SUCCESS;
-
-    /* loop over all elements */
-    cmp_pos = start_pos;
-    while(cmp_pos != end_pos)
+    /* build heap and move maximum to the end one by one */
+    for(start = item_count / 2; item_count > 1; )
     {
-        size_t cmp_left = cmp_pos;
-        size_t cmp_right;
+        if(start > 0)
+        {
+            --start;
 
-        /* next item */
-        err = elist_next(elist, cmp_pos, &cmp_pos);
-        if(err != ELIBC_SUCCESS) break;
+        } else
+        {
+            --item_count;
+            _eswap_items(begin, begin + item_count * item_size, item_size);
+        }
 
-        /* move to the beginning */
-        cmp_right = cmp_pos;
-        while(cmp_right != start_pos)
+        /* sift down */
+        for(root = start; (child = 2 * root + 1) < item_count; root = child)
         {
-            /* check order */
-            if(eless_func(elist_item(elist, cmp_left), elist_item(elist, cmp_right))) break;
-            
-            /* swap */
-            err = elist_swap(elist, cmp_left, cmp_right);
-            if(err != ELIBC_SUCCESS) break;
-
-            cmp_right = cmp_left; 
-
-            /* previous */
-            err = elist_previous(elist, cmp_left, &cmp_left);
-            if(err != ELIBC_SUCCESS) break;
+            if(child + 1 < item_count && eless_func(begin + child * item_size, begin + (child + 1) * item_size)) ++child;
+            if(!eless_func(begin + root * item_size, begin + child * item_size)) break;
+
+            _eswap_items(begin + root * item_size, begin + child * item_size, item_size);
         }
     }
-
-    return err;
 }
 
-size_t _esort_list_item_count(elist_t* elist, eliter_t start_pos, const eliter_t end_pos)
+void _esort_choose_pivot(char* begin, char* end, size_t item_size, eless_func_t eless_func)
 {
-    size_t item_count = 1;
-    int err = ELIBC_SUCCESS;
+    size_t item_count = (size_t)(end - begin) / item_size;
+    char* mid = begin + (item_count / 2) * item_size;
+    char* last = end - item_size;
 
-    EASSERT(start_pos);
-    EASSERT(end_pos);
-
-    /* count items */
-    while(start_pos != end_pos)
+    if(item_count > ESORT_NINTHER_THRESHOLD)
     {
-        item_count++;
+        /* pseudo median of nine */
+        _esort2(begin, mid, item_size, eless_func);
+        _esort2(mid, last, item_size, eless_func);
+        _esort2(begin, mid, item_size, eless_func);
 
-        /* next */
-        err = elist_next(elist, start_pos, &start_pos);
-        if(err != ELIBC_SUCCESS) break;
-    }
+        _esort2(begin + item_size, mid - item_size, item_size, eless_func);
+        _esort2(mid - item_size, last - item_size, item_size, eless_func);
+        _esort2(begin + item_size, mid - item_size, item_size, eless_func);
+
+        _esort2(begin + 2 * item_size, mid + item_size, item_size, eless_func);
+        _esort2(mid + item_size, last - 2 * item_size, item_size, eless_func);
+        _esort2(begin + 2 * item_size, mid + item_size, item_size, eless_func);
+
+        _esort2(mid - item_size, mid, item_size, eless_func);
+        _esort2(mid, mid + item_size, item_size, eless_func);
+        _esort2(mid - item_size, mid, item_size, eless_func);
 
-    EASSERT(err == ELIBC_SUCCESS);
-    return item_count;
+        _eswap_items(begin, mid, item_size);
+
+    } else
+    {
+        /* median of three moved to the beginning */
+        _esort2(mid, begin, item_size, eless_func);
+        _esort2(begin, last, item_size, eless_func);
+        _esort2(mid, begin, item_size, eless_func);
+    }
 }
 
-eliter_t _esort_list_advance(elist_t* elist, eliter_t start_pos, size_t count)
+char* _esort_partition_right(char* begin, char* end, size_t item_size, eless_func_t eless_func, int* partitioned)
 {
-    size_t item_count = 0;
-    int err;
+    char* low = begin + item_size;
+    char* high = end;
 
-    EASSERT(start_pos);
+    /* items less than pivot go left, pivot stays at the beginning */
+    while(low < high && eless_func(low, begin)) low += item_size;
+    while(low < high && !eless_func(high - item_size, begin)) high -= item_size;
 
-    /* advance iterator */
-    while(item_count < count)
+    *partitioned = (low >= high) ? ELIBC_TRUE : ELIBC_FALSE;
+
+    while(low < high)
     {
-        item_count++;
+        _eswap_items(low, high - item_size, item_size);
+        low += item_size;
+        high -= item_size;
 
-        /* next */
-        err = elist_next(elist, start_pos, &start_pos);
-        if(err != ELIBC_SUCCESS) break;
+        while(low < high && eless_func(low, begin)) low += item_size;
+        while(low < high && !eless_func(high - item_size, begin)) high -= item_size;
     }
 
-    EASSERT(err == ELIBC_SUCCESS);
-    return start_pos;
+    /* move pivot between parts */
+    low -= item_size;
+    _eswap_items(begin, low, item_size);
+
+    return low;
 }
 
-int _esort_list_iteration(elist_t* elist, const eliter_t start_pos, const eliter_t end_pos, eless_func_t eless_func)
+char* _esort_partition_left(char* begin, char* end, size_t item_size, eless_func_t eless_func)
 {
-    eliter_t pivot, low, high;
-    size_t item_count;
-    int err;
+    char* low = begin + item_size;
+    char* high = end;
 
-    /* find size */
-    item_count = _esort_list_item_count(elist, start_pos, end_pos);
+    /* items not greater than pivot go left */
+    while(low < high && !eless_func(begin, low)) low += item_size;
+    while(low < high && eless_func(begin, high - item_size)) high -= item_size;
 
-    /* check if ready*/
-    if(item_count <= ESORT_LIST_CUTOFF_THRESHOLD) 
+    while(low < high)
     {
-        /* finish with insertion sort */
-        return _einsertsort_list(elist, start_pos, end_pos, eless_func);
-    }
+        _eswap_items(low, high - item_size, item_size);
+        low += item_size;
+        high -= item_size;
 
-    /* use median as pivot */
-    pivot = _esort_list_advance(elist, start_pos, item_count / 2);
-
-    /* move pivot point to the end */
-    err = elist_swap(elist, pivot, end_pos);
-    if(err != ELIBC_SUCCESS) return err;
+        while(low < high && !eless_func(begin, low)) low += item_size;
+        while(low < high && eless_func(begin, high - item_size)) high -= item_size;
+    }
 
-    /* adjust pivot iterator */
-    pivot = end_pos;
+    /* move pivot between parts */
+    low -= item_size;
+    _eswap_items(begin, low, item_size);
 
-    /* beginning */
-    low = start_pos;
+    return low;
+}
 
-    /* end (ignore pivot value) */
-    err = elist_previous(elist, pivot, &high);
-    if(err != ELIBC_SUCCESS) return err;
+void _esort_iteration(char* begin, char* end, size_t item_size, eless_func_t eless_func, char* swap_buffer, int bad_allowed, int leftmost)
+{
+    char* pivot;
+    size_t item_count, left_count, right_count;
+    int partitioned;
 
-    /* sort */
-    while(low != high)
+    for(;;)
     {
-        /* find low swap point */
-        while(low != high && eless_func(elist_item(elist, low), elist_item(elist, pivot))) 
+        item_count = (size_t)(end - begin) / item_size;
+
+        /* finish with insertion sort */
+        if(item_count < ESORT_INSERTION_THRESHOLD)
         {
-            err = elist_next(elist, low, &low);
-            if(err != ELIBC_SUCCESS) return err;
+            _einsertsort(begin, end, item_size, eless_func, swap_buffer);
+            return;
         }
 
-        /* find high swap point */
-        while(low != high && eless_func(elist_item(elist, pivot), elist_item(elist, high)))
+        _esort_choose_pivot(begin, end, item_size, eless_func);
+
+        /* pivot equal to preceding item, all equal items go left and are done */
+        if(!leftmost && !eless_func(begin - item_size, begin))
         {
-            err = elist_previous(elist, high, &high);
-            if(err != ELIBC_SUCCESS) return err;
+            begin = _esort_partition_left(begin, end, item_size, eless_func) + item_size;
+            continue;
         }
 
-        /* swap if needed */
-        if(low != high)
-        {
-            err = elist_swap(elist, low, high);
-            if(err != ELIBC_SUCCESS) return err;
+        pivot = _esort_partition_right(begin, end, item_size, eless_func, &partitioned);
 
-            err = elist_next(elist, low, &low);
-            if(err != ELIBC_SUCCESS) return err;
+        left_count = (size_t)(pivot - begin) / item_size;
+        right_count = (size_t)(end - pivot) / item_size - 1;
 
-            if(low != high)
+        if(left_count < item_count / 8 || right_count < item_count / 8)
+        {
+            /* too many bad partitions, sort the rest in guaranteed time */
+            if(--bad_allowed == 0)
             {
-                err = elist_previous(elist, high, &high);
-                if(err != ELIBC_SUCCESS) return err;
+                _eheapsort(begin, end, item_size, eless_func);
+                return;
             }
-        }
-    }
 
-    /* check if we need to move intersection point */
-    if(eless_func(elist_item(elist, low), elist_item(elist, pivot)))
-    {
-        err = elist_next(elist, low, &low);
-        if(err != ELIBC_SUCCESS) return err;
-    }
-    
-    /* move pivot at intersection point */
-    err = elist_swap(elist, low, pivot);
-    if(err != ELIBC_SUCCESS) return err;
+            /* break patterns */
+            if(left_count >= ESORT_INSERTION_THRESHOLD)
+            {
+                _eswap_items(begin, begin + (left_count / 4) * item_size, item_size);
+                _eswap_items(pivot - item_size, pivot - (left_count / 4) * item_size, item_size);
+            }
 
-    /* move high to next */
-    err = elist_next(elist, high, &high);
-    if(err != ELIBC_SUCCESS) return err;
+            if(right_count >= ESORT_INSERTION_THRESHOLD)
+            {
+                _eswap_items(pivot + item_size, pivot + (1 + right_count / 4) * item_size, item_size);
+                _eswap_items(end - item_size, end - (right_count / 4) * item_size, item_size);
+            }
 
-    /* sort left part */
-    err = _esort_list_iteration(elist, start_pos, low, eless_func);
-    if(err != ELIBC_SUCCESS) return err;
+        } else if(partitioned &&
+                  _epartial_insertsort(begin, pivot, item_size, eless_func, swap_buffer) &&
+                  _epartial_insertsort(pivot + item_size, end, item_size, eless_func, swap_buffer))
+        {
+            /* range was almost sorted */
+            return;
+        }
 
-    /* sort right part */
-    err = _esort_list_iteration(elist, high, end_pos, eless_func);
-    if(err != ELIBC_SUCCESS) return err;
+        /* sort left part, continue with right one */
+        _esort_iteration(begin, pivot, item_size, eless_func, swap_buffer, bad_allowed, leftmost);
 
-    return err;
+        begin = pivot + item_size;
+        leftmost = ELIBC_FALSE;
+    }
 }
 
-int esort_list(elist_t* elist, eless_func_t eless_func)
+int esort(char* items, size_t item_size, size_t item_count, eless_func_t eless_func, char* swap_buffer)
 {
-    eliter_t list_head, list_tail;
-    int err;
+    char* temp_buffer=0;
 
     /* check input */
-    EASSERT(elist);
+    EASSERT(items);
+    EASSERT(item_size);
     EASSERT(eless_func);
-    if(elist == 0 || eless_func == 0) return ELIBC_ERROR_ARGUMENT;
+    if(items == 0 || item_size == 0 || eless_func == 0) return ELIBC_ERROR_ARGUMENT;
 
     /* ignore if there is one or zero items */
-    if(elist_size(elist) <= 1) return ELIBC_SUCCESS;
+    if(item_count <= 1) return ELIBC_SUCCESS;
 
-    /* list head */
-    err = elist_head(elist, &list_head);
-    if(err != ELIBC_SUCCESS) return err;
+    /* alloc swap buffer if not provided */
+    if(swap_buffer == 0)
+    {
+        temp_buffer = (char*)emalloc(item_size);
+        if(temp_buffer == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
 
-    /* list tail */
-    err = elist_tail(elist, &list_tail);
-    if(err != ELIBC_SUCCESS) return err;
+        /* set reference */
+        swap_buffer = temp_buffer;
+    }
 
     /* sort */
-    err = _esort_list_iteration(elist, list_head, list_tail, eless_func);
+    _esort_iteration(items, items + item_count * item_size, item_size, eless_func, swap_buffer, _esort_bad_partitions(item_count), ELIBC_TRUE);
 
-    EASSERT(err == ELIBC_SUCCESS);
-    return err;
+    /* release swap buffer if any */
+    if(temp_buffer)
+    {
+        efree(temp_buffer);
+        temp_buffer = 0;
+    }
+
+    return ELIBC_SUCCESS;
 }
 
+/*----------------------------------------------------------------------*/
+/* typed array sorts */
 /*----------------------------------------------------------------------*/
 
+#define ESORT_TYPED_NAME            esort_int
+#define ESORT_TYPED_TYPE            int
+#define ESORT_TYPED_LESS(l, r)      ((l) < (r))
+#include "esort_typed.h"
+
+#define ESORT_TYPED_NAME            esort_uint32
+#define ESORT_TYPED_TYPE            euint32_t
+#define ESORT_TYPED_LESS(l, r)      ((l) < (r))
+#include "esort_typed.h"
+
+#define ESORT_TYPED_NAME            esort_int64
+#define ESORT_TYPED_TYPE            eint64_t
+#define ESORT_TYPED_LESS(l, r)      ((l) < (r))
+#include "esort_typed.h"
+
+#define ESORT_TYPED_NAME            esort_uint64
+#define ESORT_TYPED_TYPE            euint64_t
+#define ESORT_TYPED_LESS(l, r)      ((l) < (r))
+#include "esort_typed.h"
+
+#define ESORT_TYPED_NAME            esort_double
+#define ESORT_TYPED_TYPE            double
+#define ESORT_TYPED_LESS(l, r)      ((l) < (r))
+#include "esort_typed.h"
+
+#define ESORT_TYPED_NAME            esort_ptr
+#define ESORT_TYPED_TYPE            void*
+#define ESORT_TYPED_LESS(l, r)      ((const char*)(l) < (const char*)(r))
+#include "esort_typed.h"
+
+#define ESORT_TYPED_NAME            esort_str
+#define ESORT_TYPED_TYPE            char*
+#define ESORT_TYPED_LESS(l, r)      (estrcmp((l), (r)) < 0)
+#include "esort_typed.h"
+
+/*----------------------------------------------------------------------*/
+/* sort list */
+/*----------------------------------------------------------------------*/
+int esort_list(elist_t* elist, eless_func_t eless_func)
+{
+    /* check input */
+    EASSERT(elist);
+    EASSERT(eless_func);
+    if(elist == 0 || eless_func == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* stable merge sort, nodes are relinked without copying items */
+    return elist_sort(elist, eless_func);
+}
+
+/*----------------------------------------------------------------------*/
@@ -5,15 +5,52 @@
 #ifndef _ESORT_H_
 #define _ESORT_H_
 
+/*
+    Arrays are sorted with pattern defeating introsort: median of three
+    (pseudo median of nine for large ranges) pivot, insertion sort for short
+    ranges and already sorted parts, heapsort after too many unbalanced
+    partitions. Worst case is O(n log n), sort is not stable.
+*/
+
+/*----------------------------------------------------------------------*/
+
+/* tuning constants (shared with esort_typed.h) */
+#define ESORT_INSERTION_THRESHOLD           24
+#define ESORT_NINTHER_THRESHOLD             128
+#define ESORT_PARTIAL_INSERTION_LIMIT       8
+
 /*----------------------------------------------------------------------*/
 
 /* generic array sort */
 int esort(char* items, size_t item_size, size_t item_count, eless_func_t eless_func, char* swap_buffer);
 
+/* typed array sorts (no comparison function calls) */
+int esort_int(int* items, size_t item_count);
+int esort_uint32(euint32_t* items, size_t item_count);
+int esort_int64(eint64_t* items, size_t item_count);
+int esort_uint64(euint64_t* items, size_t item_count);
+int esort_double(double* items, size_t item_count);
+int esort_ptr(void** items, size_t item_count);
+int esort_str(char** items, size_t item_count);
+
+/*
+    NOTE: radix sorts are stable and order keys as unsigned integers. Temporary
+          buffer must hold item_count items, it is allocated if zero.
+*/
+
+/* radix sorts */
+int esort_radix32(euint32_t* items, size_t item_count, euint32_t* temp_buffer);
+int esort_radix64(euint64_t* items, size_t item_count, euint64_t* temp_buffer);
+
+/* radix sort for records with 32 or 64 bits key (key_size) at key_offset */
+int esort_radix_records(char* items, size_t item_size, size_t item_count, size_t key_offset, size_t key_size, char* temp_buffer);
+
+/* parallel sort for large arrays (thread_count zero uses all cpus) */
+int esort_parallel(char* items, size_t item_size, size_t item_count, eless_func_t eless_func, unsigned int thread_count);
+
 /* sort list */
 int esort_list(elist_t* elist, eless_func_t eless_func);
 
 /*----------------------------------------------------------------------*/
 
 #endif /* _ESORT_H_ */
-
@@ -0,0 +1,244 @@
+/*
+    Parallel sort implementation
+*/
+
+#include "../elibc_config.h"
+#include "../stdlib/estdlib.h"
+
+#include "ecore_types.h"
+#include "eassert.h"
+#include "etrace.h"
+#include "eerror.h"
+#include "elist.h"
+#include "esystem.h"
+#include "ethread.h"
+#include "esort.h"
+
+/*----------------------------------------------------------------------*/
+
+/*
+    NOTE: array is split in one part per thread, parts are sorted with esort
+          in parallel and then merged pairwise in parallel rounds between
+          input and temporary buffer.
+*/
+
+/*----------------------------------------------------------------------*/
+/* constants */
+/*----------------------------------------------------------------------*/
+
+/* smallest part sorted by one thread */
+#define ESORT_PARALLEL_MIN_ITEMS            16384
+
+/*----------------------------------------------------------------------*/
+/* types */
+/*----------------------------------------------------------------------*/
+
+/* sort or merge task */
+typedef struct
+{
+    char*           src;
+    char*           dst;
+    size_t          item_size;
+    eless_func_t    eless_func;
+
+    /* items range, merged parts are [begin, middle) and [middle, end) */
+    size_t          begin;
+    size_t          middle;
+    size_t          end;
+
+    int             result;
+
+} esort_parallel_task_t;
+
+/*----------------------------------------------------------------------*/
+/* helper functions */
+/*----------------------------------------------------------------------*/
+ELIBC_FORCE_INLINE void _esort_parallel_copy(char* dst, const char* src, size_t item_size)
+{
+    /* common item sizes are copied with fixed size moves */
+    switch(item_size)
+    {
+    case 4:  ememcpy(dst, src, 4); break;
+    case 8:  ememcpy(dst, src, 8); break;
+    case 16: ememcpy(dst, src, 16); break;
+    default: ememcpy(dst, src, item_size); break;
+    }
+}
+
+void _esort_parallel_sort_task(void* arg)
+{
+    esort_parallel_task_t* task = (esort_parallel_task_t*)arg;
+
+    task->result = esort(task->src + task->begin * task->item_size, task->item_size,
+                         task->end - task->begin, task->eless_func, 0);
+}
+
+void _esort_parallel_merge_task(void* arg)
+{
+    esort_parallel_task_t* task = (esort_parallel_task_t*)arg;
+    size_t item_size = task->item_size;
+    char* left = task->src + task->begin * item_size;
+    char* left_end = task->src + task->middle * item_size;
+    char* right = left_end;
+    char* right_end = task->src + task->end * item_size;
+    char* dst = task->dst + task->begin * item_size;
+
+    /* take left item unless right one is less */
+    while(left < left_end && right < right_end)
+    {
+        if(task->eless_func(right, left))
+        {
+            _esort_parallel_copy(dst, right, item_size);
+            right += item_size;
+
+        } else
+        {
+            _esort_parallel_copy(dst, left, item_size);
+            left += item_size;
+        }
+
+        dst += item_size;
+    }
+
+    /* copy the rest */
+    if(left < left_end) ememcpy(dst, left, (size_t)(left_end - left));
+    if(right < right_end) ememcpy(dst, right, (size_t)(right_end - right));
+
+    task->result = ELIBC_SUCCESS;
+}
+
+void _esort_parallel_run(esort_parallel_task_t* tasks, ethread_t* threads, size_t task_count, ethread_func_t task_func)
+{
+    size_t idx;
+
+    /* start threads for all tasks except the first one */
+    for(idx = 1; idx < task_count; ++idx)
+    {
+        if(ethread_create(threads + idx, task_func, tasks + idx) != ELIBC_SUCCESS)
+        {
+            /* run in calling thread if thread can't be started */
+            threads[idx] = 0;
+            task_func(tasks + idx);
+        }
+    }
+
+    /* first task in calling thread */
+    task_func(tasks);
+
+    /* wait for all */
+    for(idx = 1; idx < task_count; ++idx)
+    {
+        if(threads[idx]) ethread_join(threads[idx]);
+    }
+}
+
+/*----------------------------------------------------------------------*/
+/* parallel sort */
+/*----------------------------------------------------------------------*/
+int esort_parallel(char* items, size_t item_size, size_t item_count, eless_func_t eless_func, unsigned int thread_count)
+{
+    esort_parallel_task_t* tasks = 0;
+    ethread_t* threads = 0;
+    char* temp_buffer = 0;
+    char* src;
+    char* dst;
+    size_t* bounds = 0;
+    size_t part_count, task_count, idx;
+    int err = ELIBC_SUCCESS;
+
+    /* check input */
+    EASSERT(items);
+    EASSERT(item_size);
+    EASSERT(eless_func);
+    if(items == 0 || item_size == 0 || eless_func == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* number of parts */
+    part_count = (thread_count > 0) ? thread_count : esystem_cpu_count();
+    if(part_count > item_count / ESORT_PARALLEL_MIN_ITEMS) part_count = item_count / ESORT_PARALLEL_MIN_ITEMS;
+
+    /* not worth starting threads */
+    if(part_count <= 1) return esort(items, item_size, item_count, eless_func, 0);
+
+    /* reserve memory */
+    tasks = (esort_parallel_task_t*)emalloc(part_count * sizeof(esort_parallel_task_t));
+    threads = (ethread_t*)emalloc(part_count * sizeof(ethread_t));
+    bounds = (size_t*)emalloc((part_count + 1) * sizeof(size_t));
+    temp_buffer = (char*)emalloc(item_count * item_size);
+
+    if(tasks == 0 || threads == 0 || bounds == 0 || temp_buffer == 0)
+    {
+        err = ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    } else
+    {
+        /* split in equal parts */
+        for(idx = 0; idx <= part_count; ++idx)
+        {
+            bounds[idx] = (item_count / part_count) * idx + (item_count % part_count) * idx / part_count;
+        }
+
+        /* sort parts */
+        for(idx = 0; idx < part_count; ++idx)
+        {
+            tasks[idx].src = items;
+            tasks[idx].dst = 0;
+            tasks[idx].item_size = item_size;
+            tasks[idx].eless_func = eless_func;
+            tasks[idx].begin = bounds[idx];
+            tasks[idx].middle = bounds[idx + 1];
+            tasks[idx].end = bounds[idx + 1];
+        }
+
+        _esort_parallel_run(tasks, threads, part_count, _esort_parallel_sort_task);
+
+        for(idx = 0; idx < part_count && err == ELIBC_SUCCESS; ++idx)
+        {
+            err = tasks[idx].result;
+        }
+    }
+
+    /* merge neighbouring parts until one is left */
+    src = items;
+    dst = temp_buffer;
+    while(err == ELIBC_SUCCESS && part_count > 1)
+    {
+        task_count = (part_count + 1) / 2;
+
+        for(idx = 0; idx < task_count; ++idx)
+        {
+            tasks[idx].src = src;
+            tasks[idx].dst = dst;
+            tasks[idx].begin = bounds[2 * idx];
+            tasks[idx].middle = bounds[2 * idx + 1];
+
+            /* last odd part is just copied */
+            tasks[idx].end = (2 * idx + 2 <= part_count) ? bounds[2 * idx + 2] : bounds[2 * idx + 1];
+        }
+
+        _esort_parallel_run(tasks, threads, task_count, _esort_parallel_merge_task);
+
+        /* merged parts bounds */
+        for(idx = 0; idx < task_count; ++idx)
+        {
+            bounds[idx + 1] = tasks[idx].end;
+        }
+
+        part_count = task_count;
+
+        dst = src;
+        src = tasks[0].dst;
+    }
+
+    /* sorted items must end in input buffer */
+    if(err == ELIBC_SUCCESS && src != items) ememcpy(items, src, item_count * item_size);
+
+    /* release memory */
+    efree(tasks);
+    efree(threads);
+    efree(bounds);
+    efree(temp_buffer);
+
+    return err;
+}
+
+/*----------------------------------------------------------------------*/
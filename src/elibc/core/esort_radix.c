@@ -0,0 +1,286 @@
+/*
+    Radix sort implementation
+*/
+
+#include "../elibc_config.h"
+#include "../stdlib/estdlib.h"
+
+#include "ecore_types.h"
+#include "eassert.h"
+#include "etrace.h"
+#include "eerror.h"
+#include "elist.h"
+#include "esort.h"
+
+/*----------------------------------------------------------------------*/
+
+/*
+    NOTE: least significant digit first, one 8 bits digit per pass. Histograms
+          for all digits are counted in single pass over keys and passes where
+          all keys have the same digit are skipped. Items are moved between
+          input and temporary buffer and copied back if needed.
+*/
+
+/*----------------------------------------------------------------------*/
+/* constants */
+/*----------------------------------------------------------------------*/
+
+#define ESORT_RADIX_BUCKETS                 256
+#define ESORT_RADIX_MAX_KEY_SIZE            8
+
+/*----------------------------------------------------------------------*/
+/* helper functions */
+/*----------------------------------------------------------------------*/
+
+/* bucket offsets from counts, returns ELIBC_FALSE if pass can be skipped */
+int _esort_radix_offsets(size_t* histogram, size_t item_count)
+{
+    size_t idx, count, offset = 0;
+
+    for(idx = 0; idx < ESORT_RADIX_BUCKETS; ++idx)
+    {
+        /* all keys have the same digit */
+        count = histogram[idx];
+        if(count == item_count) return ELIBC_FALSE;
+
+        histogram[idx] = offset;
+        offset += count;
+    }
+
+    return ELIBC_TRUE;
+}
+
+ELIBC_FORCE_INLINE euint64_t _esort_radix_key(const char* item, size_t key_size)
+{
+    euint32_t key32;
+    euint64_t key64;
+
+    if(key_size == sizeof(euint32_t))
+    {
+        ememcpy(&key32, item, sizeof(euint32_t));
+        return key32;
+    }
+
+    ememcpy(&key64, item, sizeof(euint64_t));
+    return key64;
+}
+
+ELIBC_FORCE_INLINE void _esort_radix_copy(char* dst, const char* src, size_t item_size)
+{
+    /* common record sizes are copied with fixed size moves */
+    switch(item_size)
+    {
+    case 8:  ememcpy(dst, src, 8); break;
+    case 16: ememcpy(dst, src, 16); break;
+    case 24: ememcpy(dst, src, 24); break;
+    default: ememcpy(dst, src, item_size); break;
+    }
+}
+
+/*----------------------------------------------------------------------*/
+/* radix sorts */
+/*----------------------------------------------------------------------*/
+int esort_radix32(euint32_t* items, size_t item_count, euint32_t* temp_buffer)
+{
+    size_t histogram[sizeof(euint32_t)][ESORT_RADIX_BUCKETS];
+    euint32_t* temp_alloc = 0;
+    euint32_t* src;
+    euint32_t* dst;
+    euint32_t* swap;
+    euint32_t key;
+    size_t idx, pass, shift;
+
+    /* check input */
+    EASSERT(items || item_count == 0);
+    if(items == 0 && item_count > 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* ignore if there is one or zero items */
+    if(item_count <= 1) return ELIBC_SUCCESS;
+
+    /* alloc temp buffer if not provided */
+    if(temp_buffer == 0)
+    {
+        temp_alloc = (euint32_t*)emalloc(item_count * sizeof(euint32_t));
+        if(temp_alloc == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+        temp_buffer = temp_alloc;
+    }
+
+    /* count digits */
+    ememset(histogram, 0, sizeof(histogram));
+    for(idx = 0; idx < item_count; ++idx)
+    {
+        key = items[idx];
+
+        histogram[0][key & 0xFF]++;
+        histogram[1][(key >> 8) & 0xFF]++;
+        histogram[2][(key >> 16) & 0xFF]++;
+        histogram[3][key >> 24]++;
+    }
+
+    /* distribute */
+    src = items;
+    dst = temp_buffer;
+    for(pass = 0, shift = 0; pass < sizeof(euint32_t); ++pass, shift += 8)
+    {
+        if(!_esort_radix_offsets(histogram[pass], item_count)) continue;
+
+        for(idx = 0; idx < item_count; ++idx)
+        {
+            key = src[idx];
+            dst[histogram[pass][(key >> shift) & 0xFF]++] = key;
+        }
+
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    /* sorted items must end in input buffer */
+    if(src != items) ememcpy(items, src, item_count * sizeof(euint32_t));
+
+    /* release temp buffer if any */
+    if(temp_alloc) efree(temp_alloc);
+
+    return ELIBC_SUCCESS;
+}
+
+int esort_radix64(euint64_t* items, size_t item_count, euint64_t* temp_buffer)
+{
+    size_t histogram[sizeof(euint64_t)][ESORT_RADIX_BUCKETS];
+    euint64_t* temp_alloc = 0;
+    euint64_t* src;
+    euint64_t* dst;
+    euint64_t* swap;
+    euint64_t key;
+    size_t idx, pass, shift;
+
+    /* check input */
+    EASSERT(items || item_count == 0);
+    if(items == 0 && item_count > 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* ignore if there is one or zero items */
+    if(item_count <= 1) return ELIBC_SUCCESS;
+
+    /* alloc temp buffer if not provided */
+    if(temp_buffer == 0)
+    {
+        temp_alloc = (euint64_t*)emalloc(item_count * sizeof(euint64_t));
+        if(temp_alloc == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+        temp_buffer = temp_alloc;
+    }
+
+    /* count digits */
+    ememset(histogram, 0, sizeof(histogram));
+    for(idx = 0; idx < item_count; ++idx)
+    {
+        key = items[idx];
+
+        histogram[0][key & 0xFF]++;
+        histogram[1][(key >> 8) & 0xFF]++;
+        histogram[2][(key >> 16) & 0xFF]++;
+        histogram[3][(key >> 24) & 0xFF]++;
+        histogram[4][(key >> 32) & 0xFF]++;
+        histogram[5][(key >> 40) & 0xFF]++;
+        histogram[6][(key >> 48) & 0xFF]++;
+        histogram[7][key >> 56]++;
+    }
+
+    /* distribute */
+    src = items;
+    dst = temp_buffer;
+    for(pass = 0, shift = 0; pass < sizeof(euint64_t); ++pass, shift += 8)
+    {
+        if(!_esort_radix_offsets(histogram[pass], item_count)) continue;
+
+        for(idx = 0; idx < item_count; ++idx)
+        {
+            key = src[idx];
+            dst[histogram[pass][(key >> shift) & 0xFF]++] = key;
+        }
+
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    /* sorted items must end in input buffer */
+    if(src != items) ememcpy(items, src, item_count * sizeof(euint64_t));
+
+    /* release temp buffer if any */
+    if(temp_alloc) efree(temp_alloc);
+
+    return ELIBC_SUCCESS;
+}
+
+int esort_radix_records(char* items, size_t item_size, size_t item_count, size_t key_offset, size_t key_size, char* temp_buffer)
+{
+    size_t histogram[ESORT_RADIX_MAX_KEY_SIZE][ESORT_RADIX_BUCKETS];
+    char* temp_alloc = 0;
+    char* src;
+    char* dst;
+    char* swap;
+    euint64_t key;
+    size_t idx, pass, shift;
+
+    /* check input */
+    EASSERT(items || item_count == 0);
+    EASSERT(key_size == sizeof(euint32_t) || key_size == sizeof(euint64_t));
+    EASSERT(key_offset + key_size <= item_size);
+    if((items == 0 && item_count > 0) ||
+       (key_size != sizeof(euint32_t) && key_size != sizeof(euint64_t)) ||
+       key_offset + key_size > item_size) return ELIBC_ERROR_ARGUMENT;
+
+    /* ignore if there is one or zero items */
+    if(item_count <= 1) return ELIBC_SUCCESS;
+
+    /* alloc temp buffer if not provided */
+    if(temp_buffer == 0)
+    {
+        temp_alloc = (char*)emalloc(item_count * item_size);
+        if(temp_alloc == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+        temp_buffer = temp_alloc;
+    }
+
+    /* count digits */
+    ememset(histogram, 0, sizeof(histogram));
+    for(idx = 0; idx < item_count; ++idx)
+    {
+        key = _esort_radix_key(items + idx * item_size + key_offset, key_size);
+
+        for(pass = 0; pass < key_size; ++pass, key >>= 8)
+        {
+            histogram[pass][key & 0xFF]++;
+        }
+    }
+
+    /* distribute */
+    src = items;
+    dst = temp_buffer;
+    for(pass = 0, shift = 0; pass < key_size; ++pass, shift += 8)
+    {
+        if(!_esort_radix_offsets(histogram[pass], item_count)) continue;
+
+        for(idx = 0; idx < item_count; ++idx)
+        {
+            key = _esort_radix_key(src + idx * item_size + key_offset, key_size);
+            _esort_radix_copy(dst + (histogram[pass][(key >> shift) & 0xFF]++) * item_size, src + idx * item_size, item_size);
+        }
+
+        swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    /* sorted items must end in input buffer */
+    if(src != items) ememcpy(items, src, item_count * item_size);
+
+    /* release temp buffer if any */
+    if(temp_alloc) efree(temp_alloc);
+
+    return ELIBC_SUCCESS;
+}
+
+/*----------------------------------------------------------------------*/
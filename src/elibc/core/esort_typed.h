@@ -0,0 +1,300 @@
+/*
+    Type specialized sorting
+*/
+
+/*
+    Generates introsort for one item type, comparison is expanded in place
+    so there is no indirect call per comparison. Header may be included
+    several times, every time with its own parameters:
+
+        #define ESORT_TYPED_NAME            esort_point
+        #define ESORT_TYPED_TYPE            point_t
+        #define ESORT_TYPED_LESS(l, r)      ((l).x < (r).x)
+        #include "esort_typed.h"
+
+    defines int esort_point(point_t* items, size_t item_count). Parameters are
+    undefined at the end of this header. Algorithm is the same as in esort.
+*/
+
+#if !defined(ESORT_TYPED_NAME) || !defined(ESORT_TYPED_TYPE) || !defined(ESORT_TYPED_LESS)
+#error "ESORT_TYPED_NAME, ESORT_TYPED_TYPE and ESORT_TYPED_LESS must be defined"
+#endif
+
+/*----------------------------------------------------------------------*/
+
+/* helper names */
+#define _ESORT_TYPED_CONCAT2(name, suffix)      _##name##_##suffix
+#define _ESORT_TYPED_CONCAT(name, suffix)       _ESORT_TYPED_CONCAT2(name, suffix)
+#define _ESORT_TYPED_FUNC(suffix)               _ESORT_TYPED_CONCAT(ESORT_TYPED_NAME, suffix)
+
+#define _ESORT_TYPED_SWAP(left, right)  { ESORT_TYPED_TYPE _swap_item = *(left); *(left) = *(right); *(right) = _swap_item; }
+#define _ESORT_TYPED_SORT2(left, right) { if(ESORT_TYPED_LESS(*(right), *(left))) _ESORT_TYPED_SWAP(left, right); }
+
+/*----------------------------------------------------------------------*/
+
+static void _ESORT_TYPED_FUNC(insertsort)(ESORT_TYPED_TYPE* begin, ESORT_TYPED_TYPE* end)
+{
+    ESORT_TYPED_TYPE* pos;
+    ESORT_TYPED_TYPE* cur;
+    ESORT_TYPED_TYPE item;
+
+    for(pos = begin + 1; pos < end; ++pos)
+    {
+        /* skip if already in place */
+        if(!ESORT_TYPED_LESS(*pos, *(pos - 1))) continue;
+
+        /* shift greater items right */
+        item = *pos;
+        cur = pos;
+        do
+        {
+            *cur = *(cur - 1);
+            --cur;
+
+        } while(cur > begin && ESORT_TYPED_LESS(item, *(cur - 1)));
+
+        *cur = item;
+    }
+}
+
+static int _ESORT_TYPED_FUNC(partial_insertsort)(ESORT_TYPED_TYPE* begin, ESORT_TYPED_TYPE* end)
+{
+    ESORT_TYPED_TYPE* pos;
+    ESORT_TYPED_TYPE* cur;
+    ESORT_TYPED_TYPE item;
+    size_t moves = 0;
+
+    for(pos = begin + 1; pos < end; ++pos)
+    {
+        /* skip if already in place */
+        if(!ESORT_TYPED_LESS(*pos, *(pos - 1))) continue;
+
+        /* shift greater items right */
+        item = *pos;
+        cur = pos;
+        do
+        {
+            *cur = *(cur - 1);
+            --cur;
+
+        } while(cur > begin && ESORT_TYPED_LESS(item, *(cur - 1)));
+
+        *cur = item;
+
+        /* give up if range is not almost sorted */
+        moves += (size_t)(pos - cur);
+        if(moves > ESORT_PARTIAL_INSERTION_LIMIT) return ELIBC_FALSE;
+    }
+
+    return ELIBC_TRUE;
+}
+
+static void _ESORT_TYPED_FUNC(heapsort)(ESORT_TYPED_TYPE* begin, ESORT_TYPED_TYPE* end)
+{
+    size_t item_count = (size_t)(end - begin);
+    size_t start, root, child;
+
+    /* build heap and move maximum to the end one by one */
+    for(start = item_count / 2; item_count > 1; )
+    {
+        if(start > 0)
+        {
+            --start;
+
+        } else
+        {
+            --item_count;
+            _ESORT_TYPED_SWAP(begin, begin + item_count);
+        }
+
+        /* sift down */
+        for(root = start; (child = 2 * root + 1) < item_count; root = child)
+        {
+            if(child + 1 < item_count && ESORT_TYPED_LESS(begin[child], begin[child + 1])) ++child;
+            if(!ESORT_TYPED_LESS(begin[root], begin[child])) break;
+
+            _ESORT_TYPED_SWAP(begin + root, begin + child);
+        }
+    }
+}
+
+static void _ESORT_TYPED_FUNC(choose_pivot)(ESORT_TYPED_TYPE* begin, ESORT_TYPED_TYPE* end)
+{
+    size_t item_count = (size_t)(end - begin);
+    ESORT_TYPED_TYPE* mid = begin + item_count / 2;
+
+    if(item_count > ESORT_NINTHER_THRESHOLD)
+    {
+        /* pseudo median of nine */
+        _ESORT_TYPED_SORT2(begin, mid); _ESORT_TYPED_SORT2(mid, end - 1); _ESORT_TYPED_SORT2(begin, mid);
+        _ESORT_TYPED_SORT2(begin + 1, mid - 1); _ESORT_TYPED_SORT2(mid - 1, end - 2); _ESORT_TYPED_SORT2(begin + 1, mid - 1);
+        _ESORT_TYPED_SORT2(begin + 2, mid + 1); _ESORT_TYPED_SORT2(mid + 1, end - 3); _ESORT_TYPED_SORT2(begin + 2, mid + 1);
+        _ESORT_TYPED_SORT2(mid - 1, mid); _ESORT_TYPED_SORT2(mid, mid + 1); _ESORT_TYPED_SORT2(mid - 1, mid);
+        _ESORT_TYPED_SWAP(begin, mid);
+
+    } else
+    {
+        /* median of three moved to the beginning */
+        _ESORT_TYPED_SORT2(mid, begin); _ESORT_TYPED_SORT2(begin, end - 1); _ESORT_TYPED_SORT2(mid, begin);
+    }
+}
+
+static ESORT_TYPED_TYPE* _ESORT_TYPED_FUNC(partition_right)(ESORT_TYPED_TYPE* begin, ESORT_TYPED_TYPE* end, int* partitioned)
+{
+    ESORT_TYPED_TYPE* low = begin + 1;
+    ESORT_TYPED_TYPE* high = end;
+
+    /* items less than pivot go left, pivot stays at the beginning */
+    while(low < high && ESORT_TYPED_LESS(*low, *begin)) ++low;
+    while(low < high && !ESORT_TYPED_LESS(*(high - 1), *begin)) --high;
+
+    *partitioned = (low >= high) ? ELIBC_TRUE : ELIBC_FALSE;
+
+    while(low < high)
+    {
+        _ESORT_TYPED_SWAP(low, high - 1);
+        ++low;
+        --high;
+
+        while(low < high && ESORT_TYPED_LESS(*low, *begin)) ++low;
+        while(low < high && !ESORT_TYPED_LESS(*(high - 1), *begin)) --high;
+    }
+
+    /* move pivot between parts */
+    --low;
+    _ESORT_TYPED_SWAP(begin, low);
+
+    return low;
+}
+
+static ESORT_TYPED_TYPE* _ESORT_TYPED_FUNC(partition_left)(ESORT_TYPED_TYPE* begin, ESORT_TYPED_TYPE* end)
+{
+    ESORT_TYPED_TYPE* low = begin + 1;
+    ESORT_TYPED_TYPE* high = end;
+
+    /* items not greater than pivot go left */
+    while(low < high && !ESORT_TYPED_LESS(*begin, *low)) ++low;
+    while(low < high && ESORT_TYPED_LESS(*begin, *(high - 1))) --high;
+
+    while(low < high)
+    {
+        _ESORT_TYPED_SWAP(low, high - 1);
+        ++low;
+        --high;
+
+        while(low < high && !ESORT_TYPED_LESS(*begin, *low)) ++low;
+        while(low < high && ESORT_TYPED_LESS(*begin, *(high - 1))) --high;
+    }
+
+    /* move pivot between parts */
+    --low;
+    _ESORT_TYPED_SWAP(begin, low);
+
+    return low;
+}
+
+static void _ESORT_TYPED_FUNC(iteration)(ESORT_TYPED_TYPE* begin, ESORT_TYPED_TYPE* end, int bad_allowed, int leftmost)
+{
+    ESORT_TYPED_TYPE* pivot;
+    size_t item_count, left_count, right_count;
+    int partitioned;
+
+    for(;;)
+    {
+        item_count = (size_t)(end - begin);
+
+        /* finish with insertion sort */
+        if(item_count < ESORT_INSERTION_THRESHOLD)
+        {
+            _ESORT_TYPED_FUNC(insertsort)(begin, end);
+            return;
+        }
+
+        _ESORT_TYPED_FUNC(choose_pivot)(begin, end);
+
+        /* pivot equal to preceding item, all equal items go left and are done */
+        if(!leftmost && !ESORT_TYPED_LESS(*(begin - 1), *begin))
+        {
+            begin = _ESORT_TYPED_FUNC(partition_left)(begin, end) + 1;
+            continue;
+        }
+
+        pivot = _ESORT_TYPED_FUNC(partition_right)(begin, end, &partitioned);
+
+        left_count = (size_t)(pivot - begin);
+        right_count = (size_t)(end - pivot - 1);
+
+        if(left_count < item_count / 8 || right_count < item_count / 8)
+        {
+            /* too many bad partitions, sort the rest in guaranteed time */
+            if(--bad_allowed == 0)
+            {
+                _ESORT_TYPED_FUNC(heapsort)(begin, end);
+                return;
+            }
+
+            /* break patterns */
+            if(left_count >= ESORT_INSERTION_THRESHOLD)
+            {
+                _ESORT_TYPED_SWAP(begin, begin + left_count / 4);
+                _ESORT_TYPED_SWAP(pivot - 1, pivot - left_count / 4);
+            }
+
+            if(right_count >= ESORT_INSERTION_THRESHOLD)
+            {
+                _ESORT_TYPED_SWAP(pivot + 1, pivot + 1 + right_count / 4);
+                _ESORT_TYPED_SWAP(end - 1, end - right_count / 4);
+            }
+
+        } else if(partitioned &&
+                  _ESORT_TYPED_FUNC(partial_insertsort)(begin, pivot) &&
+                  _ESORT_TYPED_FUNC(partial_insertsort)(pivot + 1, end))
+        {
+            /* range was almost sorted */
+            return;
+        }
+
+        /* sort left part, continue with right one */
+        _ESORT_TYPED_FUNC(iteration)(begin, pivot, bad_allowed, leftmost);
+
+        begin = pivot + 1;
+        leftmost = ELIBC_FALSE;
+    }
+}
+
+/*----------------------------------------------------------------------*/
+
+int ESORT_TYPED_NAME(ESORT_TYPED_TYPE* items, size_t item_count)
+{
+    size_t count;
+    int bad_allowed = 0;
+
+    /* check input */
+    EASSERT(items || item_count == 0);
+    if(items == 0 && item_count > 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* ignore if there is one or zero items */
+    if(item_count <= 1) return ELIBC_SUCCESS;
+
+    /* unbalanced partitions allowed before heapsort (log2 of item count) */
+    for(count = item_count; count > 1; count >>= 1) ++bad_allowed;
+
+    /* sort */
+    _ESORT_TYPED_FUNC(iteration)(items, items + item_count, bad_allowed, ELIBC_TRUE);
+
+    return ELIBC_SUCCESS;
+}
+
+/*----------------------------------------------------------------------*/
+
+#undef _ESORT_TYPED_SORT2
+#undef _ESORT_TYPED_SWAP
+#undef _ESORT_TYPED_FUNC
+#undef _ESORT_TYPED_CONCAT
+#undef _ESORT_TYPED_CONCAT2
+
+#undef ESORT_TYPED_LESS
+#undef ESORT_TYPED_TYPE
+#undef ESORT_TYPED_NAME
+
+/*----------------------------------------------------------------------*/
@@ -14,6 +14,7 @@ typedef earray_t   estack_t;
 
 /* init and close */
 #define estack_init                     earray_init
+#define estack_init_inline              earray_init_inline
 #define estack_reset                    earray_reset
 #define estack_free                     earray_free
 #define estack_reserve                  earray_reserve
@@ -24,6 +25,7 @@ typedef earray_t   estack_t;
 #define estack_at                       earray_at
 #define estack_size                     earray_size
 #define estack_item_size                earray_item_size
+#define estack_is_inline                earray_is_inline
 
 /* stack manipulations */
 #define estack_push(estack, value)      earray_append((estack), &value)
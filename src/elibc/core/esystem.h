@@ -10,6 +10,29 @@
 /* sleep (in milliseconds) */
 void esleep(int sleep_ms);
 
+/* number of logical cpus (at least one) */
+unsigned int esystem_cpu_count();
+
+/*----------------------------------------------------------------------*/
+
+/* cpu features */
+#define ESYSTEM_CPU_SSSE3               0x0001
+#define ESYSTEM_CPU_SSE41               0x0002
+#define ESYSTEM_CPU_AVX2                0x0004
+#define ESYSTEM_CPU_SHA                 0x0008
+#define ESYSTEM_CPU_SSE2                0x0010
+#define ESYSTEM_CPU_AVX512              0x0020      /* AVX-512 foundation */
+#define ESYSTEM_CPU_SSE42               0x0040
+#define ESYSTEM_CPU_PCLMUL              0x0080
+
+/*
+    NOTE: features are reported only if they are supported by both cpu and os
+          (e.g. avx state saving), zero is returned on non x86 platforms
+*/
+
+/* detect cpu features */
+unsigned int esystem_cpu_features();
+
 /*----------------------------------------------------------------------*/
 
 #endif /* _ESYSTEM_H_ */
@@ -5,6 +5,11 @@
 #include <unistd.h>
 
 #include "../elibc_config.h"
+
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+#include <cpuid.h>
+#endif
+
 #include "../stdlib/estdlib.h"
 
 #include "esystem.h"
@@ -18,4 +23,57 @@ void esleep(int sleep_ms)
     usleep(sleep_ms * 1000);   
 }
 
+/* number of logical cpus (at least one) */
+unsigned int esystem_cpu_count()
+{
+    long cpu_count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (cpu_count > 0) ? (unsigned int)cpu_count : 1;
+}
+
+/*----------------------------------------------------------------------*/
+
+/* detect cpu features */
+unsigned int esystem_cpu_features()
+{
+    unsigned int features = 0;
+
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+    unsigned int eax, ebx, ecx, edx;
+    unsigned int max_leaf, xcr0 = 0;
+
+    /* basic features */
+    max_leaf = __get_cpuid_max(0, 0);
+    if(max_leaf < 1) return 0;
+
+    __cpuid(1, eax, ebx, ecx, edx);
+
+    if(edx & bit_SSE2) features |= ESYSTEM_CPU_SSE2;
+    if(ecx & bit_SSSE3) features |= ESYSTEM_CPU_SSSE3;
+    if(ecx & bit_SSE4_1) features |= ESYSTEM_CPU_SSE41;
+    if(ecx & bit_SSE4_2) features |= ESYSTEM_CPU_SSE42;
+    if(ecx & bit_PCLMUL) features |= ESYSTEM_CPU_PCLMUL;
+
+    /* check that os saves avx registers */
+    if((ecx & bit_OSXSAVE) && (ecx & bit_AVX))
+    {
+        __asm__ __volatile__("xgetbv" : "=a"(xcr0), "=d"(edx) : "c"(0));
+    }
+
+    /* extended features */
+    if(max_leaf >= 7)
+    {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+
+        if((ebx & bit_AVX2) && (xcr0 & 0x06) == 0x06) features |= ESYSTEM_CPU_AVX2;
+        if(ebx & bit_SHA) features |= ESYSTEM_CPU_SHA;
+
+        /* avx-512 also needs opmask and zmm state saving */
+        if((ebx & bit_AVX512F) && (xcr0 & 0xE6) == 0xE6) features |= ESYSTEM_CPU_AVX512;
+    }
+#endif /* _ELIBC_ARCH_X86 */
+
+    return features;
+}
+
 /*----------------------------------------------------------------------*/
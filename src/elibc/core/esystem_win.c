@@ -3,6 +3,7 @@
 */
 
 #include <windows.h>
+#include <intrin.h>
 
 #include "../elibc_config.h"
 #include "../stdlib/estdlib.h"
@@ -17,4 +18,61 @@ void esleep(int sleep_ms)
     Sleep(sleep_ms);
 }
 
+/* number of logical cpus (at least one) */
+unsigned int esystem_cpu_count()
+{
+    SYSTEM_INFO system_info;
+
+    GetSystemInfo(&system_info);
+
+    return (system_info.dwNumberOfProcessors > 0) ? (unsigned int)system_info.dwNumberOfProcessors : 1;
+}
+
+/*----------------------------------------------------------------------*/
+
+/* detect cpu features */
+unsigned int esystem_cpu_features()
+{
+    unsigned int features = 0;
+
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+    int regs[4];
+    int max_leaf;
+    unsigned __int64 xcr0 = 0;
+
+    /* basic features */
+    __cpuid(regs, 0);
+    max_leaf = regs[0];
+    if(max_leaf < 1) return 0;
+
+    __cpuid(regs, 1);
+
+    if(regs[3] & (1 << 26)) features |= ESYSTEM_CPU_SSE2;
+    if(regs[2] & (1 << 9)) features |= ESYSTEM_CPU_SSSE3;
+    if(regs[2] & (1 << 19)) features |= ESYSTEM_CPU_SSE41;
+    if(regs[2] & (1 << 20)) features |= ESYSTEM_CPU_SSE42;
+    if(regs[2] & (1 << 1)) features |= ESYSTEM_CPU_PCLMUL;
+
+    /* check that os saves avx registers (osxsave and avx bits) */
+    if((regs[2] & (1 << 27)) && (regs[2] & (1 << 28)))
+    {
+        xcr0 = _xgetbv(0);
+    }
+
+    /* extended features */
+    if(max_leaf >= 7)
+    {
+        __cpuidex(regs, 7, 0);
+
+        if((regs[1] & (1 << 5)) && (xcr0 & 0x06) == 0x06) features |= ESYSTEM_CPU_AVX2;
+        if(regs[1] & (1 << 29)) features |= ESYSTEM_CPU_SHA;
+
+        /* avx-512 also needs opmask and zmm state saving */
+        if((regs[1] & (1 << 16)) && (xcr0 & 0xE6) == 0xE6) features |= ESYSTEM_CPU_AVX512;
+    }
+#endif /* _ELIBC_ARCH_X86 */
+
+    return features;
+}
+
 /*----------------------------------------------------------------------*/
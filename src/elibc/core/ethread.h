@@ -0,0 +1,48 @@
+/*
+    Threads
+*/
+
+#ifndef _ETHREAD_H_
+#define _ETHREAD_H_
+
+/*----------------------------------------------------------------------*/
+
+/* thread handle */
+typedef void*   ethread_t;
+
+/* thread function (argument) */
+typedef void (*ethread_func_t)(void*);
+
+/*----------------------------------------------------------------------*/
+
+/* start thread */
+int ethread_create(ethread_t* ethread, ethread_func_t ethread_func, void* arg);
+
+/* wait for thread to finish and release handle */
+int ethread_join(ethread_t ethread);
+
+/* give up the rest of time slice */
+void ethread_yield();
+
+/*----------------------------------------------------------------------*/
+
+/* mutex and condition variable handles */
+typedef void*   emutex_t;
+typedef void*   econd_t;
+
+/* mutex */
+int emutex_create(emutex_t* emutex);
+void emutex_destroy(emutex_t emutex);
+void emutex_lock(emutex_t emutex);
+void emutex_unlock(emutex_t emutex);
+
+/* condition variable (wait must be called with mutex locked) */
+int econd_create(econd_t* econd);
+void econd_destroy(econd_t econd);
+void econd_wait(econd_t econd, emutex_t emutex);
+void econd_signal(econd_t econd);
+void econd_broadcast(econd_t econd);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _ETHREAD_H_ */
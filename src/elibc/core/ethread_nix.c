@@ -0,0 +1,191 @@
+/*
+    Threads
+*/
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "../elibc_config.h"
+#include "../stdlib/estdlib.h"
+
+#include "eassert.h"
+#include "etrace.h"
+#include "eerror.h"
+#include "ethread.h"
+
+/*----------------------------------------------------------------------*/
+
+/* thread data */
+typedef struct
+{
+    pthread_t       thread;
+    ethread_func_t  ethread_func;
+    void*           arg;
+
+} ethread_data_t;
+
+/*----------------------------------------------------------------------*/
+
+void* _ethread_start(void* arg)
+{
+    ethread_data_t* ethread_data = (ethread_data_t*)arg;
+
+    ethread_data->ethread_func(ethread_data->arg);
+
+    return 0;
+}
+
+/*----------------------------------------------------------------------*/
+
+/* start thread */
+int ethread_create(ethread_t* ethread, ethread_func_t ethread_func, void* arg)
+{
+    ethread_data_t* ethread_data;
+
+    EASSERT(ethread);
+    EASSERT(ethread_func);
+    if(ethread == 0 || ethread_func == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* reset output */
+    *ethread = 0;
+
+    ethread_data = (ethread_data_t*)emalloc(sizeof(ethread_data_t));
+    if(ethread_data == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    ethread_data->ethread_func = ethread_func;
+    ethread_data->arg = arg;
+
+    /* start */
+    if(pthread_create(&ethread_data->thread, 0, _ethread_start, ethread_data) != 0)
+    {
+        ETRACE("ethread: failed to create thread");
+        efree(ethread_data);
+        return ELIBC_ERROR_INTERNAL;
+    }
+
+    *ethread = ethread_data;
+
+    return ELIBC_SUCCESS;
+}
+
+/* wait for thread to finish and release handle */
+int ethread_join(ethread_t ethread)
+{
+    ethread_data_t* ethread_data = (ethread_data_t*)ethread;
+    int err;
+
+    EASSERT(ethread);
+    if(ethread == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* wait */
+    err = pthread_join(ethread_data->thread, 0);
+
+    efree(ethread_data);
+
+    return (err == 0) ? ELIBC_SUCCESS : ELIBC_ERROR_INTERNAL;
+}
+
+/* give up the rest of time slice */
+void ethread_yield()
+{
+    sched_yield();
+}
+
+/*----------------------------------------------------------------------*/
+/* mutex */
+/*----------------------------------------------------------------------*/
+int emutex_create(emutex_t* emutex)
+{
+    pthread_mutex_t* mutex;
+
+    EASSERT(emutex);
+    if(emutex == 0) return ELIBC_ERROR_ARGUMENT;
+
+    mutex = (pthread_mutex_t*)emalloc(sizeof(pthread_mutex_t));
+    if(mutex == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    if(pthread_mutex_init(mutex, 0) != 0)
+    {
+        efree(mutex);
+        return ELIBC_ERROR_INTERNAL;
+    }
+
+    *emutex = mutex;
+
+    return ELIBC_SUCCESS;
+}
+
+void emutex_destroy(emutex_t emutex)
+{
+    if(emutex)
+    {
+        pthread_mutex_destroy((pthread_mutex_t*)emutex);
+        efree(emutex);
+    }
+}
+
+void emutex_lock(emutex_t emutex)
+{
+    EASSERT(emutex);
+    pthread_mutex_lock((pthread_mutex_t*)emutex);
+}
+
+void emutex_unlock(emutex_t emutex)
+{
+    EASSERT(emutex);
+    pthread_mutex_unlock((pthread_mutex_t*)emutex);
+}
+
+/*----------------------------------------------------------------------*/
+/* condition variable */
+/*----------------------------------------------------------------------*/
+int econd_create(econd_t* econd)
+{
+    pthread_cond_t* cond;
+
+    EASSERT(econd);
+    if(econd == 0) return ELIBC_ERROR_ARGUMENT;
+
+    cond = (pthread_cond_t*)emalloc(sizeof(pthread_cond_t));
+    if(cond == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    if(pthread_cond_init(cond, 0) != 0)
+    {
+        efree(cond);
+        return ELIBC_ERROR_INTERNAL;
+    }
+
+    *econd = cond;
+
+    return ELIBC_SUCCESS;
+}
+
+void econd_destroy(econd_t econd)
+{
+    if(econd)
+    {
+        pthread_cond_destroy((pthread_cond_t*)econd);
+        efree(econd);
+    }
+}
+
+void econd_wait(econd_t econd, emutex_t emutex)
+{
+    EASSERT(econd);
+    EASSERT(emutex);
+    pthread_cond_wait((pthread_cond_t*)econd, (pthread_mutex_t*)emutex);
+}
+
+void econd_signal(econd_t econd)
+{
+    EASSERT(econd);
+    pthread_cond_signal((pthread_cond_t*)econd);
+}
+
+void econd_broadcast(econd_t econd)
+{
+    EASSERT(econd);
+    pthread_cond_broadcast((pthread_cond_t*)econd);
+}
+
+/*----------------------------------------------------------------------*/
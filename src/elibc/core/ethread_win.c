@@ -0,0 +1,178 @@
+/*
+    Threads
+*/
+
+#include <windows.h>
+
+#include "../elibc_config.h"
+#include "../stdlib/estdlib.h"
+
+#include "eassert.h"
+#include "etrace.h"
+#include "eerror.h"
+#include "ethread.h"
+
+/*----------------------------------------------------------------------*/
+
+/* thread data */
+typedef struct
+{
+    HANDLE          thread;
+    ethread_func_t  ethread_func;
+    void*           arg;
+
+} ethread_data_t;
+
+/*----------------------------------------------------------------------*/
+
+DWORD WINAPI _ethread_start(LPVOID arg)
+{
+    ethread_data_t* ethread_data = (ethread_data_t*)arg;
+
+    ethread_data->ethread_func(ethread_data->arg);
+
+    return 0;
+}
+
+/*----------------------------------------------------------------------*/
+
+/* start thread */
+int ethread_create(ethread_t* ethread, ethread_func_t ethread_func, void* arg)
+{
+    ethread_data_t* ethread_data;
+
+    EASSERT(ethread);
+    EASSERT(ethread_func);
+    if(ethread == 0 || ethread_func == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* reset output */
+    *ethread = 0;
+
+    ethread_data = (ethread_data_t*)emalloc(sizeof(ethread_data_t));
+    if(ethread_data == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    ethread_data->ethread_func = ethread_func;
+    ethread_data->arg = arg;
+
+    /* start */
+    ethread_data->thread = CreateThread(0, 0, _ethread_start, ethread_data, 0, 0);
+    if(ethread_data->thread == 0)
+    {
+        ETRACE("ethread: failed to create thread");
+        efree(ethread_data);
+        return ELIBC_ERROR_INTERNAL;
+    }
+
+    *ethread = ethread_data;
+
+    return ELIBC_SUCCESS;
+}
+
+/* wait for thread to finish and release handle */
+int ethread_join(ethread_t ethread)
+{
+    ethread_data_t* ethread_data = (ethread_data_t*)ethread;
+    DWORD result;
+
+    EASSERT(ethread);
+    if(ethread == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* wait */
+    result = WaitForSingleObject(ethread_data->thread, INFINITE);
+
+    CloseHandle(ethread_data->thread);
+    efree(ethread_data);
+
+    return (result == WAIT_OBJECT_0) ? ELIBC_SUCCESS : ELIBC_ERROR_INTERNAL;
+}
+
+/* give up the rest of time slice */
+void ethread_yield()
+{
+    SwitchToThread();
+}
+
+/*----------------------------------------------------------------------*/
+/* mutex */
+/*----------------------------------------------------------------------*/
+int emutex_create(emutex_t* emutex)
+{
+    SRWLOCK* lock;
+
+    EASSERT(emutex);
+    if(emutex == 0) return ELIBC_ERROR_ARGUMENT;
+
+    lock = (SRWLOCK*)emalloc(sizeof(SRWLOCK));
+    if(lock == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    InitializeSRWLock(lock);
+
+    *emutex = lock;
+
+    return ELIBC_SUCCESS;
+}
+
+void emutex_destroy(emutex_t emutex)
+{
+    /* slim locks do not need to be destroyed */
+    efree(emutex);
+}
+
+void emutex_lock(emutex_t emutex)
+{
+    EASSERT(emutex);
+    AcquireSRWLockExclusive((SRWLOCK*)emutex);
+}
+
+void emutex_unlock(emutex_t emutex)
+{
+    EASSERT(emutex);
+    ReleaseSRWLockExclusive((SRWLOCK*)emutex);
+}
+
+/*----------------------------------------------------------------------*/
+/* condition variable */
+/*----------------------------------------------------------------------*/
+int econd_create(econd_t* econd)
+{
+    CONDITION_VARIABLE* cond;
+
+    EASSERT(econd);
+    if(econd == 0) return ELIBC_ERROR_ARGUMENT;
+
+    cond = (CONDITION_VARIABLE*)emalloc(sizeof(CONDITION_VARIABLE));
+    if(cond == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    InitializeConditionVariable(cond);
+
+    *econd = cond;
+
+    return ELIBC_SUCCESS;
+}
+
+void econd_destroy(econd_t econd)
+{
+    /* condition variables do not need to be destroyed */
+    efree(econd);
+}
+
+void econd_wait(econd_t econd, emutex_t emutex)
+{
+    EASSERT(econd);
+    EASSERT(emutex);
+    SleepConditionVariableSRW((CONDITION_VARIABLE*)econd, (SRWLOCK*)emutex, INFINITE, 0);
+}
+
+void econd_signal(econd_t econd)
+{
+    EASSERT(econd);
+    WakeConditionVariable((CONDITION_VARIABLE*)econd);
+}
+
+void econd_broadcast(econd_t econd)
+{
+    EASSERT(econd);
+    WakeAllConditionVariable((CONDITION_VARIABLE*)econd);
+}
+
+/*----------------------------------------------------------------------*/
@@ -0,0 +1,607 @@
+/*
+    Work stealing thread pool
+*/
+
+#include "../elibc_config.h"
+#include "../stdlib/estdlib.h"
+
+#include "eassert.h"
+#include "etrace.h"
+#include "eerror.h"
+#include "eatomic.h"
+#include "esystem.h"
+#include "ethread.h"
+#include "ethreadpool.h"
+
+/*----------------------------------------------------------------------*/
+/* constants */
+/*----------------------------------------------------------------------*/
+
+/* initial deque size (power of two) */
+#define ETHREADPOOL_DEQUE_SIZE              256
+
+/* failed attempts to find task before worker goes to sleep */
+#define ETHREADPOOL_SPIN_COUNT              64
+
+/* ranges per worker when grain size is not set */
+#define ETHREADPOOL_RANGES_PER_WORKER       8
+
+/*----------------------------------------------------------------------*/
+/* types */
+/*----------------------------------------------------------------------*/
+
+/* task */
+typedef struct ethreadpool_task_s
+{
+    struct ethreadpool_task_s*  next;           /* shared queue link */
+    ethreadpool_group_t*        group;
+
+    /* function or range function */
+    ethreadpool_func_t          func;
+    ethreadpool_range_func_t    range_func;
+    void*                       arg;
+
+    size_t                      begin;
+    size_t                      end;
+    size_t                      grain_size;
+
+} ethreadpool_task_t;
+
+/* deque storage, replaced arrays are kept until pool is stopped */
+typedef struct ethreadpool_deque_array_s
+{
+    struct ethreadpool_deque_array_s*   previous;
+    eint64_t                            size;
+    eatomic_ptr_t                       items[1];
+
+} ethreadpool_deque_array_t;
+
+/* worker */
+typedef struct
+{
+    /* owner side */
+    eatomic_t                   bottom;
+    eatomic_ptr_t               array;
+    char                        padding0[EATOMIC_CACHE_LINE_SIZE - sizeof(eatomic_t) - sizeof(eatomic_ptr_t)];
+
+    /* thieves side */
+    eatomic_t                   top;
+    char                        padding1[EATOMIC_CACHE_LINE_SIZE - sizeof(eatomic_t)];
+
+    ethreadpool_t*              ethreadpool;
+    ethread_t                   thread;
+    euint32_t                   seed;
+    char                        padding2[EATOMIC_CACHE_LINE_SIZE];
+
+} ethreadpool_worker_t;
+
+/*----------------------------------------------------------------------*/
+
+/* worker running in current thread */
+static ELIBC_THREAD_LOCAL ethreadpool_worker_t* _ethreadpool_current = 0;
+
+/*----------------------------------------------------------------------*/
+/* deque */
+/*----------------------------------------------------------------------*/
+ethreadpool_deque_array_t* _ethreadpool_array_alloc(eint64_t size)
+{
+    ethreadpool_deque_array_t* array;
+
+    array = (ethreadpool_deque_array_t*)emalloc(sizeof(ethreadpool_deque_array_t) + (size_t)(size - 1) * sizeof(eatomic_ptr_t));
+    if(array == 0) return 0;
+
+    array->previous = 0;
+    array->size = size;
+
+    return array;
+}
+
+int _ethreadpool_deque_push(ethreadpool_worker_t* worker, ethreadpool_task_t* task)
+{
+    ethreadpool_deque_array_t* array;
+    ethreadpool_deque_array_t* grown;
+    eint64_t bottom, top, idx;
+
+    bottom = eatomic_load_relaxed(&worker->bottom);
+    top = eatomic_load(&worker->top);
+    array = (ethreadpool_deque_array_t*)eatomic_load_ptr_relaxed(&worker->array);
+
+    /* grow if full */
+    if(bottom - top >= array->size)
+    {
+        grown = _ethreadpool_array_alloc(array->size * 2);
+        if(grown == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+        for(idx = top; idx < bottom; ++idx)
+        {
+            grown->items[idx & (grown->size - 1)] = array->items[idx & (array->size - 1)];
+        }
+
+        /* thieves may still read old array */
+        grown->previous = array;
+        eatomic_store_ptr(&worker->array, grown);
+        array = grown;
+    }
+
+    eatomic_store_ptr_relaxed(&array->items[bottom & (array->size - 1)], task);
+    eatomic_store(&worker->bottom, bottom + 1);
+
+    return ELIBC_SUCCESS;
+}
+
+ethreadpool_task_t* _ethreadpool_deque_take(ethreadpool_worker_t* worker)
+{
+    ethreadpool_deque_array_t* array;
+    ethreadpool_task_t* task = 0;
+    eint64_t bottom, top;
+
+    bottom = eatomic_load_relaxed(&worker->bottom) - 1;
+    array = (ethreadpool_deque_array_t*)eatomic_load_ptr_relaxed(&worker->array);
+    eatomic_store_relaxed(&worker->bottom, bottom);
+    eatomic_fence();
+    top = eatomic_load_relaxed(&worker->top);
+
+    if(top <= bottom)
+    {
+        task = (ethreadpool_task_t*)eatomic_load_ptr_relaxed(&array->items[bottom & (array->size - 1)]);
+
+        /* last item, race with thieves */
+        if(top == bottom)
+        {
+            if(!eatomic_cas(&worker->top, top, top + 1)) task = 0;
+            eatomic_store_relaxed(&worker->bottom, bottom + 1);
+        }
+
+    } else
+    {
+        /* empty */
+        eatomic_store_relaxed(&worker->bottom, bottom + 1);
+    }
+
+    return task;
+}
+
+ethreadpool_task_t* _ethreadpool_deque_steal(ethreadpool_worker_t* worker)
+{
+    ethreadpool_deque_array_t* array;
+    ethreadpool_task_t* task;
+    eint64_t bottom, top;
+
+    top = eatomic_load(&worker->top);
+    eatomic_fence();
+    bottom = eatomic_load(&worker->bottom);
+
+    if(top >= bottom) return 0;
+
+    array = (ethreadpool_deque_array_t*)eatomic_load_ptr(&worker->array);
+    task = (ethreadpool_task_t*)eatomic_load_ptr_relaxed(&array->items[top & (array->size - 1)]);
+
+    /* lost race with owner or other thief */
+    if(!eatomic_cas(&worker->top, top, top + 1)) return 0;
+
+    return task;
+}
+
+/*----------------------------------------------------------------------*/
+/* tasks */
+/*----------------------------------------------------------------------*/
+void _ethreadpool_push(ethreadpool_t* ethreadpool, ethreadpool_task_t* task)
+{
+    ethreadpool_worker_t* worker = _ethreadpool_current;
+    ethreadpool_task_t* queue_tail;
+
+    /* counted before it is visible, so sleeping workers can't miss it */
+    eatomic_add(&ethreadpool->queued, 1);
+
+    /* own deque if called from worker of this pool, shared queue otherwise */
+    if(worker == 0 || worker->ethreadpool != ethreadpool ||
+       _ethreadpool_deque_push(worker, task) != ELIBC_SUCCESS)
+    {
+        task->next = 0;
+
+        emutex_lock(ethreadpool->mutex);
+
+        queue_tail = (ethreadpool_task_t*)ethreadpool->queue_tail;
+        if(queue_tail)
+            queue_tail->next = task;
+        else
+            eatomic_store_ptr(&ethreadpool->queue_head, task);
+
+        ethreadpool->queue_tail = task;
+
+        emutex_unlock(ethreadpool->mutex);
+    }
+
+    /* wake up sleeping worker */
+    eatomic_fence();
+    if(eatomic_load(&ethreadpool->sleeping) > 0)
+    {
+        emutex_lock(ethreadpool->mutex);
+        econd_signal(ethreadpool->cond);
+        emutex_unlock(ethreadpool->mutex);
+    }
+}
+
+ethreadpool_task_t* _ethreadpool_find(ethreadpool_t* ethreadpool, ethreadpool_worker_t* worker)
+{
+    ethreadpool_worker_t* workers = (ethreadpool_worker_t*)ethreadpool->workers;
+    ethreadpool_task_t* task = 0;
+    euint32_t seed, victim, idx;
+
+    /* own deque first */
+    if(worker) task = _ethreadpool_deque_take(worker);
+
+    /* shared queue */
+    if(task == 0 && eatomic_load_ptr(&ethreadpool->queue_head) != 0)
+    {
+        emutex_lock(ethreadpool->mutex);
+
+        task = (ethreadpool_task_t*)ethreadpool->queue_head;
+        if(task)
+        {
+            eatomic_store_ptr(&ethreadpool->queue_head, task->next);
+            if(task->next == 0) ethreadpool->queue_tail = 0;
+        }
+
+        emutex_unlock(ethreadpool->mutex);
+    }
+
+    /* steal starting from random worker */
+    if(task == 0)
+    {
+        seed = worker ? worker->seed : (euint32_t)(size_t)&task;
+
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+
+        if(worker) worker->seed = seed;
+
+        for(idx = 0; idx < ethreadpool->worker_count && task == 0; ++idx)
+        {
+            victim = (seed + idx) % ethreadpool->worker_count;
+            if(workers + victim != worker) task = _ethreadpool_deque_steal(workers + victim);
+        }
+    }
+
+    if(task) eatomic_add(&ethreadpool->queued, -1);
+
+    return task;
+}
+
+ethreadpool_task_t* _ethreadpool_task_alloc(ethreadpool_group_t* group)
+{
+    ethreadpool_task_t* task;
+
+    task = (ethreadpool_task_t*)emalloc(sizeof(ethreadpool_task_t));
+    if(task == 0) return 0;
+
+    ememset(task, 0, sizeof(ethreadpool_task_t));
+    task->group = group;
+
+    return task;
+}
+
+void _ethreadpool_range(ethreadpool_t* ethreadpool, ethreadpool_group_t* group, ethreadpool_range_func_t range_func,
+                        void* arg, size_t begin, size_t end, size_t grain_size)
+{
+    ethreadpool_task_t* task;
+    size_t middle;
+
+    /* split off right halves as tasks for other workers */
+    while(end - begin > grain_size)
+    {
+        task = _ethreadpool_task_alloc(group);
+        if(task == 0) break;
+
+        middle = begin + (end - begin) / 2;
+
+        task->range_func = range_func;
+        task->arg = arg;
+        task->begin = middle;
+        task->end = end;
+        task->grain_size = grain_size;
+
+        eatomic_add(&group->pending, 1);
+        eatomic_add(&ethreadpool->unfinished, 1);
+        _ethreadpool_push(ethreadpool, task);
+
+        end = middle;
+    }
+
+    range_func(arg, begin, end);
+}
+
+void _ethreadpool_execute(ethreadpool_t* ethreadpool, ethreadpool_task_t* task)
+{
+    ethreadpool_group_t* group = task->group;
+
+    if(task->range_func)
+        _ethreadpool_range(ethreadpool, group, task->range_func, task->arg, task->begin, task->end, task->grain_size);
+    else
+        task->func(task->arg);
+
+    efree(task);
+
+    /* done */
+    if(group) eatomic_add(&group->pending, -1);
+    eatomic_add(&ethreadpool->unfinished, -1);
+}
+
+int _ethreadpool_start(ethreadpool_t* ethreadpool, ethreadpool_group_t* group, ethreadpool_func_t func, void* arg)
+{
+    ethreadpool_task_t* task;
+
+    task = _ethreadpool_task_alloc(group);
+    if(task == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    task->func = func;
+    task->arg = arg;
+
+    if(group) eatomic_add(&group->pending, 1);
+    eatomic_add(&ethreadpool->unfinished, 1);
+    _ethreadpool_push(ethreadpool, task);
+
+    return ELIBC_SUCCESS;
+}
+
+/* run tasks until counter drops to zero */
+void _ethreadpool_help(ethreadpool_t* ethreadpool, eatomic_t* counter)
+{
+    ethreadpool_worker_t* worker = _ethreadpool_current;
+    ethreadpool_task_t* task;
+
+    if(worker && worker->ethreadpool != ethreadpool) worker = 0;
+
+    while(eatomic_load(counter) > 0)
+    {
+        task = _ethreadpool_find(ethreadpool, worker);
+
+        if(task)
+            _ethreadpool_execute(ethreadpool, task);
+        else
+            ethread_yield();
+    }
+}
+
+/*----------------------------------------------------------------------*/
+/* worker thread */
+/*----------------------------------------------------------------------*/
+void _ethreadpool_worker(void* arg)
+{
+    ethreadpool_worker_t* worker = (ethreadpool_worker_t*)arg;
+    ethreadpool_t* ethreadpool = worker->ethreadpool;
+    ethreadpool_task_t* task;
+    int spin_count = 0;
+
+    _ethreadpool_current = worker;
+
+    while(!eatomic_load(&ethreadpool->shutdown))
+    {
+        task = _ethreadpool_find(ethreadpool, worker);
+        if(task)
+        {
+            _ethreadpool_execute(ethreadpool, task);
+            spin_count = 0;
+            continue;
+        }
+
+        /* keep looking for a while */
+        if(++spin_count < ETHREADPOOL_SPIN_COUNT)
+        {
+            if(eatomic_load(&ethreadpool->queued) > 0)
+                eatomic_pause();
+            else
+                ethread_yield();
+
+            continue;
+        }
+
+        /* sleep until something is queued */
+        emutex_lock(ethreadpool->mutex);
+
+        eatomic_add(&ethreadpool->sleeping, 1);
+        eatomic_fence();
+
+        while(eatomic_load(&ethreadpool->queued) <= 0 && !eatomic_load(&ethreadpool->shutdown))
+        {
+            econd_wait(ethreadpool->cond, ethreadpool->mutex);
+        }
+
+        eatomic_add(&ethreadpool->sleeping, -1);
+
+        emutex_unlock(ethreadpool->mutex);
+
+        spin_count = 0;
+    }
+
+    _ethreadpool_current = 0;
+}
+
+/*----------------------------------------------------------------------*/
+/* start and stop */
+/*----------------------------------------------------------------------*/
+int ethreadpool_init(ethreadpool_t* ethreadpool, unsigned int thread_count)
+{
+    ethreadpool_worker_t* workers = 0;
+    unsigned int idx;
+    int err;
+
+    EASSERT(ethreadpool);
+    if(ethreadpool == 0) return ELIBC_ERROR_ARGUMENT;
+
+    ememset(ethreadpool, 0, sizeof(ethreadpool_t));
+
+    if(thread_count == 0) thread_count = esystem_cpu_count();
+
+    /* shared queue */
+    err = emutex_create(&ethreadpool->mutex);
+    if(err == ELIBC_SUCCESS) err = econd_create(&ethreadpool->cond);
+
+    /* workers */
+    if(err == ELIBC_SUCCESS)
+    {
+        workers = (ethreadpool_worker_t*)emalloc(thread_count * sizeof(ethreadpool_worker_t));
+        if(workers)
+        {
+            ememset(workers, 0, thread_count * sizeof(ethreadpool_worker_t));
+            ethreadpool->workers = workers;
+            ethreadpool->worker_count = thread_count;
+
+        } else
+        {
+            err = ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+        }
+    }
+
+    /* deques must be ready before any worker starts stealing */
+    for(idx = 0; idx < thread_count && err == ELIBC_SUCCESS; ++idx)
+    {
+        workers[idx].array = _ethreadpool_array_alloc(ETHREADPOOL_DEQUE_SIZE);
+        if(workers[idx].array == 0) err = ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+        workers[idx].ethreadpool = ethreadpool;
+        workers[idx].seed = 2463534242u + idx * 2654435761u;
+    }
+
+    /* start */
+    for(idx = 0; idx < thread_count && err == ELIBC_SUCCESS; ++idx)
+    {
+        err = ethread_create(&workers[idx].thread, _ethreadpool_worker, workers + idx);
+    }
+
+    if(err != ELIBC_SUCCESS)
+    {
+        ETRACE("ethreadpool: failed to start workers");
+        ethreadpool_free(ethreadpool);
+    }
+
+    return err;
+}
+
+void ethreadpool_free(ethreadpool_t* ethreadpool)
+{
+    ethreadpool_worker_t* workers;
+    ethreadpool_deque_array_t* array;
+    unsigned int idx;
+
+    EASSERT(ethreadpool);
+    if(ethreadpool == 0) return;
+
+    workers = (ethreadpool_worker_t*)ethreadpool->workers;
+
+    /* finish started tasks */
+    _ethreadpool_help(ethreadpool, &ethreadpool->unfinished);
+
+    /* stop workers */
+    if(ethreadpool->mutex)
+    {
+        emutex_lock(ethreadpool->mutex);
+        eatomic_store(&ethreadpool->shutdown, 1);
+        if(ethreadpool->cond) econd_broadcast(ethreadpool->cond);
+        emutex_unlock(ethreadpool->mutex);
+    }
+
+    /* release workers */
+    if(workers)
+    {
+        /* all must be stopped before deques are released */
+        for(idx = 0; idx < ethreadpool->worker_count; ++idx)
+        {
+            if(workers[idx].thread) ethread_join(workers[idx].thread);
+        }
+
+        for(idx = 0; idx < ethreadpool->worker_count; ++idx)
+        {
+            while((array = (ethreadpool_deque_array_t*)workers[idx].array) != 0)
+            {
+                workers[idx].array = array->previous;
+                efree(array);
+            }
+        }
+
+        efree(workers);
+    }
+
+    econd_destroy(ethreadpool->cond);
+    emutex_destroy(ethreadpool->mutex);
+
+    ememset(ethreadpool, 0, sizeof(ethreadpool_t));
+}
+
+/* number of worker threads */
+unsigned int ethreadpool_thread_count(ethreadpool_t* ethreadpool)
+{
+    EASSERT(ethreadpool);
+    if(ethreadpool == 0) return 0;
+
+    return ethreadpool->worker_count;
+}
+
+/* start task without waiting */
+int ethreadpool_submit(ethreadpool_t* ethreadpool, ethreadpool_func_t func, void* arg)
+{
+    EASSERT(ethreadpool);
+    EASSERT(func);
+    if(ethreadpool == 0 || func == 0) return ELIBC_ERROR_ARGUMENT;
+
+    return _ethreadpool_start(ethreadpool, 0, func, arg);
+}
+
+/*----------------------------------------------------------------------*/
+/* task groups */
+/*----------------------------------------------------------------------*/
+void ethreadpool_group_init(ethreadpool_group_t* group, ethreadpool_t* ethreadpool)
+{
+    EASSERT(group);
+    EASSERT(ethreadpool);
+    if(group == 0) return;
+
+    group->ethreadpool = ethreadpool;
+    group->pending = 0;
+}
+
+int ethreadpool_group_run(ethreadpool_group_t* group, ethreadpool_func_t func, void* arg)
+{
+    EASSERT(group);
+    EASSERT(group && group->ethreadpool);
+    EASSERT(func);
+    if(group == 0 || group->ethreadpool == 0 || func == 0) return ELIBC_ERROR_ARGUMENT;
+
+    return _ethreadpool_start(group->ethreadpool, group, func, arg);
+}
+
+void ethreadpool_group_wait(ethreadpool_group_t* group)
+{
+    EASSERT(group);
+    EASSERT(group && group->ethreadpool);
+    if(group == 0 || group->ethreadpool == 0) return;
+
+    _ethreadpool_help(group->ethreadpool, &group->pending);
+}
+
+/* parallel loop over [begin, end) in ranges of at most grain_size */
+void ethreadpool_parallel_for(ethreadpool_t* ethreadpool, size_t begin, size_t end, size_t grain_size, ethreadpool_range_func_t func, void* arg)
+{
+    ethreadpool_group_t group;
+
+    EASSERT(ethreadpool);
+    EASSERT(func);
+    if(ethreadpool == 0 || func == 0 || begin >= end) return;
+
+    /* few ranges per worker */
+    if(grain_size == 0)
+    {
+        grain_size = (end - begin) / ((size_t)ethreadpool->worker_count * ETHREADPOOL_RANGES_PER_WORKER + 1);
+        if(grain_size == 0) grain_size = 1;
+    }
+
+    ethreadpool_group_init(&group, ethreadpool);
+
+    /* calling thread splits and runs the first range */
+    _ethreadpool_range(ethreadpool, &group, func, arg, begin, end, grain_size);
+
+    ethreadpool_group_wait(&group);
+}
+
+/*----------------------------------------------------------------------*/
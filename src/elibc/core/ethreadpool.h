@@ -0,0 +1,80 @@
+/*
+    Work stealing thread pool
+*/
+
+#ifndef _ETHREADPOOL_H_
+#define _ETHREADPOOL_H_
+
+/*
+    Every worker owns task deque (Chase-Lev), tasks started by worker are pushed
+    to and taken from the bottom of its own deque while idle workers steal from
+    the top of other deques. Tasks started from other threads go to shared queue.
+    Thread waiting for task group runs pending tasks instead of blocking, so tasks
+    can start and wait for nested groups.
+*/
+
+/*----------------------------------------------------------------------*/
+
+/* task function (argument) */
+typedef void (*ethreadpool_func_t)(void*);
+
+/* range function (argument, first index, end index) */
+typedef void (*ethreadpool_range_func_t)(void*, size_t, size_t);
+
+/* thread pool */
+typedef struct
+{
+    void*           workers;        /* worker threads and deques */
+    unsigned int    worker_count;
+
+    /* shared queue */
+    emutex_t        mutex;
+    econd_t         cond;
+    eatomic_ptr_t   queue_head;
+    void*           queue_tail;
+
+    /* tasks waiting in deques and queue, not finished tasks */
+    eatomic_t       queued;
+    eatomic_t       unfinished;
+
+    eatomic_t       sleeping;
+    eatomic_t       shutdown;
+
+} ethreadpool_t;
+
+/* task group */
+typedef struct
+{
+    ethreadpool_t*  ethreadpool;
+    eatomic_t       pending;
+
+} ethreadpool_group_t;
+
+/*----------------------------------------------------------------------*/
+
+/*
+    NOTE: pool must not be moved in memory after it is started, free waits until
+          all started tasks are finished
+*/
+
+/* start and stop (thread_count zero starts one worker per cpu) */
+int ethreadpool_init(ethreadpool_t* ethreadpool, unsigned int thread_count);
+void ethreadpool_free(ethreadpool_t* ethreadpool);
+
+/* number of worker threads */
+unsigned int ethreadpool_thread_count(ethreadpool_t* ethreadpool);
+
+/* start task without waiting */
+int ethreadpool_submit(ethreadpool_t* ethreadpool, ethreadpool_func_t func, void* arg);
+
+/* task groups */
+void ethreadpool_group_init(ethreadpool_group_t* group, ethreadpool_t* ethreadpool);
+int ethreadpool_group_run(ethreadpool_group_t* group, ethreadpool_func_t func, void* arg);
+void ethreadpool_group_wait(ethreadpool_group_t* group);
+
+/* parallel loop over [begin, end) in ranges of at most grain_size (zero to select automatically) */
+void ethreadpool_parallel_for(ethreadpool_t* ethreadpool, size_t begin, size_t end, size_t grain_size, ethreadpool_range_func_t func, void* arg);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _ETHREADPOOL_H_ */
@@ -31,11 +31,19 @@ extern "C" {
 #include "core/ebuffer.h"
 #include "core/earray.h"
 #include "core/estack.h"
+#include "core/ebuffer_chain.h"
+#include "core/ering.h"
 #include "core/eset.h"
+#include "core/ehashmap.h"
 #include "core/elist.h"
 #include "core/ebinsearch.h"
 #include "core/efile.h"
 #include "core/esystem.h"
+#include "core/eatomic.h"
+#include "core/ethread.h"
+#include "core/ethreadpool.h"
+#include "core/equeue.h"
+#include "core/epool.h"
 #include "core/esort.h"
 
 /*----------------------------------------------------------------------*/
@@ -116,6 +116,32 @@ typedef     euint64_t           efilesize_t;
 #define ELIBC_FORCE_INLINE
 #endif
 
+/* define this to use compiler intrinsics instead of C11 atomics */
+/* #define _ELIBC_NO_C11_ATOMICS */
+
+/* thread local variables */
+#if defined(_MSC_VER)
+#define ELIBC_THREAD_LOCAL  __declspec(thread)
+#else
+#define ELIBC_THREAD_LOCAL  __thread
+#endif
+
+/*----------------------------------------------------------------------*/
+/* cpu architecture */
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define _ELIBC_ARCH_X86
+#endif
+
+/* define this to disable cpu specific code paths */
+/* #define _ELIBC_NO_SIMD */
+
+/* enable instruction set for single function (msvc allows intrinsics without it) */
+#if defined(__GNUC__)
+#define ELIBC_TARGET(isa)       __attribute__((target(isa)))
+#else
+#define ELIBC_TARGET(isa)
+#endif
+
 /*----------------------------------------------------------------------*/
 /* language options */
 
@@ -44,6 +44,7 @@ typedef struct tm   etm_t;
 #define ememmove    memmove
 #define ememset     memset
 #define ememcmp     memcmp
+#define ememchr     memchr
 
 /* string functions */
 #define estrcpy     strcpy
@@ -58,6 +59,7 @@ typedef struct tm   etm_t;
 #define ewcscmp     wcscmp
 #define estrncmp    strncmp
 #define ewcsncmp    wcsncmp
+#define estrchr     strchr
 #define estrstr     strstr
 #define ewcsstr     wcsstr
 
@@ -5,6 +5,7 @@
 #include "../elib_config.h"
 
 #include "../http/http_param.h"
+#include "../text/text_number.h"
 #include "json_encode.h"
 
 /*----------------------------------------------------------------------*/
@@ -123,6 +124,45 @@ int _json_encode_begin_item(json_encoder_t* json_encoder, const char* name)
     return ELIBC_SUCCESS;
 }
 
+/* validate number syntax (-?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?) */
+ebool_t _json_is_valid_number(const char* value, size_t value_size)
+{
+    size_t pos = 0, digits;
+
+    /* sign */
+    if(pos < value_size && value[pos] == '-') pos++;
+
+    /* integer part (no leading zeros) */
+    for(digits = 0; pos < value_size && eisdigit((unsigned char)value[pos]); ++pos, ++digits);
+    if(digits == 0 || (digits > 1 && value[pos - digits] == '0')) return ELIBC_FALSE;
+
+    /* fraction */
+    if(pos < value_size && value[pos] == '.')
+    {
+        for(pos++, digits = 0; pos < value_size && eisdigit((unsigned char)value[pos]); ++pos, ++digits);
+        if(digits == 0) return ELIBC_FALSE;
+    }
+
+    /* exponent */
+    if(pos < value_size && (value[pos] == 'e' || value[pos] == 'E'))
+    {
+        pos++;
+        if(pos < value_size && (value[pos] == '+' || value[pos] == '-')) pos++;
+
+        for(digits = 0; pos < value_size && eisdigit((unsigned char)value[pos]); ++pos, ++digits);
+        if(digits == 0) return ELIBC_FALSE;
+    }
+
+    return (pos == value_size) ? ELIBC_TRUE : ELIBC_FALSE;
+}
+
+int _json_encode_number_ready(json_encoder_t* json_encoder, size_t number_length)
+{
+    /* number is formatted in reserved space, adjust buffer position to actual length */
+    return ebuffer_setpos(json_encoder->encode_buffer, 
+        ebuffer_pos(json_encoder->encode_buffer) - TEXT_NUMBER_BUFFER_SIZE + number_length);
+}
+
 /*----------------------------------------------------------------------*/
 
 /* encoder handle */
@@ -282,7 +322,7 @@ int json_encode_value_text(json_encoder_t* json_encoder, const http_param_t* htt
 
 int json_encode_value_number(json_encoder_t* json_encoder, const http_param_t* http_param)
 {
-    size_t pos, idx;
+    size_t pos;
     int err;
 
     /* check input */
@@ -301,24 +341,72 @@ int json_encode_value_number(json_encoder_t* json_encoder, const http_param_t* h
     if(err != ELIBC_SUCCESS) return err;
 
     /* validate number */
-    if(pos < ebuffer_pos(json_encoder->encode_buffer))
+    if(!_json_is_valid_number(ebuffer_data(json_encoder->encode_buffer) + pos, 
+                              ebuffer_pos(json_encoder->encode_buffer) - pos))
     {
-        for(idx = pos; idx < ebuffer_pos(json_encoder->encode_buffer); ++idx)
-        {
-            if(!eisdigit(ebuffer_data(json_encoder->encode_buffer)[pos + idx]))
-            {
-                ETRACE("json_encoder: invalid number value");
-                return ELIBC_ERROR_ARGUMENT;
-            }
-        }
+        ETRACE("json_encoder: invalid number value");
+        return ELIBC_ERROR_ARGUMENT;
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+int json_encode_value_int(json_encoder_t* json_encoder, const char* name, eint64_t value)
+{
+    char* number_str;
+    int err;
 
-    } else
+    /* encode value start */
+    err = _json_encode_begin_item(json_encoder, name);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* reserve space */
+    number_str = ebuffer_append_ptr(json_encoder->encode_buffer, TEXT_NUMBER_BUFFER_SIZE);
+    if(number_str == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    /* format directly to buffer */
+    return _json_encode_number_ready(json_encoder, int64_to_str(value, number_str));
+}
+
+int json_encode_value_uint(json_encoder_t* json_encoder, const char* name, euint64_t value)
+{
+    char* number_str;
+    int err;
+
+    /* encode value start */
+    err = _json_encode_begin_item(json_encoder, name);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* reserve space */
+    number_str = ebuffer_append_ptr(json_encoder->encode_buffer, TEXT_NUMBER_BUFFER_SIZE);
+    if(number_str == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    /* format directly to buffer */
+    return _json_encode_number_ready(json_encoder, uint64_to_str(value, number_str));
+}
+
+int json_encode_value_double(json_encoder_t* json_encoder, const char* name, double value)
+{
+    char* number_str;
+    int err;
+
+    /* json has no representation for NaN and infinity (x - x is zero only for finite numbers) */
+    if(value - value != 0)
     {
-        ETRACE("json_encoder: invalid number value (empty)");
+        ETRACE("json_encoder: number value is not finite");
         return ELIBC_ERROR_ARGUMENT;
     }
 
-    return ELIBC_SUCCESS;
+    /* encode value start */
+    err = _json_encode_begin_item(json_encoder, name);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* reserve space */
+    number_str = ebuffer_append_ptr(json_encoder->encode_buffer, TEXT_NUMBER_BUFFER_SIZE);
+    if(number_str == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    /* format directly to buffer (shortest round-trip representation) */
+    return _json_encode_number_ready(json_encoder, double_to_str(value, number_str));
 }
 
 int json_encode_end(json_encoder_t* json_encoder)
@@ -30,6 +30,9 @@ int     json_encode_array_begin(json_encoder_t* json_encoder, const char* name);
 int     json_encode_array_end(json_encoder_t* json_encoder);
 int     json_encode_value_text(json_encoder_t* json_encoder, const http_param_t* http_param, http_encoding_t encoding);
 int     json_encode_value_number(json_encoder_t* json_encoder, const http_param_t* http_param);
+int     json_encode_value_int(json_encoder_t* json_encoder, const char* name, eint64_t value);
+int     json_encode_value_uint(json_encoder_t* json_encoder, const char* name, euint64_t value);
+int     json_encode_value_double(json_encoder_t* json_encoder, const char* name, double value);
 int     json_encode_end(json_encoder_t* json_encoder);
 
 /*----------------------------------------------------------------------*/
@@ -5,19 +5,129 @@
 #include "../elib_config.h"
 
 #include "../http/http_param.h"
+#include "../text/text_number.h"
 #include "xml_encode.h"
 
 /*----------------------------------------------------------------------*/
 
+/* encoder flags */
+#define XML_ENCODE_FLAG_TAG_OPEN            0x0001      /* tag begin is not finished yet */
+#define XML_ENCODE_FLAG_ATTRIBUTE           0x0002      /* attribute value is not finished yet */
+
+/*----------------------------------------------------------------------*/
+
 /* encoder stack item */
 typedef struct
 {
-    // TODO:
-    unsigned short          flags;
+    size_t                  name_offset;
+    size_t                  name_length;
 
 } xml_encode_stack_item_t;
 
 /*----------------------------------------------------------------------*/
+/* helpers */
+
+#define XML_ENCODE_APPEND_CHAR(ch) \
+    err = ebuffer_append_char((xml_encoder->encode_buffer), (ch)); \
+    if(err != ELIBC_SUCCESS) return err;
+
+#define XML_ENCODE_APPEND_TEXT(text, length) \
+    err = ebuffer_append((xml_encoder->encode_buffer), (text), (length)); \
+    if(err != ELIBC_SUCCESS) return err;
+
+/*----------------------------------------------------------------------*/
+/* worker methods */
+ELIBC_FORCE_INLINE const char* _xml_encode_escape(char ch, ebool_t attribute)
+{
+    switch(ch)
+    {
+    case '&':   return "&amp;";
+    case '<':   return "&lt;";
+    case '>':   return "&gt;";
+    case '\"':  return attribute ? "&quot;" : 0;
+    default:    return 0;
+    }
+}
+
+int _xml_encode_escaped(xml_encoder_t* xml_encoder, const char* text, size_t text_length, ebool_t attribute)
+{
+    const char* escape;
+    size_t pos, run;
+    int err;
+
+    /* copy characters that need no escaping in runs */
+    for(pos = 0, run = 0; pos < text_length; ++pos)
+    {
+        escape = _xml_encode_escape(text[pos], attribute);
+        if(escape == 0) continue;
+
+        /* flush run */
+        XML_ENCODE_APPEND_TEXT(text + run, pos - run);
+
+        /* escaped character */
+        XML_ENCODE_APPEND_TEXT(escape, estrlen(escape));
+
+        run = pos + 1;
+    }
+
+    /* the rest */
+    XML_ENCODE_APPEND_TEXT(text + run, text_length - run);
+
+    return ELIBC_SUCCESS;
+}
+
+int _xml_encode_validate_state(xml_encoder_t* xml_encoder)
+{
+    /* check input */
+    EASSERT(xml_encoder);
+    if(xml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* check state */
+    EASSERT(xml_encoder->encode_buffer);
+    if(xml_encoder->encode_buffer == 0) return ELIBC_ERROR_ARGUMENT;
+
+    return ELIBC_SUCCESS;
+}
+
+int _xml_encode_finish_attribute(xml_encoder_t* xml_encoder)
+{
+    int err;
+
+    /* close attribute value if open */
+    if(xml_encoder->flags & XML_ENCODE_FLAG_ATTRIBUTE)
+    {
+        XML_ENCODE_APPEND_CHAR('\"');
+
+        xml_encoder->flags &= ~XML_ENCODE_FLAG_ATTRIBUTE;
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+int _xml_encode_content_begin(xml_encoder_t* xml_encoder)
+{
+    int err;
+
+    /* content must be inside tag */
+    if(estack_size(&xml_encoder->state_stack) == 0)
+    {
+        ETRACE("xml_encoder: content must be inside tag");
+        return ELIBC_ERROR_INVALID_STATE;
+    }
+
+    /* finish tag begin if needed */
+    if(xml_encoder->flags & XML_ENCODE_FLAG_TAG_OPEN)
+    {
+        err = _xml_encode_finish_attribute(xml_encoder);
+        if(err != ELIBC_SUCCESS) return err;
+
+        XML_ENCODE_APPEND_CHAR('>');
+
+        xml_encoder->flags &= ~XML_ENCODE_FLAG_TAG_OPEN;
+    }
+
+    return ELIBC_SUCCESS;
+}
 
 /*----------------------------------------------------------------------*/
 
@@ -31,6 +141,9 @@ void xml_encode_init(xml_encoder_t* xml_encoder)
 
     /* init state stack */
     estack_init(&xml_encoder->state_stack, sizeof(xml_encode_stack_item_t));
+
+    /* init tag names */
+    ebuffer_init(&xml_encoder->name_buffer);
 }
 
 void xml_encode_reset(xml_encoder_t* xml_encoder)
@@ -40,9 +153,11 @@ void xml_encode_reset(xml_encoder_t* xml_encoder)
     {
         /* reset state */
         xml_encoder->encode_buffer = 0;
+        xml_encoder->flags = 0;
 
         /* reset stack */
         estack_reset(&xml_encoder->state_stack);
+        ebuffer_reset(&xml_encoder->name_buffer);
     }
 }
 
@@ -53,6 +168,7 @@ void  xml_encode_close(xml_encoder_t* xml_encoder)
     {
         /* release stack */
         estack_free(&xml_encoder->state_stack);
+        ebuffer_free(&xml_encoder->name_buffer);
 
 #ifndef _ELIBC_DEBUG
         /* reset all fields */
@@ -75,50 +191,293 @@ int xml_encode_begin(xml_encoder_t* xml_encoder, ebuffer_t* encode_buffer)
     /* copy buffer */
     xml_encoder->encode_buffer = encode_buffer;
 
-    /* TODO: */
-    return ELIBC_ERROR_NOT_IMPLEMENTED;
+    return ELIBC_SUCCESS;
 }
 
 int xml_encode_object_begin(xml_encoder_t* xml_encoder, const char* name)
 {
-    /* TODO: */
-    return ELIBC_ERROR_NOT_IMPLEMENTED;
+    /* check input */
+    EASSERT(name);
+    if(name == 0) return ELIBC_ERROR_ARGUMENT;
+
+    return xml_encode_tag_begin(xml_encoder, name, estrlen(name));
 }
 
 int xml_encode_object_end(xml_encoder_t* xml_encoder)
 {
-    /* TODO: */
-    return ELIBC_ERROR_NOT_IMPLEMENTED;
+    return xml_encode_tag_end(xml_encoder);
 }
 
 int xml_encode_array_begin(xml_encoder_t* xml_encoder, const char* name)
 {
-    /* TODO: */
-    return ELIBC_ERROR_NOT_IMPLEMENTED;
+    /* array is just a tag with items */
+    return xml_encode_object_begin(xml_encoder, name);
 }
 
 int xml_encode_array_end(xml_encoder_t* xml_encoder)
 {
-    /* TODO: */
-    return ELIBC_ERROR_NOT_IMPLEMENTED;
+    return xml_encode_tag_end(xml_encoder);
 }
 
 int xml_encode_value_tag(xml_encoder_t* xml_encoder, const http_param_t* http_param, http_encoding_t encoding)
 {
-    /* TODO: */
-    return ELIBC_ERROR_NOT_IMPLEMENTED;
+    int err;
+
+    /* check input */
+    EASSERT(http_param);
+    if(http_param == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* tag */
+    err = xml_encode_object_begin(xml_encoder, http_param->name);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* value */
+    if(encoding == HTTP_VALUE_ENCODING_NONE && http_parameter_is_text(http_param) && !http_parameter_is_utf16(http_param))
+    {
+        err = xml_encode_content(xml_encoder, http_param_str(*http_param), http_param_len(*http_param));
+        if(err != ELIBC_SUCCESS) return err;
+
+    } else
+    {
+        err = _xml_encode_content_begin(xml_encoder);
+        if(err != ELIBC_SUCCESS) return err;
+
+        err = http_encode_value_buffer(xml_encoder->encode_buffer, http_param, encoding);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    return xml_encode_tag_end(xml_encoder);
 }
 
 int xml_encode_value_attribute(xml_encoder_t* xml_encoder, const http_param_t* http_param)
 {
-    /* TODO: */
-    return ELIBC_ERROR_NOT_IMPLEMENTED;
+    int err;
+
+    /* check input */
+    EASSERT(http_param);
+    EASSERT(http_param && http_param->name);
+    if(http_param == 0 || http_param->name == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* attribute name */
+    err = xml_encode_attribute_begin(xml_encoder, http_param->name, estrlen(http_param->name));
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* value */
+    return xml_encode_attribute_value(xml_encoder, http_param_str(*http_param), http_param_len(*http_param));
 }
 
 int xml_encode_end(xml_encoder_t* xml_encoder)
 {
-    /* TODO: */
-    return ELIBC_ERROR_NOT_IMPLEMENTED;
+    int err;
+
+    /* check state */
+    err = _xml_encode_validate_state(xml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* close tags if something left */
+    while(estack_size(&xml_encoder->state_stack) > 0)
+    {
+        err = xml_encode_tag_end(xml_encoder);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    /* reset encoder */
+    xml_encode_reset(xml_encoder);
+
+    return ELIBC_SUCCESS;
+}
+
+/* encode xml stream */
+int xml_encode_tag_begin(xml_encoder_t* xml_encoder, const char* name, size_t name_length)
+{
+    xml_encode_stack_item_t stack_item;
+    int err;
+
+    /* check state */
+    err = _xml_encode_validate_state(xml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* check input */
+    EASSERT(name);
+    if(name == 0 || name_length == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* finish parent tag begin */
+    if(estack_size(&xml_encoder->state_stack) > 0)
+    {
+        err = _xml_encode_content_begin(xml_encoder);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    /* save name for tag end */
+    stack_item.name_offset = ebuffer_pos(&xml_encoder->name_buffer);
+    stack_item.name_length = name_length;
+
+    err = ebuffer_append(&xml_encoder->name_buffer, name, name_length);
+    if(err != ELIBC_SUCCESS) return err;
+
+    err = estack_push(&xml_encoder->state_stack, stack_item);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* tag begin */
+    XML_ENCODE_APPEND_CHAR('<');
+    XML_ENCODE_APPEND_TEXT(name, name_length);
+
+    /* attributes may follow */
+    xml_encoder->flags |= XML_ENCODE_FLAG_TAG_OPEN;
+
+    return ELIBC_SUCCESS;
+}
+
+int xml_encode_tag_end(xml_encoder_t* xml_encoder)
+{
+    xml_encode_stack_item_t* stack_item;
+    int err;
+
+    /* check state */
+    err = _xml_encode_validate_state(xml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    if(estack_size(&xml_encoder->state_stack) == 0)
+    {
+        ETRACE("xml_encoder: invalid state while reporting tag end");
+        return ELIBC_ERROR_INVALID_STATE;
+    }
+
+    stack_item = (xml_encode_stack_item_t*)estack_top(&xml_encoder->state_stack);
+
+    if(xml_encoder->flags & XML_ENCODE_FLAG_TAG_OPEN)
+    {
+        /* tag without content */
+        err = _xml_encode_finish_attribute(xml_encoder);
+        if(err != ELIBC_SUCCESS) return err;
+
+        XML_ENCODE_APPEND_CHAR('/');
+        XML_ENCODE_APPEND_CHAR('>');
+
+        xml_encoder->flags &= ~XML_ENCODE_FLAG_TAG_OPEN;
+
+    } else
+    {
+        /* tag end */
+        XML_ENCODE_APPEND_CHAR('<');
+        XML_ENCODE_APPEND_CHAR('/');
+        XML_ENCODE_APPEND_TEXT(ebuffer_data(&xml_encoder->name_buffer) + stack_item->name_offset, stack_item->name_length);
+        XML_ENCODE_APPEND_CHAR('>');
+    }
+
+    /* pop name */
+    err = ebuffer_setpos(&xml_encoder->name_buffer, stack_item->name_offset);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return estack_pop(&xml_encoder->state_stack);
+}
+
+int xml_encode_attribute_begin(xml_encoder_t* xml_encoder, const char* name, size_t name_length)
+{
+    int err;
+
+    /* check state */
+    err = _xml_encode_validate_state(xml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* check input */
+    EASSERT(name);
+    if(name == 0 || name_length == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* attributes must follow tag begin */
+    if((xml_encoder->flags & XML_ENCODE_FLAG_TAG_OPEN) == 0)
+    {
+        ETRACE("xml_encoder: attribute must follow tag begin");
+        return ELIBC_ERROR_INVALID_STATE;
+    }
+
+    /* finish previous attribute */
+    err = _xml_encode_finish_attribute(xml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* attribute name */
+    XML_ENCODE_APPEND_CHAR(' ');
+    XML_ENCODE_APPEND_TEXT(name, name_length);
+    XML_ENCODE_APPEND_CHAR('=');
+    XML_ENCODE_APPEND_CHAR('\"');
+
+    xml_encoder->flags |= XML_ENCODE_FLAG_ATTRIBUTE;
+
+    return ELIBC_SUCCESS;
+}
+
+int xml_encode_attribute_value(xml_encoder_t* xml_encoder, const char* value, size_t value_length)
+{
+    int err;
+
+    /* check state */
+    err = _xml_encode_validate_state(xml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* check input */
+    EASSERT(value || value_length == 0);
+    if(value == 0 && value_length > 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* value must follow attribute name */
+    if((xml_encoder->flags & XML_ENCODE_FLAG_ATTRIBUTE) == 0)
+    {
+        ETRACE("xml_encoder: attribute value must follow attribute name");
+        return ELIBC_ERROR_INVALID_STATE;
+    }
+
+    /* value can be set in several parts */
+    return _xml_encode_escaped(xml_encoder, value, value_length, ELIBC_TRUE);
+}
+
+int xml_encode_content(xml_encoder_t* xml_encoder, const char* content, size_t content_length)
+{
+    int err;
+
+    /* check state */
+    err = _xml_encode_validate_state(xml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* check input */
+    EASSERT(content || content_length == 0);
+    if(content == 0 && content_length > 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* finish tag begin */
+    err = _xml_encode_content_begin(xml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return _xml_encode_escaped(xml_encoder, content, content_length, ELIBC_FALSE);
+}
+
+int xml_encode_entity(xml_encoder_t* xml_encoder, euint32_t entity)
+{
+    char* number_str;
+    int err;
+
+    /* check state */
+    err = _xml_encode_validate_state(xml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* entity may be part of attribute value or content */
+    if((xml_encoder->flags & XML_ENCODE_FLAG_ATTRIBUTE) == 0)
+    {
+        err = _xml_encode_content_begin(xml_encoder);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    XML_ENCODE_APPEND_CHAR('&');
+    XML_ENCODE_APPEND_CHAR('#');
+
+    /* reserve space and format directly to buffer */
+    number_str = ebuffer_append_ptr(xml_encoder->encode_buffer, TEXT_NUMBER_BUFFER_SIZE);
+    if(number_str == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    err = ebuffer_setpos(xml_encoder->encode_buffer,
+        ebuffer_pos(xml_encoder->encode_buffer) - TEXT_NUMBER_BUFFER_SIZE + uint32_to_str(entity, number_str));
+    if(err != ELIBC_SUCCESS) return err;
+
+    XML_ENCODE_APPEND_CHAR(';');
+
+    return ELIBC_SUCCESS;
 }
 
 /*----------------------------------------------------------------------*/
@@ -11,7 +11,9 @@
 typedef struct {
 
     estack_t                state_stack;
+    ebuffer_t               name_buffer;
     ebuffer_t*              encode_buffer;
+    unsigned short          flags;
 
 } xml_encoder_t;
 
@@ -22,6 +24,14 @@ void    xml_encode_init(xml_encoder_t* xml_encoder);
 void    xml_encode_reset(xml_encoder_t* xml_encoder);
 void    xml_encode_close(xml_encoder_t* xml_encoder);
 
+/*
+    NOTE: - xml has no arrays, array is encoded as tag containing its items
+          - tag begin is finished only when tag content is added, so attributes
+            can be added until then and tags without content are encoded as "<tag/>"
+          - encoder keeps no references to data in encode_buffer, so encoded data
+            can be consumed and buffer reset at any point
+*/
+
 /* encode xml content */
 int     xml_encode_begin(xml_encoder_t* xml_encoder, ebuffer_t* encode_buffer);
 int     xml_encode_object_begin(xml_encoder_t* xml_encoder, const char* name);
@@ -32,6 +42,19 @@ int     xml_encode_value_tag(xml_encoder_t* xml_encoder, const http_param_t* htt
 int     xml_encode_value_attribute(xml_encoder_t* xml_encoder, const http_param_t* http_param);
 int     xml_encode_end(xml_encoder_t* xml_encoder);
 
+/*
+    NOTE: strings are escaped if needed, entity is added to attribute value
+          if attribute is not finished yet or to tag content otherwise
+*/
+
+/* encode xml stream */
+int     xml_encode_tag_begin(xml_encoder_t* xml_encoder, const char* name, size_t name_length);
+int     xml_encode_tag_end(xml_encoder_t* xml_encoder);
+int     xml_encode_attribute_begin(xml_encoder_t* xml_encoder, const char* name, size_t name_length);
+int     xml_encode_attribute_value(xml_encoder_t* xml_encoder, const char* value, size_t value_length);
+int     xml_encode_content(xml_encoder_t* xml_encoder, const char* content, size_t content_length);
+int     xml_encode_entity(xml_encoder_t* xml_encoder, euint32_t entity);
+
 /*----------------------------------------------------------------------*/
 
 #endif /* _XML_ENCODE_H_ */
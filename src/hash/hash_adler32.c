@@ -0,0 +1,288 @@
+/*
+    Adler-32 checksum
+*/
+
+#include "../elib_config.h"
+
+#include "hash_adler32.h"
+
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+#include <immintrin.h>
+#endif
+
+/*----------------------------------------------------------------------*/
+
+/* largest prime smaller than 65536 */
+#define ADLER32_BASE                65521
+
+/* largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1 */
+#define ADLER32_NMAX                5552
+
+/* SIMD block size and the largest number of blocks between reductions */
+#define ADLER32_BLOCK_SIZE          32
+#define ADLER32_BLOCKS_MAX          (ADLER32_NMAX / ADLER32_BLOCK_SIZE)
+
+/* update (adler, data, data size) */
+typedef euint32_t (*adler32_update_t)(euint32_t, const euint8_t*, size_t);
+
+/*----------------------------------------------------------------------*/
+/* portable */
+
+#define ADLER32_DO1(data, idx)  s1 += (data)[idx]; s2 += s1;
+#define ADLER32_DO4(data, idx)  ADLER32_DO1(data, idx); ADLER32_DO1(data, idx + 1); ADLER32_DO1(data, idx + 2); ADLER32_DO1(data, idx + 3);
+#define ADLER32_DO16(data)      ADLER32_DO4(data, 0); ADLER32_DO4(data, 4); ADLER32_DO4(data, 8); ADLER32_DO4(data, 12);
+
+euint32_t _adler32_update_portable(euint32_t adler, const euint8_t* data, size_t data_size)
+{
+    euint32_t s1 = adler & 0xFFFF;
+    euint32_t s2 = adler >> 16;
+    size_t count;
+
+    while(data_size > 0)
+    {
+        /* sums can not overflow before reduction */
+        count = (data_size < ADLER32_NMAX) ? data_size : ADLER32_NMAX;
+        data_size -= count;
+
+        for( ; count >= 16; count -= 16, data += 16)
+        {
+            ADLER32_DO16(data);
+        }
+
+        for( ; count > 0; --count, ++data)
+        {
+            ADLER32_DO1(data, 0);
+        }
+
+        s1 %= ADLER32_BASE;
+        s2 %= ADLER32_BASE;
+    }
+
+    return (s2 << 16) | s1;
+}
+
+/*----------------------------------------------------------------------*/
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+
+/*
+    For every 32 bytes block s2 receives 32 * s1 plus bytes weighted 32..1 and s1
+    receives sum of bytes. Sum of s1 before each block is kept separately and
+    multiplied by 32 once per reduction. Tail shorter than block is portable.
+*/
+
+ELIBC_TARGET("ssse3")
+euint32_t _adler32_update_ssse3(euint32_t adler, const euint8_t* data, size_t data_size)
+{
+    euint32_t s1 = adler & 0xFFFF;
+    euint32_t s2 = adler >> 16;
+    __m128i v_s1, v_s2, v_ps, bytes0, bytes1;
+    __m128i weights0, weights1, ones, zero;
+    size_t blocks, count;
+
+    weights0 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    weights1 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    ones = _mm_set1_epi16(1);
+    zero = _mm_setzero_si128();
+
+    blocks = data_size / ADLER32_BLOCK_SIZE;
+    data_size -= blocks * ADLER32_BLOCK_SIZE;
+
+    while(blocks > 0)
+    {
+        count = (blocks < ADLER32_BLOCKS_MAX) ? blocks : ADLER32_BLOCKS_MAX;
+        blocks -= count;
+
+        v_ps = _mm_cvtsi32_si128((int)(s1 * count));
+        v_s2 = _mm_cvtsi32_si128((int)s2);
+        v_s1 = zero;
+
+        for( ; count > 0; --count, data += ADLER32_BLOCK_SIZE)
+        {
+            bytes0 = _mm_loadu_si128((const __m128i*)(data + 0));
+            bytes1 = _mm_loadu_si128((const __m128i*)(data + 16));
+
+            v_ps = _mm_add_epi32(v_ps, v_s1);
+            v_s1 = _mm_add_epi32(v_s1, _mm_add_epi32(_mm_sad_epu8(bytes0, zero), _mm_sad_epu8(bytes1, zero)));
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes0, weights0), ones));
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, weights1), ones));
+        }
+
+        v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+        /* horizontal sums */
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, 0x4E));
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, 0xB1));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, 0x4E));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, 0xB1));
+
+        s1 = (s1 + (euint32_t)_mm_cvtsi128_si32(v_s1)) % ADLER32_BASE;
+        s2 = (euint32_t)_mm_cvtsi128_si32(v_s2) % ADLER32_BASE;
+    }
+
+    return _adler32_update_portable((s2 << 16) | s1, data, data_size);
+}
+
+ELIBC_TARGET("avx2")
+euint32_t _adler32_update_avx2(euint32_t adler, const euint8_t* data, size_t data_size)
+{
+    euint32_t s1 = adler & 0xFFFF;
+    euint32_t s2 = adler >> 16;
+    __m256i v_s1, v_s2, v_ps, bytes, weights, ones, zero;
+    __m128i sum1, sum2;
+    size_t blocks, count;
+
+    weights = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+                               16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    ones = _mm256_set1_epi16(1);
+    zero = _mm256_setzero_si256();
+
+    blocks = data_size / ADLER32_BLOCK_SIZE;
+    data_size -= blocks * ADLER32_BLOCK_SIZE;
+
+    while(blocks > 0)
+    {
+        count = (blocks < ADLER32_BLOCKS_MAX) ? blocks : ADLER32_BLOCKS_MAX;
+        blocks -= count;
+
+        v_ps = _mm256_setr_epi32((int)(s1 * count), 0, 0, 0, 0, 0, 0, 0);
+        v_s2 = _mm256_setr_epi32((int)s2, 0, 0, 0, 0, 0, 0, 0);
+        v_s1 = zero;
+
+        for( ; count > 0; --count, data += ADLER32_BLOCK_SIZE)
+        {
+            bytes = _mm256_loadu_si256((const __m256i*)data);
+
+            v_ps = _mm256_add_epi32(v_ps, v_s1);
+            v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));
+            v_s2 = _mm256_add_epi32(v_s2, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, weights), ones));
+        }
+
+        v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 5));
+
+        /* horizontal sums */
+        sum1 = _mm_add_epi32(_mm256_castsi256_si128(v_s1), _mm256_extracti128_si256(v_s1, 1));
+        sum2 = _mm_add_epi32(_mm256_castsi256_si128(v_s2), _mm256_extracti128_si256(v_s2, 1));
+        sum1 = _mm_add_epi32(sum1, _mm_shuffle_epi32(sum1, 0x4E));
+        sum1 = _mm_add_epi32(sum1, _mm_shuffle_epi32(sum1, 0xB1));
+        sum2 = _mm_add_epi32(sum2, _mm_shuffle_epi32(sum2, 0x4E));
+        sum2 = _mm_add_epi32(sum2, _mm_shuffle_epi32(sum2, 0xB1));
+
+        s1 = (s1 + (euint32_t)_mm_cvtsi128_si32(sum1)) % ADLER32_BASE;
+        s2 = (euint32_t)_mm_cvtsi128_si32(sum2) % ADLER32_BASE;
+    }
+
+    return _adler32_update_portable((s2 << 16) | s1, data, data_size);
+}
+
+#endif /* _ELIBC_ARCH_X86 */
+
+/*----------------------------------------------------------------------*/
+/* implementation selection */
+
+static adler32_update_t _adler32_update = 0;
+static hash_adler32_impl_t _adler32_impl = hash_adler32_impl_auto;
+
+/* get update function or zero if not supported */
+adler32_update_t _adler32_find_update(hash_adler32_impl_t adler32_impl)
+{
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+    unsigned int features = esystem_cpu_features();
+
+    switch(adler32_impl)
+    {
+    case hash_adler32_impl_ssse3:
+        if(features & ESYSTEM_CPU_SSSE3) return _adler32_update_ssse3;
+        break;
+
+    case hash_adler32_impl_avx2:
+        if(features & ESYSTEM_CPU_AVX2) return _adler32_update_avx2;
+        break;
+
+    default:
+        break;
+    }
+#endif /* _ELIBC_ARCH_X86 */
+
+    return (adler32_impl == hash_adler32_impl_portable) ? _adler32_update_portable : 0;
+}
+
+adler32_update_t _adler32_get_update()
+{
+    /* select best implementation on first use */
+    if(_adler32_update == 0) hash_adler32_set_impl(hash_adler32_impl_auto);
+
+    return _adler32_update;
+}
+
+/*----------------------------------------------------------------------*/
+
+/* implementation selection */
+int hash_adler32_set_impl(hash_adler32_impl_t adler32_impl)
+{
+    adler32_update_t adler32_update;
+
+    /* select the fastest supported implementation */
+    if(adler32_impl == hash_adler32_impl_auto)
+    {
+        adler32_impl = hash_adler32_impl_avx2;
+        while((adler32_update = _adler32_find_update(adler32_impl)) == 0)
+        {
+            adler32_impl = (hash_adler32_impl_t)(adler32_impl - 1);
+        }
+
+    } else
+    {
+        adler32_update = _adler32_find_update(adler32_impl);
+        if(adler32_update == 0) return ELIBC_ERROR_NOT_SUPPORTED;
+    }
+
+    _adler32_update = adler32_update;
+    _adler32_impl = adler32_impl;
+
+    return ELIBC_SUCCESS;
+}
+
+hash_adler32_impl_t hash_adler32_get_impl()
+{
+    /* make sure implementation is selected */
+    _adler32_get_update();
+
+    return _adler32_impl;
+}
+
+/* checksum binary data */
+void hash_adler32_begin(adler32_context_t* adler32_context)
+{
+    EASSERT(adler32_context);
+    if(adler32_context == 0) return;
+
+    adler32_context->adler = 1;
+}
+
+void hash_adler32_update(adler32_context_t* adler32_context, const euint8_t* data, size_t data_size)
+{
+    EASSERT(adler32_context);
+    EASSERT(data || data_size == 0);
+    if(adler32_context == 0 || data == 0 || data_size == 0) return;
+
+    adler32_context->adler = _adler32_get_update()(adler32_context->adler, data, data_size);
+}
+
+euint32_t hash_adler32_end(const adler32_context_t* adler32_context)
+{
+    EASSERT(adler32_context);
+    if(adler32_context == 0) return 1;
+
+    return adler32_context->adler;
+}
+
+/* checksum data in single run */
+euint32_t hash_adler32(const euint8_t* data, size_t data_size)
+{
+    EASSERT(data || data_size == 0);
+    if(data == 0 || data_size == 0) return 1;
+
+    return _adler32_get_update()(1, data, data_size);
+}
+
+/*----------------------------------------------------------------------*/
@@ -0,0 +1,54 @@
+/*
+    Adler-32 checksum
+*/
+
+#ifndef _HASH_ADLER32_H_
+#define _HASH_ADLER32_H_
+
+/*
+    Adler-32 as used in zlib stream framing, for details refer to
+    RFC1950: http://tools.ietf.org/html/rfc1950
+*/
+
+/*----------------------------------------------------------------------*/
+
+/* context */
+typedef struct
+{
+    euint32_t   adler;
+
+} adler32_context_t;
+
+/* implementations */
+typedef enum
+{
+    hash_adler32_impl_auto,
+    hash_adler32_impl_portable,
+    hash_adler32_impl_ssse3,
+    hash_adler32_impl_avx2
+
+} hash_adler32_impl_t;
+
+/*----------------------------------------------------------------------*/
+
+/*
+    NOTE: the fastest implementation supported by cpu is selected on first use,
+          selecting it manually is only needed for testing and benchmarking
+*/
+
+/* implementation selection */
+int hash_adler32_set_impl(hash_adler32_impl_t adler32_impl);
+hash_adler32_impl_t hash_adler32_get_impl();
+
+/* checksum binary data */
+void hash_adler32_begin(adler32_context_t* adler32_context);
+void hash_adler32_update(adler32_context_t* adler32_context, const euint8_t* data, size_t data_size);
+euint32_t hash_adler32_end(const adler32_context_t* adler32_context);
+
+/* checksum data in single run */
+euint32_t hash_adler32(const euint8_t* data, size_t data_size);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _HASH_ADLER32_H_ */
+
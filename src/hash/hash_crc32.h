@@ -0,0 +1,65 @@
+/*
+    CRC32 and CRC32C checksums
+*/
+
+#ifndef _HASH_CRC32_H_
+#define _HASH_CRC32_H_
+
+/*
+    CRC32 uses IEEE 802.3 polynomial (zlib, gzip, png), CRC32C uses Castagnoli
+    polynomial (iSCSI, SCTP, ext4). Both are bit reflected with inverted
+    initial and final values, so results match zlib crc32() and SSE4.2 crc32.
+
+    Large buffers are folded with PCLMULQDQ as described in "Fast CRC Computation
+    for Generic Polynomials Using PCLMULQDQ Instruction" (Intel, 2009),
+    CRC32C tail is computed with SSE4.2 crc32 instruction.
+*/
+
+/*----------------------------------------------------------------------*/
+
+/* context (the same for both checksums) */
+typedef struct
+{
+    euint32_t   crc;
+
+} crc32_context_t;
+
+/* implementations */
+typedef enum
+{
+    hash_crc32_impl_auto,
+    hash_crc32_impl_portable,   /* slicing-by-8 tables */
+    hash_crc32_impl_sse42,      /* crc32 instruction (CRC32C only, CRC32 uses tables) */
+    hash_crc32_impl_pclmul      /* folding for buffers of 64 bytes and more */
+
+} hash_crc32_impl_t;
+
+/*----------------------------------------------------------------------*/
+
+/*
+    NOTE: the fastest implementation supported by cpu is selected on first use,
+          selecting it manually is only needed for testing and benchmarking
+*/
+
+/* implementation selection */
+int hash_crc32_set_impl(hash_crc32_impl_t crc32_impl);
+hash_crc32_impl_t hash_crc32_get_impl();
+
+/* CRC32 (IEEE) */
+void hash_crc32_begin(crc32_context_t* crc32_context);
+void hash_crc32_update(crc32_context_t* crc32_context, const euint8_t* data, size_t data_size);
+euint32_t hash_crc32_end(const crc32_context_t* crc32_context);
+
+euint32_t hash_crc32(const euint8_t* data, size_t data_size);
+
+/* CRC32C (Castagnoli) */
+void hash_crc32c_begin(crc32_context_t* crc32_context);
+void hash_crc32c_update(crc32_context_t* crc32_context, const euint8_t* data, size_t data_size);
+euint32_t hash_crc32c_end(const crc32_context_t* crc32_context);
+
+euint32_t hash_crc32c(const euint8_t* data, size_t data_size);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _HASH_CRC32_H_ */
+
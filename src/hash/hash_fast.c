@@ -0,0 +1,655 @@
+/*
+    Fast non cryptographic hash functions
+*/
+
+#include "../elib_config.h"
+
+#include "hash_fast.h"
+
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+/*----------------------------------------------------------------------*/
+
+/* mixing constants */
+#define HASH_FAST_P0                ((euint64_t)0xa0761d6478bd642fULL)
+#define HASH_FAST_P1                ((euint64_t)0xe7037ed1a0b428dbULL)
+#define HASH_FAST_P2                ((euint64_t)0x8ebc6af09c88c6e3ULL)
+#define HASH_FAST_P3                ((euint64_t)0x589965cc75374cc3ULL)
+#define HASH_FAST_AVALANCHE         ((euint64_t)0x165667919e3779f9ULL)
+#define HASH_FAST_SCRAMBLE          0x9e3779b1U
+
+/* inputs up to this size are hashed with short path */
+#define HASH_FAST_SHORT_MAX                 240
+
+/* long input layout (secret offsets are in bytes) */
+#define HASH_FAST_STRIPES_PER_BLOCK         ((HASH_FAST_SECRET_SIZE - HASH_FAST_STRIPE_SIZE) / 8)
+#define HASH_FAST_SCRAMBLE_OFFSET           (HASH_FAST_SECRET_SIZE - HASH_FAST_STRIPE_SIZE)
+#define HASH_FAST_LAST_STRIPE_OFFSET        (HASH_FAST_SECRET_SIZE - HASH_FAST_STRIPE_SIZE - 7)
+#define HASH_FAST_MERGE_OFFSET_LOW          11
+#define HASH_FAST_MERGE_OFFSET_HIGH         (HASH_FAST_SECRET_SIZE - HASH_FAST_STRIPE_SIZE - 11)
+
+/* default secret (splitmix64 output), seeded secret is derived from it */
+static const euint8_t _hash_fast_secret[HASH_FAST_SECRET_SIZE] = {
+    0x20, 0x9d, 0x78, 0x48, 0x2e, 0xdb, 0xd2, 0x0b, 0xa8, 0x50, 0xb5, 0x43, 0xc5, 0x1b, 0x62, 0x7c,
+    0x46, 0xde, 0x13, 0x9e, 0x63, 0x10, 0x74, 0xb2, 0xe5, 0x69, 0xb5, 0x14, 0x17, 0xeb, 0xc4, 0xd3,
+    0x39, 0xda, 0xed, 0x66, 0x22, 0xbe, 0xc8, 0x9f, 0x30, 0xbe, 0xe4, 0xeb, 0xce, 0x4a, 0x1e, 0x49,
+    0xb0, 0xbe, 0x70, 0x95, 0x1a, 0xfb, 0x0a, 0x18, 0x50, 0x29, 0x8d, 0x87, 0x37, 0x45, 0x45, 0xca,
+    0x78, 0x54, 0x04, 0x28, 0xc8, 0x98, 0x6a, 0xa9, 0xf5, 0x5b, 0xe1, 0xc8, 0x20, 0xb9, 0xa4, 0xa4,
+    0x11, 0x31, 0x68, 0xba, 0x2f, 0xd9, 0x09, 0xae, 0x64, 0x20, 0xa3, 0x76, 0x48, 0xe0, 0xef, 0x1d,
+    0x5f, 0xa9, 0xf3, 0xe5, 0xed, 0x0c, 0x83, 0x1b, 0x7f, 0x29, 0xd3, 0x3d, 0x1f, 0xa3, 0x45, 0x5d,
+    0x8e, 0xa1, 0xad, 0xb9, 0x03, 0xfd, 0x37, 0x1b, 0x49, 0xf1, 0x33, 0x40, 0x75, 0xd3, 0xca, 0xa9,
+    0xd1, 0x09, 0xdf, 0xc2, 0xb3, 0x59, 0xbe, 0x2b, 0x84, 0xa9, 0xfb, 0x97, 0x4b, 0x60, 0x1f, 0xc0,
+    0xf5, 0x10, 0xc9, 0x10, 0x54, 0x32, 0xd0, 0xda, 0xf9, 0xad, 0xdb, 0x8b, 0xdd, 0xe5, 0x77, 0x06,
+    0x36, 0x3b, 0xbc, 0x44, 0xfd, 0xab, 0xc9, 0x2b, 0xef, 0x2c, 0x74, 0x12, 0x23, 0x10, 0xcf, 0x08,
+    0x3d, 0x83, 0x95, 0x0c, 0x65, 0xf4, 0x5c, 0x49, 0x37, 0xbc, 0x41, 0xe0, 0xef, 0x61, 0x89, 0x28
+};
+
+/* accumulate stripes (acc, data, number of 64 bytes stripes, secret for the first stripe) */
+typedef void (*hash_fast_accumulate_t)(euint64_t*, const euint8_t*, size_t, const euint8_t*);
+
+/*----------------------------------------------------------------------*/
+/* helpers */
+
+/* little endian reads and writes (also handle unaligned data) */
+ELIBC_FORCE_INLINE euint64_t _hash_fast_read64(const euint8_t* data)
+{
+#ifdef ELIBC_BIG_ENDIAN
+    return ((euint64_t)data[0]) | ((euint64_t)data[1] << 8) | ((euint64_t)data[2] << 16) | ((euint64_t)data[3] << 24) |
+           ((euint64_t)data[4] << 32) | ((euint64_t)data[5] << 40) | ((euint64_t)data[6] << 48) | ((euint64_t)data[7] << 56);
+#else
+    euint64_t value;
+    ememcpy(&value, data, sizeof(value));
+    return value;
+#endif /* ELIBC_BIG_ENDIAN */
+}
+
+ELIBC_FORCE_INLINE euint64_t _hash_fast_read32(const euint8_t* data)
+{
+#ifdef ELIBC_BIG_ENDIAN
+    return ((euint64_t)data[0]) | ((euint64_t)data[1] << 8) | ((euint64_t)data[2] << 16) | ((euint64_t)data[3] << 24);
+#else
+    euint32_t value;
+    ememcpy(&value, data, sizeof(value));
+    return value;
+#endif /* ELIBC_BIG_ENDIAN */
+}
+
+ELIBC_FORCE_INLINE void _hash_fast_write64(euint8_t* data, euint64_t value)
+{
+#ifdef ELIBC_BIG_ENDIAN
+    int idx;
+    for(idx = 0; idx < 8; ++idx) data[idx] = (euint8_t)(value >> (8 * idx));
+#else
+    ememcpy(data, &value, sizeof(value));
+#endif /* ELIBC_BIG_ENDIAN */
+}
+
+/* 64x64->128 bit multiplication, a receives low and b high part */
+ELIBC_FORCE_INLINE void _hash_fast_mum(euint64_t* a, euint64_t* b)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = (unsigned __int128)*a * *b;
+    *a = (euint64_t)product;
+    *b = (euint64_t)(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    *a = _umul128(*a, *b, b);
+#else
+    euint64_t ha = *a >> 32, hb = *b >> 32, la = (euint32_t)*a, lb = (euint32_t)*b;
+    euint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    euint64_t tmp = rl + (rm0 << 32);
+    euint64_t carry = (tmp < rl);
+    euint64_t low = tmp + (rm1 << 32);
+    carry += (low < tmp);
+    *a = low;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+}
+
+ELIBC_FORCE_INLINE euint64_t _hash_fast_mix(euint64_t a, euint64_t b)
+{
+    _hash_fast_mum(&a, &b);
+    return a ^ b;
+}
+
+ELIBC_FORCE_INLINE euint64_t _hash_fast_avalanche(euint64_t hash)
+{
+    hash ^= hash >> 37;
+    hash *= HASH_FAST_AVALANCHE;
+    return hash ^ (hash >> 32);
+}
+
+/*----------------------------------------------------------------------*/
+/* short inputs */
+
+euint64_t _hash_fast_short(const euint8_t* data, size_t data_size, euint64_t seed)
+{
+    euint64_t a, b, seed1, seed2;
+    size_t size_left;
+
+    seed ^= _hash_fast_mix(seed ^ HASH_FAST_P0, HASH_FAST_P1);
+
+    if(data_size <= 16)
+    {
+        if(data_size >= 4)
+        {
+            /* two (possibly overlapping) 32 bits reads from each end */
+            a = (_hash_fast_read32(data) << 32) | _hash_fast_read32(data + ((data_size >> 3) << 2));
+            b = (_hash_fast_read32(data + data_size - 4) << 32) | _hash_fast_read32(data + data_size - 4 - ((data_size >> 3) << 2));
+
+        } else if(data_size > 0)
+        {
+            a = ((euint64_t)data[0] << 16) | ((euint64_t)data[data_size >> 1] << 8) | data[data_size - 1];
+            b = 0;
+
+        } else
+        {
+            a = b = 0;
+        }
+
+    } else
+    {
+        size_left = data_size;
+
+        /* three independent chains */
+        if(size_left > 48)
+        {
+            seed1 = seed2 = seed;
+            do
+            {
+                seed = _hash_fast_mix(_hash_fast_read64(data) ^ HASH_FAST_P1, _hash_fast_read64(data + 8) ^ seed);
+                seed1 = _hash_fast_mix(_hash_fast_read64(data + 16) ^ HASH_FAST_P2, _hash_fast_read64(data + 24) ^ seed1);
+                seed2 = _hash_fast_mix(_hash_fast_read64(data + 32) ^ HASH_FAST_P3, _hash_fast_read64(data + 40) ^ seed2);
+
+                data += 48;
+                size_left -= 48;
+
+            } while(size_left > 48);
+
+            seed ^= seed1 ^ seed2;
+        }
+
+        while(size_left > 16)
+        {
+            seed = _hash_fast_mix(_hash_fast_read64(data) ^ HASH_FAST_P1, _hash_fast_read64(data + 8) ^ seed);
+
+            data += 16;
+            size_left -= 16;
+        }
+
+        /* last 16 bytes (may overlap already mixed data) */
+        a = _hash_fast_read64(data + size_left - 16);
+        b = _hash_fast_read64(data + size_left - 8);
+    }
+
+    a ^= HASH_FAST_P1;
+    b ^= seed;
+    _hash_fast_mum(&a, &b);
+
+    return _hash_fast_mix(a ^ HASH_FAST_P0 ^ (euint64_t)data_size, b ^ HASH_FAST_P1);
+}
+
+void _hash_fast_short128(const euint8_t* data, size_t data_size, euint64_t seed, hash_fast128_t* hash_out)
+{
+    /* two hashes with independent seeds */
+    hash_out->low = _hash_fast_short(data, data_size, seed);
+    hash_out->high = _hash_fast_short(data, data_size, seed ^ HASH_FAST_P2);
+}
+
+/*----------------------------------------------------------------------*/
+/* long inputs */
+
+/*
+    Every stripe updates 8 lanes:
+        acc[i ^ 1] += data[i]
+        acc[i] += low32(data[i] ^ secret[i]) * high32(data[i] ^ secret[i])
+    secret is shifted by 8 bytes for every stripe, after 16 stripes (block)
+    lanes are scrambled with the last 64 bytes of secret.
+*/
+
+void _hash_fast_accumulate_portable(euint64_t* acc, const euint8_t* data, size_t stripes, const euint8_t* secret)
+{
+    euint64_t value, key;
+    int idx;
+
+    for( ; stripes > 0; --stripes, data += HASH_FAST_STRIPE_SIZE, secret += 8)
+    {
+        for(idx = 0; idx < 8; ++idx)
+        {
+            value = _hash_fast_read64(data + 8 * idx);
+            key = value ^ _hash_fast_read64(secret + 8 * idx);
+
+            acc[idx ^ 1] += value;
+            acc[idx] += (key & 0xFFFFFFFF) * (key >> 32);
+        }
+    }
+}
+
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD) && !defined(ELIBC_BIG_ENDIAN)
+
+/* lanes swap within 128 bits is the same as acc[i ^ 1] */
+#define HASH_FAST_SSE2_ACCUMULATE(acc_vec, offset)                                              \
+    value = _mm_loadu_si128((const __m128i*)(data + offset));                                   \
+    key = _mm_xor_si128(value, _mm_loadu_si128((const __m128i*)(secret + offset)));             \
+    key = _mm_mul_epu32(key, _mm_srli_epi64(key, 32));                                          \
+    acc_vec = _mm_add_epi64(acc_vec, _mm_add_epi64(key, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2))));
+
+#define HASH_FAST_AVX2_ACCUMULATE(acc_vec, offset)                                              \
+    value = _mm256_loadu_si256((const __m256i*)(data + offset));                                \
+    key = _mm256_xor_si256(value, _mm256_loadu_si256((const __m256i*)(secret + offset)));       \
+    key = _mm256_mul_epu32(key, _mm256_srli_epi64(key, 32));                                    \
+    acc_vec = _mm256_add_epi64(acc_vec, _mm256_add_epi64(key, _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2))));
+
+ELIBC_TARGET("sse2")
+void _hash_fast_accumulate_sse2(euint64_t* acc, const euint8_t* data, size_t stripes, const euint8_t* secret)
+{
+    __m128i acc0, acc1, acc2, acc3, value, key;
+
+    acc0 = _mm_loadu_si128((const __m128i*)(acc + 0));
+    acc1 = _mm_loadu_si128((const __m128i*)(acc + 2));
+    acc2 = _mm_loadu_si128((const __m128i*)(acc + 4));
+    acc3 = _mm_loadu_si128((const __m128i*)(acc + 6));
+
+    for( ; stripes > 0; --stripes, data += HASH_FAST_STRIPE_SIZE, secret += 8)
+    {
+        HASH_FAST_SSE2_ACCUMULATE(acc0, 0);
+        HASH_FAST_SSE2_ACCUMULATE(acc1, 16);
+        HASH_FAST_SSE2_ACCUMULATE(acc2, 32);
+        HASH_FAST_SSE2_ACCUMULATE(acc3, 48);
+    }
+
+    _mm_storeu_si128((__m128i*)(acc + 0), acc0);
+    _mm_storeu_si128((__m128i*)(acc + 2), acc1);
+    _mm_storeu_si128((__m128i*)(acc + 4), acc2);
+    _mm_storeu_si128((__m128i*)(acc + 6), acc3);
+}
+
+ELIBC_TARGET("avx2")
+void _hash_fast_accumulate_avx2(euint64_t* acc, const euint8_t* data, size_t stripes, const euint8_t* secret)
+{
+    __m256i acc0, acc1, value, key;
+
+    acc0 = _mm256_loadu_si256((const __m256i*)(acc + 0));
+    acc1 = _mm256_loadu_si256((const __m256i*)(acc + 4));
+
+    for( ; stripes > 0; --stripes, data += HASH_FAST_STRIPE_SIZE, secret += 8)
+    {
+        HASH_FAST_AVX2_ACCUMULATE(acc0, 0);
+        HASH_FAST_AVX2_ACCUMULATE(acc1, 32);
+    }
+
+    _mm256_storeu_si256((__m256i*)(acc + 0), acc0);
+    _mm256_storeu_si256((__m256i*)(acc + 4), acc1);
+}
+
+#endif /* _ELIBC_ARCH_X86 */
+
+/* scramble is done once per block, so it is scalar for all implementations */
+void _hash_fast_scramble(euint64_t* acc, const euint8_t* secret)
+{
+    int idx;
+
+    for(idx = 0; idx < 8; ++idx)
+    {
+        acc[idx] ^= acc[idx] >> 47;
+        acc[idx] ^= _hash_fast_read64(secret + 8 * idx);
+        acc[idx] *= HASH_FAST_SCRAMBLE;
+    }
+}
+
+/*----------------------------------------------------------------------*/
+/* implementation selection */
+
+static hash_fast_accumulate_t _hash_fast_accumulate = 0;
+static hash_fast_impl_t _hash_fast_impl = hash_fast_impl_auto;
+
+/* get accumulate function or zero if not supported */
+hash_fast_accumulate_t _hash_fast_find_accumulate(hash_fast_impl_t fast_impl)
+{
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD) && !defined(ELIBC_BIG_ENDIAN)
+    unsigned int features = esystem_cpu_features();
+
+    switch(fast_impl)
+    {
+    case hash_fast_impl_sse2:
+        if(features & ESYSTEM_CPU_SSE2) return _hash_fast_accumulate_sse2;
+        break;
+
+    case hash_fast_impl_avx2:
+        if(features & ESYSTEM_CPU_AVX2) return _hash_fast_accumulate_avx2;
+        break;
+
+    default:
+        break;
+    }
+#endif /* _ELIBC_ARCH_X86 */
+
+    return (fast_impl == hash_fast_impl_portable) ? _hash_fast_accumulate_portable : 0;
+}
+
+hash_fast_accumulate_t _hash_fast_get_accumulate()
+{
+    /* select best implementation on first use */
+    if(_hash_fast_accumulate == 0) hash_fast_set_impl(hash_fast_impl_auto);
+
+    return _hash_fast_accumulate;
+}
+
+/*----------------------------------------------------------------------*/
+
+void _hash_fast_init_acc(euint64_t* acc)
+{
+    acc[0] = 0xc2b2ae3dULL;
+    acc[1] = HASH_FAST_P0;
+    acc[2] = HASH_FAST_P1;
+    acc[3] = HASH_FAST_P2;
+    acc[4] = HASH_FAST_P3;
+    acc[5] = 0x85ebca77ULL;
+    acc[6] = 0x27d4eb2f165667c5ULL;
+    acc[7] = 0x9e3779b1ULL;
+}
+
+void _hash_fast_init_secret(euint8_t* secret, euint64_t seed)
+{
+    size_t idx;
+
+    /* seed is added to even and subtracted from odd words */
+    for(idx = 0; idx < HASH_FAST_SECRET_SIZE; idx += 16)
+    {
+        _hash_fast_write64(secret + idx, _hash_fast_read64(_hash_fast_secret + idx) + seed);
+        _hash_fast_write64(secret + idx + 8, _hash_fast_read64(_hash_fast_secret + idx + 8) - seed);
+    }
+}
+
+/* accumulate stripes in blocks and scramble after each full block, returns stripe index in block */
+size_t _hash_fast_consume(euint64_t* acc, size_t stripe_idx, const euint8_t* data, size_t stripes,
+                          const euint8_t* secret, hash_fast_accumulate_t accumulate)
+{
+    size_t count;
+
+    while(stripes > 0)
+    {
+        count = HASH_FAST_STRIPES_PER_BLOCK - stripe_idx;
+        if(count > stripes) count = stripes;
+
+        accumulate(acc, data, count, secret + 8 * stripe_idx);
+
+        data += count * HASH_FAST_STRIPE_SIZE;
+        stripes -= count;
+        stripe_idx += count;
+
+        if(stripe_idx == HASH_FAST_STRIPES_PER_BLOCK)
+        {
+            _hash_fast_scramble(acc, secret + HASH_FAST_SCRAMBLE_OFFSET);
+            stripe_idx = 0;
+        }
+    }
+
+    return stripe_idx;
+}
+
+euint64_t _hash_fast_merge(const euint64_t* acc, const euint8_t* secret, euint64_t hash)
+{
+    int idx;
+
+    for(idx = 0; idx < 4; ++idx)
+    {
+        hash += _hash_fast_mix(acc[2 * idx] ^ _hash_fast_read64(secret + 16 * idx),
+                               acc[2 * idx + 1] ^ _hash_fast_read64(secret + 16 * idx + 8));
+    }
+
+    return _hash_fast_avalanche(hash);
+}
+
+/* all stripes except the last one are consumed in blocks, the last one is always the last 64 bytes */
+void _hash_fast_long(const euint8_t* data, size_t data_size, const euint8_t* secret, euint64_t* acc)
+{
+    hash_fast_accumulate_t accumulate = _hash_fast_get_accumulate();
+
+    _hash_fast_init_acc(acc);
+    _hash_fast_consume(acc, 0, data, (data_size - 1) / HASH_FAST_STRIPE_SIZE, secret, accumulate);
+
+    accumulate(acc, data + data_size - HASH_FAST_STRIPE_SIZE, 1, secret + HASH_FAST_LAST_STRIPE_OFFSET);
+}
+
+/*----------------------------------------------------------------------*/
+
+/* long input implementation selection */
+int hash_fast_set_impl(hash_fast_impl_t fast_impl)
+{
+    hash_fast_accumulate_t fast_accumulate;
+
+    /* select the fastest supported implementation */
+    if(fast_impl == hash_fast_impl_auto)
+    {
+        fast_impl = hash_fast_impl_avx2;
+        while((fast_accumulate = _hash_fast_find_accumulate(fast_impl)) == 0)
+        {
+            fast_impl = (hash_fast_impl_t)(fast_impl - 1);
+        }
+
+    } else
+    {
+        fast_accumulate = _hash_fast_find_accumulate(fast_impl);
+        if(fast_accumulate == 0) return ELIBC_ERROR_NOT_SUPPORTED;
+    }
+
+    _hash_fast_accumulate = fast_accumulate;
+    _hash_fast_impl = fast_impl;
+
+    return ELIBC_SUCCESS;
+}
+
+hash_fast_impl_t hash_fast_get_impl()
+{
+    /* make sure implementation is selected */
+    _hash_fast_get_accumulate();
+
+    return _hash_fast_impl;
+}
+
+/* hash data in single run */
+euint64_t hash_fast64(const euint8_t* data, size_t data_size)
+{
+    return hash_fast64_seed(data, data_size, 0);
+}
+
+euint64_t hash_fast64_seed(const euint8_t* data, size_t data_size, euint64_t seed)
+{
+    euint8_t secret[HASH_FAST_SECRET_SIZE];
+    euint64_t acc[8];
+
+    EASSERT(data || data_size == 0);
+    if(data == 0 && data_size > 0) return 0;
+
+    if(data_size <= HASH_FAST_SHORT_MAX) return _hash_fast_short(data, data_size, seed);
+
+    if(seed == 0)
+    {
+        _hash_fast_long(data, data_size, _hash_fast_secret, acc);
+        return _hash_fast_merge(acc, _hash_fast_secret + HASH_FAST_MERGE_OFFSET_LOW, (euint64_t)data_size * HASH_FAST_P0);
+    }
+
+    _hash_fast_init_secret(secret, seed);
+    _hash_fast_long(data, data_size, secret, acc);
+
+    return _hash_fast_merge(acc, secret + HASH_FAST_MERGE_OFFSET_LOW, (euint64_t)data_size * HASH_FAST_P0);
+}
+
+void hash_fast128(const euint8_t* data, size_t data_size, hash_fast128_t* hash_out)
+{
+    hash_fast128_seed(data, data_size, 0, hash_out);
+}
+
+void hash_fast128_seed(const euint8_t* data, size_t data_size, euint64_t seed, hash_fast128_t* hash_out)
+{
+    euint8_t secret[HASH_FAST_SECRET_SIZE];
+    const euint8_t* secret_used;
+    euint64_t acc[8];
+
+    EASSERT(data || data_size == 0);
+    EASSERT(hash_out);
+    if((data == 0 && data_size > 0) || hash_out == 0) return;
+
+    if(data_size <= HASH_FAST_SHORT_MAX)
+    {
+        _hash_fast_short128(data, data_size, seed, hash_out);
+        return;
+    }
+
+    secret_used = _hash_fast_secret;
+    if(seed != 0)
+    {
+        _hash_fast_init_secret(secret, seed);
+        secret_used = secret;
+    }
+
+    _hash_fast_long(data, data_size, secret_used, acc);
+
+    hash_out->low = _hash_fast_merge(acc, secret_used + HASH_FAST_MERGE_OFFSET_LOW, (euint64_t)data_size * HASH_FAST_P0);
+    hash_out->high = _hash_fast_merge(acc, secret_used + HASH_FAST_MERGE_OFFSET_HIGH, ~((euint64_t)data_size * HASH_FAST_P1));
+}
+
+/*----------------------------------------------------------------------*/
+/* streaming */
+
+/* finish lanes with buffered data on a copy of context state */
+void _hash_fast_end_acc(const hash_fast_context_t* fast_context, euint64_t* acc)
+{
+    hash_fast_accumulate_t accumulate = _hash_fast_get_accumulate();
+    euint8_t last_stripe[HASH_FAST_STRIPE_SIZE];
+    size_t count;
+
+    ememcpy(acc, fast_context->acc, sizeof(fast_context->acc));
+
+    if(fast_context->buffer_size >= HASH_FAST_STRIPE_SIZE)
+    {
+        _hash_fast_consume(acc, fast_context->stripe_idx, fast_context->buffer,
+                           (fast_context->buffer_size - 1) / HASH_FAST_STRIPE_SIZE, fast_context->secret, accumulate);
+
+        accumulate(acc, fast_context->buffer + fast_context->buffer_size - HASH_FAST_STRIPE_SIZE, 1,
+                   fast_context->secret + HASH_FAST_LAST_STRIPE_OFFSET);
+
+    } else
+    {
+        /* last stripe starts in the end of previously consumed buffer */
+        count = HASH_FAST_STRIPE_SIZE - fast_context->buffer_size;
+        ememcpy(last_stripe, fast_context->buffer + HASH_FAST_BUFFER_SIZE - count, count);
+        ememcpy(last_stripe + count, fast_context->buffer, fast_context->buffer_size);
+
+        accumulate(acc, last_stripe, 1, fast_context->secret + HASH_FAST_LAST_STRIPE_OFFSET);
+    }
+}
+
+void hash_fast_begin(hash_fast_context_t* fast_context, euint64_t seed)
+{
+    EASSERT(fast_context);
+    if(fast_context == 0) return;
+
+    _hash_fast_init_acc(fast_context->acc);
+    _hash_fast_init_secret(fast_context->secret, seed);
+
+    fast_context->seed = seed;
+    fast_context->total_size = 0;
+    fast_context->stripe_idx = 0;
+    fast_context->buffer_size = 0;
+}
+
+void hash_fast_update(hash_fast_context_t* fast_context, const euint8_t* data, size_t data_size)
+{
+    hash_fast_accumulate_t accumulate;
+    size_t count;
+
+    EASSERT(fast_context);
+    EASSERT(data || data_size == 0);
+    if(fast_context == 0 || data == 0 || data_size == 0) return;
+
+    fast_context->total_size += data_size;
+
+    /* keep data in buffer until there is more than fits */
+    if(data_size <= HASH_FAST_BUFFER_SIZE - fast_context->buffer_size)
+    {
+        ememcpy(fast_context->buffer + fast_context->buffer_size, data, data_size);
+        fast_context->buffer_size += data_size;
+        return;
+    }
+
+    accumulate = _hash_fast_get_accumulate();
+
+    /* complete and consume buffer */
+    if(fast_context->buffer_size > 0)
+    {
+        count = HASH_FAST_BUFFER_SIZE - fast_context->buffer_size;
+        ememcpy(fast_context->buffer + fast_context->buffer_size, data, count);
+        data += count;
+        data_size -= count;
+
+        fast_context->stripe_idx = _hash_fast_consume(fast_context->acc, fast_context->stripe_idx, fast_context->buffer,
+                                                      HASH_FAST_BUFFER_SIZE / HASH_FAST_STRIPE_SIZE, fast_context->secret, accumulate);
+        fast_context->buffer_size = 0;
+    }
+
+    /* consume input directly, at least one byte is left for the last stripe */
+    if(data_size > HASH_FAST_BUFFER_SIZE)
+    {
+        count = (data_size - 1) / HASH_FAST_STRIPE_SIZE;
+
+        fast_context->stripe_idx = _hash_fast_consume(fast_context->acc, fast_context->stripe_idx, data,
+                                                      count, fast_context->secret, accumulate);
+
+        data += count * HASH_FAST_STRIPE_SIZE;
+        data_size -= count * HASH_FAST_STRIPE_SIZE;
+
+        /* last consumed stripe may be needed for the last stripe */
+        ememcpy(fast_context->buffer + HASH_FAST_BUFFER_SIZE - HASH_FAST_STRIPE_SIZE, data - HASH_FAST_STRIPE_SIZE, HASH_FAST_STRIPE_SIZE);
+    }
+
+    ememcpy(fast_context->buffer, data, data_size);
+    fast_context->buffer_size = data_size;
+}
+
+euint64_t hash_fast_end64(const hash_fast_context_t* fast_context)
+{
+    euint64_t acc[8];
+
+    EASSERT(fast_context);
+    if(fast_context == 0) return 0;
+
+    /* short input is still in buffer */
+    if(fast_context->total_size <= HASH_FAST_SHORT_MAX)
+    {
+        return _hash_fast_short(fast_context->buffer, (size_t)fast_context->total_size, fast_context->seed);
+    }
+
+    _hash_fast_end_acc(fast_context, acc);
+
+    return _hash_fast_merge(acc, fast_context->secret + HASH_FAST_MERGE_OFFSET_LOW, fast_context->total_size * HASH_FAST_P0);
+}
+
+void hash_fast_end128(const hash_fast_context_t* fast_context, hash_fast128_t* hash_out)
+{
+    euint64_t acc[8];
+
+    EASSERT(fast_context);
+    EASSERT(hash_out);
+    if(fast_context == 0 || hash_out == 0) return;
+
+    /* short input is still in buffer */
+    if(fast_context->total_size <= HASH_FAST_SHORT_MAX)
+    {
+        _hash_fast_short128(fast_context->buffer, (size_t)fast_context->total_size, fast_context->seed, hash_out);
+        return;
+    }
+
+    _hash_fast_end_acc(fast_context, acc);
+
+    hash_out->low = _hash_fast_merge(acc, fast_context->secret + HASH_FAST_MERGE_OFFSET_LOW, fast_context->total_size * HASH_FAST_P0);
+    hash_out->high = _hash_fast_merge(acc, fast_context->secret + HASH_FAST_MERGE_OFFSET_HIGH, ~(fast_context->total_size * HASH_FAST_P1));
+}
+
+/*----------------------------------------------------------------------*/
@@ -0,0 +1,91 @@
+/*
+    Fast non cryptographic hash functions
+*/
+
+#ifndef _HASH_FAST_H_
+#define _HASH_FAST_H_
+
+/*
+    64 and 128 bit hash for hash tables, deduplication and sharding keys.
+    Short inputs are mixed with 64x64->128 bit multiplications (wyhash design),
+    long inputs are accumulated in 64 bytes stripes with 8 independent lanes
+    (XXH3 design) which are computed with SIMD instructions when available.
+
+    NOTE: - output is not compatible with wyhash or XXH3, but it is the same on all
+            platforms and implementations, so it can be stored or sent over network
+          - low part of 128 bit hash is the same as 64 bit hash of the same data
+*/
+
+/*----------------------------------------------------------------------*/
+
+/* constants */
+#define HASH_FAST_SECRET_SIZE                   192
+#define HASH_FAST_STRIPE_SIZE                   64
+#define HASH_FAST_BUFFER_SIZE                   256
+
+/*----------------------------------------------------------------------*/
+
+/* 128 bit hash value */
+typedef struct
+{
+    euint64_t   low;
+    euint64_t   high;
+
+} hash_fast128_t;
+
+/* streaming context */
+typedef struct
+{
+    euint64_t   acc[8];
+    euint64_t   seed;
+    euint64_t   total_size;
+    size_t      stripe_idx;
+    size_t      buffer_size;
+    euint8_t    secret[HASH_FAST_SECRET_SIZE];
+    euint8_t    buffer[HASH_FAST_BUFFER_SIZE];
+
+} hash_fast_context_t;
+
+/* long input implementations */
+typedef enum
+{
+    hash_fast_impl_auto,
+    hash_fast_impl_portable,
+    hash_fast_impl_sse2,
+    hash_fast_impl_avx2
+
+} hash_fast_impl_t;
+
+/*----------------------------------------------------------------------*/
+
+/*
+    NOTE: the fastest implementation supported by cpu is selected on first use,
+          selecting it manually is only needed for testing and benchmarking
+*/
+
+/* long input implementation selection */
+int hash_fast_set_impl(hash_fast_impl_t fast_impl);
+hash_fast_impl_t hash_fast_get_impl();
+
+/* hash data in single run (empty data is allowed) */
+euint64_t hash_fast64(const euint8_t* data, size_t data_size);
+euint64_t hash_fast64_seed(const euint8_t* data, size_t data_size, euint64_t seed);
+
+void hash_fast128(const euint8_t* data, size_t data_size, hash_fast128_t* hash_out);
+void hash_fast128_seed(const euint8_t* data, size_t data_size, euint64_t seed, hash_fast128_t* hash_out);
+
+/*
+    NOTE: streaming gives the same result as single run hashing of all data,
+          end functions do not modify context, so more data can be added after
+*/
+
+/* hash in binary data */
+void hash_fast_begin(hash_fast_context_t* fast_context, euint64_t seed);
+void hash_fast_update(hash_fast_context_t* fast_context, const euint8_t* data, size_t data_size);
+euint64_t hash_fast_end64(const hash_fast_context_t* fast_context);
+void hash_fast_end128(const hash_fast_context_t* fast_context, hash_fast128_t* hash_out);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _HASH_FAST_H_ */
+
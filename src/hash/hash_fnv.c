@@ -38,11 +38,11 @@ unsigned long hash_fnv32(const unsigned char* buffer, unsigned long buffer_size)
 #define HASH_FNV_64_INIT ((euint64_t)0xcbf29ce484222325ULL)    
 #define HASH_FNV_64_MULT ((euint64_t)0x100000001b3ULL)    
 
-euint64_t hash_fnv64(const unsigned char* buffer, int buffer_size)
+euint64_t hash_fnv64(const unsigned char* buffer, size_t buffer_size)
 {
     /* initial hash value */
     euint64_t hash_val = HASH_FNV_64_INIT;
-    euint64_t idx;
+    size_t idx;
 
     /* loop over buffer */
     for(idx = 0; idx < buffer_size; ++idx)
@@ -20,7 +20,7 @@ unsigned long hash_fnv32(const unsigned char* buffer, unsigned long buffer_size)
 #ifdef _ELIBC_64_BITS_SUPPORT
 
 /* 64 bit hash function */
-euint64_t hash_fnv64(const unsigned char* buffer, int buffer_size);
+euint64_t hash_fnv64(const unsigned char* buffer, size_t buffer_size);
 
 #endif /* _ELIBC_64_BITS_SUPPORT */
 
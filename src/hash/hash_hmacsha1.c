@@ -8,56 +8,67 @@
 #include "hash_hmacsha1.h"
 
 /*----------------------------------------------------------------------*/
-/*
-    NOTE: functions expect digest_out to be of size HASH_SHA1_DIGEST_SIZE
-*/
-
-/* hash in binary data */
-void hash_hmac_sha1_begin(hmac_sha1_context_t* hmac_sha1_context, const euint8_t* key, euint32_t key_length)
+/* worker methods */
+void _hash_hmac_sha1_init_key(sha1_context_t* inner_context, sha1_context_t* outer_context, const euint8_t* key, euint32_t key_length)
 {
+    euint8_t ipad[HASH_SHA1_BLOCK_SIZE];
+    euint8_t opad[HASH_SHA1_BLOCK_SIZE];
+    euint8_t key_block[HASH_SHA1_BLOCK_SIZE];
     int idx;
 
-    EASSERT(hmac_sha1_context);
-    EASSERT(key);
-    EASSERT(key_length);
-    if(hmac_sha1_context == 0 || key == 0 || key_length == 0) return;
-
-    /* init ipad and opad */
-    ememset(hmac_sha1_context->ipad, 0x36, sizeof(hmac_sha1_context->ipad));
-    ememset(hmac_sha1_context->opad, 0x5c, sizeof(hmac_sha1_context->opad));
-
     /* init key with zeros */
-    ememset(hmac_sha1_context->key, 0x00, sizeof(hmac_sha1_context->key));
+    ememset(key_block, 0x00, sizeof(key_block));
 
     /* check key length */
     if(key_length > HASH_SHA1_BLOCK_SIZE)
     {
-        /* has key */
-        hash_sha1_begin(&hmac_sha1_context->sha1_context);
-        hash_sha1_update(&hmac_sha1_context->sha1_context, key, key_length);
-        hash_sha1_end(&hmac_sha1_context->sha1_context, hmac_sha1_context->key);
-
-        /* update key size */
-        key_length = HASH_SHA1_DIGEST_SIZE;
+        /* hash key */
+        hash_sha1_begin(inner_context);
+        hash_sha1_update(inner_context, key, key_length);
+        hash_sha1_end(inner_context, key_block);
 
     } else
     {
         /* copy key */
-        ememcpy(hmac_sha1_context->key, key, key_length);
+        ememcpy(key_block, key, key_length);
     }
 
     /* XOR key */
     for(idx = 0; idx < HASH_SHA1_BLOCK_SIZE; ++idx)
     {
-        hmac_sha1_context->ipad[idx] ^= hmac_sha1_context->key[idx];
-        hmac_sha1_context->opad[idx] ^= hmac_sha1_context->key[idx];
+        ipad[idx] = key_block[idx] ^ 0x36;
+        opad[idx] = key_block[idx] ^ 0x5c;
     }
 
-    /* init sha1 context */
-    hash_sha1_begin(&hmac_sha1_context->sha1_context);
-
     /* hash in ipad */
-    hash_sha1_update(&hmac_sha1_context->sha1_context, hmac_sha1_context->ipad, sizeof(hmac_sha1_context->ipad));
+    hash_sha1_begin(inner_context);
+    hash_sha1_update(inner_context, ipad, sizeof(ipad));
+
+    /* hash in opad */
+    hash_sha1_begin(outer_context);
+    hash_sha1_update(outer_context, opad, sizeof(opad));
+
+    /* do not leave key material on stack */
+    ememset(key_block, 0x00, sizeof(key_block));
+    ememset(ipad, 0x00, sizeof(ipad));
+    ememset(opad, 0x00, sizeof(opad));
+}
+
+/*----------------------------------------------------------------------*/
+/*
+    NOTE: functions expect digest_out to be of size HASH_SHA1_DIGEST_SIZE
+*/
+
+/* hash in binary data */
+void hash_hmac_sha1_begin(hmac_sha1_context_t* hmac_sha1_context, const euint8_t* key, euint32_t key_length)
+{
+    EASSERT(hmac_sha1_context);
+    EASSERT(key);
+    EASSERT(key_length);
+    if(hmac_sha1_context == 0 || key == 0 || key_length == 0) return;
+
+    /* init both sha1 contexts */
+    _hash_hmac_sha1_init_key(&hmac_sha1_context->sha1_context, &hmac_sha1_context->outer_context, key, key_length);
 }
 
 void hash_hmac_sha1_update(hmac_sha1_context_t* hmac_sha1_context, const euint8_t* data, euint32_t data_size)
@@ -82,11 +93,9 @@ void hash_hmac_sha1_end(hmac_sha1_context_t* hmac_sha1_context, euint8_t* digest
     /* compute (ipad + data) hash */
     hash_sha1_end(&hmac_sha1_context->sha1_context, tmp_digest);
 
-    /* now hash (opad + temp digest) */
-    hash_sha1_begin(&hmac_sha1_context->sha1_context);
-    hash_sha1_update(&hmac_sha1_context->sha1_context, hmac_sha1_context->opad, sizeof(hmac_sha1_context->opad));
-    hash_sha1_update(&hmac_sha1_context->sha1_context, tmp_digest, sizeof(tmp_digest));
-    hash_sha1_end(&hmac_sha1_context->sha1_context, digest_out);
+    /* now hash (opad + temp digest), opad is already hashed in */
+    hash_sha1_update(&hmac_sha1_context->outer_context, tmp_digest, sizeof(tmp_digest));
+    hash_sha1_end(&hmac_sha1_context->outer_context, digest_out);
 }
 
 /* hash data in single run */
@@ -110,5 +119,88 @@ int hash_hmac_sha1(const euint8_t* data, euint32_t data_size,
     return ELIBC_SUCCESS;
 }
 
-/*----------------------------------------------------------------------*/
+/* precompute key once to sign many messages */
+int hash_hmac_sha1_key(hmac_sha1_key_t* hmac_sha1_key, const euint8_t* key, euint32_t key_length)
+{
+    EASSERT(hmac_sha1_key);
+    EASSERT(key);
+    EASSERT(key_length);
+    if(hmac_sha1_key == 0 || key == 0 || key_length == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* keep states after ipad and opad blocks */
+    _hash_hmac_sha1_init_key(&hmac_sha1_key->inner_context, &hmac_sha1_key->outer_context, key, key_length);
+
+    return ELIBC_SUCCESS;
+}
+
+void hash_hmac_sha1_begin_key(hmac_sha1_context_t* hmac_sha1_context, const hmac_sha1_key_t* hmac_sha1_key)
+{
+    EASSERT(hmac_sha1_context);
+    EASSERT(hmac_sha1_key);
+    if(hmac_sha1_context == 0 || hmac_sha1_key == 0) return;
+
+    /* clone precomputed states */
+    hmac_sha1_context->sha1_context = hmac_sha1_key->inner_context;
+    hmac_sha1_context->outer_context = hmac_sha1_key->outer_context;
+}
+
+int hash_hmac_sha1_with_key(const euint8_t* data, euint32_t data_size,
+                            const hmac_sha1_key_t* hmac_sha1_key, euint8_t* digest_out)
+{
+    hmac_sha1_context_t hmac_sha1_context;
 
+    EASSERT(data);
+    EASSERT(data_size);
+    EASSERT(hmac_sha1_key);
+    EASSERT(digest_out);
+    if(data_size == 0 || data == 0 || hmac_sha1_key == 0 || digest_out == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* hash data with temp context */
+    hash_hmac_sha1_begin_key(&hmac_sha1_context, hmac_sha1_key);
+    hash_hmac_sha1_update(&hmac_sha1_context, data, data_size);
+    hash_hmac_sha1_end(&hmac_sha1_context, digest_out);
+
+    return ELIBC_SUCCESS;
+}
+
+/* sign many messages with the same key in parallel */
+int hash_hmac_sha1_multi(const euint8_t* const* data, const euint32_t* data_sizes, size_t count,
+                         const hmac_sha1_key_t* hmac_sha1_key, euint8_t* digests_out)
+{
+    euint8_t inner_digests[HASH_SHA1_MAX_LANES * HASH_SHA1_DIGEST_SIZE];
+    const euint8_t* inner_data[HASH_SHA1_MAX_LANES];
+    euint32_t inner_sizes[HASH_SHA1_MAX_LANES];
+    size_t idx, batch;
+    int err;
+
+    EASSERT(data);
+    EASSERT(data_sizes);
+    EASSERT(hmac_sha1_key);
+    EASSERT(digests_out);
+    if(data == 0 || data_sizes == 0 || hmac_sha1_key == 0 || digests_out == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* inner digests are hashed as outer messages */
+    for(idx = 0; idx < HASH_SHA1_MAX_LANES; ++idx)
+    {
+        inner_data[idx] = inner_digests + idx * HASH_SHA1_DIGEST_SIZE;
+        inner_sizes[idx] = HASH_SHA1_DIGEST_SIZE;
+    }
+
+    /* process in batches to keep inner digests on stack */
+    for(idx = 0; idx < count; idx += batch)
+    {
+        batch = (count - idx < HASH_SHA1_MAX_LANES) ? count - idx : HASH_SHA1_MAX_LANES;
+
+        /* hash (ipad + data) */
+        err = hash_sha1_multi_prefix(&hmac_sha1_key->inner_context, data + idx, data_sizes + idx, batch, inner_digests);
+        if(err != ELIBC_SUCCESS) return err;
+
+        /* hash (opad + inner digest) */
+        err = hash_sha1_multi_prefix(&hmac_sha1_key->outer_context, inner_data, inner_sizes, batch, digests_out + idx * HASH_SHA1_DIGEST_SIZE);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+/*----------------------------------------------------------------------*/
@@ -12,13 +12,19 @@
 
 /*----------------------------------------------------------------------*/
 
+/* precomputed key (hash states after ipad and opad blocks) */
+typedef struct
+{
+    sha1_context_t  inner_context;
+    sha1_context_t  outer_context;
+
+} hmac_sha1_key_t;
+
 /* context */
 typedef struct
 {
-    euint8_t         ipad[HASH_SHA1_BLOCK_SIZE];
-    euint8_t         opad[HASH_SHA1_BLOCK_SIZE];
-    euint8_t         key[HASH_SHA1_BLOCK_SIZE];
     sha1_context_t  sha1_context;
+    sha1_context_t  outer_context;
 
 } hmac_sha1_context_t;
 
@@ -36,6 +42,21 @@ void hash_hmac_sha1_end(hmac_sha1_context_t* hmac_sha1_context, euint8_t* digest
 int hash_hmac_sha1(const euint8_t* data, euint32_t data_size,
                    const euint8_t* key, euint32_t key_length, euint8_t* digest_out);
 
+/*
+    NOTE: precomputed key saves key setup and two block transforms per message,
+          it is not modified by hashing and can be shared between threads
+*/
+
+/* precompute key once to sign many messages */
+int hash_hmac_sha1_key(hmac_sha1_key_t* hmac_sha1_key, const euint8_t* key, euint32_t key_length);
+void hash_hmac_sha1_begin_key(hmac_sha1_context_t* hmac_sha1_context, const hmac_sha1_key_t* hmac_sha1_key);
+int hash_hmac_sha1_with_key(const euint8_t* data, euint32_t data_size,
+                            const hmac_sha1_key_t* hmac_sha1_key, euint8_t* digest_out);
+
+/* sign many messages with the same key in parallel (refer to hash_sha1_multi) */
+int hash_hmac_sha1_multi(const euint8_t* const* data, const euint32_t* data_sizes, size_t count,
+                         const hmac_sha1_key_t* hmac_sha1_key, euint8_t* digests_out);
+
 /*----------------------------------------------------------------------*/
 
 #endif /* _HASH_HMACSHA1_H_ */
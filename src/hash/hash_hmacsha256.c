@@ -0,0 +1,166 @@
+/*
+    HMAC-SHA256 hash functions
+*/
+
+#include "../elib_config.h"
+
+#include "hash_sha256.h"
+#include "hash_hmacsha256.h"
+
+/*----------------------------------------------------------------------*/
+/* worker methods */
+void _hash_hmac_sha256_init_key(sha256_context_t* inner_context, sha256_context_t* outer_context, const euint8_t* key, euint32_t key_length)
+{
+    euint8_t ipad[HASH_SHA256_BLOCK_SIZE];
+    euint8_t opad[HASH_SHA256_BLOCK_SIZE];
+    euint8_t key_block[HASH_SHA256_BLOCK_SIZE];
+    int idx;
+
+    /* init key with zeros */
+    ememset(key_block, 0x00, sizeof(key_block));
+
+    /* check key length */
+    if(key_length > HASH_SHA256_BLOCK_SIZE)
+    {
+        /* hash key */
+        hash_sha256_begin(inner_context);
+        hash_sha256_update(inner_context, key, key_length);
+        hash_sha256_end(inner_context, key_block);
+
+    } else
+    {
+        /* copy key */
+        ememcpy(key_block, key, key_length);
+    }
+
+    /* XOR key */
+    for(idx = 0; idx < HASH_SHA256_BLOCK_SIZE; ++idx)
+    {
+        ipad[idx] = key_block[idx] ^ 0x36;
+        opad[idx] = key_block[idx] ^ 0x5c;
+    }
+
+    /* hash in ipad */
+    hash_sha256_begin(inner_context);
+    hash_sha256_update(inner_context, ipad, sizeof(ipad));
+
+    /* hash in opad */
+    hash_sha256_begin(outer_context);
+    hash_sha256_update(outer_context, opad, sizeof(opad));
+
+    /* do not leave key material on stack */
+    ememset(key_block, 0x00, sizeof(key_block));
+    ememset(ipad, 0x00, sizeof(ipad));
+    ememset(opad, 0x00, sizeof(opad));
+}
+
+/*----------------------------------------------------------------------*/
+/*
+    NOTE: functions expect digest_out to be of size HASH_SHA256_DIGEST_SIZE
+*/
+
+/* hash in binary data */
+void hash_hmac_sha256_begin(hmac_sha256_context_t* hmac_sha256_context, const euint8_t* key, euint32_t key_length)
+{
+    EASSERT(hmac_sha256_context);
+    EASSERT(key);
+    EASSERT(key_length);
+    if(hmac_sha256_context == 0 || key == 0 || key_length == 0) return;
+
+    /* init both sha256 contexts */
+    _hash_hmac_sha256_init_key(&hmac_sha256_context->sha256_context, &hmac_sha256_context->outer_context, key, key_length);
+}
+
+void hash_hmac_sha256_update(hmac_sha256_context_t* hmac_sha256_context, const euint8_t* data, euint32_t data_size)
+{
+    EASSERT(hmac_sha256_context);
+    EASSERT(data);
+    EASSERT(data_size);
+    if(hmac_sha256_context == 0 || data == 0 || data_size == 0) return;
+
+    /* hash in data */
+    hash_sha256_update(&hmac_sha256_context->sha256_context, data, data_size);
+}
+
+void hash_hmac_sha256_end(hmac_sha256_context_t* hmac_sha256_context, euint8_t* digest_out)
+{
+    euint8_t tmp_digest[HASH_SHA256_DIGEST_SIZE];
+
+    EASSERT(hmac_sha256_context);
+    EASSERT(digest_out);
+    if(hmac_sha256_context == 0 || digest_out == 0) return;
+
+    /* compute (ipad + data) hash */
+    hash_sha256_end(&hmac_sha256_context->sha256_context, tmp_digest);
+
+    /* now hash (opad + temp digest), opad is already hashed in */
+    hash_sha256_update(&hmac_sha256_context->outer_context, tmp_digest, sizeof(tmp_digest));
+    hash_sha256_end(&hmac_sha256_context->outer_context, digest_out);
+}
+
+/* hash data in single run */
+int hash_hmac_sha256(const euint8_t* data, euint32_t data_size,
+                     const euint8_t* key, euint32_t key_length, euint8_t* digest_out)
+{
+    hmac_sha256_context_t hmac_sha256_context;
+
+    EASSERT(data);
+    EASSERT(data_size);
+    EASSERT(key);
+    EASSERT(key_length);
+    EASSERT(digest_out);
+    if(data_size == 0 || data == 0 || key == 0 || key_length == 0 || digest_out == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* hash data with temp context */
+    hash_hmac_sha256_begin(&hmac_sha256_context, key, key_length);
+    hash_hmac_sha256_update(&hmac_sha256_context, data, data_size);
+    hash_hmac_sha256_end(&hmac_sha256_context, digest_out);
+
+    return ELIBC_SUCCESS;
+}
+
+/* precompute key once to sign many messages */
+int hash_hmac_sha256_key(hmac_sha256_key_t* hmac_sha256_key, const euint8_t* key, euint32_t key_length)
+{
+    EASSERT(hmac_sha256_key);
+    EASSERT(key);
+    EASSERT(key_length);
+    if(hmac_sha256_key == 0 || key == 0 || key_length == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* keep states after ipad and opad blocks */
+    _hash_hmac_sha256_init_key(&hmac_sha256_key->inner_context, &hmac_sha256_key->outer_context, key, key_length);
+
+    return ELIBC_SUCCESS;
+}
+
+void hash_hmac_sha256_begin_key(hmac_sha256_context_t* hmac_sha256_context, const hmac_sha256_key_t* hmac_sha256_key)
+{
+    EASSERT(hmac_sha256_context);
+    EASSERT(hmac_sha256_key);
+    if(hmac_sha256_context == 0 || hmac_sha256_key == 0) return;
+
+    /* clone precomputed states */
+    hmac_sha256_context->sha256_context = hmac_sha256_key->inner_context;
+    hmac_sha256_context->outer_context = hmac_sha256_key->outer_context;
+}
+
+int hash_hmac_sha256_with_key(const euint8_t* data, euint32_t data_size,
+                              const hmac_sha256_key_t* hmac_sha256_key, euint8_t* digest_out)
+{
+    hmac_sha256_context_t hmac_sha256_context;
+
+    EASSERT(data);
+    EASSERT(data_size);
+    EASSERT(hmac_sha256_key);
+    EASSERT(digest_out);
+    if(data_size == 0 || data == 0 || hmac_sha256_key == 0 || digest_out == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* hash data with temp context */
+    hash_hmac_sha256_begin_key(&hmac_sha256_context, hmac_sha256_key);
+    hash_hmac_sha256_update(&hmac_sha256_context, data, data_size);
+    hash_hmac_sha256_end(&hmac_sha256_context, digest_out);
+
+    return ELIBC_SUCCESS;
+}
+
+/*----------------------------------------------------------------------*/
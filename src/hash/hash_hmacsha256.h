@@ -0,0 +1,60 @@
+/*
+    HMAC-SHA256 hash functions
+*/
+
+#ifndef _HASH_HMACSHA256_H_
+#define _HASH_HMACSHA256_H_
+
+/*
+    HMAC-SHA256 hashing (Keyed-Hashing for Message Authentication). 
+    For algorithm details refer to RFC2104: http://tools.ietf.org/html/rfc2104
+    Test vectors are in RFC4231: http://tools.ietf.org/html/rfc4231
+*/
+
+/*----------------------------------------------------------------------*/
+
+/* precomputed key (hash states after ipad and opad blocks) */
+typedef struct
+{
+    sha256_context_t  inner_context;
+    sha256_context_t  outer_context;
+
+} hmac_sha256_key_t;
+
+/* context */
+typedef struct
+{
+    sha256_context_t  sha256_context;
+    sha256_context_t  outer_context;
+
+} hmac_sha256_context_t;
+
+/*----------------------------------------------------------------------*/
+/*
+    NOTE: functions expect digest_out to be of size HASH_SHA256_DIGEST_SIZE
+*/
+
+/* hash in binary data */
+void hash_hmac_sha256_begin(hmac_sha256_context_t* hmac_sha256_context, const euint8_t* key, euint32_t key_length);
+void hash_hmac_sha256_update(hmac_sha256_context_t* hmac_sha256_context, const euint8_t* data, euint32_t data_size);
+void hash_hmac_sha256_end(hmac_sha256_context_t* hmac_sha256_context, euint8_t* digest_out);
+
+/* hash data in single run */
+int hash_hmac_sha256(const euint8_t* data, euint32_t data_size,
+                     const euint8_t* key, euint32_t key_length, euint8_t* digest_out);
+
+/*
+    NOTE: precomputed key saves key setup and two block transforms per message,
+          it is not modified by hashing and can be shared between threads
+*/
+
+/* precompute key once to sign many messages */
+int hash_hmac_sha256_key(hmac_sha256_key_t* hmac_sha256_key, const euint8_t* key, euint32_t key_length);
+void hash_hmac_sha256_begin_key(hmac_sha256_context_t* hmac_sha256_context, const hmac_sha256_key_t* hmac_sha256_key);
+int hash_hmac_sha256_with_key(const euint8_t* data, euint32_t data_size,
+                              const hmac_sha256_key_t* hmac_sha256_key, euint8_t* digest_out);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _HASH_HMACSHA256_H_ */
+
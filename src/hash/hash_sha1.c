@@ -6,6 +6,10 @@
 
 #include "hash_sha1.h"
 
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+#include <immintrin.h>
+#endif
+
 /*----------------------------------------------------------------------*/
 
 /* helper types */
@@ -38,48 +42,138 @@ typedef union {
 
 /*----------------------------------------------------------------------*/
 
+/* round constants */
+#define SHA1_K0     0x5A827999
+#define SHA1_K1     0x6ED9EBA1
+#define SHA1_K2     0x8F1BBCDC
+#define SHA1_K3     0xCA62C1D6
+
+/* block transform (state, data, number of 64 bytes blocks) */
+typedef void (*sha1_transform_t)(euint32_t*, const euint8_t*, size_t);
+
+/*----------------------------------------------------------------------*/
+
 /* 
-    Hash a single 512-bit block. This is the core of the algorithm. 
+    Hash 512-bit blocks. This is the core of the algorithm. 
      - state size is expected to be five 32 bits values 
-     - buffer size is expected to be 64 bytes 
+     - data size is expected to be 64 bytes per block
 */
-ELIBC_FORCE_INLINE void _sha1_transform(euint32_t* state, const euint8_t* buffer)
+void _sha1_transform_portable(euint32_t* state, const euint8_t* data, size_t blocks)
 {
     euint32_t a, b, c, d, e;
+    SHA1_WORKBLOCK workspace;
     SHA1_WORKBLOCK* block;
 
-    block = (SHA1_WORKBLOCK*)buffer;
+    /* transform modifies block, so input is copied (this also handles unaligned input) */
+    block = &workspace;
+
+    for( ; blocks > 0; --blocks, data += HASH_SHA1_BLOCK_SIZE)
+    {
+        ememcpy(block, data, HASH_SHA1_BLOCK_SIZE);
+
+        /* Copy state context to working vars */
+        a = state[0];
+        b = state[1];
+        c = state[2];
+        d = state[3];
+        e = state[4];
+
+        /* 4 rounds of 20 operations each. Loop unrolled. */
+        R0(a,b,c,d,e, 0); R0(e,a,b,c,d, 1); R0(d,e,a,b,c, 2); R0(c,d,e,a,b, 3);
+        R0(b,c,d,e,a, 4); R0(a,b,c,d,e, 5); R0(e,a,b,c,d, 6); R0(d,e,a,b,c, 7);
+        R0(c,d,e,a,b, 8); R0(b,c,d,e,a, 9); R0(a,b,c,d,e,10); R0(e,a,b,c,d,11);
+        R0(d,e,a,b,c,12); R0(c,d,e,a,b,13); R0(b,c,d,e,a,14); R0(a,b,c,d,e,15);
+        R1(e,a,b,c,d,16); R1(d,e,a,b,c,17); R1(c,d,e,a,b,18); R1(b,c,d,e,a,19);
+        R2(a,b,c,d,e,20); R2(e,a,b,c,d,21); R2(d,e,a,b,c,22); R2(c,d,e,a,b,23);
+        R2(b,c,d,e,a,24); R2(a,b,c,d,e,25); R2(e,a,b,c,d,26); R2(d,e,a,b,c,27);
+        R2(c,d,e,a,b,28); R2(b,c,d,e,a,29); R2(a,b,c,d,e,30); R2(e,a,b,c,d,31);
+        R2(d,e,a,b,c,32); R2(c,d,e,a,b,33); R2(b,c,d,e,a,34); R2(a,b,c,d,e,35);
+        R2(e,a,b,c,d,36); R2(d,e,a,b,c,37); R2(c,d,e,a,b,38); R2(b,c,d,e,a,39);
+        R3(a,b,c,d,e,40); R3(e,a,b,c,d,41); R3(d,e,a,b,c,42); R3(c,d,e,a,b,43);
+        R3(b,c,d,e,a,44); R3(a,b,c,d,e,45); R3(e,a,b,c,d,46); R3(d,e,a,b,c,47);
+        R3(c,d,e,a,b,48); R3(b,c,d,e,a,49); R3(a,b,c,d,e,50); R3(e,a,b,c,d,51);
+        R3(d,e,a,b,c,52); R3(c,d,e,a,b,53); R3(b,c,d,e,a,54); R3(a,b,c,d,e,55);
+        R3(e,a,b,c,d,56); R3(d,e,a,b,c,57); R3(c,d,e,a,b,58); R3(b,c,d,e,a,59);
+        R4(a,b,c,d,e,60); R4(e,a,b,c,d,61); R4(d,e,a,b,c,62); R4(c,d,e,a,b,63);
+        R4(b,c,d,e,a,64); R4(a,b,c,d,e,65); R4(e,a,b,c,d,66); R4(d,e,a,b,c,67);
+        R4(c,d,e,a,b,68); R4(b,c,d,e,a,69); R4(a,b,c,d,e,70); R4(e,a,b,c,d,71);
+        R4(d,e,a,b,c,72); R4(c,d,e,a,b,73); R4(b,c,d,e,a,74); R4(a,b,c,d,e,75);
+        R4(e,a,b,c,d,76); R4(d,e,a,b,c,77); R4(c,d,e,a,b,78); R4(b,c,d,e,a,79);
+
+        /* Add the working vars back into context state */
+        state[0] += a;
+        state[1] += b;
+        state[2] += c;
+        state[3] += d;
+        state[4] += e;
+    }
+}
+
+/*----------------------------------------------------------------------*/
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+
+/*
+    SSSE3 and AVX2 variants compute message schedule (W + K) with vector instructions
+    four words at a time (AVX2 does this for two blocks at once), rounds are scalar.
+    SHA-NI variant uses dedicated SHA instructions for both schedule and rounds.
+*/
+
+/* rounds with precomputed schedule */
+#define RW0(v,w,x,y,z,i) z+=((w&(x^y))^y)+wk[i]+rol(v,5);w=rol(w,30);
+#define RW2(v,w,x,y,z,i) z+=(w^x^y)+wk[i]+rol(v,5);w=rol(w,30);
+#define RW3(v,w,x,y,z,i) z+=(((w|x)&y)|(w&x))+wk[i]+rol(v,5);w=rol(w,30);
+
+/* compute next four schedule words from previous sixteen (w0 holds the oldest) */
+#define SHA1_SSE_SCHEDULE(w0, w1, w2, w3, wn)                                       \
+    wn = _mm_xor_si128(_mm_xor_si128(_mm_srli_si128(w3, 4), w2),                    \
+                       _mm_xor_si128(_mm_alignr_epi8(w1, w0, 8), w0));              \
+    wn = _mm_or_si128(_mm_slli_epi32(wn, 1), _mm_srli_epi32(wn, 31));               \
+    tmp = _mm_slli_si128(wn, 12);                                                   \
+    wn = _mm_xor_si128(wn, _mm_or_si128(_mm_slli_epi32(tmp, 1), _mm_srli_epi32(tmp, 31)));
+
+#define SHA1_AVX2_SCHEDULE(w0, w1, w2, w3, wn)                                      \
+    wn = _mm256_xor_si256(_mm256_xor_si256(_mm256_srli_si256(w3, 4), w2),           \
+                          _mm256_xor_si256(_mm256_alignr_epi8(w1, w0, 8), w0));     \
+    wn = _mm256_or_si256(_mm256_slli_epi32(wn, 1), _mm256_srli_epi32(wn, 31));      \
+    tmp = _mm256_slli_si256(wn, 12);                                                \
+    wn = _mm256_xor_si256(wn, _mm256_or_si256(_mm256_slli_epi32(tmp, 1), _mm256_srli_epi32(tmp, 31)));
+
+ELIBC_FORCE_INLINE euint32_t _sha1_round_constant(int idx)
+{
+    return (idx < 20) ? SHA1_K0 : (idx < 40) ? SHA1_K1 : (idx < 60) ? SHA1_K2 : SHA1_K3;
+}
+
+void _sha1_rounds_wk(euint32_t* state, const euint32_t* wk)
+{
+    euint32_t a, b, c, d, e;
 
-    /* Copy state context to working vars */
     a = state[0];
     b = state[1];
     c = state[2];
     d = state[3];
     e = state[4];
 
-    /* 4 rounds of 20 operations each. Loop unrolled. */
-    R0(a,b,c,d,e, 0); R0(e,a,b,c,d, 1); R0(d,e,a,b,c, 2); R0(c,d,e,a,b, 3);
-    R0(b,c,d,e,a, 4); R0(a,b,c,d,e, 5); R0(e,a,b,c,d, 6); R0(d,e,a,b,c, 7);
-    R0(c,d,e,a,b, 8); R0(b,c,d,e,a, 9); R0(a,b,c,d,e,10); R0(e,a,b,c,d,11);
-    R0(d,e,a,b,c,12); R0(c,d,e,a,b,13); R0(b,c,d,e,a,14); R0(a,b,c,d,e,15);
-    R1(e,a,b,c,d,16); R1(d,e,a,b,c,17); R1(c,d,e,a,b,18); R1(b,c,d,e,a,19);
-    R2(a,b,c,d,e,20); R2(e,a,b,c,d,21); R2(d,e,a,b,c,22); R2(c,d,e,a,b,23);
-    R2(b,c,d,e,a,24); R2(a,b,c,d,e,25); R2(e,a,b,c,d,26); R2(d,e,a,b,c,27);
-    R2(c,d,e,a,b,28); R2(b,c,d,e,a,29); R2(a,b,c,d,e,30); R2(e,a,b,c,d,31);
-    R2(d,e,a,b,c,32); R2(c,d,e,a,b,33); R2(b,c,d,e,a,34); R2(a,b,c,d,e,35);
-    R2(e,a,b,c,d,36); R2(d,e,a,b,c,37); R2(c,d,e,a,b,38); R2(b,c,d,e,a,39);
-    R3(a,b,c,d,e,40); R3(e,a,b,c,d,41); R3(d,e,a,b,c,42); R3(c,d,e,a,b,43);
-    R3(b,c,d,e,a,44); R3(a,b,c,d,e,45); R3(e,a,b,c,d,46); R3(d,e,a,b,c,47);
-    R3(c,d,e,a,b,48); R3(b,c,d,e,a,49); R3(a,b,c,d,e,50); R3(e,a,b,c,d,51);
-    R3(d,e,a,b,c,52); R3(c,d,e,a,b,53); R3(b,c,d,e,a,54); R3(a,b,c,d,e,55);
-    R3(e,a,b,c,d,56); R3(d,e,a,b,c,57); R3(c,d,e,a,b,58); R3(b,c,d,e,a,59);
-    R4(a,b,c,d,e,60); R4(e,a,b,c,d,61); R4(d,e,a,b,c,62); R4(c,d,e,a,b,63);
-    R4(b,c,d,e,a,64); R4(a,b,c,d,e,65); R4(e,a,b,c,d,66); R4(d,e,a,b,c,67);
-    R4(c,d,e,a,b,68); R4(b,c,d,e,a,69); R4(a,b,c,d,e,70); R4(e,a,b,c,d,71);
-    R4(d,e,a,b,c,72); R4(c,d,e,a,b,73); R4(b,c,d,e,a,74); R4(a,b,c,d,e,75);
-    R4(e,a,b,c,d,76); R4(d,e,a,b,c,77); R4(c,d,e,a,b,78); R4(b,c,d,e,a,79);
-
-    /* Add the working vars back into context state */
+    RW0(a,b,c,d,e, 0); RW0(e,a,b,c,d, 1); RW0(d,e,a,b,c, 2); RW0(c,d,e,a,b, 3);
+    RW0(b,c,d,e,a, 4); RW0(a,b,c,d,e, 5); RW0(e,a,b,c,d, 6); RW0(d,e,a,b,c, 7);
+    RW0(c,d,e,a,b, 8); RW0(b,c,d,e,a, 9); RW0(a,b,c,d,e,10); RW0(e,a,b,c,d,11);
+    RW0(d,e,a,b,c,12); RW0(c,d,e,a,b,13); RW0(b,c,d,e,a,14); RW0(a,b,c,d,e,15);
+    RW0(e,a,b,c,d,16); RW0(d,e,a,b,c,17); RW0(c,d,e,a,b,18); RW0(b,c,d,e,a,19);
+    RW2(a,b,c,d,e,20); RW2(e,a,b,c,d,21); RW2(d,e,a,b,c,22); RW2(c,d,e,a,b,23);
+    RW2(b,c,d,e,a,24); RW2(a,b,c,d,e,25); RW2(e,a,b,c,d,26); RW2(d,e,a,b,c,27);
+    RW2(c,d,e,a,b,28); RW2(b,c,d,e,a,29); RW2(a,b,c,d,e,30); RW2(e,a,b,c,d,31);
+    RW2(d,e,a,b,c,32); RW2(c,d,e,a,b,33); RW2(b,c,d,e,a,34); RW2(a,b,c,d,e,35);
+    RW2(e,a,b,c,d,36); RW2(d,e,a,b,c,37); RW2(c,d,e,a,b,38); RW2(b,c,d,e,a,39);
+    RW3(a,b,c,d,e,40); RW3(e,a,b,c,d,41); RW3(d,e,a,b,c,42); RW3(c,d,e,a,b,43);
+    RW3(b,c,d,e,a,44); RW3(a,b,c,d,e,45); RW3(e,a,b,c,d,46); RW3(d,e,a,b,c,47);
+    RW3(c,d,e,a,b,48); RW3(b,c,d,e,a,49); RW3(a,b,c,d,e,50); RW3(e,a,b,c,d,51);
+    RW3(d,e,a,b,c,52); RW3(c,d,e,a,b,53); RW3(b,c,d,e,a,54); RW3(a,b,c,d,e,55);
+    RW3(e,a,b,c,d,56); RW3(d,e,a,b,c,57); RW3(c,d,e,a,b,58); RW3(b,c,d,e,a,59);
+    RW2(a,b,c,d,e,60); RW2(e,a,b,c,d,61); RW2(d,e,a,b,c,62); RW2(c,d,e,a,b,63);
+    RW2(b,c,d,e,a,64); RW2(a,b,c,d,e,65); RW2(e,a,b,c,d,66); RW2(d,e,a,b,c,67);
+    RW2(c,d,e,a,b,68); RW2(b,c,d,e,a,69); RW2(a,b,c,d,e,70); RW2(e,a,b,c,d,71);
+    RW2(d,e,a,b,c,72); RW2(c,d,e,a,b,73); RW2(b,c,d,e,a,74); RW2(a,b,c,d,e,75);
+    RW2(e,a,b,c,d,76); RW2(d,e,a,b,c,77); RW2(c,d,e,a,b,78); RW2(b,c,d,e,a,79);
+
     state[0] += a;
     state[1] += b;
     state[2] += c;
@@ -87,7 +181,335 @@ ELIBC_FORCE_INLINE void _sha1_transform(euint32_t* state, const euint8_t* buffer
     state[4] += e;
 }
 
+ELIBC_TARGET("ssse3")
+void _sha1_transform_ssse3(euint32_t* state, const euint8_t* data, size_t blocks)
+{
+    euint32_t wk[80];
+    __m128i w0, w1, w2, w3, wn, tmp;
+    __m128i bswap;
+    int idx;
+
+    /* big endian words */
+    bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    for( ; blocks > 0; --blocks, data += HASH_SHA1_BLOCK_SIZE)
+    {
+        w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), bswap);
+        w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), bswap);
+        w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), bswap);
+        w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), bswap);
+
+        tmp = _mm_set1_epi32((int)SHA1_K0);
+        _mm_storeu_si128((__m128i*)(wk + 0), _mm_add_epi32(w0, tmp));
+        _mm_storeu_si128((__m128i*)(wk + 4), _mm_add_epi32(w1, tmp));
+        _mm_storeu_si128((__m128i*)(wk + 8), _mm_add_epi32(w2, tmp));
+        _mm_storeu_si128((__m128i*)(wk + 12), _mm_add_epi32(w3, tmp));
+
+        /* expand schedule */
+        for(idx = 16; idx < 80; idx += 4)
+        {
+            SHA1_SSE_SCHEDULE(w0, w1, w2, w3, wn);
+            _mm_storeu_si128((__m128i*)(wk + idx), _mm_add_epi32(wn, _mm_set1_epi32((int)_sha1_round_constant(idx))));
+
+            w0 = w1;
+            w1 = w2;
+            w2 = w3;
+            w3 = wn;
+        }
+
+        _sha1_rounds_wk(state, wk);
+    }
+}
+
+ELIBC_TARGET("avx2")
+void _sha1_transform_avx2(euint32_t* state, const euint8_t* data, size_t blocks)
+{
+    euint32_t wk[2][80];
+    __m256i w0, w1, w2, w3, wn, tmp;
+    __m256i bswap;
+    int idx;
+
+    /* big endian words */
+    bswap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                            12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    /* schedule is computed for two blocks at once (one per 128 bits lane) */
+    for( ; blocks > 1; blocks -= 2, data += 2 * HASH_SHA1_BLOCK_SIZE)
+    {
+#define SHA1_AVX2_LOAD(offset)                                                                      \
+        _mm256_shuffle_epi8(_mm256_inserti128_si256(                                                \
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(data + offset))),               \
+            _mm_loadu_si128((const __m128i*)(data + HASH_SHA1_BLOCK_SIZE + offset)), 1), bswap)
+
+#define SHA1_AVX2_STORE(idx, value)                                                                 \
+        _mm_storeu_si128((__m128i*)(wk[0] + idx), _mm256_castsi256_si128(value));                   \
+        _mm_storeu_si128((__m128i*)(wk[1] + idx), _mm256_extracti128_si256(value, 1));
+
+        w0 = SHA1_AVX2_LOAD(0);
+        w1 = SHA1_AVX2_LOAD(16);
+        w2 = SHA1_AVX2_LOAD(32);
+        w3 = SHA1_AVX2_LOAD(48);
+
+        tmp = _mm256_set1_epi32((int)SHA1_K0);
+        SHA1_AVX2_STORE(0, _mm256_add_epi32(w0, tmp));
+        SHA1_AVX2_STORE(4, _mm256_add_epi32(w1, tmp));
+        SHA1_AVX2_STORE(8, _mm256_add_epi32(w2, tmp));
+        SHA1_AVX2_STORE(12, _mm256_add_epi32(w3, tmp));
+
+        /* expand schedule */
+        for(idx = 16; idx < 80; idx += 4)
+        {
+            SHA1_AVX2_SCHEDULE(w0, w1, w2, w3, wn);
+            SHA1_AVX2_STORE(idx, _mm256_add_epi32(wn, _mm256_set1_epi32((int)_sha1_round_constant(idx))));
+
+            w0 = w1;
+            w1 = w2;
+            w2 = w3;
+            w3 = wn;
+        }
+
+#undef SHA1_AVX2_LOAD
+#undef SHA1_AVX2_STORE
+
+        _sha1_rounds_wk(state, wk[0]);
+        _sha1_rounds_wk(state, wk[1]);
+    }
+
+    /* last odd block */
+    if(blocks > 0)
+    {
+        _sha1_transform_ssse3(state, data, blocks);
+    }
+}
+
+/* four rounds with sha instructions, e_next receives abcd for the next step */
+#define SHA1NI_ROUNDS(e_cur, e_next, msg, func)         \
+    e_cur = _mm_sha1nexte_epu32(e_cur, msg);            \
+    e_next = abcd;                                      \
+    abcd = _mm_sha1rnds4_epu32(abcd, e_cur, func);
+
+ELIBC_TARGET("sha,sse4.1,ssse3")
+void _sha1_transform_shani(euint32_t* state, const euint8_t* data, size_t blocks)
+{
+    __m128i abcd, abcd_save, e0, e0_save, e1;
+    __m128i msg0, msg1, msg2, msg3;
+    __m128i bswap;
+
+    /* big endian words in reversed order */
+    bswap = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+
+    /* load state */
+    abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)state), 0x1B);
+    e0 = _mm_set_epi32((int)state[4], 0, 0, 0);
+
+    for( ; blocks > 0; --blocks, data += HASH_SHA1_BLOCK_SIZE)
+    {
+        abcd_save = abcd;
+        e0_save = e0;
+
+        /* rounds 0-3 */
+        msg0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), bswap);
+        e0 = _mm_add_epi32(e0, msg0);
+        e1 = abcd;
+        abcd = _mm_sha1rnds4_epu32(abcd, e0, 0);
+
+        /* rounds 4-7 */
+        msg1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), bswap);
+        SHA1NI_ROUNDS(e1, e0, msg1, 0);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+
+        /* rounds 8-11 */
+        msg2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), bswap);
+        SHA1NI_ROUNDS(e0, e1, msg2, 0);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        /* rounds 12-15 */
+        msg3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), bswap);
+        SHA1NI_ROUNDS(e1, e0, msg3, 0);
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+        /* rounds 16-19 */
+        SHA1NI_ROUNDS(e0, e1, msg0, 0);
+        msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+        msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+        msg2 = _mm_xor_si128(msg2, msg0);
+
+        /* rounds 20-23 */
+        SHA1NI_ROUNDS(e1, e0, msg1, 1);
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        /* rounds 24-27 */
+        SHA1NI_ROUNDS(e0, e1, msg2, 1);
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        /* rounds 28-31 */
+        SHA1NI_ROUNDS(e1, e0, msg3, 1);
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+        /* rounds 32-35 */
+        SHA1NI_ROUNDS(e0, e1, msg0, 1);
+        msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+        msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+        msg2 = _mm_xor_si128(msg2, msg0);
+
+        /* rounds 36-39 */
+        SHA1NI_ROUNDS(e1, e0, msg1, 1);
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        /* rounds 40-43 */
+        SHA1NI_ROUNDS(e0, e1, msg2, 2);
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        /* rounds 44-47 */
+        SHA1NI_ROUNDS(e1, e0, msg3, 2);
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+        /* rounds 48-51 */
+        SHA1NI_ROUNDS(e0, e1, msg0, 2);
+        msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+        msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+        msg2 = _mm_xor_si128(msg2, msg0);
+
+        /* rounds 52-55 */
+        SHA1NI_ROUNDS(e1, e0, msg1, 2);
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        msg0 = _mm_sha1msg1_epu32(msg0, msg1);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        /* rounds 56-59 */
+        SHA1NI_ROUNDS(e0, e1, msg2, 2);
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+        msg1 = _mm_sha1msg1_epu32(msg1, msg2);
+        msg0 = _mm_xor_si128(msg0, msg2);
+
+        /* rounds 60-63 */
+        SHA1NI_ROUNDS(e1, e0, msg3, 3);
+        msg0 = _mm_sha1msg2_epu32(msg0, msg3);
+        msg2 = _mm_sha1msg1_epu32(msg2, msg3);
+        msg1 = _mm_xor_si128(msg1, msg3);
+
+        /* rounds 64-67 */
+        SHA1NI_ROUNDS(e0, e1, msg0, 3);
+        msg1 = _mm_sha1msg2_epu32(msg1, msg0);
+        msg3 = _mm_sha1msg1_epu32(msg3, msg0);
+        msg2 = _mm_xor_si128(msg2, msg0);
+
+        /* rounds 68-71 */
+        SHA1NI_ROUNDS(e1, e0, msg1, 3);
+        msg2 = _mm_sha1msg2_epu32(msg2, msg1);
+        msg3 = _mm_xor_si128(msg3, msg1);
+
+        /* rounds 72-75 */
+        SHA1NI_ROUNDS(e0, e1, msg2, 3);
+        msg3 = _mm_sha1msg2_epu32(msg3, msg2);
+
+        /* rounds 76-79 */
+        SHA1NI_ROUNDS(e1, e0, msg3, 3);
+
+        /* add block result to state */
+        e0 = _mm_sha1nexte_epu32(e0, e0_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+    }
+
+    /* store state */
+    _mm_storeu_si128((__m128i*)state, _mm_shuffle_epi32(abcd, 0x1B));
+    state[4] = (euint32_t)_mm_extract_epi32(e0, 3);
+}
+
+#endif /* _ELIBC_ARCH_X86 */
+
 /*----------------------------------------------------------------------*/
+/* transform selection */
+
+static sha1_transform_t _sha1_transform = 0;
+static hash_sha1_impl_t _sha1_impl = hash_sha1_impl_auto;
+
+/* get transform function or zero if not supported */
+sha1_transform_t _sha1_find_transform(hash_sha1_impl_t sha1_impl)
+{
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+    unsigned int features = esystem_cpu_features();
+
+    switch(sha1_impl)
+    {
+    case hash_sha1_impl_ssse3:
+        if(features & ESYSTEM_CPU_SSSE3) return _sha1_transform_ssse3;
+        break;
+
+    case hash_sha1_impl_avx2:
+        if((features & (ESYSTEM_CPU_SSSE3 | ESYSTEM_CPU_AVX2)) == (ESYSTEM_CPU_SSSE3 | ESYSTEM_CPU_AVX2)) return _sha1_transform_avx2;
+        break;
+
+    case hash_sha1_impl_shani:
+        if((features & (ESYSTEM_CPU_SSSE3 | ESYSTEM_CPU_SSE41 | ESYSTEM_CPU_SHA)) == (ESYSTEM_CPU_SSSE3 | ESYSTEM_CPU_SSE41 | ESYSTEM_CPU_SHA)) return _sha1_transform_shani;
+        break;
+
+    default:
+        break;
+    }
+#endif /* _ELIBC_ARCH_X86 */
+
+    return (sha1_impl == hash_sha1_impl_portable) ? _sha1_transform_portable : 0;
+}
+
+sha1_transform_t _sha1_get_transform()
+{
+    /* select best implementation on first use */
+    if(_sha1_transform == 0) hash_sha1_set_impl(hash_sha1_impl_auto);
+
+    return _sha1_transform;
+}
+
+/*----------------------------------------------------------------------*/
+
+/* block transform selection */
+int hash_sha1_set_impl(hash_sha1_impl_t sha1_impl)
+{
+    sha1_transform_t sha1_transform;
+
+    /* select the fastest supported implementation */
+    if(sha1_impl == hash_sha1_impl_auto)
+    {
+        sha1_impl = hash_sha1_impl_shani;
+        while((sha1_transform = _sha1_find_transform(sha1_impl)) == 0)
+        {
+            sha1_impl = (hash_sha1_impl_t)(sha1_impl - 1);
+        }
+
+    } else
+    {
+        sha1_transform = _sha1_find_transform(sha1_impl);
+        if(sha1_transform == 0) return ELIBC_ERROR_NOT_SUPPORTED;
+    }
+
+    _sha1_transform = sha1_transform;
+    _sha1_impl = sha1_impl;
+
+    return ELIBC_SUCCESS;
+}
+
+hash_sha1_impl_t hash_sha1_get_impl()
+{
+    /* make sure implementation is selected */
+    _sha1_get_transform();
+
+    return _sha1_impl;
+}
 
 /* hash in binary data */
 void hash_sha1_begin(sha1_context_t* sha1_context)
@@ -122,11 +544,17 @@ void hash_sha1_update(sha1_context_t* sha1_context, const euint8_t* data, euint3
     /* update hash */
     if ((idx_j + data_size) > 63) 
     {
+        sha1_transform_t sha1_transform = _sha1_get_transform();
+
+        /* finish buffered block */
         ememcpy(&sha1_context->buffer[idx_j], data, (idx_i = 64-idx_j));
-        _sha1_transform(sha1_context->state, sha1_context->buffer);
-        for ( ; idx_i + 63 < data_size; idx_i += 64) 
+        sha1_transform(sha1_context->state, sha1_context->buffer, 1);
+
+        /* hash all full blocks directly from input */
+        if(idx_i + 63 < data_size)
         {
-            _sha1_transform(sha1_context->state, data + idx_i);
+            sha1_transform(sha1_context->state, data + idx_i, (data_size - idx_i) / 64);
+            idx_i += ((data_size - idx_i) / 64) * 64;
         }
         idx_j = 0;
     } else  
@@ -140,24 +568,33 @@ void hash_sha1_update(sha1_context_t* sha1_context, const euint8_t* data, euint3
 
 void hash_sha1_end(sha1_context_t* sha1_context, euint8_t* digest_out)
 {
-    size_t      idx_i;
-    euint8_t    finalcount[8];
+    size_t      idx_i, idx_j;
 
     EASSERT(sha1_context);
     EASSERT(digest_out);
     if(sha1_context == 0 || digest_out == 0) return;
 
-    for (idx_i = 0; idx_i < 8; idx_i++) {
-        finalcount[idx_i] = (euint8_t)((sha1_context->count[(idx_i >= 4 ? 0 : 1)]
-         >> ((3-(idx_i & 3)) * 8) ) & 255);  /* Endian independent */
+    /* append padding directly to buffered block */
+    idx_j = (sha1_context->count[0] >> 3) & 63;
+    sha1_context->buffer[idx_j++] = 0x80;
+
+    /* length must fit to the last 8 bytes */
+    if(idx_j > 56)
+    {
+        ememset(&sha1_context->buffer[idx_j], 0, 64 - idx_j);
+        _sha1_get_transform()(sha1_context->state, sha1_context->buffer, 1);
+        idx_j = 0;
     }
+    ememset(&sha1_context->buffer[idx_j], 0, 56 - idx_j);
 
-    hash_sha1_update(sha1_context, (euint8_t *)"\200", 1);
-    while ((sha1_context->count[0] & 504) != 448) {
-        hash_sha1_update(sha1_context, (euint8_t *)"\0", 1);
+    /* message length in bits (endian independent) */
+    for (idx_i = 0; idx_i < 8; idx_i++) {
+        sha1_context->buffer[56 + idx_i] = (euint8_t)((sha1_context->count[(idx_i >= 4 ? 0 : 1)]
+         >> ((3-(idx_i & 3)) * 8) ) & 255);
     }
 
-    hash_sha1_update(sha1_context, finalcount, 8);  /* Should cause a _sha1_transform() */
+    _sha1_get_transform()(sha1_context->state, sha1_context->buffer, 1);
+
     for (idx_i = 0; idx_i < HASH_SHA1_DIGEST_SIZE; idx_i++) {
         digest_out[idx_i] = (euint8_t)
          ((sha1_context->state[idx_i>>2] >> ((3-(idx_i & 3)) * 8) ) & 255);
@@ -14,6 +14,7 @@
 /* constants */
 #define HASH_SHA1_BLOCK_SIZE                    64
 #define HASH_SHA1_DIGEST_SIZE                   20
+#define HASH_SHA1_MAX_LANES                     16
 
 /*----------------------------------------------------------------------*/
 
@@ -26,8 +27,28 @@ typedef struct
 
 } sha1_context_t;
 
+/* block transform implementations */
+typedef enum
+{
+    hash_sha1_impl_auto,
+    hash_sha1_impl_portable,
+    hash_sha1_impl_ssse3,
+    hash_sha1_impl_avx2,
+    hash_sha1_impl_shani
+
+} hash_sha1_impl_t;
+
 /*----------------------------------------------------------------------*/
 
+/*
+    NOTE: the fastest implementation supported by cpu is selected on first use,
+          selecting it manually is only needed for testing and benchmarking
+*/
+
+/* block transform selection */
+int hash_sha1_set_impl(hash_sha1_impl_t sha1_impl);
+hash_sha1_impl_t hash_sha1_get_impl();
+
 /*
     NOTE: functions expect digest_out to be of size HASH_SHA1_DIGEST_SIZE
 */
@@ -40,6 +61,24 @@ void hash_sha1_end(sha1_context_t* sha1_context, euint8_t* digest_out);
 /* hash data in single run */
 int hash_sha1(const euint8_t* data, euint32_t data_size, euint8_t* digest_out);
 
+/*
+    NOTE: - multi functions hash count independent messages and write count digests
+            one after another to digests_out, messages are hashed in groups of lanes
+            (16 with AVX-512, 8 with AVX2, 4 with SSE2 or one by one without SIMD,
+            with SHA extensions only 16 lanes are faster than one by one hashing),
+            lanes are best utilized when messages have similar length
+          - prefix_context must have whole blocks hashed in (e.g. HMAC key pad)
+*/
+
+/* hash many messages in parallel */
+int hash_sha1_multi(const euint8_t* const* data, const euint32_t* data_sizes, size_t count, euint8_t* digests_out);
+int hash_sha1_multi_prefix(const sha1_context_t* prefix_context, const euint8_t* const* data, const euint32_t* data_sizes,
+                           size_t count, euint8_t* digests_out);
+
+/* lanes selection (zero selects the fastest supported) */
+int hash_sha1_multi_set_lanes(size_t lanes);
+size_t hash_sha1_multi_lanes();
+
 /*----------------------------------------------------------------------*/
 
 #endif /* _HASH_SHA1_H_ */
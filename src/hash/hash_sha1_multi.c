@@ -0,0 +1,449 @@
+/*
+    SHA1 hash functions for many messages in parallel
+*/
+
+#include "../elib_config.h"
+
+#include "hash_sha1.h"
+
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+#include <immintrin.h>
+#endif
+
+/*----------------------------------------------------------------------*/
+
+/*
+    Every vector lane hashes its own message. State and message words are
+    kept transposed (word of all lanes per vector), so rounds are exactly
+    the same as in scalar code. Messages are padded in advance, lanes which
+    finished their message still run transform but keep their state.
+*/
+
+/* lane transform (transposed state, block pointer per lane) */
+typedef void (*sha1_multi_transform_t)(euint32_t*, const euint8_t* const*);
+
+/* padded message tail (up to two blocks) */
+#define SHA1_MULTI_TAIL_SIZE        (2 * HASH_SHA1_BLOCK_SIZE)
+
+/* round constants */
+#define SHA1_MULTI_K0               0x5A827999
+#define SHA1_MULTI_K1               0x6ED9EBA1
+#define SHA1_MULTI_K2               0x8F1BBCDC
+#define SHA1_MULTI_K3               0xCA62C1D6
+
+/*----------------------------------------------------------------------*/
+/* worker methods */
+ELIBC_FORCE_INLINE euint32_t _sha1_multi_load_be32(const euint8_t* data)
+{
+    return ((euint32_t)data[0] << 24) | ((euint32_t)data[1] << 16) | ((euint32_t)data[2] << 8) | (euint32_t)data[3];
+}
+
+/* transpose message words (word idx of all lanes is stored continuously) */
+ELIBC_FORCE_INLINE void _sha1_multi_load_words(euint32_t* words, const euint8_t* const* blocks, size_t lanes)
+{
+    size_t lane, idx;
+
+    for(lane = 0; lane < lanes; ++lane)
+    {
+        for(idx = 0; idx < 16; ++idx)
+        {
+            words[idx * lanes + lane] = _sha1_multi_load_be32(blocks[lane] + 4 * idx);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------*/
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+
+/*
+    Kernels share round code, vector operations are defined before each
+    kernel as V_* macros (f2 is parity, f3 is majority)
+*/
+#define SHA1_MULTI_ROUND(func, k, idx)                                                  \
+    if((idx) >= 16)                                                                     \
+    {                                                                                   \
+        w[(idx) & 15] = V_ROL(V_XOR(V_XOR(w[((idx) + 13) & 15], w[((idx) + 8) & 15]),   \
+                                    V_XOR(w[((idx) + 2) & 15], w[(idx) & 15])), 1);     \
+    }                                                                                   \
+    tmp = V_ADD(V_ADD(V_ROL(a, 5), func(b, c, d)), V_ADD(V_ADD(e, k), w[(idx) & 15]));  \
+    e = d;                                                                              \
+    d = c;                                                                              \
+    c = V_ROL(b, 30);                                                                   \
+    b = a;                                                                              \
+    a = tmp;
+
+/* rounds are unrolled, so schedule indices are constant */
+#define SHA1_MULTI_ROUND4(func, k, idx)                                                 \
+    SHA1_MULTI_ROUND(func, k, (idx) + 0);                                               \
+    SHA1_MULTI_ROUND(func, k, (idx) + 1);                                               \
+    SHA1_MULTI_ROUND(func, k, (idx) + 2);                                               \
+    SHA1_MULTI_ROUND(func, k, (idx) + 3);
+
+#define SHA1_MULTI_ROUND20(func, k, idx)                                                \
+    SHA1_MULTI_ROUND4(func, k, (idx) + 0);                                              \
+    SHA1_MULTI_ROUND4(func, k, (idx) + 4);                                              \
+    SHA1_MULTI_ROUND4(func, k, (idx) + 8);                                              \
+    SHA1_MULTI_ROUND4(func, k, (idx) + 12);                                             \
+    SHA1_MULTI_ROUND4(func, k, (idx) + 16);
+
+#define SHA1_MULTI_TRANSFORM(lanes)                                                     \
+    _sha1_multi_load_words(words, blocks, lanes);                                       \
+    for(idx = 0; idx < 16; ++idx) w[idx] = V_LOAD(words + idx * (lanes));               \
+                                                                                        \
+    a = V_LOAD(state + 0 * (lanes));                                                    \
+    b = V_LOAD(state + 1 * (lanes));                                                    \
+    c = V_LOAD(state + 2 * (lanes));                                                    \
+    d = V_LOAD(state + 3 * (lanes));                                                    \
+    e = V_LOAD(state + 4 * (lanes));                                                    \
+                                                                                        \
+    SHA1_MULTI_ROUND20(V_F0, V_SET1(SHA1_MULTI_K0), 0);                                 \
+    SHA1_MULTI_ROUND20(V_F2, V_SET1(SHA1_MULTI_K1), 20);                                \
+    SHA1_MULTI_ROUND20(V_F3, V_SET1(SHA1_MULTI_K2), 40);                                \
+    SHA1_MULTI_ROUND20(V_F2, V_SET1(SHA1_MULTI_K3), 60);                                \
+                                                                                        \
+    V_STORE(state + 0 * (lanes), V_ADD(a, V_LOAD(state + 0 * (lanes))));                \
+    V_STORE(state + 1 * (lanes), V_ADD(b, V_LOAD(state + 1 * (lanes))));                \
+    V_STORE(state + 2 * (lanes), V_ADD(c, V_LOAD(state + 2 * (lanes))));                \
+    V_STORE(state + 3 * (lanes), V_ADD(d, V_LOAD(state + 3 * (lanes))));                \
+    V_STORE(state + 4 * (lanes), V_ADD(e, V_LOAD(state + 4 * (lanes))));
+
+/*----------------------------------------------------------------------*/
+/* SSE2 (4 lanes) */
+#define V_LOAD(p)           _mm_loadu_si128((const __m128i*)(p))
+#define V_STORE(p, v)       _mm_storeu_si128((__m128i*)(p), v)
+#define V_SET1(x)           _mm_set1_epi32((int)(x))
+#define V_ADD(x, y)         _mm_add_epi32(x, y)
+#define V_XOR(x, y)         _mm_xor_si128(x, y)
+#define V_ROL(x, n)         _mm_or_si128(_mm_slli_epi32(x, n), _mm_srli_epi32(x, 32 - (n)))
+#define V_F0(x, y, z)       _mm_xor_si128(z, _mm_and_si128(x, _mm_xor_si128(y, z)))
+#define V_F2(x, y, z)       _mm_xor_si128(_mm_xor_si128(x, y), z)
+#define V_F3(x, y, z)       _mm_or_si128(_mm_and_si128(x, y), _mm_and_si128(z, _mm_or_si128(x, y)))
+
+ELIBC_TARGET("sse2")
+void _sha1_multi_transform_sse2(euint32_t* state, const euint8_t* const* blocks)
+{
+    euint32_t words[16 * 4];
+    __m128i a, b, c, d, e, tmp, w[16];
+    int idx;
+
+    SHA1_MULTI_TRANSFORM(4);
+}
+
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ADD
+#undef V_XOR
+#undef V_ROL
+#undef V_F0
+#undef V_F2
+#undef V_F3
+
+/*----------------------------------------------------------------------*/
+/* AVX2 (8 lanes) */
+#define V_LOAD(p)           _mm256_loadu_si256((const __m256i*)(p))
+#define V_STORE(p, v)       _mm256_storeu_si256((__m256i*)(p), v)
+#define V_SET1(x)           _mm256_set1_epi32((int)(x))
+#define V_ADD(x, y)         _mm256_add_epi32(x, y)
+#define V_XOR(x, y)         _mm256_xor_si256(x, y)
+#define V_ROL(x, n)         _mm256_or_si256(_mm256_slli_epi32(x, n), _mm256_srli_epi32(x, 32 - (n)))
+#define V_F0(x, y, z)       _mm256_xor_si256(z, _mm256_and_si256(x, _mm256_xor_si256(y, z)))
+#define V_F2(x, y, z)       _mm256_xor_si256(_mm256_xor_si256(x, y), z)
+#define V_F3(x, y, z)       _mm256_or_si256(_mm256_and_si256(x, y), _mm256_and_si256(z, _mm256_or_si256(x, y)))
+
+ELIBC_TARGET("avx2")
+void _sha1_multi_transform_avx2(euint32_t* state, const euint8_t* const* blocks)
+{
+    euint32_t words[16 * 8];
+    __m256i a, b, c, d, e, tmp, w[16];
+    int idx;
+
+    SHA1_MULTI_TRANSFORM(8);
+}
+
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ADD
+#undef V_XOR
+#undef V_ROL
+#undef V_F0
+#undef V_F2
+#undef V_F3
+
+/*----------------------------------------------------------------------*/
+/* AVX-512 (16 lanes, rotate and ternary logic instructions) */
+#define V_LOAD(p)           _mm512_loadu_si512((const void*)(p))
+#define V_STORE(p, v)       _mm512_storeu_si512((void*)(p), v)
+#define V_SET1(x)           _mm512_set1_epi32((int)(x))
+#define V_ADD(x, y)         _mm512_add_epi32(x, y)
+#define V_XOR(x, y)         _mm512_xor_si512(x, y)
+#define V_ROL(x, n)         _mm512_rol_epi32(x, n)
+#define V_F0(x, y, z)       _mm512_ternarylogic_epi32(x, y, z, 0xCA)
+#define V_F2(x, y, z)       _mm512_ternarylogic_epi32(x, y, z, 0x96)
+#define V_F3(x, y, z)       _mm512_ternarylogic_epi32(x, y, z, 0xE8)
+
+ELIBC_TARGET("avx512f")
+void _sha1_multi_transform_avx512(euint32_t* state, const euint8_t* const* blocks)
+{
+    euint32_t words[16 * 16];
+    __m512i a, b, c, d, e, tmp, w[16];
+    int idx;
+
+    SHA1_MULTI_TRANSFORM(16);
+}
+
+#undef V_LOAD
+#undef V_STORE
+#undef V_SET1
+#undef V_ADD
+#undef V_XOR
+#undef V_ROL
+#undef V_F0
+#undef V_F2
+#undef V_F3
+
+#endif /* _ELIBC_ARCH_X86 */
+
+/*----------------------------------------------------------------------*/
+/* lanes selection */
+
+static sha1_multi_transform_t _sha1_multi_transform = 0;
+static size_t _sha1_multi_lanes = 0;
+
+/* get lane transform or zero if not supported (single lane has no transform) */
+int _sha1_multi_find_transform(size_t lanes, sha1_multi_transform_t* sha1_multi_transform)
+{
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+    unsigned int features = esystem_cpu_features();
+
+    switch(lanes)
+    {
+    case 4:
+        *sha1_multi_transform = _sha1_multi_transform_sse2;
+        return (features & ESYSTEM_CPU_SSE2) ? ELIBC_SUCCESS : ELIBC_ERROR_NOT_SUPPORTED;
+        break;
+
+    case 8:
+        *sha1_multi_transform = _sha1_multi_transform_avx2;
+        return (features & ESYSTEM_CPU_AVX2) ? ELIBC_SUCCESS : ELIBC_ERROR_NOT_SUPPORTED;
+        break;
+
+    case 16:
+        *sha1_multi_transform = _sha1_multi_transform_avx512;
+        return (features & ESYSTEM_CPU_AVX512) ? ELIBC_SUCCESS : ELIBC_ERROR_NOT_SUPPORTED;
+        break;
+
+    default:
+        break;
+    }
+#endif /* _ELIBC_ARCH_X86 */
+
+    *sha1_multi_transform = 0;
+    return (lanes == 1) ? ELIBC_SUCCESS : ELIBC_ERROR_NOT_SUPPORTED;
+}
+
+/* hash up to lanes messages at once */
+void _sha1_multi_hash_lanes(sha1_multi_transform_t sha1_multi_transform, size_t lanes, const sha1_context_t* prefix_context,
+                            const euint8_t* const* data, const euint32_t* data_sizes, size_t count, euint8_t* digests_out)
+{
+    euint32_t state[5 * HASH_SHA1_MAX_LANES];
+    euint32_t saved_state[5 * HASH_SHA1_MAX_LANES];
+    euint8_t tail[HASH_SHA1_MAX_LANES][SHA1_MULTI_TAIL_SIZE];
+    euint8_t dummy_block[HASH_SHA1_BLOCK_SIZE];
+    const euint8_t* blocks[HASH_SHA1_MAX_LANES];
+    size_t full_blocks[HASH_SHA1_MAX_LANES];
+    size_t total_blocks[HASH_SHA1_MAX_LANES];
+    size_t lane, block, max_blocks, tail_size, idx;
+    euint64_t bit_count;
+
+    EASSERT(count <= lanes);
+
+    /* unused lanes hash dummy block */
+    ememset(dummy_block, 0, sizeof(dummy_block));
+
+    /* prepare lanes */
+    max_blocks = 0;
+    for(lane = 0; lane < lanes; ++lane)
+    {
+        /* copy prefix state */
+        for(idx = 0; idx < 5; ++idx)
+        {
+            state[idx * lanes + lane] = prefix_context->state[idx];
+        }
+
+        if(lane >= count)
+        {
+            total_blocks[lane] = 0;
+            continue;
+        }
+
+        /* whole blocks are hashed directly from input */
+        full_blocks[lane] = data_sizes[lane] / HASH_SHA1_BLOCK_SIZE;
+        tail_size = data_sizes[lane] % HASH_SHA1_BLOCK_SIZE;
+
+        /* message length in bits including prefix */
+        bit_count = ((euint64_t)prefix_context->count[1] << 32) + prefix_context->count[0] + ((euint64_t)data_sizes[lane] << 3);
+
+        /* pad tail (length must fit to the last 8 bytes) */
+        total_blocks[lane] = full_blocks[lane] + ((tail_size + 9 > HASH_SHA1_BLOCK_SIZE) ? 2 : 1);
+
+        ememset(tail[lane], 0, SHA1_MULTI_TAIL_SIZE);
+        if(tail_size > 0) ememcpy(tail[lane], data[lane] + full_blocks[lane] * HASH_SHA1_BLOCK_SIZE, tail_size);
+        tail[lane][tail_size] = 0x80;
+
+        tail_size = (total_blocks[lane] - full_blocks[lane]) * HASH_SHA1_BLOCK_SIZE;
+        for(idx = 0; idx < 8; ++idx)
+        {
+            tail[lane][tail_size - 1 - idx] = (euint8_t)(bit_count >> (8 * idx));
+        }
+
+        if(total_blocks[lane] > max_blocks) max_blocks = total_blocks[lane];
+    }
+
+    /* hash blocks of all lanes */
+    for(block = 0; block < max_blocks; ++block)
+    {
+        for(lane = 0; lane < lanes; ++lane)
+        {
+            if(block < full_blocks[lane] && lane < count)
+            {
+                blocks[lane] = data[lane] + block * HASH_SHA1_BLOCK_SIZE;
+
+            } else if(block < total_blocks[lane])
+            {
+                blocks[lane] = tail[lane] + (block - full_blocks[lane]) * HASH_SHA1_BLOCK_SIZE;
+
+            } else
+            {
+                blocks[lane] = dummy_block;
+            }
+        }
+
+        /* keep state of finished lanes */
+        ememcpy(saved_state, state, 5 * lanes * sizeof(euint32_t));
+
+        sha1_multi_transform(state, blocks);
+
+        for(lane = 0; lane < count; ++lane)
+        {
+            if(block >= total_blocks[lane])
+            {
+                for(idx = 0; idx < 5; ++idx)
+                {
+                    state[idx * lanes + lane] = saved_state[idx * lanes + lane];
+                }
+            }
+        }
+    }
+
+    /* output digests */
+    for(lane = 0; lane < count; ++lane)
+    {
+        for(idx = 0; idx < HASH_SHA1_DIGEST_SIZE; ++idx)
+        {
+            digests_out[lane * HASH_SHA1_DIGEST_SIZE + idx] =
+                (euint8_t)((state[(idx >> 2) * lanes + lane] >> ((3 - (idx & 3)) * 8)) & 255);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------*/
+
+/* hash many messages in parallel */
+int hash_sha1_multi(const euint8_t* const* data, const euint32_t* data_sizes, size_t count, euint8_t* digests_out)
+{
+    sha1_context_t sha1_context;
+
+    /* hash with empty prefix */
+    hash_sha1_begin(&sha1_context);
+
+    return hash_sha1_multi_prefix(&sha1_context, data, data_sizes, count, digests_out);
+}
+
+int hash_sha1_multi_prefix(const sha1_context_t* prefix_context, const euint8_t* const* data, const euint32_t* data_sizes,
+                           size_t count, euint8_t* digests_out)
+{
+    sha1_multi_transform_t sha1_multi_transform;
+    sha1_context_t sha1_context;
+    size_t lanes, idx;
+
+    EASSERT(prefix_context);
+    EASSERT(data);
+    EASSERT(data_sizes);
+    EASSERT(digests_out);
+    if(prefix_context == 0 || data == 0 || data_sizes == 0 || digests_out == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* prefix must end on block boundary */
+    if(prefix_context->count[0] & (HASH_SHA1_BLOCK_SIZE * 8 - 1)) return ELIBC_ERROR_ARGUMENT;
+
+    /* select lanes on first use */
+    lanes = hash_sha1_multi_lanes();
+    sha1_multi_transform = _sha1_multi_transform;
+
+    /* hash one by one if there is no SIMD support */
+    if(sha1_multi_transform == 0)
+    {
+        for(idx = 0; idx < count; ++idx)
+        {
+            sha1_context = *prefix_context;
+            if(data_sizes[idx] > 0) hash_sha1_update(&sha1_context, data[idx], data_sizes[idx]);
+            hash_sha1_end(&sha1_context, digests_out + idx * HASH_SHA1_DIGEST_SIZE);
+        }
+
+        return ELIBC_SUCCESS;
+    }
+
+    /* hash in groups of lanes */
+    for(idx = 0; idx < count; idx += lanes)
+    {
+        _sha1_multi_hash_lanes(sha1_multi_transform, lanes, prefix_context, data + idx, data_sizes + idx,
+                               (count - idx < lanes) ? count - idx : lanes, digests_out + idx * HASH_SHA1_DIGEST_SIZE);
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+/* lanes selection (zero selects the fastest supported) */
+int hash_sha1_multi_set_lanes(size_t lanes)
+{
+    sha1_multi_transform_t sha1_multi_transform = 0;
+    int err;
+
+    if(lanes == 0)
+    {
+        /* select the widest supported lanes */
+        lanes = HASH_SHA1_MAX_LANES;
+        while(_sha1_multi_find_transform(lanes, &sha1_multi_transform) != ELIBC_SUCCESS)
+        {
+            lanes = (lanes > 4) ? lanes / 2 : 1;
+        }
+
+        /* SHA extensions hash one message faster than 4 or 8 lanes */
+        if(lanes > 1 && lanes < HASH_SHA1_MAX_LANES && (esystem_cpu_features() & ESYSTEM_CPU_SHA))
+        {
+            lanes = 1;
+            _sha1_multi_find_transform(lanes, &sha1_multi_transform);
+        }
+
+    } else
+    {
+        err = _sha1_multi_find_transform(lanes, &sha1_multi_transform);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    _sha1_multi_transform = sha1_multi_transform;
+    _sha1_multi_lanes = lanes;
+
+    return ELIBC_SUCCESS;
+}
+
+size_t hash_sha1_multi_lanes()
+{
+    /* select lanes on first use */
+    if(_sha1_multi_lanes == 0) hash_sha1_multi_set_lanes(0);
+
+    return _sha1_multi_lanes;
+}
+
+/*----------------------------------------------------------------------*/
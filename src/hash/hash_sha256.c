@@ -0,0 +1,551 @@
+/*
+    SHA256 hash functions
+*/
+
+#include "../elib_config.h"
+
+#include "hash_sha256.h"
+
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+#include <immintrin.h>
+#endif
+
+/*----------------------------------------------------------------------*/
+
+/* round constants */
+static const euint32_t _sha256_k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/* block transform (state, data, number of 64 bytes blocks) */
+typedef void (*sha256_transform_t)(euint32_t*, const euint8_t*, size_t);
+
+/*----------------------------------------------------------------------*/
+
+/* helper macro */
+#define ror(value, bits) (((value) >> (bits)) | ((value) << (32 - (bits))))
+
+#define SHA256_CH(x, y, z)      (((x) & ((y) ^ (z))) ^ (z))
+#define SHA256_MAJ(x, y, z)     (((x) & (y)) | ((z) & ((x) | (y))))
+#define SHA256_S0(x)            (ror(x, 2) ^ ror(x, 13) ^ ror(x, 22))
+#define SHA256_S1(x)            (ror(x, 6) ^ ror(x, 11) ^ ror(x, 25))
+#define SHA256_G0(x)            (ror(x, 7) ^ ror(x, 18) ^ ((x) >> 3))
+#define SHA256_G1(x)            (ror(x, 17) ^ ror(x, 19) ^ ((x) >> 10))
+
+/* round with precomputed schedule (W + K), variables are rotated by caller */
+#define RW(a,b,c,d,e,f,g,h,i)                                                   \
+    tmp = h + SHA256_S1(e) + SHA256_CH(e,f,g) + wk[i];                          \
+    d += tmp;                                                                   \
+    h = tmp + SHA256_S0(a) + SHA256_MAJ(a,b,c);
+
+#define RW8(i)                                                                  \
+    RW(a,b,c,d,e,f,g,h,(i)+0); RW(h,a,b,c,d,e,f,g,(i)+1);                       \
+    RW(g,h,a,b,c,d,e,f,(i)+2); RW(f,g,h,a,b,c,d,e,(i)+3);                       \
+    RW(e,f,g,h,a,b,c,d,(i)+4); RW(d,e,f,g,h,a,b,c,(i)+5);                       \
+    RW(c,d,e,f,g,h,a,b,(i)+6); RW(b,c,d,e,f,g,h,a,(i)+7);
+
+/*----------------------------------------------------------------------*/
+
+/* 64 rounds with precomputed schedule */
+void _sha256_rounds_wk(euint32_t* state, const euint32_t* wk)
+{
+    euint32_t a, b, c, d, e, f, g, h, tmp;
+
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
+
+    RW8(0); RW8(8); RW8(16); RW8(24);
+    RW8(32); RW8(40); RW8(48); RW8(56);
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+/*
+    Hash 512-bit blocks.
+     - state size is expected to be eight 32 bits values
+     - data size is expected to be 64 bytes per block
+*/
+void _sha256_transform_portable(euint32_t* state, const euint8_t* data, size_t blocks)
+{
+    euint32_t w[64], wk[64];
+    int idx;
+
+    for( ; blocks > 0; --blocks, data += HASH_SHA256_BLOCK_SIZE)
+    {
+        /* big endian words (also handles unaligned input) */
+        for(idx = 0; idx < 16; ++idx)
+        {
+            w[idx] = ((euint32_t)data[4 * idx] << 24) | ((euint32_t)data[4 * idx + 1] << 16) |
+                     ((euint32_t)data[4 * idx + 2] << 8) | (euint32_t)data[4 * idx + 3];
+        }
+
+        /* expand schedule */
+        for(idx = 16; idx < 64; ++idx)
+        {
+            w[idx] = SHA256_G1(w[idx - 2]) + w[idx - 7] + SHA256_G0(w[idx - 15]) + w[idx - 16];
+        }
+
+        for(idx = 0; idx < 64; ++idx)
+        {
+            wk[idx] = w[idx] + _sha256_k[idx];
+        }
+
+        _sha256_rounds_wk(state, wk);
+    }
+}
+
+/*----------------------------------------------------------------------*/
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+
+/*
+    SSSE3 and AVX2 variants compute message schedule (W + K) with vector instructions
+    four words at a time (AVX2 does this for two blocks at once), rounds are scalar.
+    Sigma1 depends on the two previous words, so it is added in two halves.
+    SHA-NI variant uses dedicated SHA instructions for both schedule and rounds.
+*/
+
+#define SHA256_SSE_ROR(x, bits)   _mm_or_si128(_mm_srli_epi32(x, bits), _mm_slli_epi32(x, 32 - (bits)))
+#define SHA256_SSE_G0(x)          _mm_xor_si128(_mm_xor_si128(SHA256_SSE_ROR(x, 7), SHA256_SSE_ROR(x, 18)), _mm_srli_epi32(x, 3))
+#define SHA256_SSE_G1(x)          _mm_xor_si128(_mm_xor_si128(SHA256_SSE_ROR(x, 17), SHA256_SSE_ROR(x, 19)), _mm_srli_epi32(x, 10))
+
+/* compute next four schedule words from previous sixteen (w0 holds the oldest) */
+#define SHA256_SSE_SCHEDULE(w0, w1, w2, w3, wn)                                                 \
+    wn = _mm_add_epi32(_mm_add_epi32(w0, _mm_alignr_epi8(w3, w2, 4)),                           \
+                       SHA256_SSE_G0(_mm_alignr_epi8(w1, w0, 4)));                              \
+    tmp = _mm_srli_si128(w3, 8);                                                                \
+    wn = _mm_add_epi32(wn, SHA256_SSE_G1(tmp));                                                 \
+    tmp = _mm_slli_si128(wn, 8);                                                                \
+    wn = _mm_add_epi32(wn, SHA256_SSE_G1(tmp));
+
+#define SHA256_AVX2_ROR(x, bits)  _mm256_or_si256(_mm256_srli_epi32(x, bits), _mm256_slli_epi32(x, 32 - (bits)))
+#define SHA256_AVX2_G0(x)         _mm256_xor_si256(_mm256_xor_si256(SHA256_AVX2_ROR(x, 7), SHA256_AVX2_ROR(x, 18)), _mm256_srli_epi32(x, 3))
+#define SHA256_AVX2_G1(x)         _mm256_xor_si256(_mm256_xor_si256(SHA256_AVX2_ROR(x, 17), SHA256_AVX2_ROR(x, 19)), _mm256_srli_epi32(x, 10))
+
+#define SHA256_AVX2_SCHEDULE(w0, w1, w2, w3, wn)                                                \
+    wn = _mm256_add_epi32(_mm256_add_epi32(w0, _mm256_alignr_epi8(w3, w2, 4)),                  \
+                          SHA256_AVX2_G0(_mm256_alignr_epi8(w1, w0, 4)));                       \
+    tmp = _mm256_srli_si256(w3, 8);                                                             \
+    wn = _mm256_add_epi32(wn, SHA256_AVX2_G1(tmp));                                             \
+    tmp = _mm256_slli_si256(wn, 8);                                                             \
+    wn = _mm256_add_epi32(wn, SHA256_AVX2_G1(tmp));
+
+ELIBC_TARGET("ssse3")
+void _sha256_transform_ssse3(euint32_t* state, const euint8_t* data, size_t blocks)
+{
+    euint32_t wk[64];
+    __m128i w0, w1, w2, w3, wn, tmp;
+    __m128i bswap;
+    int idx;
+
+    /* big endian words */
+    bswap = _mm_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    for( ; blocks > 0; --blocks, data += HASH_SHA256_BLOCK_SIZE)
+    {
+        w0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), bswap);
+        w1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), bswap);
+        w2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), bswap);
+        w3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), bswap);
+
+        _mm_storeu_si128((__m128i*)(wk + 0), _mm_add_epi32(w0, _mm_loadu_si128((const __m128i*)(_sha256_k + 0))));
+        _mm_storeu_si128((__m128i*)(wk + 4), _mm_add_epi32(w1, _mm_loadu_si128((const __m128i*)(_sha256_k + 4))));
+        _mm_storeu_si128((__m128i*)(wk + 8), _mm_add_epi32(w2, _mm_loadu_si128((const __m128i*)(_sha256_k + 8))));
+        _mm_storeu_si128((__m128i*)(wk + 12), _mm_add_epi32(w3, _mm_loadu_si128((const __m128i*)(_sha256_k + 12))));
+
+        /* expand schedule */
+        for(idx = 16; idx < 64; idx += 4)
+        {
+            SHA256_SSE_SCHEDULE(w0, w1, w2, w3, wn);
+            _mm_storeu_si128((__m128i*)(wk + idx), _mm_add_epi32(wn, _mm_loadu_si128((const __m128i*)(_sha256_k + idx))));
+
+            w0 = w1;
+            w1 = w2;
+            w2 = w3;
+            w3 = wn;
+        }
+
+        _sha256_rounds_wk(state, wk);
+    }
+}
+
+ELIBC_TARGET("avx2")
+void _sha256_transform_avx2(euint32_t* state, const euint8_t* data, size_t blocks)
+{
+    euint32_t wk[2][64];
+    __m256i w0, w1, w2, w3, wn, tmp;
+    __m256i bswap;
+    int idx;
+
+    /* big endian words */
+    bswap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+                            12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+
+    /* schedule is computed for two blocks at once (one per 128 bits lane) */
+    for( ; blocks > 1; blocks -= 2, data += 2 * HASH_SHA256_BLOCK_SIZE)
+    {
+#define SHA256_AVX2_LOAD(offset)                                                                    \
+        _mm256_shuffle_epi8(_mm256_inserti128_si256(                                                \
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(data + offset))),               \
+            _mm_loadu_si128((const __m128i*)(data + HASH_SHA256_BLOCK_SIZE + offset)), 1), bswap)
+
+#define SHA256_AVX2_STORE(idx, value)                                                               \
+        tmp = _mm256_add_epi32(value, _mm256_broadcastsi128_si256(                                  \
+                                    _mm_loadu_si128((const __m128i*)(_sha256_k + idx))));           \
+        _mm_storeu_si128((__m128i*)(wk[0] + idx), _mm256_castsi256_si128(tmp));                     \
+        _mm_storeu_si128((__m128i*)(wk[1] + idx), _mm256_extracti128_si256(tmp, 1));
+
+        w0 = SHA256_AVX2_LOAD(0);
+        w1 = SHA256_AVX2_LOAD(16);
+        w2 = SHA256_AVX2_LOAD(32);
+        w3 = SHA256_AVX2_LOAD(48);
+
+        SHA256_AVX2_STORE(0, w0);
+        SHA256_AVX2_STORE(4, w1);
+        SHA256_AVX2_STORE(8, w2);
+        SHA256_AVX2_STORE(12, w3);
+
+        /* expand schedule */
+        for(idx = 16; idx < 64; idx += 4)
+        {
+            SHA256_AVX2_SCHEDULE(w0, w1, w2, w3, wn);
+            SHA256_AVX2_STORE(idx, wn);
+
+            w0 = w1;
+            w1 = w2;
+            w2 = w3;
+            w3 = wn;
+        }
+
+#undef SHA256_AVX2_LOAD
+#undef SHA256_AVX2_STORE
+
+        _sha256_rounds_wk(state, wk[0]);
+        _sha256_rounds_wk(state, wk[1]);
+    }
+
+    /* last odd block */
+    if(blocks > 0)
+    {
+        _sha256_transform_ssse3(state, data, blocks);
+    }
+}
+
+/* four rounds with sha instructions (two per instruction) */
+#define SHA256NI_ROUNDS(msg, idx)                                                               \
+    tmp = _mm_add_epi32(msg, _mm_loadu_si128((const __m128i*)(_sha256_k + idx)));               \
+    state1 = _mm_sha256rnds2_epu32(state1, state0, tmp);                                        \
+    tmp = _mm_shuffle_epi32(tmp, 0x0E);                                                         \
+    state0 = _mm_sha256rnds2_epu32(state0, state1, tmp);
+
+/* finish schedule words for the next group from current and previous groups */
+#define SHA256NI_MSG2(msg_next, msg_cur, msg_prev)                                              \
+    msg_next = _mm_sha256msg2_epu32(_mm_add_epi32(msg_next, _mm_alignr_epi8(msg_cur, msg_prev, 4)), msg_cur);
+
+ELIBC_TARGET("sha,sse4.1,ssse3")
+void _sha256_transform_shani(euint32_t* state, const euint8_t* data, size_t blocks)
+{
+    __m128i state0, state1, state0_save, state1_save;
+    __m128i msg0, msg1, msg2, msg3, tmp;
+    __m128i bswap;
+
+    /* big endian words */
+    bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    /* load state as (abef, cdgh) */
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(state + 0)), 0xB1);
+    state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(state + 4)), 0x1B);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xF0);
+
+    for( ; blocks > 0; --blocks, data += HASH_SHA256_BLOCK_SIZE)
+    {
+        state0_save = state0;
+        state1_save = state1;
+
+        /* rounds 0-15 */
+        msg0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 0)), bswap);
+        SHA256NI_ROUNDS(msg0, 0);
+
+        msg1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 16)), bswap);
+        SHA256NI_ROUNDS(msg1, 4);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+        msg2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 32)), bswap);
+        SHA256NI_ROUNDS(msg2, 8);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+        msg3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + 48)), bswap);
+        SHA256NI_ROUNDS(msg3, 12);
+        SHA256NI_MSG2(msg0, msg3, msg2);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+        /* rounds 16-51 */
+        SHA256NI_ROUNDS(msg0, 16);
+        SHA256NI_MSG2(msg1, msg0, msg3);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+        SHA256NI_ROUNDS(msg1, 20);
+        SHA256NI_MSG2(msg2, msg1, msg0);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+        SHA256NI_ROUNDS(msg2, 24);
+        SHA256NI_MSG2(msg3, msg2, msg1);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+        SHA256NI_ROUNDS(msg3, 28);
+        SHA256NI_MSG2(msg0, msg3, msg2);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+        SHA256NI_ROUNDS(msg0, 32);
+        SHA256NI_MSG2(msg1, msg0, msg3);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+        SHA256NI_ROUNDS(msg1, 36);
+        SHA256NI_MSG2(msg2, msg1, msg0);
+        msg0 = _mm_sha256msg1_epu32(msg0, msg1);
+
+        SHA256NI_ROUNDS(msg2, 40);
+        SHA256NI_MSG2(msg3, msg2, msg1);
+        msg1 = _mm_sha256msg1_epu32(msg1, msg2);
+
+        SHA256NI_ROUNDS(msg3, 44);
+        SHA256NI_MSG2(msg0, msg3, msg2);
+        msg2 = _mm_sha256msg1_epu32(msg2, msg3);
+
+        SHA256NI_ROUNDS(msg0, 48);
+        SHA256NI_MSG2(msg1, msg0, msg3);
+        msg3 = _mm_sha256msg1_epu32(msg3, msg0);
+
+        /* rounds 52-63 */
+        SHA256NI_ROUNDS(msg1, 52);
+        SHA256NI_MSG2(msg2, msg1, msg0);
+
+        SHA256NI_ROUNDS(msg2, 56);
+        SHA256NI_MSG2(msg3, msg2, msg1);
+
+        SHA256NI_ROUNDS(msg3, 60);
+
+        /* add block result to state */
+        state0 = _mm_add_epi32(state0, state0_save);
+        state1 = _mm_add_epi32(state1, state1_save);
+    }
+
+    /* store state back as (abcd, efgh) */
+    tmp = _mm_shuffle_epi32(state0, 0x1B);
+    state1 = _mm_shuffle_epi32(state1, 0xB1);
+    _mm_storeu_si128((__m128i*)(state + 0), _mm_blend_epi16(tmp, state1, 0xF0));
+    _mm_storeu_si128((__m128i*)(state + 4), _mm_alignr_epi8(state1, tmp, 8));
+}
+
+#endif /* _ELIBC_ARCH_X86 */
+
+/*----------------------------------------------------------------------*/
+/* transform selection */
+
+static sha256_transform_t _sha256_transform = 0;
+static hash_sha256_impl_t _sha256_impl = hash_sha256_impl_auto;
+
+/* get transform function or zero if not supported */
+sha256_transform_t _sha256_find_transform(hash_sha256_impl_t sha256_impl)
+{
+#if defined(_ELIBC_ARCH_X86) && !defined(_ELIBC_NO_SIMD)
+    unsigned int features = esystem_cpu_features();
+
+    switch(sha256_impl)
+    {
+    case hash_sha256_impl_ssse3:
+        if(features & ESYSTEM_CPU_SSSE3) return _sha256_transform_ssse3;
+        break;
+
+    case hash_sha256_impl_avx2:
+        if((features & (ESYSTEM_CPU_SSSE3 | ESYSTEM_CPU_AVX2)) == (ESYSTEM_CPU_SSSE3 | ESYSTEM_CPU_AVX2)) return _sha256_transform_avx2;
+        break;
+
+    case hash_sha256_impl_shani:
+        if((features & (ESYSTEM_CPU_SSSE3 | ESYSTEM_CPU_SSE41 | ESYSTEM_CPU_SHA)) == (ESYSTEM_CPU_SSSE3 | ESYSTEM_CPU_SSE41 | ESYSTEM_CPU_SHA)) return _sha256_transform_shani;
+        break;
+
+    default:
+        break;
+    }
+#endif /* _ELIBC_ARCH_X86 */
+
+    return (sha256_impl == hash_sha256_impl_portable) ? _sha256_transform_portable : 0;
+}
+
+sha256_transform_t _sha256_get_transform()
+{
+    /* select best implementation on first use */
+    if(_sha256_transform == 0) hash_sha256_set_impl(hash_sha256_impl_auto);
+
+    return _sha256_transform;
+}
+
+/*----------------------------------------------------------------------*/
+
+/* block transform selection */
+int hash_sha256_set_impl(hash_sha256_impl_t sha256_impl)
+{
+    sha256_transform_t sha256_transform;
+
+    /* select the fastest supported implementation */
+    if(sha256_impl == hash_sha256_impl_auto)
+    {
+        sha256_impl = hash_sha256_impl_shani;
+        while((sha256_transform = _sha256_find_transform(sha256_impl)) == 0)
+        {
+            sha256_impl = (hash_sha256_impl_t)(sha256_impl - 1);
+        }
+
+    } else
+    {
+        sha256_transform = _sha256_find_transform(sha256_impl);
+        if(sha256_transform == 0) return ELIBC_ERROR_NOT_SUPPORTED;
+    }
+
+    _sha256_transform = sha256_transform;
+    _sha256_impl = sha256_impl;
+
+    return ELIBC_SUCCESS;
+}
+
+hash_sha256_impl_t hash_sha256_get_impl()
+{
+    /* make sure implementation is selected */
+    _sha256_get_transform();
+
+    return _sha256_impl;
+}
+
+/* hash in binary data */
+void hash_sha256_begin(sha256_context_t* sha256_context)
+{
+    EASSERT(sha256_context);
+    if(sha256_context == 0) return;
+
+    /* SHA256 initialization constants */
+    sha256_context->state[0] = 0x6a09e667;
+    sha256_context->state[1] = 0xbb67ae85;
+    sha256_context->state[2] = 0x3c6ef372;
+    sha256_context->state[3] = 0xa54ff53a;
+    sha256_context->state[4] = 0x510e527f;
+    sha256_context->state[5] = 0x9b05688c;
+    sha256_context->state[6] = 0x1f83d9ab;
+    sha256_context->state[7] = 0x5be0cd19;
+
+    sha256_context->count[0] = sha256_context->count[1] = 0;
+}
+
+void hash_sha256_update(sha256_context_t* sha256_context, const euint8_t* data, euint32_t data_size)
+{
+    size_t idx_i, idx_j;
+
+    EASSERT(sha256_context);
+    EASSERT(data);
+    EASSERT(data_size);
+    if(sha256_context == 0 || data == 0 || data_size == 0) return;
+
+    /* init counts */
+    idx_j = (sha256_context->count[0] >> 3) & 63;
+    if ((sha256_context->count[0] += data_size << 3) < (data_size << 3)) sha256_context->count[1]++;
+    sha256_context->count[1] += (data_size >> 29);
+
+    /* update hash */
+    if ((idx_j + data_size) > 63)
+    {
+        sha256_transform_t sha256_transform = _sha256_get_transform();
+
+        /* finish buffered block */
+        ememcpy(&sha256_context->buffer[idx_j], data, (idx_i = 64-idx_j));
+        sha256_transform(sha256_context->state, sha256_context->buffer, 1);
+
+        /* hash all full blocks directly from input */
+        if(idx_i + 63 < data_size)
+        {
+            sha256_transform(sha256_context->state, data + idx_i, (data_size - idx_i) / 64);
+            idx_i += ((data_size - idx_i) / 64) * 64;
+        }
+        idx_j = 0;
+    } else
+    {
+        idx_i = 0;
+    }
+
+    /* copy rest of the data */
+    ememcpy(&sha256_context->buffer[idx_j], &data[idx_i], data_size - idx_i);
+}
+
+void hash_sha256_end(sha256_context_t* sha256_context, euint8_t* digest_out)
+{
+    size_t      idx_i, idx_j;
+
+    EASSERT(sha256_context);
+    EASSERT(digest_out);
+    if(sha256_context == 0 || digest_out == 0) return;
+
+    /* append padding directly to buffered block */
+    idx_j = (sha256_context->count[0] >> 3) & 63;
+    sha256_context->buffer[idx_j++] = 0x80;
+
+    /* length must fit to the last 8 bytes */
+    if(idx_j > 56)
+    {
+        ememset(&sha256_context->buffer[idx_j], 0, 64 - idx_j);
+        _sha256_get_transform()(sha256_context->state, sha256_context->buffer, 1);
+        idx_j = 0;
+    }
+    ememset(&sha256_context->buffer[idx_j], 0, 56 - idx_j);
+
+    /* message length in bits (endian independent) */
+    for (idx_i = 0; idx_i < 8; idx_i++) {
+        sha256_context->buffer[56 + idx_i] = (euint8_t)((sha256_context->count[(idx_i >= 4 ? 0 : 1)]
+         >> ((3-(idx_i & 3)) * 8) ) & 255);
+    }
+
+    _sha256_get_transform()(sha256_context->state, sha256_context->buffer, 1);
+
+    for (idx_i = 0; idx_i < HASH_SHA256_DIGEST_SIZE; idx_i++) {
+        digest_out[idx_i] = (euint8_t)
+         ((sha256_context->state[idx_i>>2] >> ((3-(idx_i & 3)) * 8) ) & 255);
+    }
+}
+
+/* hash data in single run */
+int hash_sha256(const euint8_t* data, euint32_t data_size, euint8_t* digest_out)
+{
+    sha256_context_t sha256_context;
+
+    EASSERT(data);
+    EASSERT(data_size);
+    EASSERT(digest_out);
+    if(data_size == 0 || data == 0 || digest_out == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* hash data with temp context */
+    hash_sha256_begin(&sha256_context);
+    hash_sha256_update(&sha256_context, data, data_size);
+    hash_sha256_end(&sha256_context, digest_out);
+
+    return ELIBC_SUCCESS;
+}
+
+/*----------------------------------------------------------------------*/
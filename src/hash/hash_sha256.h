@@ -0,0 +1,66 @@
+/*
+    SHA256 hash functions
+*/
+
+#ifndef _HASH_SHA256_H_
+#define _HASH_SHA256_H_
+
+/*
+    SHA-256 as specified in FIPS 180-4: http://csrc.nist.gov/publications/fips/fips180-4/fips-180-4.pdf
+*/
+
+/*----------------------------------------------------------------------*/
+
+/* constants */
+#define HASH_SHA256_BLOCK_SIZE                  64
+#define HASH_SHA256_DIGEST_SIZE                 32
+
+/*----------------------------------------------------------------------*/
+
+/* context */
+typedef struct
+{
+    euint32_t   state[8];
+    euint32_t   count[2];
+    euint8_t    buffer[64];
+
+} sha256_context_t;
+
+/* block transform implementations */
+typedef enum
+{
+    hash_sha256_impl_auto,
+    hash_sha256_impl_portable,
+    hash_sha256_impl_ssse3,
+    hash_sha256_impl_avx2,
+    hash_sha256_impl_shani
+
+} hash_sha256_impl_t;
+
+/*----------------------------------------------------------------------*/
+
+/*
+    NOTE: the fastest implementation supported by cpu is selected on first use,
+          selecting it manually is only needed for testing and benchmarking
+*/
+
+/* block transform selection */
+int hash_sha256_set_impl(hash_sha256_impl_t sha256_impl);
+hash_sha256_impl_t hash_sha256_get_impl();
+
+/*
+    NOTE: functions expect digest_out to be of size HASH_SHA256_DIGEST_SIZE
+*/
+
+/* hash in binary data */
+void hash_sha256_begin(sha256_context_t* sha256_context);
+void hash_sha256_update(sha256_context_t* sha256_context, const euint8_t* data, euint32_t data_size);
+void hash_sha256_end(sha256_context_t* sha256_context, euint8_t* digest_out);
+
+/* hash data in single run */
+int hash_sha256(const euint8_t* data, euint32_t data_size, euint8_t* digest_out);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _HASH_SHA256_H_ */
+
@@ -829,3 +829,84 @@ euint64_t http_form_content_size(http_form_t* http_form)
 }
 
 /*----------------------------------------------------------------------*/
+/* form pool */
+/*----------------------------------------------------------------------*/
+
+/* pooled form with own encode buffer */
+typedef struct
+{
+    http_form_t             http_form;      /* must be the first */
+    ebuffer_t               encode_buffer;
+
+} http_pool_form_t;
+
+int _http_pool_form_init(void* object, void* arg)
+{
+    http_pool_form_t* pool_form = (http_pool_form_t*)object;
+
+    EUNUSED(arg);
+
+    http_form_init(&pool_form->http_form);
+    ebuffer_init(&pool_form->encode_buffer);
+
+    return ELIBC_SUCCESS;
+}
+
+void _http_pool_form_free(void* object, void* arg)
+{
+    http_pool_form_t* pool_form = (http_pool_form_t*)object;
+
+    EUNUSED(arg);
+
+    http_form_close(&pool_form->http_form);
+    ebuffer_free(&pool_form->encode_buffer);
+}
+
+int http_form_pool_init(epool_t* epool, size_t slab_objects)
+{
+    int err;
+
+    err = epool_init(epool, sizeof(http_pool_form_t), slab_objects);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return epool_set_object_funcs(epool, _http_pool_form_init, _http_pool_form_free, 0);
+}
+
+http_form_t* http_form_pool_get(epool_t* epool)
+{
+    http_pool_form_t* pool_form;
+
+    EASSERT(epool);
+    if(epool == 0) return 0;
+
+    pool_form = (http_pool_form_t*)epool_alloc(epool);
+    if(pool_form == 0) return 0;
+
+    /* keep memory reserved by previous user (like parser pools) */
+    http_form_reset(&pool_form->http_form);
+
+    return &pool_form->http_form;
+}
+
+void http_form_pool_put(epool_t* epool, http_form_t* http_form)
+{
+    if(http_form == 0) return;
+
+    /* don't keep file open while form is in pool, state is reset on get */
+    efile_close(http_form->encode_file);
+    http_form->encode_file = 0;
+
+    epool_release(epool, http_form);
+}
+
+int http_form_pool_encode_init(http_form_t* http_form, http_param_t* parameters, size_t parameter_count)
+{
+    EASSERT(http_form);
+    if(http_form == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* NOTE: form must come from http_form_pool_get, pooled buffer follows it */
+
+    return http_form_encode_init(http_form, &((http_pool_form_t*)http_form)->encode_buffer, parameters, parameter_count);
+}
+
+/*----------------------------------------------------------------------*/
@@ -61,6 +61,20 @@ int http_form_encode(http_form_t* http_form, char* buffer, size_t buffer_size, s
 const char* http_form_content_type(const http_form_t* http_form);
 euint64_t http_form_content_size(http_form_t* http_form);
 
+/*
+    Form pool keeps forms with their encode buffer memory between uses, get
+    returns reset form (the same as parser pools). Forms from pool are encoded
+    with http_form_pool_encode_init that uses pooled buffer. Pool is closed
+    with epool_free.
+
+    NOTE: http_form_pool_encode_init may be used only with forms returned by
+          http_form_pool_get, other forms have no pooled buffer
+*/
+int http_form_pool_init(epool_t* epool, size_t slab_objects);
+http_form_t* http_form_pool_get(epool_t* epool);
+void http_form_pool_put(epool_t* epool, http_form_t* http_form);
+int http_form_pool_encode_init(http_form_t* http_form, http_param_t* parameters, size_t parameter_count);
+
 /*----------------------------------------------------------------------*/
 
 #endif /* _HTTP_FORM_H_ */
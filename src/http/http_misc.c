@@ -4,12 +4,44 @@
 
 #include "../elib_config.h"
 
+#include "../time/time_format.h"
+
 #include "http_misc.h"
 
 /*----------------------------------------------------------------------*/
 /* data */
 static const char HTTP_CONTENT_BOUNDARY_ALPHABET[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
 
+/*----------------------------------------------------------------------*/
+/* date cache */
+
+/*
+    NOTE: cache is published using sequence lock, writer makes sequence odd
+          while updating and readers retry or format date themselves if 
+          sequence changed during copy. Cached date is kept in atomic words,
+          so readers never race with writer on plain memory.
+*/
+
+#define HTTP_DATE_CACHE_WORDS   ((HTTP_DATE_LENGTH + sizeof(eint64_t)) / sizeof(eint64_t))
+
+typedef struct
+{
+    eatomic_t           sequence;
+    eatomic_t           unixtime;
+    eatomic_t           date[HTTP_DATE_CACHE_WORDS];
+
+} http_date_cache_t;
+
+/* date copy */
+typedef union
+{
+    eint64_t            words[HTTP_DATE_CACHE_WORDS];
+    char                date[HTTP_DATE_CACHE_WORDS * sizeof(eint64_t)];
+
+} http_date_words_t;
+
+static http_date_cache_t _http_date_cache = { 0, -1, { 0 } };
+
 /*----------------------------------------------------------------------*/
 
 /* format content boundary */
@@ -26,7 +58,116 @@ void http_format_content_boundary(char* boundary_out, size_t boundary_length)
               sizeof(HTTP_CONTENT_BOUNDARY_ALPHABET) - 1);
 }
 
-
 /*----------------------------------------------------------------------*/
 
+/* format two digits */
+ELIBC_FORCE_INLINE char* _http_format_date_digits(char* date_out, unsigned int value)
+{
+    date_out[0] = (char)('0' + value / 10);
+    date_out[1] = (char)('0' + value % 10);
+
+    return date_out + 2;
+}
+
+/* format date */
+int http_format_date(etime_t unixtime, char* date_out)
+{
+    datetime_t datetime;
+    char* str_out;
+    int err;
+
+    /* check input */
+    EASSERT(date_out);
+    if(date_out == 0) return ELIBC_ERROR_ARGUMENT;
 
+    /* convert */
+    err = unixtime_to_datetime(unixtime, &datetime);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* "Sun, 06 Nov 1994 08:49:37 GMT" */
+    str_out = date_out;
+
+    ememcpy(str_out, datetime_weekday(datetime.weekday), 3);
+    str_out[3] = ',';
+    str_out[4] = ' ';
+    str_out = _http_format_date_digits(str_out + 5, datetime.day);
+    str_out[0] = ' ';
+    ememcpy(str_out + 1, datetime_month_name(datetime.month), 3);
+    str_out[4] = ' ';
+    str_out = _http_format_date_digits(str_out + 5, datetime.year / 100);
+    str_out = _http_format_date_digits(str_out, datetime.year % 100);
+    str_out[0] = ' ';
+    str_out = _http_format_date_digits(str_out + 1, datetime.hours);
+    str_out[0] = ':';
+    str_out = _http_format_date_digits(str_out + 1, datetime.minutes);
+    str_out[0] = ':';
+    str_out = _http_format_date_digits(str_out + 1, datetime.seconds);
+    ememcpy(str_out, " GMT", 5);
+
+    EASSERT(str_out + 4 == date_out + HTTP_DATE_LENGTH);
+
+    return ELIBC_SUCCESS;
+}
+
+int http_format_date_current(char* date_out)
+{
+    http_date_words_t date_words;
+    etime_t unixtime;
+    eint64_t sequence;
+    size_t idx;
+    int err;
+
+    /* check input */
+    EASSERT(date_out);
+    if(date_out == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* current time */
+    unixtime = etime(0);
+
+    /* try cached value first */
+    sequence = eatomic_load(&_http_date_cache.sequence);
+    if((sequence & 1) == 0 && eatomic_load_relaxed(&_http_date_cache.unixtime) == unixtime)
+    {
+        /* copy */
+        for(idx = 0; idx < HTTP_DATE_CACHE_WORDS; ++idx)
+        {
+            date_words.words[idx] = eatomic_load_relaxed(&_http_date_cache.date[idx]);
+        }
+
+        /* check that cache was not updated meanwhile (copy must complete before check) */
+        eatomic_fence_acquire();
+        if(eatomic_load_relaxed(&_http_date_cache.sequence) == sequence)
+        {
+            ememcpy(date_out, date_words.date, HTTP_DATE_LENGTH + 1);
+            return ELIBC_SUCCESS;
+        }
+    }
+
+    /* format */
+    err = http_format_date(unixtime, date_out);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* update cache unless other thread is already doing it or has newer value */
+    if((sequence & 1) == 0 && eatomic_load_relaxed(&_http_date_cache.unixtime) < unixtime && 
+       eatomic_cas(&_http_date_cache.sequence, sequence, sequence + 1))
+    {
+        ememset(&date_words, 0, sizeof(date_words));
+        ememcpy(date_words.date, date_out, HTTP_DATE_LENGTH + 1);
+
+        /* odd sequence must be visible before any cache data (pairs with reader fence) */
+        eatomic_fence_release();
+
+        eatomic_store_relaxed(&_http_date_cache.unixtime, unixtime);
+        for(idx = 0; idx < HTTP_DATE_CACHE_WORDS; ++idx)
+        {
+            eatomic_store_relaxed(&_http_date_cache.date[idx], date_words.words[idx]);
+        }
+
+        /* publish (release store orders data before even sequence) */
+        eatomic_store(&_http_date_cache.sequence, sequence + 2);
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+/*----------------------------------------------------------------------*/
@@ -10,6 +10,19 @@
 /* format content boundary */
 void http_format_content_boundary(char* boundary_out, size_t boundary_length);
 
+/* HTTP date length, e.g. "Sun, 06 Nov 1994 08:49:37 GMT" */
+#define HTTP_DATE_LENGTH        29
+
+/* 
+    NOTE: - date_out must fit HTTP_DATE_LENGTH characters plus zero terminate
+          - current date string is cached and regenerated at most once per 
+            second, function is thread safe and never blocks
+*/
+
+/* format date (RFC 1123 in GMT) */
+int http_format_date(etime_t unixtime, char* date_out);
+int http_format_date_current(char* date_out);
+
 /*----------------------------------------------------------------------*/
 
 #endif /* _HTTP_MISC_H_ */
@@ -35,6 +35,24 @@ int _http_parser_linefeed(http_parser_t* http_parser, const char* data, size_t d
 int _http_parser_content(http_parser_t* http_parser, const char* data, size_t data_size, size_t* pos);
 int _http_parser_done(http_parser_t* http_parser, const char* data, size_t data_size, size_t* pos);
 
+/* state parsers (in http_state_t order) */
+static const http_state_parse_t _http_state_parsers[http_state_count] = {
+    (http_state_parse_t)_http_parser_begin,          /* http_state_begin */
+    (http_state_parse_t)_http_parser_version,        /* http_state_version */
+    (http_state_parse_t)_http_parser_method,         /* http_state_method */
+    (http_state_parse_t)_http_parser_uri,            /* http_state_uri */
+    (http_state_parse_t)_http_parser_status_code,    /* http_state_status_code */
+    (http_state_parse_t)_http_parser_reason_phrase,  /* http_state_reason_phrase */
+    (http_state_parse_t)_http_parser_header_line,    /* http_state_header_line */
+    (http_state_parse_t)_http_parser_header_name,    /* http_state_header_name */
+    (http_state_parse_t)_http_parser_header_value,   /* http_state_header_value */
+    (http_state_parse_t)_http_parser_wait_colon,     /* http_state_wait_colon */
+    (http_state_parse_t)_http_parser_wait_value,     /* http_state_wait_value */
+    (http_state_parse_t)_http_parser_linefeed,       /* http_state_linefeed */
+    (http_state_parse_t)_http_parser_content,        /* http_state_content */
+    (http_state_parse_t)_http_parser_done            /* http_state_done */
+};
+
 /*----------------------------------------------------------------------*/
 /* helpers */
 
@@ -222,34 +240,24 @@ void http_parse_init(http_parser_t* http_parser, http_parse_callback_t parser_ca
     http_parser->callback_data = user_data;
     http_parser->callback_return = ELIBC_CONTINUE;
 
-    /* init state parsers */
-    http_parser->parsers[http_state_begin] = (http_state_parse_t)_http_parser_begin;
-    http_parser->parsers[http_state_version] = (http_state_parse_t)_http_parser_version;
-    http_parser->parsers[http_state_method] = (http_state_parse_t)_http_parser_method;
-    http_parser->parsers[http_state_uri] = (http_state_parse_t)_http_parser_uri;
-    http_parser->parsers[http_state_status_code] = (http_state_parse_t)_http_parser_status_code;
-    http_parser->parsers[http_state_reason_phrase] = (http_state_parse_t)_http_parser_reason_phrase;
-    http_parser->parsers[http_state_header_line] = (http_state_parse_t)_http_parser_header_line;
-    http_parser->parsers[http_state_header_name] = (http_state_parse_t)_http_parser_header_name;
-    http_parser->parsers[http_state_header_value] = (http_state_parse_t)_http_parser_header_value;
-    http_parser->parsers[http_state_wait_colon] = (http_state_parse_t)_http_parser_wait_colon;
-    http_parser->parsers[http_state_wait_value] = (http_state_parse_t)_http_parser_wait_value;
-    http_parser->parsers[http_state_linefeed] = (http_state_parse_t)_http_parser_linefeed;
-    http_parser->parsers[http_state_content] = (http_state_parse_t)_http_parser_content;
-    http_parser->parsers[http_state_done] = (http_state_parse_t)_http_parser_done;
-
 #ifdef _ELIBC_DEBUG
     /* check that all parsers were set */    
     {
         int i;
         for(i = 0; i < http_state_count; ++i)
         {
-            EASSERT1(http_parser->parsers[i], "http_parser: state parser was not set");
+            EASSERT1(_http_state_parsers[i], "http_parser: state parser was not set");
         }
     }
 #endif /* _ELIBC_DEBUG */
 }
 
+void http_parse_reset(http_parser_t* http_parser, http_parse_callback_t parser_callback, void* user_data)
+{
+    /* parser doesn't own any memory and has only few fields */
+    http_parse_init(http_parser, parser_callback, user_data);
+}
+
 void http_parse_close(http_parser_t* http_parser)
 {
     if(http_parser)
@@ -311,7 +319,7 @@ int http_parse(http_parser_t* http_parser, const char* data, size_t data_size, s
 
         /* process text */
         EASSERT((int)http_parser->http_state < http_state_count);
-        err = http_parser->parsers[http_parser->http_state](http_parser, data, data_size, &char_pos);
+        err = _http_state_parsers[http_parser->http_state](http_parser, data, data_size, &char_pos);
 
         /* stop if error */
         if(http_parser->flags & HTTP_FLAG_ERROR)
@@ -357,6 +365,73 @@ int http_parse_ready(http_parser_t* http_parser)
     return (http_parser->http_state == http_state_done) ? ELIBC_TRUE : ELIBC_FALSE;
 }
 
+/*----------------------------------------------------------------------*/
+/* parser pool */
+
+/* pooled parser with own parse buffer */
+typedef struct {
+
+    http_parser_t           http_parser;    /* must be the first */
+    ebuffer_t               parse_buffer;
+
+} http_pool_parser_t;
+
+int _http_pool_parser_init(void* object, void* arg)
+{
+    http_pool_parser_t* pool_parser = (http_pool_parser_t*)object;
+
+    EUNUSED(arg);
+
+    ememset(pool_parser, 0, sizeof(http_pool_parser_t));
+    ebuffer_init(&pool_parser->parse_buffer);
+
+    return ELIBC_SUCCESS;
+}
+
+void _http_pool_parser_free(void* object, void* arg)
+{
+    http_pool_parser_t* pool_parser = (http_pool_parser_t*)object;
+
+    EUNUSED(arg);
+
+    http_parse_close(&pool_parser->http_parser);
+    ebuffer_free(&pool_parser->parse_buffer);
+}
+
+int http_parse_pool_init(epool_t* epool, size_t slab_objects)
+{
+    int err;
+
+    err = epool_init(epool, sizeof(http_pool_parser_t), slab_objects);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return epool_set_object_funcs(epool, _http_pool_parser_init, _http_pool_parser_free, 0);
+}
+
+http_parser_t* http_parse_pool_get(epool_t* epool, http_parse_type_t type, http_parse_callback_t parser_callback, void* user_data)
+{
+    http_pool_parser_t* pool_parser;
+
+    EASSERT(epool);
+    EASSERT(parser_callback);
+    if(epool == 0 || parser_callback == 0) return 0;
+
+    pool_parser = (http_pool_parser_t*)epool_alloc(epool);
+    if(pool_parser == 0) return 0;
+
+    /* parse buffer keeps memory reserved by previous user */
+    http_parse_reset(&pool_parser->http_parser, parser_callback, user_data);
+
+    http_parse_begin(&pool_parser->http_parser, type, &pool_parser->parse_buffer);
+
+    return &pool_parser->http_parser;
+}
+
+void http_parse_pool_put(epool_t* epool, http_parser_t* http_parser)
+{
+    epool_release(epool, http_parser);
+}
+
 /*----------------------------------------------------------------------*/
 /* state parsers */
 int _http_parser_begin(http_parser_t* http_parser, const char* data, size_t data_size, size_t* pos)
@@ -100,9 +100,6 @@ typedef int (*http_state_parse_t)(void*, const char*, size_t, size_t*);
 /* http parser data */
 typedef struct {
 
-    /* state parsers */
-    http_state_parse_t      parsers[http_state_count];
-
     /* parser state */
     http_parse_type_t       parse_type;
     http_state_t            http_state;
@@ -132,11 +129,23 @@ typedef struct {
 void    http_parse_init(http_parser_t* http_parser, http_parse_callback_t parser_callback, void* user_data);
 void    http_parse_close(http_parser_t* http_parser);
 
+/* reset parser to the state after init (cheap way to reuse parser) */
+void    http_parse_reset(http_parser_t* http_parser, http_parse_callback_t parser_callback, void* user_data);
+
 /* parse  */
 int     http_parse_begin(http_parser_t* http_parser, http_parse_type_t type, ebuffer_t* parse_buffer);
 int     http_parse(http_parser_t* http_parser, const char* data, size_t data_size, size_t* data_used);
 int     http_parse_ready(http_parser_t* http_parser);
 
+/*
+    Parser pool keeps parsers with their parse buffer memory between uses, get
+    returns parser ready for http_parse (http_parse_begin is called with pooled
+    buffer). Pool is closed with epool_free.
+*/
+int             http_parse_pool_init(epool_t* epool, size_t slab_objects);
+http_parser_t*  http_parse_pool_get(epool_t* epool, http_parse_type_t type, http_parse_callback_t parser_callback, void* user_data);
+void            http_parse_pool_put(epool_t* epool, http_parser_t* http_parser);
+
 /*----------------------------------------------------------------------*/
 
 #endif /* _HTTP_PARSE_H_ */
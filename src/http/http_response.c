@@ -8,6 +8,7 @@
 #include "http_mime_types.h"
 #include "http_header.h"
 #include "http_status.h"
+#include "http_misc.h"
 #include "http_response.h"
 
 /*----------------------------------------------------------------------*/
@@ -51,6 +52,9 @@ void http_response_reset(http_response_t* http_response)
         /* reset content */
         http_response->content_type = 0;
         http_response->content_length = 0;
+
+        /* reset date */
+        http_response->add_date = ELIBC_FALSE;
     }
 }
 
@@ -143,12 +147,25 @@ euint64_t http_response_content_length(http_response_t* http_response)
     return http_response->content_length;
 }
 
+/* date */
+int http_response_set_date(http_response_t* http_response, ebool_t add_date)
+{
+    /* check input */
+    EASSERT(http_response);
+    if(http_response == 0) return ELIBC_ERROR_ARGUMENT;
+
+    http_response->add_date = add_date;
+
+    return ELIBC_SUCCESS;
+}
+
 /* format response */
 int http_response_format_header(http_response_t* http_response, ebuffer_t* encode_buffer)
 {
     const char* status_reason;
     const http_param_t* http_param;
     char buffer[32];  
+    char date_buffer[HTTP_DATE_LENGTH + 1];
     size_t idx;
     int err;
 
@@ -206,6 +223,18 @@ int http_response_format_header(http_response_t* http_response, ebuffer_t* encod
     _HTTP_RESPONSE_ENCODE_BUFFER_APPEND_STR(status_reason);
     _HTTP_RESPONSE_ENCODE_BUFFER_APPEND("\r\n");
 
+    /* date header */
+    if(http_response->add_date)
+    {
+        /* cached current date */
+        err = http_format_date_current(date_buffer);
+        if(err != ELIBC_SUCCESS) return err;
+
+        _HTTP_RESPONSE_ENCODE_BUFFER_APPEND("Date: ");
+        if(ebuffer_append(encode_buffer, date_buffer, HTTP_DATE_LENGTH) != ELIBC_SUCCESS) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+        _HTTP_RESPONSE_ENCODE_BUFFER_APPEND("\r\n");
+    }
+
     /* format response headers */
     for(idx = 0; idx < http_paramset_size(&http_response->headers); ++idx)
     {
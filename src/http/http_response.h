@@ -32,6 +32,9 @@ typedef struct
     const char*             content_type;
     euint64_t               content_length;
 
+    /* add Date header */
+    ebool_t                 add_date;
+
 } http_response_t;
 
 /*----------------------------------------------------------------------*/
@@ -58,6 +61,14 @@ int http_response_set_status(http_response_t* http_response, unsigned short stat
 int http_response_set_content(http_response_t* http_response, const char* content_type, euint64_t content_length);
 euint64_t http_response_content_length(http_response_t* http_response);
 
+/* 
+    NOTE: if enabled current Date header is formatted from cache (see http_format_date_current),
+          do not add it to headers in that case
+*/
+
+/* date */
+int http_response_set_date(http_response_t* http_response, ebool_t add_date);
+
 /* format http response message header */
 int http_response_format_header(http_response_t* http_response, ebuffer_t* encode_buffer);
 
@@ -2452,7 +2452,7 @@ int _entity_parse_unicode_char(entity_parser_t* entity_parser, ebool_t is_hex, c
     EASSERT(entity_parser->input_pos <= ENTITY_MAX_DIGIT_INPUT_LENGTH);
 
     /* check if found */
-    if(text[*size_out] == ';')
+    if((*size_out) < text_size && text[*size_out] == ';')
     {
         /* append ending */
         entity_parser->input[entity_parser->input_pos] = ';';
@@ -2515,7 +2515,7 @@ int _entity_parse_name(entity_parser_t* entity_parser, const char* text, size_t
     EASSERT(entity_parser->input_pos <= ENTITY_MAX_INPUT_LENGTH);
 
     /* check if found */
-    if(text[*size_out] == ';')
+    if((*size_out) < text_size && text[*size_out] == ';')
     {
         /* exact match */
         res = _entity_find_name(entity_parser->input + 1, entity_parser->input_pos - 1, ELIBC_TRUE);
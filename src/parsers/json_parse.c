@@ -131,6 +131,21 @@ int _json_parser_array_value(json_parser_t* json_parser, const char* text, size_
 int _json_parser_escape(json_parser_t* json_parser, const char* text, size_t text_size, size_t* pos);
 int _json_parser_entity(json_parser_t* json_parser, const char* text, size_t text_size, size_t* pos);
 
+/* state parsers (in json_state_t order) */
+static const json_state_parse_t _json_state_parsers[json_state_count] = {
+    (json_state_parse_t)_json_parser_begin,         /* json_state_begin */
+    (json_state_parse_t)_json_parser_object,        /* json_state_object */
+    (json_state_parse_t)_json_parser_array,         /* json_state_array */
+    (json_state_parse_t)_json_parser_string,        /* json_state_string */
+    (json_state_parse_t)_json_parser_key,           /* json_state_key */
+    (json_state_parse_t)_json_parser_value,         /* json_state_value */
+    (json_state_parse_t)_json_parser_value_string,  /* json_state_value_string */
+    (json_state_parse_t)_json_parser_value_data,    /* json_state_value_data */
+    (json_state_parse_t)_json_parser_array_value,   /* json_state_array_value */
+    (json_state_parse_t)_json_parser_escape,        /* json_state_escape */
+    (json_state_parse_t)_json_parser_entity         /* json_state_entity */
+};
+
 /*----------------------------------------------------------------------*/
 /* worker methods */
 /*----------------------------------------------------------------------*/
@@ -186,42 +201,45 @@ void json_init(json_parser_t* json_parser, json_callback_t parser_callback, void
     /* reset all fields */
     ememset(json_parser, 0, sizeof(json_parser_t));
 
-    /* init state stack */
-    estack_init(&json_parser->state_stack, sizeof(json_state_t));
-
-    /* reserve default space (ignore error, if memory allocation fails we will notice this later) */
-    estack_reserve(&json_parser->state_stack, PARSER_DEFAULT_STACK_SIZE);
+    /* init state stack (shallow documents don't allocate) */
+    estack_init_inline(&json_parser->state_stack, sizeof(json_state_t),
+                       json_parser->state_stack_items, sizeof(json_parser->state_stack_items));
 
     /* copy callback */
     json_parser->callback = parser_callback;
     json_parser->callback_data = user_data;
     json_parser->callback_return = ELIBC_CONTINUE;
 
-    /* init state parsers */
-    json_parser->parsers[json_state_begin] = (json_state_parse_t)_json_parser_begin;
-    json_parser->parsers[json_state_object] = (json_state_parse_t)_json_parser_object;
-    json_parser->parsers[json_state_array] = (json_state_parse_t)_json_parser_array;
-    json_parser->parsers[json_state_string] = (json_state_parse_t)_json_parser_string;
-    json_parser->parsers[json_state_key] = (json_state_parse_t)_json_parser_key;
-    json_parser->parsers[json_state_value] = (json_state_parse_t)_json_parser_value;
-    json_parser->parsers[json_state_value_string] = (json_state_parse_t)_json_parser_value_string;
-    json_parser->parsers[json_state_value_data] = (json_state_parse_t)_json_parser_value_data;
-    json_parser->parsers[json_state_array_value] = (json_state_parse_t)_json_parser_array_value;    
-    json_parser->parsers[json_state_escape] = (json_state_parse_t)_json_parser_escape;    
-    json_parser->parsers[json_state_entity] = (json_state_parse_t)_json_parser_entity;    
-
 #ifdef _ELIBC_DEBUG
     /* check that all parsers were set */    
     {
         int i;
         for(i = 0; i < json_state_count; ++i)
         {
-            EASSERT1(json_parser->parsers[i], "json_parser: state parser was not set");
+            EASSERT1(_json_state_parsers[i], "json_parser: state parser was not set");
         }
     }
 #endif /* _ELIBC_DEBUG */
 }
 
+void json_reset(json_parser_t* json_parser, json_callback_t parser_callback, void* user_data)
+{
+    EASSERT(json_parser);
+    EASSERT(parser_callback);
+    if(json_parser == 0 || parser_callback == 0) return;
+
+    /* keep stack memory, escape sequence parsers are reset when they are used */
+    estack_reset(&json_parser->state_stack);
+    json_parser->json_state = json_state_begin;
+    json_parser->parse_buffer = 0;
+    json_parser->flags = 0;
+
+    /* copy callback */
+    json_parser->callback = parser_callback;
+    json_parser->callback_data = user_data;
+    json_parser->callback_return = ELIBC_CONTINUE;
+}
+
 void json_close(json_parser_t* json_parser)
 {
     /* free buffers */
@@ -303,7 +321,7 @@ int json_parse(json_parser_t* json_parser, const char* text, size_t text_size)
 
         /* process text */
         EASSERT((int)json_parser->json_state < json_state_count);
-        err = json_parser->parsers[json_parser->json_state](json_parser, text, text_size, &char_pos);
+        err = _json_state_parsers[json_parser->json_state](json_parser, text, text_size, &char_pos);
 
         /* stop if error */
         if(json_parser->flags & JSON_FLAG_ERROR)
@@ -351,6 +369,76 @@ int json_end(json_parser_t* json_parser)
     return ELIBC_SUCCESS;
 }
 
+/*----------------------------------------------------------------------*/
+/* parser pool */
+/*----------------------------------------------------------------------*/
+
+/* pooled parser with own parse buffer */
+typedef struct {
+
+    json_parser_t           json_parser;    /* must be the first */
+    ebuffer_t               parse_buffer;
+
+} json_pool_parser_t;
+
+int _json_pool_parser_init(void* object, void* arg)
+{
+    json_pool_parser_t* pool_parser = (json_pool_parser_t*)object;
+
+    EUNUSED(arg);
+
+    ememset(pool_parser, 0, sizeof(json_pool_parser_t));
+
+    estack_init_inline(&pool_parser->json_parser.state_stack, sizeof(json_state_t),
+                       pool_parser->json_parser.state_stack_items, sizeof(pool_parser->json_parser.state_stack_items));
+    ebuffer_init(&pool_parser->parse_buffer);
+
+    return ELIBC_SUCCESS;
+}
+
+void _json_pool_parser_free(void* object, void* arg)
+{
+    json_pool_parser_t* pool_parser = (json_pool_parser_t*)object;
+
+    EUNUSED(arg);
+
+    json_close(&pool_parser->json_parser);
+    ebuffer_free(&pool_parser->parse_buffer);
+}
+
+int json_pool_init(epool_t* epool, size_t slab_objects)
+{
+    int err;
+
+    err = epool_init(epool, sizeof(json_pool_parser_t), slab_objects);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return epool_set_object_funcs(epool, _json_pool_parser_init, _json_pool_parser_free, 0);
+}
+
+json_parser_t* json_pool_get(epool_t* epool, json_callback_t parser_callback, void* user_data)
+{
+    json_pool_parser_t* pool_parser;
+
+    EASSERT(epool);
+    EASSERT(parser_callback);
+    if(epool == 0 || parser_callback == 0) return 0;
+
+    pool_parser = (json_pool_parser_t*)epool_alloc(epool);
+    if(pool_parser == 0) return 0;
+
+    /* keep memory reserved by previous user */
+    json_reset(&pool_parser->json_parser, parser_callback, user_data);
+    json_begin(&pool_parser->json_parser, &pool_parser->parse_buffer);
+
+    return &pool_parser->json_parser;
+}
+
+void json_pool_put(epool_t* epool, json_parser_t* json_parser)
+{
+    epool_release(epool, json_parser);
+}
+
 /*----------------------------------------------------------------------*/
 /* state parsers */
 /*----------------------------------------------------------------------*/
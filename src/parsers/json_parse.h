@@ -76,12 +76,10 @@ typedef int (*json_state_parse_t)(void*, const char*, size_t, size_t*);
 /* json parser data */
 typedef struct {
 
-    /* state parsers */
-    json_state_parse_t      parsers[json_state_count];
-
     /* state stack */
     estack_t                state_stack;
     json_state_t            json_state;
+    json_state_t            state_stack_items[PARSER_DEFAULT_STACK_SIZE];
 
     /* data buffer */
     ebuffer_t*              parse_buffer;
@@ -108,6 +106,9 @@ typedef struct {
 void    json_init(json_parser_t* json_parser, json_callback_t parser_callback, void* user_data);
 void    json_close(json_parser_t* json_parser);
 
+/* reset parser to the state after init, keeps reserved memory (cheap way to reuse parser) */
+void    json_reset(json_parser_t* json_parser, json_callback_t parser_callback, void* user_data);
+
 /* options */
 int     json_decode_escapes(json_parser_t* json_parser, int enable_decode);
 
@@ -116,6 +117,15 @@ int     json_begin(json_parser_t* json_parser, ebuffer_t* parse_buffer);
 int     json_parse(json_parser_t* json_parser, const char* text, size_t text_size);
 int     json_end(json_parser_t* json_parser);
 
+/*
+    Parser pool keeps parsers with their state stack and parse buffer memory
+    between uses, get returns parser ready for json_parse (json_begin is called
+    with pooled buffer). Pool is closed with epool_free.
+*/
+int             json_pool_init(epool_t* epool, size_t slab_objects);
+json_parser_t*  json_pool_get(epool_t* epool, json_callback_t parser_callback, void* user_data);
+void            json_pool_put(epool_t* epool, json_parser_t* json_parser);
+
 /*----------------------------------------------------------------------*/
 
 #endif /* _JSON_PARSE_H_ */
@@ -158,6 +158,30 @@ int _xml_parser_dtd(xml_parser_t* xml_parser, const char* text, size_t text_size
 int _xml_parser_escape(xml_parser_t* xml_parser, const char* text, size_t text_size, size_t* pos);
 int _xml_parser_entity(xml_parser_t* xml_parser, const char* text, size_t text_size, size_t* pos);
 
+/* state parsers (in xml_state_t order) */
+static const xml_state_parse_t _xml_state_parsers[xml_state_count] = {
+    (xml_state_parse_t)_xml_parser_tag_scan,          /* xml_state_tag_scan */
+    (xml_state_parse_t)_xml_parser_tag_open,          /* xml_state_tag_open */
+    (xml_state_parse_t)_xml_parser_tag_extra,         /* xml_state_tag_extra */
+    (xml_state_parse_t)_xml_parser_tag_name,          /* xml_state_tag_name */
+    (xml_state_parse_t)_xml_parser_tag,               /* xml_state_tag */
+    (xml_state_parse_t)_xml_parser_tag_end,           /* xml_state_tag_end */
+    (xml_state_parse_t)_xml_parser_tag_close,         /* xml_state_tag_close */
+    (xml_state_parse_t)_xml_parser_content,           /* xml_state_content */
+    (xml_state_parse_t)_xml_parser_comment,           /* xml_state_comment */
+    (xml_state_parse_t)_xml_parser_attribute_name,    /* xml_state_attribute_name */
+    (xml_state_parse_t)_xml_parser_attribute,         /* xml_state_attribute */
+    (xml_state_parse_t)_xml_parser_attribute_value,   /* xml_state_attribute_value */
+    (xml_state_parse_t)_xml_parser_attribute_string,  /* xml_state_attribute_string */
+    (xml_state_parse_t)_xml_parser_pi_begin,          /* xml_state_pi_begin */
+    (xml_state_parse_t)_xml_parser_pi_content,        /* xml_state_pi_content */
+    (xml_state_parse_t)_xml_parser_pi_content,        /* xml_state_declaration */
+    (xml_state_parse_t)_xml_parser_cdata,             /* xml_state_cdata */
+    (xml_state_parse_t)_xml_parser_dtd,               /* xml_state_dtd */
+    (xml_state_parse_t)_xml_parser_escape,            /* xml_state_escape */
+    (xml_state_parse_t)_xml_parser_entity             /* xml_state_entity */
+};
+
 /*----------------------------------------------------------------------*/
 /* internal types */
 /*----------------------------------------------------------------------*/
@@ -416,52 +440,49 @@ void xml_init(xml_parser_t* xml_parser, xml_callback_t parser_callback, void* us
     /* reset all fields */
     ememset(xml_parser, 0, sizeof(xml_parser_t));
 
-    /* init state stack */
-    estack_init(&xml_parser->tag_stack, sizeof(xml_tag_t));
+    /* init state stack (shallow documents don't allocate) */
+    estack_init_inline(&xml_parser->tag_stack, sizeof(xml_tag_t),
+                       xml_parser->tag_stack_items, sizeof(xml_parser->tag_stack_items));
     ebuffer_init(&xml_parser->name_buffer);
 
-    /* reserve default space (ignore error, if memory allocation fails we will notice this later) */
-    estack_reserve(&xml_parser->tag_stack, PARSER_DEFAULT_STACK_SIZE);
-
     /* copy callback */
     xml_parser->callback = parser_callback;
     xml_parser->callback_data = user_data;
     xml_parser->callback_return = ELIBC_CONTINUE;
 
-    /* init state parsers */
-    xml_parser->parsers[xml_state_tag_scan] = (xml_state_parse_t)_xml_parser_tag_scan;
-    xml_parser->parsers[xml_state_tag_open] = (xml_state_parse_t)_xml_parser_tag_open;
-    xml_parser->parsers[xml_state_tag_extra] = (xml_state_parse_t)_xml_parser_tag_extra;
-    xml_parser->parsers[xml_state_tag_name] = (xml_state_parse_t)_xml_parser_tag_name;
-    xml_parser->parsers[xml_state_tag] = (xml_state_parse_t)_xml_parser_tag;
-    xml_parser->parsers[xml_state_tag_end] = (xml_state_parse_t)_xml_parser_tag_end;
-    xml_parser->parsers[xml_state_tag_close] = (xml_state_parse_t)_xml_parser_tag_close;
-    xml_parser->parsers[xml_state_content] = (xml_state_parse_t)_xml_parser_content;
-    xml_parser->parsers[xml_state_comment] = (xml_state_parse_t)_xml_parser_comment;
-    xml_parser->parsers[xml_state_attribute_name] = (xml_state_parse_t)_xml_parser_attribute_name;
-    xml_parser->parsers[xml_state_attribute] = (xml_state_parse_t)_xml_parser_attribute;
-    xml_parser->parsers[xml_state_attribute_value] = (xml_state_parse_t)_xml_parser_attribute_value;
-    xml_parser->parsers[xml_state_attribute_string] = (xml_state_parse_t)_xml_parser_attribute_string;
-    xml_parser->parsers[xml_state_pi_begin] = (xml_state_parse_t)_xml_parser_pi_begin;
-    xml_parser->parsers[xml_state_pi_content] = (xml_state_parse_t)_xml_parser_pi_content;
-    xml_parser->parsers[xml_state_declaration] = (xml_state_parse_t)_xml_parser_pi_content;
-    xml_parser->parsers[xml_state_cdata] = (xml_state_parse_t)_xml_parser_cdata;
-    xml_parser->parsers[xml_state_dtd] = (xml_state_parse_t)_xml_parser_dtd;
-    xml_parser->parsers[xml_state_escape] = (xml_state_parse_t)_xml_parser_escape;
-    xml_parser->parsers[xml_state_entity] = (xml_state_parse_t)_xml_parser_entity;
-
 #ifdef _ELIBC_DEBUG
     /* check that all parsers were set */
     {
         int i;
         for(i = 0; i < xml_state_count; ++i)
         {
-            EASSERT1(xml_parser->parsers[i], "xml_parser: state parser was not set");
+            EASSERT1(_xml_state_parsers[i], "xml_parser: state parser was not set");
         }
     }
 #endif /* _ELIBC_DEBUG */
 }
 
+void xml_reset(xml_parser_t* xml_parser, xml_callback_t parser_callback, void* user_data)
+{
+    EASSERT(xml_parser);
+    EASSERT(parser_callback);
+    if(xml_parser == 0 || parser_callback == 0) return;
+
+    /* keep stack and name buffer memory, escape sequence parsers are reset when they are used */
+    estack_reset(&xml_parser->tag_stack);
+    ebuffer_reset(&xml_parser->name_buffer);
+    xml_parser->xml_state = xml_state_tag_scan;
+    xml_parser->parse_buffer = 0;
+    xml_parser->flags = 0;
+    xml_parser->buffer_offset = 0;
+    xml_parser->dtd_depth = 0;
+
+    /* copy callback */
+    xml_parser->callback = parser_callback;
+    xml_parser->callback_data = user_data;
+    xml_parser->callback_return = ELIBC_CONTINUE;
+}
+
 void xml_close(xml_parser_t* xml_parser)
 {
     /* free buffers */
@@ -550,28 +571,28 @@ int xml_parse(xml_parser_t* xml_parser, const char* text, size_t text_size)
         if(_xml_test_flag(xml_parser, XML_FLAG_PARSE_COMMENT))
         {
             /* comments */
-            err = xml_parser->parsers[xml_state_comment](xml_parser, text, text_size, &char_pos);
+            err = _xml_state_parsers[xml_state_comment](xml_parser, text, text_size, &char_pos);
 
         } else if(_xml_test_flag(xml_parser, XML_FLAG_PARSE_CDATA))
         {
             /* CDATA */
-            err = xml_parser->parsers[xml_state_cdata](xml_parser, text, text_size, &char_pos);
+            err = _xml_state_parsers[xml_state_cdata](xml_parser, text, text_size, &char_pos);
 
         } else if(_xml_test_flag(xml_parser, XML_FLAG_PARSE_ESCAPE))
         {
             /* escapes */
-            err = xml_parser->parsers[xml_state_escape](xml_parser, text, text_size, &char_pos);
+            err = _xml_state_parsers[xml_state_escape](xml_parser, text, text_size, &char_pos);
 
         } else if(_xml_test_flag(xml_parser, XML_FLAG_PARSE_ENTITY))
         {
             /* entities */
-            err = xml_parser->parsers[xml_state_entity](xml_parser, text, text_size, &char_pos);
+            err = _xml_state_parsers[xml_state_entity](xml_parser, text, text_size, &char_pos);
 
         } else
         {
             /* default processing */
             EASSERT((int)xml_parser->xml_state < xml_state_count);
-            err = xml_parser->parsers[xml_parser->xml_state](xml_parser, text, text_size, &char_pos);
+            err = _xml_state_parsers[xml_parser->xml_state](xml_parser, text, text_size, &char_pos);
         }
 
         /* stop if error */
@@ -655,6 +676,76 @@ int xml_get_state_tag(xml_parser_t* xml_parser, const char** name_out, size_t* l
     return ELIBC_SUCCESS;
 }
 
+/*----------------------------------------------------------------------*/
+/* parser pool */
+
+/* pooled parser with own parse buffer */
+typedef struct {
+
+    xml_parser_t            xml_parser;     /* must be the first */
+    ebuffer_t               parse_buffer;
+
+} xml_pool_parser_t;
+
+int _xml_pool_parser_init(void* object, void* arg)
+{
+    xml_pool_parser_t* pool_parser = (xml_pool_parser_t*)object;
+
+    EUNUSED(arg);
+
+    ememset(pool_parser, 0, sizeof(xml_pool_parser_t));
+
+    estack_init_inline(&pool_parser->xml_parser.tag_stack, sizeof(xml_tag_t),
+                       pool_parser->xml_parser.tag_stack_items, sizeof(pool_parser->xml_parser.tag_stack_items));
+    ebuffer_init(&pool_parser->xml_parser.name_buffer);
+    ebuffer_init(&pool_parser->parse_buffer);
+
+    return ELIBC_SUCCESS;
+}
+
+void _xml_pool_parser_free(void* object, void* arg)
+{
+    xml_pool_parser_t* pool_parser = (xml_pool_parser_t*)object;
+
+    EUNUSED(arg);
+
+    xml_close(&pool_parser->xml_parser);
+    ebuffer_free(&pool_parser->parse_buffer);
+}
+
+int xml_pool_init(epool_t* epool, size_t slab_objects)
+{
+    int err;
+
+    err = epool_init(epool, sizeof(xml_pool_parser_t), slab_objects);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return epool_set_object_funcs(epool, _xml_pool_parser_init, _xml_pool_parser_free, 0);
+}
+
+xml_parser_t* xml_pool_get(epool_t* epool, xml_callback_t parser_callback, void* user_data)
+{
+    xml_pool_parser_t* pool_parser;
+
+    EASSERT(epool);
+    EASSERT(parser_callback);
+    if(epool == 0 || parser_callback == 0) return 0;
+
+    pool_parser = (xml_pool_parser_t*)epool_alloc(epool);
+    if(pool_parser == 0) return 0;
+
+    /* keep memory reserved by previous user */
+    xml_reset(&pool_parser->xml_parser, parser_callback, user_data);
+    xml_begin(&pool_parser->xml_parser, &pool_parser->parse_buffer);
+
+    return &pool_parser->xml_parser;
+}
+
+void xml_pool_put(epool_t* epool, xml_parser_t* xml_parser)
+{
+    epool_release(epool, xml_parser);
+}
+
 /*----------------------------------------------------------------------*/
 /* state parsers */
 int _xml_parser_tag_scan(xml_parser_t* xml_parser, const char* text, size_t text_size, size_t* pos)
@@ -89,11 +89,9 @@ typedef int (*xml_state_parse_t)(void*, const char*, size_t, size_t*);
 /* xml parser data */
 typedef struct {
 
-    /* state parsers */
-    xml_state_parse_t       parsers[xml_state_count];
-
     /* state stack */
     estack_t                tag_stack;
+    size_t                  tag_stack_items[2 * PARSER_DEFAULT_STACK_SIZE];   /* tag name offset and length */
     ebuffer_t               name_buffer;
     xml_state_t             xml_state;
 
@@ -124,6 +122,9 @@ typedef struct {
 void    xml_init(xml_parser_t* xml_parser, xml_callback_t parser_callback, void* user_data);
 void    xml_close(xml_parser_t* xml_parser);
 
+/* reset parser to the state after init, keeps reserved memory (cheap way to reuse parser) */
+void    xml_reset(xml_parser_t* xml_parser, xml_callback_t parser_callback, void* user_data);
+
 /* options */
 int     xml_decode_escapes(xml_parser_t* xml_parser, int enable_decode);
 
@@ -135,6 +136,15 @@ int     xml_end(xml_parser_t* xml_parser);
 /* parser state */
 int     xml_get_state_tag(xml_parser_t* xml_parser, const char** name_out, size_t* length_out);
 
+/*
+    Parser pool keeps parsers with their tag stack and parse buffer memory
+    between uses, get returns parser ready for xml_parse (xml_begin is called
+    with pooled buffer). Pool is closed with epool_free.
+*/
+int             xml_pool_init(epool_t* epool, size_t slab_objects);
+xml_parser_t*   xml_pool_get(epool_t* epool, xml_callback_t parser_callback, void* user_data);
+void            xml_pool_put(epool_t* epool, xml_parser_t* xml_parser);
+
 /*----------------------------------------------------------------------*/
 
 #endif /* _XML_PARSE_H_ */
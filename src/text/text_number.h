@@ -0,0 +1,40 @@
+/*
+    Number to text formatting helpers
+*/
+
+#ifndef _TEXT_NUMBER_H_
+#define _TEXT_NUMBER_H_
+
+/*----------------------------------------------------------------------*/
+
+/* buffer size enough to fit any formatted number (including string end) */
+#define TEXT_NUMBER_BUFFER_SIZE         32
+
+/*
+    NOTE: - functions write null terminated string to str_out (must be at least
+            TEXT_NUMBER_BUFFER_SIZE characters long) and return its length
+          - output does not depend on current locale
+*/
+
+/*----------------------------------------------------------------------*/
+
+/* integer numbers */
+size_t int32_to_str(eint32_t number, char* str_out);
+size_t uint32_to_str(euint32_t number, char* str_out);
+size_t int64_to_str(eint64_t number, char* str_out);
+size_t uint64_to_str(euint64_t number, char* str_out);
+
+/*
+    NOTE: double_to_str produces the shortest string that parses back to exactly
+          the same number. Decimal notation is used for exponents from -6 to 20
+          and scientific otherwise (e.g. "0.1", "123.456", "1e+21", "5e-324").
+          Not finite numbers are formatted as "NaN", "Infinity" and "-Infinity".
+*/
+
+/* floating point numbers */
+size_t double_to_str(double number, char* str_out);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _TEXT_NUMBER_H_ */
+
@@ -5,6 +5,7 @@
 #include "../elib_config.h"
 
 #include "text_format.h"
+#include "text_number.h"
 #include "text_string.h"
 
 /*----------------------------------------------------------------------*/
@@ -282,116 +283,62 @@ int ustring_append_char(ustring_t* ustring, char ch)
 
 int ustring_append_int(ustring_t* ustring, int number)
 {
-    /* should be enough to fit signed 64 bit integer as string */
-    char buffer[32]; 
+    char buffer[TEXT_NUMBER_BUFFER_SIZE]; 
+    size_t length;
 
-    /* format string to buffer */
-    esnprintf(buffer, sizeof(buffer), "%d", number);
+    /* format number to buffer */
+    length = int32_to_str((eint32_t)number, buffer);
 
     /* append as utf8 string */
-    return ustring_append_utf8(ustring, (const utf8_t*)buffer, 0);
+    return ustring_append_utf8(ustring, (const utf8_t*)buffer, length);
 }
 
 int ustring_append_uint(ustring_t* ustring, unsigned int number)
 {
-    /* should be enough to fit unsigned 64 bit integer as string */
-    char buffer[32]; 
+    char buffer[TEXT_NUMBER_BUFFER_SIZE]; 
+    size_t length;
 
-    /* format string to buffer */
-    esnprintf(buffer, sizeof(buffer), "%u", number);
+    /* format number to buffer */
+    length = uint32_to_str((euint32_t)number, buffer);
 
     /* append as utf8 string */
-    return ustring_append_utf8(ustring, (const utf8_t*)buffer, 0);
+    return ustring_append_utf8(ustring, (const utf8_t*)buffer, length);
 }
 
 int ustring_append_int64(ustring_t* ustring, eint64_t number)
 {
-    /* should be enough to fit signed 64 bit integer as string */
-    char buffer[32]; 
+    char buffer[TEXT_NUMBER_BUFFER_SIZE]; 
+    size_t length;
 
-    /* format string to buffer */
-    esnprintf(buffer, sizeof(buffer), "%" EPRId64, number);
+    /* format number to buffer */
+    length = int64_to_str(number, buffer);
 
     /* append as utf8 string */
-    return ustring_append_utf8(ustring, (const utf8_t*)buffer, 0);
+    return ustring_append_utf8(ustring, (const utf8_t*)buffer, length);
 }
 
 int ustring_append_uint64(ustring_t* ustring, euint64_t number)
 {
-    /* should be enough to fit unsigned 64 bit integer as string */
-    char buffer[32]; 
+    char buffer[TEXT_NUMBER_BUFFER_SIZE]; 
+    size_t length;
 
-    /* format string to buffer */
-    esnprintf(buffer, sizeof(buffer), "%" EPRIu64, number);
+    /* format number to buffer */
+    length = uint64_to_str(number, buffer);
 
     /* append as utf8 string */
-    return ustring_append_utf8(ustring, (const utf8_t*)buffer, 0);
+    return ustring_append_utf8(ustring, (const utf8_t*)buffer, length);
 }
 
 int ustring_append_float(ustring_t* ustring, double number)
 {
-    size_t required_size;
-    char dummy;
-    int err;
-
-    /* check input */
-    EASSERT(ustring);
-    if(ustring == 0) return ELIBC_ERROR_ARGUMENT;
-
-    /* compute required size (in characters) */
-#ifdef __GNUC__
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wformat-truncation"
-#endif /* __GNUC__ */
-    required_size = esnprintf(&dummy, 1, "%f", number);
-#ifdef __GNUC__
-#pragma GCC diagnostic pop
-#endif /* __GNUC__ */
-    if(required_size <= 0)
-    {
-        ETRACE("ustring: failed to append floating number");
-        return ELIBC_ERROR_ARGUMENT;
-    }
-
-    /* check string encoding */
-    if(ustring->encoding == TEXT_ENCODING_UTF8)
-    {
-        char* output_str;
-
-        /* update buffer position (remove last zero) */
-        err = ebuffer_setpos(&ustring->data, ustring->length * sizeof(utf8_t));
-        if(err != ELIBC_SUCCESS) return err;
-
-        /* reserve space */
-        output_str = ebuffer_append_ptr(&ustring->data, required_size * sizeof(utf8_t));
-        if(output_str == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+    char buffer[TEXT_NUMBER_BUFFER_SIZE]; 
+    size_t length;
 
-        /* format number (NOTE: string termination will be added as well) */
-        esnprintf(output_str, required_size, "%f", number);
+    /* format number to buffer (shortest round-trip representation) */
+    length = double_to_str(number, buffer);
 
-        /* update length */
-        ustring->length += required_size;
-
-    } else
-    {
-        ewchar_t* output_str;
-
-        /* update buffer position (remove last zero) */
-        err = ebuffer_setpos(&ustring->data, ustring->length * sizeof(utf16_t));
-        if(err != ELIBC_SUCCESS) return err;
-
-        /* reserve space */
-        output_str = (ewchar_t*)ebuffer_append_ptr(&ustring->data, required_size * sizeof(ewchar_t));
-        if(output_str == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
-
-        /* format number (NOTE: string termination will be added as well) */
-        eswprintf(output_str, required_size, (const ewchar_t*)L"%f", number);
-
-        /* update length */
-        ustring->length += required_size;
-    }
-
-    return ELIBC_SUCCESS;
+    /* append as utf8 string */
+    return ustring_append_utf8(ustring, (const utf8_t*)buffer, length);
 }
 
 /* string encoding */
@@ -182,6 +182,195 @@ int _datetime_parser_validate(const datetime_t* datetime)
     return err;
 }
 
+/*----------------------------------------------------------------------*/
+/* fixed layout fast path */
+/*----------------------------------------------------------------------*/
+
+/*
+    NOTE: most of the timestamps use fixed width layouts, i.e. "2016-04-29T18:31:37Z"
+          or "Sun, 06 Nov 1994 08:49:37 GMT". Such inputs are validated and decoded
+          eight characters at a time, anything else goes to the generic parsers.
+*/
+
+#define DATETIME_ISO8601_UTC_LENGTH     20
+#define DATETIME_ISO8601_OFFSET_LENGTH  25
+#define DATETIME_RFC1123_GMT_LENGTH     29
+
+/* lane (character) value in eight character word */
+#define DATETIME_LANE(word, lane)       ((unsigned short)(((word) >> ((lane) * 8)) & 0xFF))
+
+/* week day and month name keys */
+#define DATETIME_NAME_KEY(a, b, c)      ((euint32_t)(a) | ((euint32_t)(b) << 8) | ((euint32_t)(c) << 16))
+
+static const euint32_t _datetime_weekday_keys[] = 
+{
+    DATETIME_NAME_KEY('S', 'u', 'n'), DATETIME_NAME_KEY('M', 'o', 'n'), DATETIME_NAME_KEY('T', 'u', 'e'),
+    DATETIME_NAME_KEY('W', 'e', 'd'), DATETIME_NAME_KEY('T', 'h', 'u'), DATETIME_NAME_KEY('F', 'r', 'i'),
+    DATETIME_NAME_KEY('S', 'a', 't')
+};
+
+static const euint32_t _datetime_month_keys[] = 
+{
+    DATETIME_NAME_KEY('J', 'a', 'n'), DATETIME_NAME_KEY('F', 'e', 'b'), DATETIME_NAME_KEY('M', 'a', 'r'),
+    DATETIME_NAME_KEY('A', 'p', 'r'), DATETIME_NAME_KEY('M', 'a', 'y'), DATETIME_NAME_KEY('J', 'u', 'n'),
+    DATETIME_NAME_KEY('J', 'u', 'l'), DATETIME_NAME_KEY('A', 'u', 'g'), DATETIME_NAME_KEY('S', 'e', 'p'),
+    DATETIME_NAME_KEY('O', 'c', 't'), DATETIME_NAME_KEY('N', 'o', 'v'), DATETIME_NAME_KEY('D', 'e', 'c')
+};
+
+/* load eight characters, first character goes to the lowest byte */
+ELIBC_FORCE_INLINE euint64_t _datetime_load_word(const char* str)
+{
+#ifdef ELIBC_BIG_ENDIAN
+    const unsigned char* data = (const unsigned char*)str;
+
+    return  ((euint64_t)data[0])       | ((euint64_t)data[1] << 8)  | 
+            ((euint64_t)data[2] << 16) | ((euint64_t)data[3] << 24) |
+            ((euint64_t)data[4] << 32) | ((euint64_t)data[5] << 40) | 
+            ((euint64_t)data[6] << 48) | ((euint64_t)data[7] << 56);
+#else
+    euint64_t word;
+
+    ememcpy(&word, str, sizeof(word));
+
+    return word;
+#endif
+}
+
+/* 
+    NOTE: digits mask selects lanes which must be digits, fixed mask selects lanes
+          which must match pattern exactly, other lanes are ignored
+*/
+ELIBC_FORCE_INLINE ebool_t _datetime_match_word(euint64_t word, euint64_t pattern, euint64_t digits, euint64_t fixed)
+{
+    euint64_t value;
+
+    /* replace other lanes with '0' */
+    value = (word & digits) | (0x3030303030303030ULL & ~digits);
+
+    /* all lanes must be in '0'-'9' range now (high nibble 3 and no carry when adding 6) */
+    value = (value & 0xF0F0F0F0F0F0F0F0ULL) | (((value + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4);
+
+    return (value == 0x3333333333333333ULL && (word & fixed) == (pattern & fixed)) ? ELIBC_TRUE : ELIBC_FALSE;
+}
+
+/* two digit values, lane N contains number formed by digits in lanes N and N+1 */
+ELIBC_FORCE_INLINE euint64_t _datetime_word_pairs(euint64_t word, euint64_t digits)
+{
+    /* digit values (other lanes are zero) */
+    word = (word & digits) - (0x3030303030303030ULL & digits);
+
+    /* lane values never exceed 99 so there is no carry between lanes */
+    return word * 10 + (word >> 8);
+}
+
+/* match three letter name key */
+ELIBC_FORCE_INLINE int _datetime_match_name_key(euint32_t key, const euint32_t* keys, int key_count)
+{
+    int idx;
+
+    for(idx = 0; idx < key_count; ++idx)
+    {
+        if(keys[idx] == key) return idx;
+    }
+
+    return -1;
+}
+
+/* parse "YYYY-MM-DDTHH:MM:SSZ" or "YYYY-MM-DDTHH:MM:SS+HH:MM" */
+ebool_t _datetime_parse_iso8601_fixed(const char* str_input, size_t str_len, datetime_t* datetime)
+{
+    euint64_t date, time, seconds, offset;
+    char terminator;
+
+    if(str_len != DATETIME_ISO8601_UTC_LENGTH && str_len != DATETIME_ISO8601_OFFSET_LENGTH) return ELIBC_FALSE;
+
+    /* check terminator */
+    terminator = str_input[19];
+    if(str_len == DATETIME_ISO8601_UTC_LENGTH ? (terminator != 'Z') : (terminator != '+' && terminator != '-')) return ELIBC_FALSE;
+
+    /* "YYYY-MM-", "DDTHH:MM" and "H:MM:SS?" */
+    date = _datetime_load_word(str_input);
+    time = _datetime_load_word(str_input + 8);
+    seconds = _datetime_load_word(str_input + 12);
+
+    if(!_datetime_match_word(date, _datetime_load_word("0000-00-"), 0x00FFFF00FFFFFFFFULL, 0xFF0000FF00000000ULL) ||
+       !_datetime_match_word(time, _datetime_load_word("00T00:00"), 0xFFFF00FFFF00FFFFULL, 0x0000FF0000FF0000ULL) ||
+       !_datetime_match_word(seconds, _datetime_load_word("0:00:00Z"), 0x00FFFF00FFFF00FFULL, 0x000000FF0000FF00ULL))
+    {
+        return ELIBC_FALSE;
+    }
+
+    if(str_len == DATETIME_ISO8601_OFFSET_LENGTH)
+    {
+        /* "SS?HH:MM" */
+        offset = _datetime_load_word(str_input + 17);
+        if(!_datetime_match_word(offset, _datetime_load_word("00+00:00"), 0xFFFF00FFFF00FFFFULL, 0x0000FF0000000000ULL)) return ELIBC_FALSE;
+
+        offset = _datetime_word_pairs(offset, 0xFFFF00FFFF000000ULL);
+        datetime->offset = 60 * DATETIME_LANE(offset, 3) + DATETIME_LANE(offset, 6);
+        if(terminator == '-') datetime->offset = -datetime->offset;
+    }
+
+    /* decode */
+    date = _datetime_word_pairs(date, 0x00FFFF00FFFFFFFFULL);
+    time = _datetime_word_pairs(time, 0xFFFF00FFFF00FFFFULL);
+    seconds = _datetime_word_pairs(seconds, 0x00FFFF0000000000ULL);
+
+    datetime->year = DATETIME_LANE(date, 0) * 100 + DATETIME_LANE(date, 2);
+    datetime->month = DATETIME_LANE(date, 5) - 1; /* ISO 8601 months are from 1-12 */
+    datetime->day = DATETIME_LANE(time, 0);
+    datetime->hours = DATETIME_LANE(time, 3);
+    datetime->minutes = DATETIME_LANE(time, 6);
+    datetime->seconds = DATETIME_LANE(seconds, 5);
+
+    return ELIBC_TRUE;
+}
+
+/* parse "Sun, 06 Nov 1994 08:49:37 GMT" */
+ebool_t _datetime_parse_rfc1123_fixed(const char* str_input, size_t str_len, datetime_t* datetime)
+{
+    euint64_t day, year, time, seconds;
+    int weekday, month;
+
+    if(str_len != DATETIME_RFC1123_GMT_LENGTH) return ELIBC_FALSE;
+
+    /* "Www, DD ", "Mmm YYYY", " HH:MM:S" and "M:SS GMT" */
+    day = _datetime_load_word(str_input);
+    year = _datetime_load_word(str_input + 8);
+    time = _datetime_load_word(str_input + 16);
+    seconds = _datetime_load_word(str_input + 21);
+
+    if(!_datetime_match_word(day, _datetime_load_word("Www, 00 "), 0x00FFFF0000000000ULL, 0xFF0000FFFF000000ULL) ||
+       !_datetime_match_word(year, _datetime_load_word("Mmm 0000"), 0xFFFFFFFF00000000ULL, 0x00000000FF000000ULL) ||
+       !_datetime_match_word(time, _datetime_load_word(" 00:00:0"), 0xFF00FFFF00FFFF00ULL, 0x00FF0000FF0000FFULL) ||
+       !_datetime_match_word(seconds, _datetime_load_word("0:00 GMT"), 0x00000000FFFF00FFULL, 0xFFFFFFFF0000FF00ULL))
+    {
+        return ELIBC_FALSE;
+    }
+
+    /* names (exact case only) */
+    weekday = _datetime_match_name_key((euint32_t)(day & 0xFFFFFF), _datetime_weekday_keys, DATETIME_WEEKDAY_SIZE);
+    month = _datetime_match_name_key((euint32_t)(year & 0xFFFFFF), _datetime_month_keys, DATETIME_MONTH_NAME_SIZE);
+    if(weekday < 0 || month < 0) return ELIBC_FALSE;
+
+    /* decode */
+    day = _datetime_word_pairs(day, 0x00FFFF0000000000ULL);
+    year = _datetime_word_pairs(year, 0xFFFFFFFF00000000ULL);
+    time = _datetime_word_pairs(time, 0xFF00FFFF00FFFF00ULL);
+    seconds = _datetime_word_pairs(seconds, 0x00000000FFFF0000ULL);
+
+    datetime->weekday = (unsigned short)weekday;
+    datetime->day = DATETIME_LANE(day, 5);
+    datetime->month = (unsigned short)month;
+    datetime->year = DATETIME_LANE(year, 4) * 100 + DATETIME_LANE(year, 6);
+    datetime->hours = DATETIME_LANE(time, 1);
+    datetime->minutes = DATETIME_LANE(time, 4);
+    datetime->seconds = DATETIME_LANE(seconds, 2);
+    datetime->offset = 0;
+
+    return ELIBC_TRUE;
+}
+
 /*----------------------------------------------------------------------*/
 /* unixtime */
 /*----------------------------------------------------------------------*/
@@ -276,6 +465,9 @@ int _datetime_parse_iso8601(const char* str_input, size_t str_len, datetime_t* d
 
     signed short offset_sign = 1;
 
+    /* try fixed layout first */
+    if(_datetime_parse_iso8601_fixed(str_input, str_len, datetime)) return _datetime_parser_validate(datetime);
+
     /* loop over all characters */
     for(str_idx = 0; str_idx < str_len && parse_state != time_parser_state_end; ++str_idx)
     {
@@ -627,6 +819,9 @@ int _datetime_parse_rfc1123(const char* str_input, size_t str_len, datetime_t* d
 
     signed short offset_sign = 1;
 
+    /* try fixed layout first */
+    if(_datetime_parse_rfc1123_fixed(str_input, str_len, datetime)) return _datetime_parser_validate(datetime);
+
     /* loop over all characters */
     for(str_idx = 0; str_idx < str_len && parse_state != time_parser_state_end; ++str_idx)
     {
@@ -1370,6 +1565,26 @@ int datetime_parse(time_format_t format, const char* str_input, size_t str_len,
     return ELIBC_ERROR_ARGUMENT;
 }
 
+int datetime_parse_batch(time_format_t format, const char* const* str_inputs, const size_t* str_lens, datetime_t* datetimes, size_t count)
+{
+    size_t idx;
+    int err;
+
+    /* check input */
+    EASSERT(str_inputs || count == 0);
+    EASSERT(datetimes || count == 0);
+    if(count > 0 && (str_inputs == 0 || datetimes == 0)) return ELIBC_ERROR_ARGUMENT;
+
+    /* parse */
+    for(idx = 0; idx < count; ++idx)
+    {
+        err = datetime_parse(format, str_inputs[idx], (str_lens ? str_lens[idx] : 0), datetimes + idx);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    return ELIBC_SUCCESS;
+}
+
 int datetime_format(time_format_t format, const datetime_t* datetime, char* str_output, size_t* output_size)
 {
     /* check input */
@@ -1420,6 +1635,123 @@ int datetime_format(time_format_t format, const datetime_t* datetime, char* str_
 
 /*----------------------------------------------------------------------*/
 
+/*
+    NOTE: conversions use pure proleptic Gregorian calendar arithmetic (days from
+          civil algorithm, http://howardhinnant.github.io/date_algorithms.html)
+          and never touch libc time state, so they are thread safe. Leap seconds
+          are ignored as in Unix time.
+*/
+
+#define DATETIME_SECONDS_PER_DAY        86400
+
+/* days between 0000-03-01 and 1970-01-01 */
+#define DATETIME_DAYS_EPOCH_SHIFT       719468
+
+/* days in 400 years era */
+#define DATETIME_DAYS_PER_ERA           146097
+
+/* days since 1970-01-01 (month is 1-12) */
+ELIBC_FORCE_INLINE eint64_t _datetime_days_from_civil(eint64_t year, unsigned int month, unsigned int day)
+{
+    eint64_t era;
+    unsigned int year_of_era, day_of_year, day_of_era;
+
+    /* year starts in March so leap day is the last one */
+    if(month <= 2) year--;
+
+    era = (year >= 0 ? year : year - 399) / 400;
+    year_of_era = (unsigned int)(year - era * 400);
+    day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+
+    return era * DATETIME_DAYS_PER_ERA + (eint64_t)day_of_era - DATETIME_DAYS_EPOCH_SHIFT;
+}
+
+/* date from days since 1970-01-01 (month is 0-11) */
+ELIBC_FORCE_INLINE eint64_t _datetime_civil_from_days(eint64_t days, unsigned int* month, unsigned int* day)
+{
+    eint64_t era, year;
+    unsigned int year_of_era, day_of_year, day_of_era, month_index;
+
+    days += DATETIME_DAYS_EPOCH_SHIFT;
+
+    era = (days >= 0 ? days : days - DATETIME_DAYS_PER_ERA + 1) / DATETIME_DAYS_PER_ERA;
+    day_of_era = (unsigned int)(days - era * DATETIME_DAYS_PER_ERA);
+    year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    month_index = (5 * day_of_year + 2) / 153;
+
+    /* month index starts from March */
+    *day = day_of_year - (153 * month_index + 2) / 5 + 1;
+    *month = (month_index < 10) ? month_index + 2 : month_index - 10;
+
+    year = (eint64_t)year_of_era + era * 400;
+    if(*month <= 1) year++;
+
+    return year;
+}
+
+/* days since Sunday */
+ELIBC_FORCE_INLINE unsigned int _datetime_weekday_from_days(eint64_t days)
+{
+    /* 1970-01-01 was Thursday */
+    return (unsigned int)(days >= -4 ? (days + 4) % 7 : (days + 5) % 7 + 6);
+}
+
+ELIBC_FORCE_INLINE etime_t _datetime_to_unixtime_impl(const datetime_t* datetime)
+{
+    eint64_t days = _datetime_days_from_civil(datetime->year, datetime->month + 1, datetime->day);
+
+    return (etime_t)(days * DATETIME_SECONDS_PER_DAY + 
+                     datetime->hours * 3600 + datetime->minutes * 60 + datetime->seconds - 
+                     60 * datetime->offset);
+}
+
+ELIBC_FORCE_INLINE void _datetime_set_time_of_day(eint64_t seconds, datetime_t* datetime)
+{
+    unsigned int day_seconds = (unsigned int)seconds;
+
+    datetime->hours = (unsigned short)(day_seconds / 3600);
+    datetime->minutes = (unsigned short)((day_seconds / 60) % 60);
+    datetime->seconds = (unsigned short)(day_seconds % 60);
+}
+
+ELIBC_FORCE_INLINE int _datetime_set_date(eint64_t days, datetime_t* datetime)
+{
+    unsigned int month, day;
+    eint64_t year;
+
+    /* convert */
+    year = _datetime_civil_from_days(days, &month, &day);
+    if(year < 0 || year > 9999)
+    {
+        ETRACE("unixtime_to_datetime: unixtime is out of supported range");
+        return ELIBC_ERROR_ARGUMENT;
+    }
+
+    datetime->year = (unsigned short)year;
+    datetime->month = (unsigned short)month;
+    datetime->day = (unsigned short)day;
+    datetime->weekday = (unsigned short)_datetime_weekday_from_days(days);
+
+    return ELIBC_SUCCESS;
+}
+
+/* split unixtime to days and seconds of the day (rounded towards negative infinity) */
+ELIBC_FORCE_INLINE eint64_t _datetime_split_unixtime(etime_t unixtime, eint64_t* seconds)
+{
+    eint64_t days = (eint64_t)unixtime / DATETIME_SECONDS_PER_DAY;
+
+    *seconds = (eint64_t)unixtime - days * DATETIME_SECONDS_PER_DAY;
+    if(*seconds < 0)
+    {
+        *seconds += DATETIME_SECONDS_PER_DAY;
+        days--;
+    }
+
+    return days;
+}
+
 /*
     NOTE: ignore milliseconds
 */
@@ -1427,67 +1759,112 @@ int datetime_format(time_format_t format, const datetime_t* datetime, char* str_
 /* convert times */
 int datetime_to_unixtime(const datetime_t* datetime, etime_t* unixtime)
 {
-    etm_t timeinfo;
-
     /* check input */
     EASSERT(datetime);
     EASSERT(unixtime);
     if(datetime == 0 || unixtime == 0) return ELIBC_ERROR_ARGUMENT;
 
-    /* reset time info */
-    ememset(&timeinfo, 0, sizeof(etm_t));
-
-    /* fill tm structure */
-    timeinfo.tm_year = datetime->year - 1900;
-    timeinfo.tm_mon = datetime->month;
-    timeinfo.tm_mday = datetime->day;
-    timeinfo.tm_hour = datetime->hours;
-    timeinfo.tm_min = datetime->minutes;
-    timeinfo.tm_sec = datetime->seconds;
-    
-    /* Zero (0) to indicate that standard time is in effect. */
-    timeinfo.tm_isdst = 0; 
-
     /* convert */
-    *unixtime = etimegm(&timeinfo);
-
-    /* remove offset */
-    *unixtime -= 60 * datetime->offset;
+    *unixtime = _datetime_to_unixtime_impl(datetime);
 
     return ELIBC_SUCCESS;
 }
 
 int unixtime_to_datetime(const etime_t unixtime, datetime_t* datetime)
 {
-    etm_t* ptm;
+    eint64_t days, seconds;
 
     /* check input */
     EASSERT(datetime);
-    EASSERT(unixtime);
-    if(datetime == 0 || unixtime == 0) return ELIBC_ERROR_ARGUMENT;
+    if(datetime == 0) return ELIBC_ERROR_ARGUMENT;
 
     /* reset output */
     ememset(datetime, 0, sizeof(datetime_t));
 
+    /* split time */
+    days = _datetime_split_unixtime(unixtime, &seconds);
+
+    /* fill output (unixtime is in UTC) */
+    _datetime_set_time_of_day(seconds, datetime);
+    return _datetime_set_date(days, datetime);
+}
+
+/* convert arrays of times */
+int datetime_to_unixtime_batch(const datetime_t* datetimes, etime_t* unixtimes, size_t count)
+{
+    size_t idx;
+
+    /* check input */
+    EASSERT(datetimes || count == 0);
+    EASSERT(unixtimes || count == 0);
+    if(count > 0 && (datetimes == 0 || unixtimes == 0)) return ELIBC_ERROR_ARGUMENT;
+
     /* convert */
-    ptm = egmtime(&unixtime);
-    if(ptm == 0)
+    for(idx = 0; idx < count; ++idx)
     {
-        ETRACE("unixtime_to_datetime: failed to convert unixtime");
-        return ELIBC_ERROR_INTERNAL;
+        unixtimes[idx] = _datetime_to_unixtime_impl(datetimes + idx);
     }
 
-    /* fill output */
-    datetime->year = ptm->tm_year + 1900;
-    datetime->month = ptm->tm_mon;
-    datetime->day = ptm->tm_mday;
-    datetime->hours = ptm->tm_hour;
-    datetime->minutes = ptm->tm_min;
-    datetime->seconds = ptm->tm_sec;
-    datetime->weekday = ptm->tm_wday;
+    return ELIBC_SUCCESS;
+}
 
-    /* unixtime is in UTC */
-    datetime->offset = 0;
+int unixtime_to_datetime_batch(const etime_t* unixtimes, datetime_t* datetimes, size_t count)
+{
+    eint64_t days, seconds, last_days;
+    size_t idx;
+    int err;
+
+    /* check input */
+    EASSERT(unixtimes || count == 0);
+    EASSERT(datetimes || count == 0);
+    if(count > 0 && (unixtimes == 0 || datetimes == 0)) return ELIBC_ERROR_ARGUMENT;
+
+    last_days = 0;
+    for(idx = 0; idx < count; ++idx)
+    {
+        /* split time */
+        days = _datetime_split_unixtime(unixtimes[idx], &seconds);
+
+        /* timestamps are usually sorted, reuse date from previous item if the same day */
+        if(idx > 0 && days == last_days)
+        {
+            datetimes[idx] = datetimes[idx - 1];
+
+        } else
+        {
+            datetimes[idx].offset = 0;
+
+            err = _datetime_set_date(days, datetimes + idx);
+            if(err != ELIBC_SUCCESS) return err;
+
+            last_days = days;
+        }
+
+        _datetime_set_time_of_day(seconds, datetimes + idx);
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+int datetime_parse_unixtime_batch(time_format_t format, const char* const* str_inputs, const size_t* str_lens, etime_t* unixtimes, size_t count)
+{
+    datetime_t datetime;
+    size_t idx;
+    int err;
+
+    /* check input */
+    EASSERT(str_inputs || count == 0);
+    EASSERT(unixtimes || count == 0);
+    if(count > 0 && (str_inputs == 0 || unixtimes == 0)) return ELIBC_ERROR_ARGUMENT;
+
+    /* parse and convert */
+    for(idx = 0; idx < count; ++idx)
+    {
+        err = datetime_parse(format, str_inputs[idx], (str_lens ? str_lens[idx] : 0), &datetime);
+        if(err != ELIBC_SUCCESS) return err;
+
+        unixtimes[idx] = _datetime_to_unixtime_impl(&datetime);
+    }
 
     return ELIBC_SUCCESS;
 }
@@ -61,12 +61,28 @@ typedef struct
 int datetime_parse(time_format_t format, const char* str_input, size_t str_len, datetime_t* datetime);
 int datetime_format(time_format_t format, const datetime_t* datetime, char* str_output, size_t* output_size);
 
+/*
+    NOTE: - batch functions parse arrays of strings (e.g. log columns), str_lens
+            is optional, if null or zero length strings must be null terminated
+          - parsing stops on the first error and its code is returned
+          - fixed width "YYYY-MM-DDTHH:MM:SSZ" and "Www, DD Mmm YYYY HH:MM:SS GMT"
+            inputs are decoded using fast path
+*/
+
+/* parse arrays of times */
+int datetime_parse_batch(time_format_t format, const char* const* str_inputs, const size_t* str_lens, datetime_t* datetimes, size_t count);
+int datetime_parse_unixtime_batch(time_format_t format, const char* const* str_inputs, const size_t* str_lens, etime_t* unixtimes, size_t count);
+
 /*----------------------------------------------------------------------*/
 
-/* convert times */
+/* convert times (thread safe, no libc time functions are used) */
 int datetime_to_unixtime(const datetime_t* datetime, etime_t* unixtime);
 int unixtime_to_datetime(const etime_t unixtime, datetime_t* datetime);
 
+/* convert arrays of times */
+int datetime_to_unixtime_batch(const datetime_t* datetimes, etime_t* unixtimes, size_t count);
+int unixtime_to_datetime_batch(const etime_t* unixtimes, datetime_t* datetimes, size_t count);
+
 /*----------------------------------------------------------------------*/
 /* names (English) */
 const char* datetime_weekday(int weekday);
@@ -11,14 +11,32 @@
 /*
     NOTE: timestamp value is system dependent
             - on Windows it is FILETIME (100-nanoseconds intervals since 1601)
+            - on Linux it is in nanoseconds from CLOCK_MONOTONIC (since unspecified
+              point, not affected by system time changes)
+          use TIMESTAMP_TICKS_PER_SEC or timestamp_append_sec to convert
 */
 
+#ifdef _ELIBC_OS_WINDOWS
+#define TIMESTAMP_TICKS_PER_SEC     10000000
+#else
+#define TIMESTAMP_TICKS_PER_SEC     1000000000
+#endif /* _ELIBC_OS_WINDOWS */
+
 eint64_t timestamp_current();
-eint64_t timestamp_append_sec(eint64_t timestamp, double seconds);
+eint64_t timestamp_append_sec(eint64_t timestamp, double seconds);   /* seconds may be negative */
+
+/*
+    NOTE: coarse timestamp has the same units but lower resolution (usually 1-4 ms),
+          it is much cheaper to get and is meant for hot paths (e.g. per event timeouts)
+*/
+eint64_t timestamp_current_coarse();
 
 /* system independent timestamp in milliseconds */
 eint64_t timestamp_current_ms();
 
+/* system independent wall clock time in nanoseconds since 1 of January 1970 (UTC) */
+eint64_t timestamp_realtime_ns();
+
 /*----------------------------------------------------------------------*/
 
 #endif /* _TIME_UTILS_H_*/
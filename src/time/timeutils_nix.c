@@ -0,0 +1,70 @@
+/*
+    Time utilities
+*/
+
+#include <time.h>
+
+#include "../elib_config.h"
+
+#include "timeutils.h"
+
+/*----------------------------------------------------------------------*/
+
+#define TIMEUTILS_NSEC_PER_SEC      1000000000
+#define TIMEUTILS_NSEC_PER_MSEC     1000000
+
+/* coarse clock is Linux specific */
+#ifdef CLOCK_MONOTONIC_COARSE
+#define TIMEUTILS_CLOCK_COARSE      CLOCK_MONOTONIC_COARSE
+#else
+#define TIMEUTILS_CLOCK_COARSE      CLOCK_MONOTONIC
+#endif /* CLOCK_MONOTONIC_COARSE */
+
+/*----------------------------------------------------------------------*/
+
+/* read clock in nanoseconds */
+ELIBC_FORCE_INLINE eint64_t _timeutils_clock_ns(clockid_t clock_id)
+{
+    struct timespec ts;
+
+    if(clock_gettime(clock_id, &ts) != 0)
+    {
+        ETRACE_ERRNO("timeutils: failed to get clock time");
+        return 0;
+    }
+
+    return (eint64_t)ts.tv_sec * TIMEUTILS_NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/*----------------------------------------------------------------------*/
+/* timestamp helpers */
+
+eint64_t timestamp_current()
+{
+    return _timeutils_clock_ns(CLOCK_MONOTONIC);
+}
+
+eint64_t timestamp_append_sec(eint64_t timestamp, double seconds)
+{
+    /* append seconds (may be negative) */
+    return timestamp + (eint64_t)(seconds * TIMEUTILS_NSEC_PER_SEC);
+}
+
+eint64_t timestamp_current_coarse()
+{
+    return _timeutils_clock_ns(TIMEUTILS_CLOCK_COARSE);
+}
+
+/* system independent timestamp in milliseconds */
+eint64_t timestamp_current_ms()
+{
+    return timestamp_current() / TIMEUTILS_NSEC_PER_MSEC;
+}
+
+/* system independent wall clock time in nanoseconds since 1 of January 1970 (UTC) */
+eint64_t timestamp_realtime_ns()
+{
+    return _timeutils_clock_ns(CLOCK_REALTIME);
+}
+
+/*----------------------------------------------------------------------*/
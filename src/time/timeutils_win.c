@@ -32,8 +32,19 @@ eint64_t timestamp_current()
 
 eint64_t timestamp_append_sec(eint64_t timestamp, double seconds)
 {
-    /* append seconds */
-    return timestamp + (ULONGLONG)(seconds * ((ULONGLONG) 10000000));
+    /* append seconds (may be negative) */
+    return timestamp + (eint64_t)(seconds * TIMESTAMP_TICKS_PER_SEC);
+}
+
+eint64_t timestamp_current_coarse()
+{
+    FILETIME ft;
+
+    /* system time as file time (updated on each tick) */
+    GetSystemTimeAsFileTime(&ft);
+
+    /* convert to int64 */
+    return (eint64_t)(((ULONGLONG) ft.dwHighDateTime) << 32) + ft.dwLowDateTime;
 }
 
 /* system independent timestamp in milliseconds */
@@ -42,4 +53,11 @@ eint64_t timestamp_current_ms()
     return timestamp_current() / 10000;
 }
 
+/* system independent wall clock time in nanoseconds since 1 of January 1970 (UTC) */
+eint64_t timestamp_realtime_ns()
+{
+    /* 100-nanoseconds intervals between 1601 and 1970 */
+    return (timestamp_current_coarse() - 116444736000000000LL) * 100;
+}
+
 /*----------------------------------------------------------------------*/
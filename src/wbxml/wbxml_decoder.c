@@ -12,6 +12,8 @@
 /* flags */
 #define WBXML_FLAG_MASK_RESET           0xFF00
 #define WBXML_FLAG_ERROR                0x0001
+#define WBXML_FLAG_PUBLIC_ID_LITERAL    0x0002
+#define WBXML_FLAG_ZERO_COPY            0x0100
 
 /*----------------------------------------------------------------------*/
 /* special token code flags */
@@ -32,6 +34,29 @@ int _wbxml_decoder_string(wbxml_decoder_t* wbxml_decoder, const euint8_t* input,
 int _wbxml_decoder_jump_to_multibyte(wbxml_decoder_t* wbxml_decoder, const euint8_t* input, size_t input_size, size_t* input_pos);
 int _wbxml_decoder_jump_to_string(wbxml_decoder_t* wbxml_decoder, const euint8_t* input, size_t input_size, size_t* input_pos);
 
+/* state decoders (in wbxml_state_t order) */
+static const wbxml_state_decode_t _wbxml_state_decoders[wbxml_state_count] = {
+    (wbxml_state_decode_t)_wbxml_decoder_version,            /* wbxml_state_version */
+    (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte,  /* wbxml_state_public_id */
+    (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte,  /* wbxml_state_charset */
+    (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte,  /* wbxml_state_stringtable_length */
+    (wbxml_state_decode_t)_wbxml_decoder_stringtable,        /* wbxml_state_stringtable */
+    (wbxml_state_decode_t)_wbxml_decoder_body,               /* wbxml_state_body */
+    (wbxml_state_decode_t)_wbxml_decoder_codepage,           /* wbxml_state_codepage */
+    (wbxml_state_decode_t)_wbxml_decoder_tag_no_content,     /* wbxml_state_tag_no_content */
+    (wbxml_state_decode_t)_wbxml_decoder_attributes,         /* wbxml_state_attributes */
+    (wbxml_state_decode_t)_wbxml_decoder_attribute,          /* wbxml_state_attribute */
+    (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte,  /* wbxml_state_opaque_data_length */
+    (wbxml_state_decode_t)_wbxml_decoder_opaque_data,        /* wbxml_state_opaque_data */
+    (wbxml_state_decode_t)_wbxml_decoder_jump_to_string,     /* wbxml_state_extension_token_str */
+    (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte,  /* wbxml_state_extension_token_int */
+    (wbxml_state_decode_t)_wbxml_decoder_multibyte,          /* wbxml_state_multibyte */
+    (wbxml_state_decode_t)_wbxml_decoder_string,             /* wbxml_state_string */
+    (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte,  /* wbxml_state_string_index */
+    (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte,  /* wbxml_state_entity */
+    (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte   /* wbxml_state_literal */
+};
+
 /* state decoder helpers */
 int _wbxml_decoder_common_token(wbxml_decoder_t* wbxml_decoder, const euint8_t* input, size_t input_size, size_t* input_pos);
 int _wbxml_decoder_begin_tag(wbxml_decoder_t* wbxml_decoder, euint8_t tag_token);
@@ -46,8 +71,9 @@ int _wbxml_decoder_multibyte_decoded(wbxml_decoder_t* wbxml_decoder);
 int _wbxml_decoder_string_decoded(wbxml_decoder_t* wbxml_decoder, const euint8_t* string, size_t string_length);
 int _wbxml_decoder_entity_decoded(wbxml_decoder_t* wbxml_decoder, euint32_t entity_code);
 int _wbxml_decoder_literal_decoded(wbxml_decoder_t* wbxml_decoder);
-int _wbxml_decoder_string_from_idx(wbxml_decoder_t* wbxml_decoder, euint32_t string_index, euint8_t** string, euint32_t* string_length);
+int _wbxml_decoder_string_from_idx(wbxml_decoder_t* wbxml_decoder, euint32_t string_index, const euint8_t** string, euint32_t* string_length);
 int _wbxml_decoder_report_string_idx(wbxml_decoder_t* wbxml_decoder, euint32_t string_index);
+int _wbxml_decoder_stringtable_decoded(wbxml_decoder_t* wbxml_decoder);
 int _wbxml_decoder_syntax_error(wbxml_decoder_t* wbxml_decoder);
 
 /*----------------------------------------------------------------------*/
@@ -103,22 +129,6 @@ ELIBC_FORCE_INLINE int _wbxml_pop_tag(wbxml_decoder_t* wbxml_decoder)
     return estack_pop(&wbxml_decoder->tag_stack);
 }
 
-ELIBC_FORCE_INLINE int _wbxml_append_char(wbxml_decoder_t* wbxml_decoder, char wbxml_char)
-{
-    if(wbxml_decoder->decode_buffer->pos + 1 < ebuffer_size(wbxml_decoder->decode_buffer))
-    {
-        /* just copy to avoid extra function call */
-        (ebuffer_data(wbxml_decoder->decode_buffer))[wbxml_decoder->decode_buffer->pos] = wbxml_char;
-        wbxml_decoder->decode_buffer->pos++;
-
-        return ELIBC_SUCCESS;
-
-    } else
-    {
-        return ebuffer_append_char(wbxml_decoder->decode_buffer, wbxml_char);
-    }
-}
-
 /*----------------------------------------------------------------------*/
 
 /* decoder handle */
@@ -132,53 +142,63 @@ void    wbxml_init(wbxml_decoder_t* wbxml_decoder, wbxml_callback_t decoder_call
     /* reset all fields */
     ememset(wbxml_decoder, 0, sizeof(wbxml_decoder_t));
 
-    /* init stacks */
-    estack_init(&wbxml_decoder->state_stack, sizeof(wbxml_state_t));
-    estack_init(&wbxml_decoder->tag_stack, sizeof(euint32_t));
-
-    /* reserve default space (ignore error, if memory allocation fails we will notice this later) */
-    estack_reserve(&wbxml_decoder->state_stack, PARSER_DEFAULT_STACK_SIZE);
-    estack_reserve(&wbxml_decoder->tag_stack, PARSER_DEFAULT_STACK_SIZE);
+    /* init stacks (shallow documents don't allocate) */
+    estack_init_inline(&wbxml_decoder->state_stack, sizeof(wbxml_state_t),
+                       wbxml_decoder->state_stack_items, sizeof(wbxml_decoder->state_stack_items));
+    estack_init_inline(&wbxml_decoder->tag_stack, sizeof(euint32_t),
+                       wbxml_decoder->tag_stack_items, sizeof(wbxml_decoder->tag_stack_items));
 
     /* copy callback */
     wbxml_decoder->callback = decoder_callback;
     wbxml_decoder->callback_data = user_data;
     wbxml_decoder->callback_return = ELIBC_CONTINUE;
 
-    /* init state decoders */
-    wbxml_decoder->decoders[wbxml_state_version] = (wbxml_state_decode_t)_wbxml_decoder_version;
-    wbxml_decoder->decoders[wbxml_state_public_id] = (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte;
-    wbxml_decoder->decoders[wbxml_state_charset] = (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte;
-    wbxml_decoder->decoders[wbxml_state_stringtable_length] = (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte;
-    wbxml_decoder->decoders[wbxml_state_stringtable] = (wbxml_state_decode_t)_wbxml_decoder_stringtable;
-    wbxml_decoder->decoders[wbxml_state_body] = (wbxml_state_decode_t)_wbxml_decoder_body;
-    wbxml_decoder->decoders[wbxml_state_codepage] = (wbxml_state_decode_t)_wbxml_decoder_codepage;
-    wbxml_decoder->decoders[wbxml_state_tag_no_content] = (wbxml_state_decode_t)_wbxml_decoder_tag_no_content;
-    wbxml_decoder->decoders[wbxml_state_attributes] = (wbxml_state_decode_t)_wbxml_decoder_attributes;
-    wbxml_decoder->decoders[wbxml_state_attribute] = (wbxml_state_decode_t)_wbxml_decoder_attribute;
-    wbxml_decoder->decoders[wbxml_state_opaque_data_length] = (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte;
-    wbxml_decoder->decoders[wbxml_state_opaque_data] = (wbxml_state_decode_t)_wbxml_decoder_opaque_data;
-    wbxml_decoder->decoders[wbxml_state_extension_token_int] = (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte;
-    wbxml_decoder->decoders[wbxml_state_extension_token_str] = (wbxml_state_decode_t)_wbxml_decoder_jump_to_string;
-
-    wbxml_decoder->decoders[wbxml_state_multibyte] = (wbxml_state_decode_t)_wbxml_decoder_multibyte;
-    wbxml_decoder->decoders[wbxml_state_string] = (wbxml_state_decode_t)_wbxml_decoder_string;
-    wbxml_decoder->decoders[wbxml_state_string_index] = (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte;
-    wbxml_decoder->decoders[wbxml_state_entity] = (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte;
-    wbxml_decoder->decoders[wbxml_state_literal] = (wbxml_state_decode_t)_wbxml_decoder_jump_to_multibyte;
-
 #ifdef _ELIBC_DEBUG
     /* check that all decoders were set */
     {
         int i;
         for(i = 0; i < wbxml_state_count; ++i)
         {
-            EASSERT1(wbxml_decoder->decoders[i], "wbxml_decoder: state decoder was not set");
+            EASSERT1(_wbxml_state_decoders[i], "wbxml_decoder: state decoder was not set");
         }
     }
 #endif /* _ELIBC_DEBUG */
 }
 
+void    wbxml_reset(wbxml_decoder_t* wbxml_decoder, wbxml_callback_t decoder_callback, void* user_data)
+{
+    estack_t state_stack, tag_stack;
+    euint8_t* string_table;
+    euint32_t table_alloc_size;
+
+    EASSERT(wbxml_decoder);
+    EASSERT(decoder_callback);
+
+    if(wbxml_decoder == 0 || decoder_callback == 0) return;
+
+    /* keep stacks and string table memory (decoder stays in place, so inline stacks remain valid) */
+    state_stack = wbxml_decoder->state_stack;
+    tag_stack = wbxml_decoder->tag_stack;
+    string_table = wbxml_decoder->string_table;
+    table_alloc_size = wbxml_decoder->table_alloc_size;
+
+    /* reset all fields */
+    ememset(wbxml_decoder, 0, sizeof(wbxml_decoder_t));
+
+    wbxml_decoder->state_stack = state_stack;
+    wbxml_decoder->tag_stack = tag_stack;
+    wbxml_decoder->string_table = string_table;
+    wbxml_decoder->table_alloc_size = table_alloc_size;
+
+    estack_reset(&wbxml_decoder->state_stack);
+    estack_reset(&wbxml_decoder->tag_stack);
+
+    /* copy callback */
+    wbxml_decoder->callback = decoder_callback;
+    wbxml_decoder->callback_data = user_data;
+    wbxml_decoder->callback_return = ELIBC_CONTINUE;
+}
+
 void    wbxml_close(wbxml_decoder_t* wbxml_decoder)
 {
     /* free buffers */
@@ -190,6 +210,24 @@ void    wbxml_close(wbxml_decoder_t* wbxml_decoder)
     }
 }
 
+/* decoder options */
+int     wbxml_set_zero_copy(wbxml_decoder_t* wbxml_decoder, int zero_copy)
+{
+    EASSERT(wbxml_decoder);
+    if(wbxml_decoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* option is kept between documents */
+    if(zero_copy)
+    {
+        wbxml_decoder->flags |= WBXML_FLAG_ZERO_COPY;
+    } else
+    {
+        wbxml_decoder->flags &= ~((unsigned short)WBXML_FLAG_ZERO_COPY);
+    }
+
+    return ELIBC_SUCCESS;
+}
+
 /* decode binary stream */
 int     wbxml_begin(wbxml_decoder_t* wbxml_decoder, ebuffer_t* decode_buffer)
 {
@@ -204,7 +242,10 @@ int     wbxml_begin(wbxml_decoder_t* wbxml_decoder, ebuffer_t* decode_buffer)
     estack_reset(&wbxml_decoder->state_stack);
     estack_reset(&wbxml_decoder->tag_stack);
     ebuffer_reset(wbxml_decoder->decode_buffer);
+    wbxml_decoder->table_data = 0;
     wbxml_decoder->table_size = 0;
+    wbxml_decoder->wbxml_tag = 0;
+    wbxml_decoder->callback_return = ELIBC_CONTINUE;
     wbxml_decoder->flags &= WBXML_FLAG_MASK_RESET;
 
     /* beginning state */
@@ -233,7 +274,7 @@ int     wbxml_decode(wbxml_decoder_t* wbxml_decoder, const euint8_t* input, size
     {
         /* process input based on state */
         EASSERT((int)wbxml_decoder->wbxml_state < wbxml_state_count);
-        err = wbxml_decoder->decoders[wbxml_decoder->wbxml_state](wbxml_decoder, input, input_size, &input_pos);
+        err = _wbxml_state_decoders[wbxml_decoder->wbxml_state](wbxml_decoder, input, input_size, &input_pos);
 
         /* stop if error */
         if(wbxml_decoder->flags & WBXML_FLAG_ERROR)
@@ -279,31 +320,67 @@ int _wbxml_decoder_version(wbxml_decoder_t* wbxml_decoder, const euint8_t* input
     wbxml_decoder->callback_return = wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_document_version, 0, input[*input_pos]);
 
     /* move to next state */
-    wbxml_decoder->wbxml_state = wbxml_document_public_id;
+    wbxml_decoder->wbxml_state = wbxml_state_public_id;
 
     return ELIBC_SUCCESS;
 }
 
 int _wbxml_decoder_stringtable(wbxml_decoder_t* wbxml_decoder, const euint8_t* input, size_t input_size, size_t* input_pos)
 {
-    /* copy string table */
-    while(wbxml_decoder->read_pos < wbxml_decoder->table_size && *input_pos < input_size)
+    size_t copy_size;
+
+    /* check if table starts in this input */
+    if(wbxml_decoder->read_pos == 0)
     {
-        /* update string count if end of string found */
-        if(input[*input_pos] == wbxml_decoder->string_term)
+        void* tmp;
+
+        /* reference whole table in input if allowed */
+        if((wbxml_decoder->flags & WBXML_FLAG_ZERO_COPY) && wbxml_decoder->table_size <= input_size - *input_pos)
         {
-            wbxml_decoder->string_count++;
+            wbxml_decoder->table_data = input + *input_pos;
+            wbxml_decoder->read_pos = wbxml_decoder->table_size;
+
+            /* stay on the last byte used */
+            *input_pos += wbxml_decoder->table_size - 1;
+
+            return _wbxml_decoder_stringtable_decoded(wbxml_decoder);
         }
 
-        wbxml_decoder->string_table[wbxml_decoder->read_pos] = input[*input_pos];
-        wbxml_decoder->read_pos++;
-        ++(*input_pos);
+        /* reserve memory for table copy (memory is kept between documents) */
+        if(wbxml_decoder->table_alloc_size < wbxml_decoder->table_size)
+        {
+            if(wbxml_decoder->string_table)
+            {
+                tmp = erealloc(wbxml_decoder->string_table, wbxml_decoder->table_size);
+
+            } else
+            {
+                tmp = emalloc(wbxml_decoder->table_size);
+            }
+
+            /* check result and copy memory reference */
+            if(tmp == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+            wbxml_decoder->string_table = (euint8_t*)tmp;
+            wbxml_decoder->table_alloc_size = wbxml_decoder->table_size;
+        }
+
+        wbxml_decoder->table_data = wbxml_decoder->string_table;
     }
 
+    /* copy available part of string table */
+    copy_size = wbxml_decoder->table_size - wbxml_decoder->read_pos;
+    if(copy_size > input_size - *input_pos) copy_size = input_size - *input_pos;
+
+    ememcpy(wbxml_decoder->string_table + wbxml_decoder->read_pos, input + *input_pos, copy_size);
+    wbxml_decoder->read_pos += (euint32_t)copy_size;
+
+    /* stay on the last byte used */
+    *input_pos += copy_size - 1;
+
     /* move to next state if whole data read */
     if(wbxml_decoder->read_pos == wbxml_decoder->table_size)
     {
-        wbxml_decoder->wbxml_state = wbxml_state_body;
+        return _wbxml_decoder_stringtable_decoded(wbxml_decoder);
     }
 
     return ELIBC_SUCCESS;
@@ -358,7 +435,7 @@ int _wbxml_decoder_common_token(wbxml_decoder_t* wbxml_decoder, const euint8_t*
 
     case WBXML_TOKEN_OPAQUE:
         /* opaque data reading */
-        return _wbxml_push_state(wbxml_decoder, wbxml_state_opaque_data);
+        return _wbxml_push_state(wbxml_decoder, wbxml_state_opaque_data_length);
         break;
 
     /*** extension tokens ***/
@@ -384,37 +461,37 @@ int _wbxml_decoder_common_token(wbxml_decoder_t* wbxml_decoder, const euint8_t*
     case WBXML_TOKEN_EXT_I_0:
         /* extension token reading */
         wbxml_decoder->ext_token = 0;
-        return _wbxml_push_state(wbxml_decoder, wbxml_state_extension_token_int);
+        return _wbxml_push_state(wbxml_decoder, wbxml_state_extension_token_str);
         break;
 
     case WBXML_TOKEN_EXT_I_1:
         /* extension token reading */
         wbxml_decoder->ext_token = 1;
-        return _wbxml_push_state(wbxml_decoder, wbxml_state_extension_token_int);
+        return _wbxml_push_state(wbxml_decoder, wbxml_state_extension_token_str);
         break;
 
     case WBXML_TOKEN_EXT_I_2:
         /* extension token reading */
         wbxml_decoder->ext_token = 2;
-        return _wbxml_push_state(wbxml_decoder, wbxml_state_extension_token_int);
+        return _wbxml_push_state(wbxml_decoder, wbxml_state_extension_token_str);
         break;
 
     case WBXML_TOKEN_EXT_T_0:
         /* extension token reading */
         wbxml_decoder->ext_token = 0;
-        return _wbxml_push_state(wbxml_decoder, wbxml_state_extension_token_str);
+        return _wbxml_push_state(wbxml_decoder, wbxml_state_extension_token_int);
         break;
 
     case WBXML_TOKEN_EXT_T_1:
         /* extension token reading */
-        wbxml_decoder->ext_token = 0;
-        return _wbxml_push_state(wbxml_decoder, wbxml_state_extension_token_str);
+        wbxml_decoder->ext_token = 1;
+        return _wbxml_push_state(wbxml_decoder, wbxml_state_extension_token_int);
         break;
 
     case WBXML_TOKEN_EXT_T_2:
         /* extension token reading */
-        wbxml_decoder->ext_token = 0;
-        return _wbxml_push_state(wbxml_decoder, wbxml_state_extension_token_str);
+        wbxml_decoder->ext_token = 2;
+        return _wbxml_push_state(wbxml_decoder, wbxml_state_extension_token_int);
         break;
 
 
@@ -436,28 +513,29 @@ int _wbxml_decoder_begin_tag(wbxml_decoder_t* wbxml_decoder, euint8_t tag_token)
     /* get tag identity from token */
     tag_id = (tag_token & WBXML_TAG_MASK);
 
-    /* push to stack */
-    err = _wbxml_push_tag(wbxml_decoder, tag_id);
-    if(err != ELIBC_SUCCESS) return err;
-
     /* check if tag is literal (should be already encoded) */
     if(tag_id != WBXML_TOKEN_LITERAL)
     {
+        /* push to stack */
+        err = _wbxml_push_tag(wbxml_decoder, tag_id);
+        if(err != ELIBC_SUCCESS) return err;
+
         /* report tag start */
         wbxml_decoder->callback_return =
                 wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_tag_begin, 0, tag_id);
     } else
     {
-        euint8_t* string;
+        const euint8_t* string;
         euint32_t string_length;
 
-        /* mark current tag id as literal */
-        wbxml_decoder->wbxml_tag |= WBXML_TOKEN_IS_LITERAL;
-
         /* find literal from index */
         err = _wbxml_decoder_string_from_idx(wbxml_decoder, wbxml_decoder->literal_index, &string, &string_length);
         if(err != ELIBC_SUCCESS) return err;
 
+        /* push literal index marked as literal (needed to report tag end) */
+        err = _wbxml_push_tag(wbxml_decoder, wbxml_decoder->literal_index | WBXML_TOKEN_IS_LITERAL);
+        if(err != ELIBC_SUCCESS) return err;
+
         /* report literal */
         wbxml_decoder->callback_return =
                 wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_tag_begin_string, string, string_length);
@@ -493,15 +571,22 @@ int _wbxml_decoder_begin_tag(wbxml_decoder_t* wbxml_decoder, euint8_t tag_token)
 
 int _wbxml_decoder_end_tag(wbxml_decoder_t* wbxml_decoder)
 {
+    /* there must be open tag */
+    if(estack_size(&wbxml_decoder->tag_stack) == 0)
+    {
+        ETRACE("wbxml_decoder: unexpected end token");
+        return _wbxml_decoder_syntax_error(wbxml_decoder);
+    }
+
     /* check if current tag is literal */
     if(wbxml_decoder->wbxml_tag & WBXML_TOKEN_IS_LITERAL)
     {
-        euint8_t* string;
+        const euint8_t* string;
         euint32_t string_length;
         int err;
 
         /* find literal from index */
-        err = _wbxml_decoder_string_from_idx(wbxml_decoder, wbxml_decoder->literal_index, &string, &string_length);
+        err = _wbxml_decoder_string_from_idx(wbxml_decoder, wbxml_decoder->wbxml_tag & ~WBXML_TOKEN_IS_LITERAL, &string, &string_length);
         if(err != ELIBC_SUCCESS) return err;
 
         /* report literal */
@@ -583,13 +668,79 @@ int _wbxml_decoder_tag_no_content(wbxml_decoder_t* wbxml_decoder, const euint8_t
 
 int _wbxml_decoder_begin_attribute(wbxml_decoder_t* wbxml_decoder, euint8_t attribute_token)
 {
-    // TODO:
+    int err;
+
+    /* attribute start finishes previous attribute */
+    if(wbxml_decoder->wbxml_state == wbxml_state_attribute)
+    {
+        err = _wbxml_decoder_end_attribute(wbxml_decoder);
+        if(err != ELIBC_SUCCESS) return err;
+
+    } else
+    {
+        /* values are read in attribute state */
+        err = _wbxml_push_state(wbxml_decoder, wbxml_state_attribute);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    /* check if attribute is literal (LITERAL_C and other global tokens can't start attribute) */
+    if(attribute_token != WBXML_TOKEN_LITERAL)
+    {
+        if(!wbxml_is_attribute_start(attribute_token))
+        {
+            ETRACE("wbxml_decoder: global token used as attribute start");
+            return _wbxml_decoder_syntax_error(wbxml_decoder);
+        }
+
+        wbxml_decoder->wbxml_attribute = attribute_token;
+
+        /* report attribute start */
+        wbxml_decoder->callback_return =
+                wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_attribute_begin, 0, attribute_token);
+    } else
+    {
+        const euint8_t* string;
+        euint32_t string_length;
+
+        /* find literal from index */
+        err = _wbxml_decoder_string_from_idx(wbxml_decoder, wbxml_decoder->literal_index, &string, &string_length);
+        if(err != ELIBC_SUCCESS) return err;
+
+        /* keep literal index to report attribute end */
+        wbxml_decoder->wbxml_attribute = wbxml_decoder->literal_index | WBXML_TOKEN_IS_LITERAL;
+
+        /* report literal */
+        wbxml_decoder->callback_return =
+                wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_attribute_begin_string, string, string_length);
+    }
+
     return ELIBC_SUCCESS;
 }
 
 int _wbxml_decoder_end_attribute(wbxml_decoder_t* wbxml_decoder)
 {
-    // TODO:
+    /* check if current attribute is literal */
+    if(wbxml_decoder->wbxml_attribute & WBXML_TOKEN_IS_LITERAL)
+    {
+        const euint8_t* string;
+        euint32_t string_length;
+        int err;
+
+        /* find literal from index */
+        err = _wbxml_decoder_string_from_idx(wbxml_decoder, wbxml_decoder->wbxml_attribute & ~WBXML_TOKEN_IS_LITERAL, &string, &string_length);
+        if(err != ELIBC_SUCCESS) return err;
+
+        /* report literal */
+        wbxml_decoder->callback_return =
+                wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_attribute_end_string, string, string_length);
+
+    } else
+    {
+        /* just report attribute id */
+        wbxml_decoder->callback_return =
+                wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_attribute_end, 0, wbxml_decoder->wbxml_attribute);
+    }
+
     return ELIBC_SUCCESS;
 }
 
@@ -634,6 +785,13 @@ int _wbxml_decoder_attributes(wbxml_decoder_t* wbxml_decoder, const euint8_t* in
         break;
 
     default:
+        /* attribute value can't start attribute list */
+        if(input[*input_pos] & WBXML_ATTRIBUTE_VALUE)
+        {
+            ETRACE("wbxml_decoder: attribute value without attribute start");
+            return _wbxml_decoder_syntax_error(wbxml_decoder);
+        }
+
         /* begin attribute */
         return _wbxml_decoder_begin_attribute(wbxml_decoder, input[*input_pos]);
         break;
@@ -644,6 +802,8 @@ int _wbxml_decoder_attributes(wbxml_decoder_t* wbxml_decoder, const euint8_t* in
 
 int _wbxml_decoder_attribute(wbxml_decoder_t* wbxml_decoder, const euint8_t* input, size_t input_size, size_t* input_pos)
 {
+    int err;
+
     /* process input */
     switch(input[*input_pos])
     {
@@ -671,11 +831,28 @@ int _wbxml_decoder_attribute(wbxml_decoder_t* wbxml_decoder, const euint8_t* inp
         break;
 
     case WBXML_TOKEN_END:
-        // TODO: fail with syntax error
+        /* end of attribute list also ends attribute */
+        err = _wbxml_decoder_end_attribute(wbxml_decoder);
+        if(err != ELIBC_SUCCESS) return err;
+
+        /* back to attribute list */
+        _wbxml_pop_state(wbxml_decoder);
+
+        return _wbxml_decoder_attributes(wbxml_decoder, input, input_size, input_pos);
         break;
 
     default:
-        // TODO: fail with syntax error ?
+        /* attribute value tokens have high bit set (attribute start tokens don't) */
+        if(input[*input_pos] & WBXML_ATTRIBUTE_VALUE)
+        {
+            /* report value token */
+            wbxml_decoder->callback_return =
+                    wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_attribute_value_token, 0, input[*input_pos]);
+        } else
+        {
+            /* begin next attribute */
+            return _wbxml_decoder_begin_attribute(wbxml_decoder, input[*input_pos]);
+        }
         break;
     }
 
@@ -684,15 +861,44 @@ int _wbxml_decoder_attribute(wbxml_decoder_t* wbxml_decoder, const euint8_t* inp
 
 int _wbxml_decoder_opaque_data(wbxml_decoder_t* wbxml_decoder, const euint8_t* input, size_t input_size, size_t* input_pos)
 {
-    /* copy opaque data */
-    while(wbxml_decoder->read_pos < wbxml_decoder->opaque_size && *input_pos < input_size)
+    size_t copy_size;
+
+    /* check if data starts in this input */
+    if(wbxml_decoder->read_pos == 0)
     {
-        /* copy data */
-        wbxml_decoder->opaque_data[wbxml_decoder->read_pos] = input[*input_pos];
-        wbxml_decoder->read_pos++;
-        ++(*input_pos);
+        /* report data directly from input if it is not split */
+        if(wbxml_decoder->opaque_size <= input_size - *input_pos)
+        {
+            wbxml_decoder->callback_return =
+                    wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_decoder_opaque_data, input + *input_pos, wbxml_decoder->opaque_size);
+
+            /* stay on the last byte used */
+            *input_pos += wbxml_decoder->opaque_size - 1;
+
+            /* pop state */
+            return _wbxml_pop_state(wbxml_decoder);
+        }
+
+        /* reserve memory for data copy */
+        ebuffer_reset(wbxml_decoder->decode_buffer);
+        if(ebuffer_reserve(wbxml_decoder->decode_buffer, wbxml_decoder->opaque_size) != ELIBC_SUCCESS)
+        {
+            return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+        }
+
+        wbxml_decoder->opaque_data = (euint8_t*)ebuffer_data(wbxml_decoder->decode_buffer);
     }
 
+    /* copy available part of opaque data */
+    copy_size = wbxml_decoder->opaque_size - wbxml_decoder->read_pos;
+    if(copy_size > input_size - *input_pos) copy_size = input_size - *input_pos;
+
+    ememcpy(wbxml_decoder->opaque_data + wbxml_decoder->read_pos, input + *input_pos, copy_size);
+    wbxml_decoder->read_pos += (euint32_t)copy_size;
+
+    /* stay on the last byte used */
+    *input_pos += copy_size - 1;
+
     /* pop state if whole data read */
     if(wbxml_decoder->read_pos == wbxml_decoder->opaque_size)
     {
@@ -711,12 +917,23 @@ int _wbxml_decoder_codepage(wbxml_decoder_t* wbxml_decoder, const euint8_t* inpu
 {
     EUNUSED(input_size);
 
-    /* report codepage switch */
-    wbxml_decoder->callback_return =
-            wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_document_codepage, 0, input[*input_pos]);
-
     /* pop state */
-    return _wbxml_pop_state(wbxml_decoder);
+    _wbxml_pop_state(wbxml_decoder);
+
+    /* tags and attributes have separate code pages */
+    if(wbxml_decoder->wbxml_state == wbxml_state_attributes || wbxml_decoder->wbxml_state == wbxml_state_attribute)
+    {
+        /* report attribute codepage switch */
+        wbxml_decoder->callback_return =
+                wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_document_attribute_codepage, 0, input[*input_pos]);
+    } else
+    {
+        /* report codepage switch */
+        wbxml_decoder->callback_return =
+                wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_document_codepage, 0, input[*input_pos]);
+    }
+
+    return ELIBC_SUCCESS;
 }
 
 int _wbxml_decoder_multibyte(wbxml_decoder_t* wbxml_decoder, const euint8_t* input, size_t input_size, size_t* input_pos)
@@ -753,30 +970,38 @@ int _wbxml_decoder_multibyte(wbxml_decoder_t* wbxml_decoder, const euint8_t* inp
 
 int _wbxml_decoder_string(wbxml_decoder_t* wbxml_decoder, const euint8_t* input, size_t input_size, size_t* input_pos)
 {
+    const euint8_t* string_end;
+    size_t string_start;
     int err;
 
-    /* read string */
-    while(*input_pos < input_size && input[*input_pos] != wbxml_decoder->string_term)
+    /* find string end */
+    string_start = *input_pos;
+    string_end = (const euint8_t*)ememchr(input + string_start, wbxml_decoder->string_term, input_size - string_start);
+    if(string_end == 0)
     {
-        /* copy data */
-        err = _wbxml_append_char(wbxml_decoder, input[*input_pos]);
-        if(err != ELIBC_SUCCESS) return err;
-
-        /* next */
-        ++(*input_pos);
+        /* copy available part and stay on the last byte */
+        *input_pos = input_size - 1;
+        return ebuffer_append(wbxml_decoder->decode_buffer, input + string_start, input_size - string_start);
     }
 
-    /* report string if string term found */
-    if(input[*input_pos] == wbxml_decoder->string_term)
-    {
-        /* pop state */
-        _wbxml_pop_state(wbxml_decoder);
+    /* stay on string term */
+    *input_pos = (size_t)(string_end - input);
 
-        /* repoort string */
-        return _wbxml_decoder_string_decoded(wbxml_decoder, (euint8_t*)ebuffer_data(wbxml_decoder->decode_buffer), ebuffer_pos(wbxml_decoder->decode_buffer));
+    /* pop state */
+    _wbxml_pop_state(wbxml_decoder);
+
+    /* report string directly from input if it was not split */
+    if(ebuffer_pos(wbxml_decoder->decode_buffer) == 0)
+    {
+        return _wbxml_decoder_string_decoded(wbxml_decoder, input + string_start, *input_pos - string_start);
     }
 
-    return ELIBC_SUCCESS;
+    /* append last part */
+    err = ebuffer_append(wbxml_decoder->decode_buffer, input + string_start, *input_pos - string_start);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* report string */
+    return _wbxml_decoder_string_decoded(wbxml_decoder, (euint8_t*)ebuffer_data(wbxml_decoder->decode_buffer), ebuffer_pos(wbxml_decoder->decode_buffer));
 }
 
 int _wbxml_decoder_jump_to_multibyte(wbxml_decoder_t* wbxml_decoder, const euint8_t* input, size_t input_size, size_t* input_pos)
@@ -851,33 +1076,14 @@ int _wbxml_decoder_multibyte_decoded(wbxml_decoder_t* wbxml_decoder)
         /* check if there is string table in the document */
         if(wbxml_decoder->table_size)
         {
-            /* reserve memory for table */
-            void* tmp = 0;
-            if(wbxml_decoder->string_table)
-            {
-                tmp = erealloc(wbxml_decoder->string_table, wbxml_decoder->table_size);
-
-            } else
-            {
-                tmp = emalloc(wbxml_decoder->table_size);
-            }
-
-            /* check result and copy memory reference */
-            if(tmp == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
-            wbxml_decoder->string_table = tmp;
-
-            /* reset table read position */
-            wbxml_decoder->read_pos = 0;
-            wbxml_decoder->string_count = 0;
-
-            /* move to table read */
+            /* move to table read (memory is reserved only if table must be copied) */
             wbxml_decoder->read_pos = 0;
             wbxml_decoder->wbxml_state = wbxml_state_stringtable;
 
         } else
         {
             /* move to next state if string table is empty */
-            wbxml_decoder->wbxml_state = wbxml_state_body;
+            return _wbxml_decoder_stringtable_decoded(wbxml_decoder);
         }
         break;
 
@@ -893,6 +1099,17 @@ int _wbxml_decoder_multibyte_decoded(wbxml_decoder_t* wbxml_decoder)
         /* pop state */
         _wbxml_pop_state(wbxml_decoder);
 
+        /* public id literal can be reported only after string table is read */
+        if(wbxml_decoder->wbxml_state == wbxml_state_public_id)
+        {
+            wbxml_decoder->literal_index = wbxml_decoder->mb_uint_value;
+            wbxml_decoder->flags |= WBXML_FLAG_PUBLIC_ID_LITERAL;
+
+            /* start reading charset */
+            wbxml_decoder->wbxml_state = wbxml_state_charset;
+            break;
+        }
+
         /* report string from table */
         return _wbxml_decoder_report_string_idx(wbxml_decoder, wbxml_decoder->mb_uint_value);
         break;
@@ -909,18 +1126,20 @@ int _wbxml_decoder_multibyte_decoded(wbxml_decoder_t* wbxml_decoder)
         break;
 
     case wbxml_state_opaque_data_length:
-        /* reset data buffer */
-        ebuffer_reset(wbxml_decoder->decode_buffer);
+        /* data is copied to decode buffer only if it is split */
+        wbxml_decoder->opaque_data = 0;
+        wbxml_decoder->opaque_size = wbxml_decoder->mb_uint_value;
 
-        /* reserve memory */
-        if(ebuffer_reserve(wbxml_decoder->decode_buffer, wbxml_decoder->mb_uint_value) != ELIBC_SUCCESS)
+        /* report empty data at once */
+        if(wbxml_decoder->opaque_size == 0)
         {
-            return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
-        }
+            wbxml_decoder->callback_return =
+                    wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_decoder_opaque_data, 0, 0);
 
-        /* init opaque buffer to read */
-        wbxml_decoder->opaque_data = (euint8_t*)ebuffer_data(wbxml_decoder->decode_buffer);
-        wbxml_decoder->opaque_size = wbxml_decoder->mb_uint_value;
+            /* pop state */
+            _wbxml_pop_state(wbxml_decoder);
+            break;
+        }
 
         /* move to data read */
         wbxml_decoder->read_pos = 0;
@@ -1024,6 +1243,12 @@ int _wbxml_decoder_entity_decoded(wbxml_decoder_t* wbxml_decoder, euint32_t enti
                 wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_tag_content_entity, 0, entity_code);
         break;
 
+    case wbxml_state_attribute:
+        /* report entity as part of attribute value */
+        wbxml_decoder->callback_return =
+                wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_attribute_value_entity, 0, entity_code);
+        break;
+
     default:
         ETRACE("wbxml_decoder: unexpected state after parsing entity");
         EASSERT(0);
@@ -1045,6 +1270,7 @@ int _wbxml_decoder_literal_decoded(wbxml_decoder_t* wbxml_decoder)
         break;
 
     case wbxml_state_attributes:
+    case wbxml_state_attribute:
         /* process attribute */
         return _wbxml_decoder_begin_attribute(wbxml_decoder, wbxml_decoder->literal_token);
         break;
@@ -1059,64 +1285,36 @@ int _wbxml_decoder_literal_decoded(wbxml_decoder_t* wbxml_decoder)
     return ELIBC_SUCCESS;
 }
 
-int _wbxml_decoder_string_from_idx(wbxml_decoder_t* wbxml_decoder, euint32_t string_index, euint8_t** string, euint32_t* string_length)
+int _wbxml_decoder_string_from_idx(wbxml_decoder_t* wbxml_decoder, euint32_t string_index, const euint8_t** string, euint32_t* string_length)
 {
-    euint8_t* string_pos;
-    euint32_t string_count;
+    const euint8_t* string_end;
 
-    /* check if string index is out of range */
-    if(string_index >= wbxml_decoder->string_count)
+    /* index is byte offset from the beginning of the string table */
+    if(string_index >= wbxml_decoder->table_size)
     {
         ETRACE("wbxml_decoder: string table index is out of range");
-        return _wbxml_decoder_syntax_error(wbxml_decoder);
-    }
-
-    /* find string start */
-    string_pos = wbxml_decoder->string_table;
-    string_count = 0;
-    while(string_count < string_index && string_pos < wbxml_decoder->string_table + wbxml_decoder->table_size)
-    {
-        ++string_pos;
-        if(*string_pos == wbxml_decoder->string_term)
-        {
-            ++string_count;
-            ++string_pos;
-        }
-    }
-
-    /* check if found just in case */
-    if(string_pos >= wbxml_decoder->string_table + wbxml_decoder->table_size)
-    {
-        ETRACE("wbxml_decoder: string table seems to be corrupted");
-        EASSERT(0);
-        return ELIBC_ERROR_INTERNAL;
+        _wbxml_decoder_syntax_error(wbxml_decoder);
+        return ELIBC_ERROR_PARSER_INVALID_INPUT;
     }
 
-    /* copy return string */
-    *string = string_pos;
-
-    /* find string length */
-    *string_length = 0;
-    while(string_pos[*string_length] != wbxml_decoder->string_term &&
-          string_pos + *string_length < wbxml_decoder->string_table + wbxml_decoder->table_size)
+    /* find string end */
+    string_end = (const euint8_t*)ememchr(wbxml_decoder->table_data + string_index, wbxml_decoder->string_term, wbxml_decoder->table_size - string_index);
+    if(string_end == 0)
     {
-        ++(*string_length);
+        ETRACE("wbxml_decoder: string in string table is not terminated");
+        _wbxml_decoder_syntax_error(wbxml_decoder);
+        return ELIBC_ERROR_PARSER_INVALID_INPUT;
     }
 
-    /* check if found just in case */
-    if(string_pos + *string_length >= wbxml_decoder->string_table + wbxml_decoder->table_size)
-    {
-        ETRACE("wbxml_decoder: string table seems to be corrupted");
-        EASSERT(0);
-        return ELIBC_ERROR_INTERNAL;
-    }
+    *string = wbxml_decoder->table_data + string_index;
+    *string_length = (euint32_t)(string_end - *string);
 
     return ELIBC_SUCCESS;
 }
 
 int _wbxml_decoder_report_string_idx(wbxml_decoder_t* wbxml_decoder, euint32_t string_index)
 {
-    euint8_t* string;
+    const euint8_t* string;
     euint32_t string_length;
     int err;
 
@@ -1128,6 +1326,32 @@ int _wbxml_decoder_report_string_idx(wbxml_decoder_t* wbxml_decoder, euint32_t s
     return _wbxml_decoder_string_decoded(wbxml_decoder, string, string_length);
 }
 
+int _wbxml_decoder_stringtable_decoded(wbxml_decoder_t* wbxml_decoder)
+{
+    /* move to document body */
+    wbxml_decoder->wbxml_state = wbxml_state_body;
+
+    /* report public id if it is encoded as literal */
+    if(wbxml_decoder->flags & WBXML_FLAG_PUBLIC_ID_LITERAL)
+    {
+        const euint8_t* string;
+        euint32_t string_length;
+        int err;
+
+        wbxml_decoder->flags &= ~WBXML_FLAG_PUBLIC_ID_LITERAL;
+
+        /* find public id from index */
+        err = _wbxml_decoder_string_from_idx(wbxml_decoder, wbxml_decoder->literal_index, &string, &string_length);
+        if(err != ELIBC_SUCCESS) return err;
+
+        /* report public id as string */
+        wbxml_decoder->callback_return =
+                wbxml_decoder->callback(wbxml_decoder->callback_data, wbxml_document_public_id_string, string, string_length);
+    }
+
+    return ELIBC_SUCCESS;
+}
+
 int _wbxml_decoder_syntax_error(wbxml_decoder_t* wbxml_decoder)
 {
     /* mark error */
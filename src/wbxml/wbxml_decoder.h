@@ -15,6 +15,7 @@ typedef enum {
     wbxml_document_public_id,
     wbxml_document_charset,             /* refer: http://www.iana.org/assignments/character-sets/character-sets.xhtml */
     wbxml_document_codepage,
+    wbxml_document_attribute_codepage,
 
     /* properties reported as string parameter */
     wbxml_document_public_id_string,
@@ -30,6 +31,7 @@ typedef enum {
     wbxml_attribute_begin_string,       /* attribute name as string parameter */
     wbxml_attribute_value_string,       /* string as data and length as integer parameter */
     wbxml_attribute_value_token,        /* value token id as integer parameter */
+    wbxml_attribute_value_entity,       /* entity code as integer parameter */
     wbxml_attribute_end,                /* attribute id as integer parameter */
     wbxml_attribute_end_string,         /* attribute name as string parameter */
 
@@ -103,25 +105,25 @@ typedef int (*wbxml_state_decode_t)(void*, const euint8_t*, size_t, size_t*);
 /* decoder */
 typedef struct {
 
-    /* state decoders */
-    wbxml_state_decode_t    decoders[wbxml_state_count];
-
     /* state stack */
     estack_t                state_stack;
     wbxml_state_t           wbxml_state;
+    wbxml_state_t           state_stack_items[PARSER_DEFAULT_STACK_SIZE];
 
     /* tag stack */
     estack_t                tag_stack;
+    euint32_t               tag_stack_items[PARSER_DEFAULT_STACK_SIZE];
     euint32_t               wbxml_tag;
-    euint8_t                wbxml_attribute;
+    euint32_t               wbxml_attribute;
 
     /* string termination symbol */
     euint8_t                string_term;
 
-    /* decoded string table */
+    /* decoded string table (table_data points either to string_table copy or to input) */
+    const euint8_t*         table_data;
     euint8_t*               string_table;
-    euint32_t               string_count;
     euint32_t               table_size;
+    euint32_t               table_alloc_size;
 
     /* decoded multi byte integer value */
     euint32_t               mb_uint_value;
@@ -161,6 +163,20 @@ typedef struct {
 void    wbxml_init(wbxml_decoder_t* wbxml_decoder, wbxml_callback_t decoder_callback, void* user_data);
 void    wbxml_close(wbxml_decoder_t* wbxml_decoder);
 
+/* reset decoder to the state after init, keeps reserved memory (cheap way to reuse decoder) */
+void    wbxml_reset(wbxml_decoder_t* wbxml_decoder, wbxml_callback_t decoder_callback, void* user_data);
+
+/*
+    NOTE: - inline strings and opaque data are reported directly from input when they
+            are not split between wbxml_decode calls, otherwise decode_buffer is used
+          - in zero copy mode string table is referenced in input instead of being copied
+            (unless it is split between wbxml_decode calls), so table strings and literals
+            point to input as well and all input must stay valid until wbxml_end
+*/
+
+/* decoder options (must be set before wbxml_begin) */
+int     wbxml_set_zero_copy(wbxml_decoder_t* wbxml_decoder, int zero_copy);
+
 /* decode binary stream */
 int     wbxml_begin(wbxml_decoder_t* wbxml_decoder, ebuffer_t* decode_buffer);
 int     wbxml_decode(wbxml_decoder_t* wbxml_decoder, const euint8_t* input, size_t input_size);
@@ -0,0 +1,815 @@
+/*
+    WBXML encoder
+    Refer to WBXML documentation: http://www.w3.org/1999/06/NOTE-wbxml-19990624/
+*/
+
+#include "../elib_config.h"
+
+#include "../hash/hash_fnv.h"
+
+#include "wbxml_types.h"
+#include "wbxml_encoder.h"
+
+/*----------------------------------------------------------------------*/
+/* flags */
+#define WBXML_ENCODER_FLAG_STARTED          0x0001      /* between begin and end */
+#define WBXML_ENCODER_FLAG_TAG_OPEN         0x0002      /* last tag token may still get attributes or content */
+#define WBXML_ENCODER_FLAG_ATTRIBUTES       0x0004      /* attribute list of last tag is open */
+#define WBXML_ENCODER_FLAG_ATTRIBUTE        0x0008      /* attribute started and may get values */
+#define WBXML_ENCODER_FLAG_TABLE_SENT       0x0010      /* header and string table already flushed */
+
+/* tag stack item flags */
+#define WBXML_ENCODER_TAG_CONTENT           0x01
+
+/* string table index */
+#define WBXML_ENCODER_INDEX_SIZE            64
+
+/* maximum size of encoded multibyte integer */
+#define WBXML_ENCODER_MB_UINT32_SIZE        5
+
+/*----------------------------------------------------------------------*/
+/* worker methods */
+/*----------------------------------------------------------------------*/
+ELIBC_FORCE_INLINE int _wbxml_encode_byte(wbxml_encoder_t* wbxml_encoder, euint8_t value)
+{
+    return ebuffer_append_char(&wbxml_encoder->body_buffer, (char)value);
+}
+
+ELIBC_FORCE_INLINE int _wbxml_encode_token_mb_uint32(wbxml_encoder_t* wbxml_encoder, euint8_t token, euint32_t value)
+{
+    euint8_t buffer[WBXML_ENCODER_MB_UINT32_SIZE + 1];
+    size_t size;
+
+    /* token followed by multibyte integer */
+    buffer[0] = token;
+    size = wbxml_encode_mb_uint32(value, buffer + 1);
+
+    return ebuffer_append(&wbxml_encoder->body_buffer, buffer, size + 1);
+}
+
+ELIBC_FORCE_INLINE int _wbxml_encode_switch_page(wbxml_encoder_t* wbxml_encoder, euint8_t* current_codepage, euint8_t codepage)
+{
+    euint8_t buffer[2];
+    int err;
+
+    /* ignore if the same */
+    if(*current_codepage == codepage) return ELIBC_SUCCESS;
+
+    buffer[0] = WBXML_TOKEN_SWITCH_PAGE;
+    buffer[1] = codepage;
+
+    err = ebuffer_append(&wbxml_encoder->body_buffer, buffer, sizeof(buffer));
+    if(err != ELIBC_SUCCESS) return err;
+
+    *current_codepage = codepage;
+
+    return ELIBC_SUCCESS;
+}
+
+/* string table index slot for string */
+ELIBC_FORCE_INLINE euint32_t* _wbxml_encode_index_slot(euint32_t* table_index, size_t index_size,
+                                                       const char* table, size_t table_size,
+                                                       const char* str, size_t str_len)
+{
+    size_t slot, offset;
+
+    /* open addressing, index size is power of two */
+    slot = (size_t)hash_fnv32((const unsigned char*)str, (unsigned long)str_len) & (index_size - 1);
+    while(table_index[slot] != 0)
+    {
+        offset = table_index[slot] - 1;
+
+        /* check if the same string (entry with terminator must fit in table) */
+        if(table_size - offset > str_len && 
+           ememcmp(table + offset, str, str_len) == 0 && table[offset + str_len] == 0) break;
+
+        slot = (slot + 1) & (index_size - 1);
+    }
+
+    return table_index + slot;
+}
+
+int _wbxml_encode_index_grow(wbxml_encoder_t* wbxml_encoder)
+{
+    euint32_t* table_index;
+    size_t index_size;
+    size_t idx;
+    const char* table_str;
+
+    /* double index size */
+    index_size = (wbxml_encoder->index_size > 0) ? wbxml_encoder->index_size * 2 : WBXML_ENCODER_INDEX_SIZE;
+
+    table_index = (euint32_t*)emalloc(index_size * sizeof(euint32_t));
+    if(table_index == 0) return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+
+    ememset(table_index, 0, index_size * sizeof(euint32_t));
+
+    /* re-insert strings */
+    for(idx = 0; idx < wbxml_encoder->index_size; ++idx)
+    {
+        if(wbxml_encoder->table_index[idx] == 0) continue;
+
+        table_str = ebuffer_data(&wbxml_encoder->string_table) + wbxml_encoder->table_index[idx] - 1;
+
+        *_wbxml_encode_index_slot(table_index, index_size, ebuffer_data(&wbxml_encoder->string_table),
+                                  ebuffer_pos(&wbxml_encoder->string_table),
+                                  table_str, estrlen(table_str)) = wbxml_encoder->table_index[idx];
+    }
+
+    /* replace index */
+    efree(wbxml_encoder->table_index);
+    wbxml_encoder->table_index = table_index;
+    wbxml_encoder->index_size = index_size;
+
+    return ELIBC_SUCCESS;
+}
+
+/* find or add string to string table */
+int _wbxml_encode_table_string(wbxml_encoder_t* wbxml_encoder, const char* str, size_t str_len, euint32_t* offset)
+{
+    euint32_t* slot;
+    int err;
+
+    /* keep index at most half full */
+    if((wbxml_encoder->string_count + 1) * 2 > wbxml_encoder->index_size)
+    {
+        err = _wbxml_encode_index_grow(wbxml_encoder);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    /* find string */
+    slot = _wbxml_encode_index_slot(wbxml_encoder->table_index, wbxml_encoder->index_size,
+                                    ebuffer_data(&wbxml_encoder->string_table),
+                                    ebuffer_pos(&wbxml_encoder->string_table), str, str_len);
+    if(*slot != 0)
+    {
+        *offset = *slot - 1;
+        return ELIBC_SUCCESS;
+    }
+
+    /* table can't be changed once sent */
+    if(wbxml_encoder->flags & WBXML_ENCODER_FLAG_TABLE_SENT) return ELIBC_ERROR_NOT_FOUND;
+
+    /* append string with terminator */
+    *offset = (euint32_t)ebuffer_pos(&wbxml_encoder->string_table);
+
+    err = ebuffer_append(&wbxml_encoder->string_table, str, str_len);
+    if(err != ELIBC_SUCCESS) return err;
+
+    err = ebuffer_append_char(&wbxml_encoder->string_table, 0);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* index it */
+    *slot = *offset + 1;
+    wbxml_encoder->string_count++;
+
+    return ELIBC_SUCCESS;
+}
+
+int _wbxml_encode_string(wbxml_encoder_t* wbxml_encoder, const char* str, size_t str_len)
+{
+    euint32_t offset;
+    int err;
+
+    /* check input */
+    EASSERT(str || str_len == 0);
+    if(str == 0 && str_len > 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* strings are zero terminated */
+    if(str_len > 0 && ememchr(str, 0, str_len) != 0)
+    {
+        ETRACE("wbxml_encoder: strings must not contain zero characters");
+        return ELIBC_ERROR_ARGUMENT;
+    }
+
+    /* check if string goes to table */
+    if(wbxml_encoder->table_string_length > 0 && str_len >= wbxml_encoder->table_string_length)
+    {
+        err = _wbxml_encode_table_string(wbxml_encoder, str, str_len, &offset);
+        if(err == ELIBC_SUCCESS)
+            return _wbxml_encode_token_mb_uint32(wbxml_encoder, WBXML_TOKEN_STR_T, offset);
+
+        /* encode inline if table was already sent */
+        if(err != ELIBC_ERROR_NOT_FOUND) return err;
+    }
+
+    /* inline string */
+    err = _wbxml_encode_byte(wbxml_encoder, WBXML_TOKEN_STR_I);
+    if(err != ELIBC_SUCCESS) return err;
+
+    if(str_len > 0)
+    {
+        err = ebuffer_append(&wbxml_encoder->body_buffer, str, str_len);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    return _wbxml_encode_byte(wbxml_encoder, 0);
+}
+
+int _wbxml_encode_literal(wbxml_encoder_t* wbxml_encoder, const char* name, size_t name_length)
+{
+    euint32_t offset;
+    int err;
+
+    /* check input */
+    EASSERT(name);
+    if(name == 0 || name_length == 0 || ememchr(name, 0, name_length) != 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* literals are always in string table */
+    err = _wbxml_encode_table_string(wbxml_encoder, name, name_length, &offset);
+    if(err == ELIBC_ERROR_NOT_FOUND)
+    {
+        ETRACE("wbxml_encoder: new literal can't be added after string table was flushed");
+        return ELIBC_ERROR_INVALID_STATE;
+    }
+    if(err != ELIBC_SUCCESS) return err;
+
+    return _wbxml_encode_token_mb_uint32(wbxml_encoder, WBXML_TOKEN_LITERAL, offset);
+}
+
+/* close open tag before content */
+int _wbxml_encode_content_begin(wbxml_encoder_t* wbxml_encoder)
+{
+    int err;
+
+    /* check state */
+    if((wbxml_encoder->flags & WBXML_ENCODER_FLAG_STARTED) == 0 || estack_size(&wbxml_encoder->tag_stack) == 0)
+    {
+        ETRACE("wbxml_encoder: content must be inside tag");
+        return ELIBC_ERROR_INVALID_STATE;
+    }
+
+    /* ignore if tag already has content */
+    if((wbxml_encoder->flags & WBXML_ENCODER_FLAG_TAG_OPEN) == 0) return ELIBC_SUCCESS;
+
+    /* close attribute list */
+    if(wbxml_encoder->flags & WBXML_ENCODER_FLAG_ATTRIBUTES)
+    {
+        err = _wbxml_encode_byte(wbxml_encoder, WBXML_TOKEN_END);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    /* mark tag with content */
+    ebuffer_data(&wbxml_encoder->body_buffer)[wbxml_encoder->tag_pos] |= WBXML_TAG_WITH_CONTENT;
+    *(euint8_t*)estack_top(&wbxml_encoder->tag_stack) |= WBXML_ENCODER_TAG_CONTENT;
+
+    wbxml_encoder->flags &= ~(WBXML_ENCODER_FLAG_TAG_OPEN | WBXML_ENCODER_FLAG_ATTRIBUTES | WBXML_ENCODER_FLAG_ATTRIBUTE);
+
+    return ELIBC_SUCCESS;
+}
+
+/* start attribute of open tag */
+int _wbxml_encode_attribute_begin(wbxml_encoder_t* wbxml_encoder)
+{
+    /* attributes must follow tag */
+    if((wbxml_encoder->flags & WBXML_ENCODER_FLAG_TAG_OPEN) == 0)
+    {
+        ETRACE("wbxml_encoder: attributes must follow tag begin");
+        return ELIBC_ERROR_INVALID_STATE;
+    }
+
+    /* mark tag with attributes */
+    if((wbxml_encoder->flags & WBXML_ENCODER_FLAG_ATTRIBUTES) == 0)
+    {
+        ebuffer_data(&wbxml_encoder->body_buffer)[wbxml_encoder->tag_pos] |= WBXML_TAG_WITH_ATTRIBUTES;
+        wbxml_encoder->flags |= WBXML_ENCODER_FLAG_ATTRIBUTES;
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+int _wbxml_encode_tag_push(wbxml_encoder_t* wbxml_encoder)
+{
+    euint8_t tag_flags = 0;
+    int err;
+
+    /* push tag */
+    err = estack_push(&wbxml_encoder->tag_stack, tag_flags);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* tag token is the last byte */
+    wbxml_encoder->flags |= WBXML_ENCODER_FLAG_TAG_OPEN;
+
+    return ELIBC_SUCCESS;
+}
+
+/* pass header and string table to output */
+int _wbxml_encode_header(wbxml_encoder_t* wbxml_encoder)
+{
+    euint8_t header[1 + 3 * WBXML_ENCODER_MB_UINT32_SIZE];
+    size_t header_size;
+    int err;
+
+    /* version, public id, charset and string table length */
+    header[0] = wbxml_encoder->version;
+    header_size = 1;
+    header_size += wbxml_encode_mb_uint32(wbxml_encoder->public_id, header + header_size);
+    header_size += wbxml_encode_mb_uint32(wbxml_encoder->charset, header + header_size);
+    header_size += wbxml_encode_mb_uint32((euint32_t)ebuffer_pos(&wbxml_encoder->string_table), header + header_size);
+
+    if(wbxml_encoder->flush_callback)
+    {
+        /* header */
+        err = wbxml_encoder->flush_callback(wbxml_encoder->flush_data, header, header_size);
+        if(err != ELIBC_SUCCESS) return err;
+
+        /* string table */
+        if(ebuffer_pos(&wbxml_encoder->string_table) > 0)
+        {
+            err = wbxml_encoder->flush_callback(wbxml_encoder->flush_data,
+                    (const euint8_t*)ebuffer_data(&wbxml_encoder->string_table), ebuffer_pos(&wbxml_encoder->string_table));
+            if(err != ELIBC_SUCCESS) return err;
+        }
+
+    } else
+    {
+        err = ebuffer_append(wbxml_encoder->encode_buffer, header, header_size);
+        if(err != ELIBC_SUCCESS) return err;
+
+        if(ebuffer_pos(&wbxml_encoder->string_table) > 0)
+        {
+            err = ebuffer_append(wbxml_encoder->encode_buffer,
+                    ebuffer_data(&wbxml_encoder->string_table), ebuffer_pos(&wbxml_encoder->string_table));
+            if(err != ELIBC_SUCCESS) return err;
+        }
+    }
+
+    /* string table is fixed from now on */
+    wbxml_encoder->flags |= WBXML_ENCODER_FLAG_TABLE_SENT;
+
+    return ELIBC_SUCCESS;
+}
+
+/* pass encoded body to flush callback */
+int _wbxml_encode_flush(wbxml_encoder_t* wbxml_encoder, ebool_t force)
+{
+    int err;
+
+    /* check if there is enough data (open tag token may still change) */
+    if(wbxml_encoder->flush_callback == 0 || (wbxml_encoder->flags & WBXML_ENCODER_FLAG_TAG_OPEN)) return ELIBC_SUCCESS;
+    if(!force && ebuffer_pos(&wbxml_encoder->body_buffer) < wbxml_encoder->flush_size) return ELIBC_SUCCESS;
+
+    /* header goes first */
+    if((wbxml_encoder->flags & WBXML_ENCODER_FLAG_TABLE_SENT) == 0)
+    {
+        err = _wbxml_encode_header(wbxml_encoder);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    /* body */
+    if(ebuffer_pos(&wbxml_encoder->body_buffer) > 0)
+    {
+        err = wbxml_encoder->flush_callback(wbxml_encoder->flush_data,
+                (const euint8_t*)ebuffer_data(&wbxml_encoder->body_buffer), ebuffer_pos(&wbxml_encoder->body_buffer));
+        if(err != ELIBC_SUCCESS) return err;
+
+        ebuffer_reset(&wbxml_encoder->body_buffer);
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+/*----------------------------------------------------------------------*/
+
+/* encoder handle */
+void wbxml_encode_init(wbxml_encoder_t* wbxml_encoder)
+{
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return;
+
+    /* reset all fields */
+    ememset(wbxml_encoder, 0, sizeof(wbxml_encoder_t));
+
+    /* init buffers (shallow documents don't allocate tag stack) */
+    estack_init_inline(&wbxml_encoder->tag_stack, sizeof(euint8_t),
+                       wbxml_encoder->tag_stack_items, sizeof(wbxml_encoder->tag_stack_items));
+    ebuffer_init(&wbxml_encoder->body_buffer);
+    ebuffer_init(&wbxml_encoder->string_table);
+
+    /* defaults */
+    wbxml_encoder->version = WBXML_ENCODER_VERSION;
+    wbxml_encoder->table_string_length = WBXML_ENCODER_TABLE_STRING_LENGTH;
+}
+
+void wbxml_encode_reset(wbxml_encoder_t* wbxml_encoder)
+{
+    /* reset encoder */
+    if(wbxml_encoder)
+    {
+        /* reset state */
+        wbxml_encoder->encode_buffer = 0;
+        wbxml_encoder->tag_codepage = 0;
+        wbxml_encoder->attribute_codepage = 0;
+        wbxml_encoder->flags = 0;
+
+        /* reset buffers */
+        estack_reset(&wbxml_encoder->tag_stack);
+        ebuffer_reset(&wbxml_encoder->body_buffer);
+        ebuffer_reset(&wbxml_encoder->string_table);
+
+        /* reset string index */
+        if(wbxml_encoder->table_index)
+            ememset(wbxml_encoder->table_index, 0, wbxml_encoder->index_size * sizeof(euint32_t));
+        wbxml_encoder->string_count = 0;
+    }
+}
+
+void wbxml_encode_close(wbxml_encoder_t* wbxml_encoder)
+{
+    /* free buffers */
+    if(wbxml_encoder)
+    {
+        estack_free(&wbxml_encoder->tag_stack);
+        ebuffer_free(&wbxml_encoder->body_buffer);
+        ebuffer_free(&wbxml_encoder->string_table);
+        efree(wbxml_encoder->table_index);
+
+#ifndef _ELIBC_DEBUG
+        /* reset all fields */
+        ememset(wbxml_encoder, 0, sizeof(wbxml_encoder_t));
+#endif /* _ELIBC_DEBUG */
+    }
+}
+
+/* encoder options */
+int wbxml_encode_set_flush(wbxml_encoder_t* wbxml_encoder, wbxml_flush_t flush_callback, void* user_data, size_t flush_size)
+{
+    /* check input */
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* options can't be changed while encoding */
+    if(wbxml_encoder->flags & WBXML_ENCODER_FLAG_STARTED) return ELIBC_ERROR_INVALID_STATE;
+
+    /* copy callback */
+    wbxml_encoder->flush_callback = flush_callback;
+    wbxml_encoder->flush_data = user_data;
+    wbxml_encoder->flush_size = flush_size;
+
+    return ELIBC_SUCCESS;
+}
+
+int wbxml_encode_set_string_table(wbxml_encoder_t* wbxml_encoder, size_t table_string_length)
+{
+    /* check input */
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* options can't be changed while encoding */
+    if(wbxml_encoder->flags & WBXML_ENCODER_FLAG_STARTED) return ELIBC_ERROR_INVALID_STATE;
+
+    wbxml_encoder->table_string_length = table_string_length;
+
+    return ELIBC_SUCCESS;
+}
+
+/* document */
+int wbxml_encode_begin(wbxml_encoder_t* wbxml_encoder, ebuffer_t* encode_buffer, euint32_t public_id, euint32_t charset)
+{
+    /* check input */
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* output buffer is required if there is no flush callback */
+    EASSERT(encode_buffer || wbxml_encoder->flush_callback);
+    if(encode_buffer == 0 && wbxml_encoder->flush_callback == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* public identifier as string is not supported */
+    if(public_id == WBXML_PUBLICID_LITERAL)
+    {
+        ETRACE("wbxml_encoder: string public identifiers are not supported");
+        return ELIBC_ERROR_NOT_SUPPORTED;
+    }
+
+    /* reset encoder */
+    wbxml_encode_reset(wbxml_encoder);
+
+    /* copy parameters */
+    wbxml_encoder->encode_buffer = encode_buffer;
+    wbxml_encoder->public_id = public_id;
+    wbxml_encoder->charset = charset;
+
+    wbxml_encoder->flags |= WBXML_ENCODER_FLAG_STARTED;
+
+    return ELIBC_SUCCESS;
+}
+
+int wbxml_encode_end(wbxml_encoder_t* wbxml_encoder)
+{
+    int err;
+
+    /* check input */
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* check state */
+    if((wbxml_encoder->flags & WBXML_ENCODER_FLAG_STARTED) == 0 || estack_size(&wbxml_encoder->tag_stack) != 0)
+    {
+        ETRACE("wbxml_encoder: document is not complete");
+        return ELIBC_ERROR_INVALID_STATE;
+    }
+
+    if(wbxml_encoder->flush_callback)
+    {
+        /* flush all data */
+        err = _wbxml_encode_flush(wbxml_encoder, ELIBC_TRUE);
+        if(err != ELIBC_SUCCESS) return err;
+
+    } else
+    {
+        /* header and string table */
+        err = _wbxml_encode_header(wbxml_encoder);
+        if(err != ELIBC_SUCCESS) return err;
+
+        /* body */
+        if(ebuffer_pos(&wbxml_encoder->body_buffer) > 0)
+        {
+            err = ebuffer_append(wbxml_encoder->encode_buffer,
+                    ebuffer_data(&wbxml_encoder->body_buffer), ebuffer_pos(&wbxml_encoder->body_buffer));
+            if(err != ELIBC_SUCCESS) return err;
+        }
+    }
+
+    wbxml_encoder->flags &= ~WBXML_ENCODER_FLAG_STARTED;
+
+    return ELIBC_SUCCESS;
+}
+
+/* tags */
+int wbxml_encode_tag_begin(wbxml_encoder_t* wbxml_encoder, euint8_t codepage, euint8_t tag)
+{
+    int err;
+
+    /* check input */
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* codes below 5 are global tokens */
+    EASSERT(tag > WBXML_TOKEN_LITERAL && tag <= WBXML_TAG_MASK);
+    if(tag <= WBXML_TOKEN_LITERAL || tag > WBXML_TAG_MASK) return ELIBC_ERROR_ARGUMENT;
+
+    /* check state */
+    if((wbxml_encoder->flags & WBXML_ENCODER_FLAG_STARTED) == 0) return ELIBC_ERROR_INVALID_STATE;
+
+    /* parent tag gets content */
+    if(estack_size(&wbxml_encoder->tag_stack) > 0)
+    {
+        err = _wbxml_encode_content_begin(wbxml_encoder);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    /* switch codepage if needed */
+    err = _wbxml_encode_switch_page(wbxml_encoder, &wbxml_encoder->tag_codepage, codepage);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* tag token, flags are added later */
+    wbxml_encoder->tag_pos = ebuffer_pos(&wbxml_encoder->body_buffer);
+
+    err = _wbxml_encode_byte(wbxml_encoder, tag);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return _wbxml_encode_tag_push(wbxml_encoder);
+}
+
+int wbxml_encode_tag_begin_literal(wbxml_encoder_t* wbxml_encoder, const char* name, size_t name_length)
+{
+    int err;
+
+    /* check input */
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* check state */
+    if((wbxml_encoder->flags & WBXML_ENCODER_FLAG_STARTED) == 0) return ELIBC_ERROR_INVALID_STATE;
+
+    /* parent tag gets content */
+    if(estack_size(&wbxml_encoder->tag_stack) > 0)
+    {
+        err = _wbxml_encode_content_begin(wbxml_encoder);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    /* literal token, flags are added later */
+    wbxml_encoder->tag_pos = ebuffer_pos(&wbxml_encoder->body_buffer);
+
+    err = _wbxml_encode_literal(wbxml_encoder, name, name_length);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return _wbxml_encode_tag_push(wbxml_encoder);
+}
+
+int wbxml_encode_tag_end(wbxml_encoder_t* wbxml_encoder)
+{
+    euint8_t tag_flags;
+    int err;
+
+    /* check input */
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* check state */
+    if(estack_size(&wbxml_encoder->tag_stack) == 0)
+    {
+        ETRACE("wbxml_encoder: no tag to end");
+        return ELIBC_ERROR_INVALID_STATE;
+    }
+
+    tag_flags = *(euint8_t*)estack_top(&wbxml_encoder->tag_stack);
+
+    /*
+        NOTE: tags with content end with END token, tags with attributes only
+              end with attribute list END token, empty tags have no END token
+    */
+    if((tag_flags & WBXML_ENCODER_TAG_CONTENT) || (wbxml_encoder->flags & WBXML_ENCODER_FLAG_ATTRIBUTES))
+    {
+        err = _wbxml_encode_byte(wbxml_encoder, WBXML_TOKEN_END);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    /* pop tag */
+    err = estack_pop(&wbxml_encoder->tag_stack);
+    if(err != ELIBC_SUCCESS) return err;
+
+    wbxml_encoder->flags &= ~(WBXML_ENCODER_FLAG_TAG_OPEN | WBXML_ENCODER_FLAG_ATTRIBUTES | WBXML_ENCODER_FLAG_ATTRIBUTE);
+
+    /* pass data to callback if ready */
+    return _wbxml_encode_flush(wbxml_encoder, ELIBC_FALSE);
+}
+
+/* attributes */
+int wbxml_encode_attribute(wbxml_encoder_t* wbxml_encoder, euint8_t codepage, euint8_t attribute)
+{
+    int err;
+
+    /* check input */
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* attribute start tokens are below 128 except global tokens */
+    EASSERT(wbxml_is_attribute_start(attribute));
+    if(!wbxml_is_attribute_start(attribute)) return ELIBC_ERROR_ARGUMENT;
+
+    err = _wbxml_encode_attribute_begin(wbxml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* switch codepage if needed */
+    err = _wbxml_encode_switch_page(wbxml_encoder, &wbxml_encoder->attribute_codepage, codepage);
+    if(err != ELIBC_SUCCESS) return err;
+
+    err = _wbxml_encode_byte(wbxml_encoder, attribute);
+    if(err != ELIBC_SUCCESS) return err;
+
+    wbxml_encoder->flags |= WBXML_ENCODER_FLAG_ATTRIBUTE;
+
+    return ELIBC_SUCCESS;
+}
+
+int wbxml_encode_attribute_literal(wbxml_encoder_t* wbxml_encoder, const char* name, size_t name_length)
+{
+    int err;
+
+    /* check input */
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    err = _wbxml_encode_attribute_begin(wbxml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    err = _wbxml_encode_literal(wbxml_encoder, name, name_length);
+    if(err != ELIBC_SUCCESS) return err;
+
+    wbxml_encoder->flags |= WBXML_ENCODER_FLAG_ATTRIBUTE;
+
+    return ELIBC_SUCCESS;
+}
+
+int wbxml_encode_attribute_value(wbxml_encoder_t* wbxml_encoder, const char* value, size_t value_length)
+{
+    /* check input */
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* values must follow attribute */
+    if((wbxml_encoder->flags & WBXML_ENCODER_FLAG_ATTRIBUTE) == 0) return ELIBC_ERROR_INVALID_STATE;
+
+    return _wbxml_encode_string(wbxml_encoder, value, value_length);
+}
+
+int wbxml_encode_attribute_value_token(wbxml_encoder_t* wbxml_encoder, euint8_t codepage, euint8_t value_token)
+{
+    int err;
+
+    /* check input */
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* attribute value tokens are 128 and above except global tokens */
+    if(value_token < WBXML_ATTRIBUTE_VALUE || (value_token & WBXML_TAG_MASK) <= WBXML_TOKEN_LITERAL) return ELIBC_ERROR_ARGUMENT;
+
+    /* values must follow attribute */
+    if((wbxml_encoder->flags & WBXML_ENCODER_FLAG_ATTRIBUTE) == 0) return ELIBC_ERROR_INVALID_STATE;
+
+    /* switch codepage if needed */
+    err = _wbxml_encode_switch_page(wbxml_encoder, &wbxml_encoder->attribute_codepage, codepage);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return _wbxml_encode_byte(wbxml_encoder, value_token);
+}
+
+/* content */
+int wbxml_encode_content(wbxml_encoder_t* wbxml_encoder, const char* content, size_t content_length)
+{
+    int err;
+
+    /* check input */
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* ignore empty content */
+    if(content_length == 0) return ELIBC_SUCCESS;
+
+    err = _wbxml_encode_content_begin(wbxml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    err = _wbxml_encode_string(wbxml_encoder, content, content_length);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* pass data to callback if ready */
+    return _wbxml_encode_flush(wbxml_encoder, ELIBC_FALSE);
+}
+
+int wbxml_encode_entity(wbxml_encoder_t* wbxml_encoder, euint32_t entity)
+{
+    int err;
+
+    /* check input */
+    EASSERT(wbxml_encoder);
+    if(wbxml_encoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    err = _wbxml_encode_content_begin(wbxml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    err = _wbxml_encode_token_mb_uint32(wbxml_encoder, WBXML_TOKEN_ENTITY, entity);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* pass data to callback if ready */
+    return _wbxml_encode_flush(wbxml_encoder, ELIBC_FALSE);
+}
+
+int wbxml_encode_opaque(wbxml_encoder_t* wbxml_encoder, const euint8_t* data, size_t data_size)
+{
+    int err;
+
+    /* check input */
+    EASSERT(wbxml_encoder);
+    EASSERT(data || data_size == 0);
+    if(wbxml_encoder == 0 || (data == 0 && data_size > 0)) return ELIBC_ERROR_ARGUMENT;
+
+    /* length must fit multibyte integer */
+    if((euint64_t)data_size > 0xFFFFFFFFUL) return ELIBC_ERROR_ARGUMENT;
+
+    err = _wbxml_encode_content_begin(wbxml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    err = _wbxml_encode_token_mb_uint32(wbxml_encoder, WBXML_TOKEN_OPAQUE, (euint32_t)data_size);
+    if(err != ELIBC_SUCCESS) return err;
+
+    if(data_size > 0)
+    {
+        err = ebuffer_append(&wbxml_encoder->body_buffer, data, data_size);
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    /* pass data to callback if ready */
+    return _wbxml_encode_flush(wbxml_encoder, ELIBC_FALSE);
+}
+
+/* multibyte integer */
+size_t wbxml_encode_mb_uint32(euint32_t value, euint8_t* buffer)
+{
+    euint8_t reversed[WBXML_ENCODER_MB_UINT32_SIZE];
+    size_t size, idx;
+
+    EASSERT(buffer);
+
+    /* 7 bits per byte, least significant first */
+    size = 0;
+    do
+    {
+        reversed[size] = (euint8_t)(value & WBXML_MULTIBYTE_CONTENT_MASK);
+        value >>= 7;
+        ++size;
+
+    } while(value != 0);
+
+    /* most significant first, all but last have continuation flag */
+    for(idx = 0; idx < size; ++idx)
+    {
+        buffer[idx] = reversed[size - idx - 1];
+        if(idx + 1 < size) buffer[idx] |= WBXML_MULTIBYTE_CONTINUE;
+    }
+
+    return size;
+}
+
+/*----------------------------------------------------------------------*/
@@ -0,0 +1,124 @@
+/*
+    WBXML encoder
+    Refer to WBXML documentation: http://www.w3.org/1999/06/NOTE-wbxml-19990624/
+*/
+
+#ifndef _WBXML_ENCODER_H_
+#define _WBXML_ENCODER_H_
+
+/*----------------------------------------------------------------------*/
+/* document defaults */
+#define WBXML_ENCODER_VERSION               0x03    /* WBXML 1.3 */
+#define WBXML_ENCODER_CHARSET_UTF8          106     /* refer: http://www.iana.org/assignments/character-sets/character-sets.xhtml */
+
+/* content strings of this length or longer are placed to string table by default */
+#define WBXML_ENCODER_TABLE_STRING_LENGTH   8
+
+/*----------------------------------------------------------------------*/
+
+/*
+    Flush callback parameters:
+     - user data associated with encoder (if set by user)
+     - encoded data
+     - encoded data size
+     Return: ELIBC_SUCCESS to continue or error code to stop encoder
+*/
+
+/* wbxml encoder flush callback */
+typedef int (*wbxml_flush_t)(void*, const euint8_t*, size_t);
+
+/*----------------------------------------------------------------------*/
+/* encoder */
+typedef struct {
+
+    /* document header */
+    euint32_t               public_id;
+    euint32_t               charset;
+    euint8_t                version;
+
+    /* current code pages */
+    euint8_t                tag_codepage;
+    euint8_t                attribute_codepage;
+
+    /* open tags */
+    estack_t                tag_stack;
+    euint8_t                tag_stack_items[PARSER_DEFAULT_STACK_SIZE];
+    size_t                  tag_pos;
+
+    /* encoded body */
+    ebuffer_t               body_buffer;
+
+    /* string table and its index (offsets + 1, zero if empty) */
+    ebuffer_t               string_table;
+    euint32_t*              table_index;
+    size_t                  index_size;
+    size_t                  string_count;
+    size_t                  table_string_length;
+
+    /* output */
+    ebuffer_t*              encode_buffer;
+
+    /* flush callback */
+    wbxml_flush_t           flush_callback;
+    void*                   flush_data;
+    size_t                  flush_size;
+
+    /* encoder state */
+    unsigned short          flags;
+
+} wbxml_encoder_t;
+
+/*----------------------------------------------------------------------*/
+
+/* encoder handle */
+void    wbxml_encode_init(wbxml_encoder_t* wbxml_encoder);
+void    wbxml_encode_reset(wbxml_encoder_t* wbxml_encoder);
+void    wbxml_encode_close(wbxml_encoder_t* wbxml_encoder);
+
+/*
+    NOTE: - encoded data is written to encode_buffer when wbxml_encode_end is called
+          - if flush callback is set, data is passed to callback instead every time
+            at least flush_size bytes are ready (encode_buffer is not used and may be null),
+            string table is sent with the first block so all strings added after that
+            are encoded inline and tag or attribute literals are not allowed
+          - content strings not shorter than table_string_length are placed to string
+            table and repeated strings are encoded as references, zero disables this
+            (literals are always placed to string table)
+*/
+
+/* encoder options (must be set before wbxml_encode_begin) */
+int     wbxml_encode_set_flush(wbxml_encoder_t* wbxml_encoder, wbxml_flush_t flush_callback, void* user_data, size_t flush_size);
+int     wbxml_encode_set_string_table(wbxml_encoder_t* wbxml_encoder, size_t table_string_length);
+
+/* document */
+int     wbxml_encode_begin(wbxml_encoder_t* wbxml_encoder, ebuffer_t* encode_buffer, euint32_t public_id, euint32_t charset);
+int     wbxml_encode_end(wbxml_encoder_t* wbxml_encoder);
+
+/*
+    NOTE: tag and attribute codes must not include WBXML flags and switch page tokens
+          are added automatically if codepage changes
+*/
+
+/* tags */
+int     wbxml_encode_tag_begin(wbxml_encoder_t* wbxml_encoder, euint8_t codepage, euint8_t tag);
+int     wbxml_encode_tag_begin_literal(wbxml_encoder_t* wbxml_encoder, const char* name, size_t name_length);
+int     wbxml_encode_tag_end(wbxml_encoder_t* wbxml_encoder);
+
+/* attributes (must follow tag begin) */
+int     wbxml_encode_attribute(wbxml_encoder_t* wbxml_encoder, euint8_t codepage, euint8_t attribute);
+int     wbxml_encode_attribute_literal(wbxml_encoder_t* wbxml_encoder, const char* name, size_t name_length);
+int     wbxml_encode_attribute_value(wbxml_encoder_t* wbxml_encoder, const char* value, size_t value_length);
+int     wbxml_encode_attribute_value_token(wbxml_encoder_t* wbxml_encoder, euint8_t codepage, euint8_t value_token);
+
+/* content */
+int     wbxml_encode_content(wbxml_encoder_t* wbxml_encoder, const char* content, size_t content_length);
+int     wbxml_encode_entity(wbxml_encoder_t* wbxml_encoder, euint32_t entity);
+int     wbxml_encode_opaque(wbxml_encoder_t* wbxml_encoder, const euint8_t* data, size_t data_size);
+
+/* multibyte integer (returns number of bytes used, buffer must fit at least 5 bytes) */
+size_t  wbxml_encode_mb_uint32(euint32_t value, euint8_t* buffer);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _WBXML_ENCODER_H_ */
+
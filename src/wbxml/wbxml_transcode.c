@@ -0,0 +1,562 @@
+/*
+    XML to WBXML and WBXML to XML transcoders
+    Refer to WBXML documentation: http://www.w3.org/1999/06/NOTE-wbxml-19990624/
+*/
+
+#include "../elib_config.h"
+
+#include "../parsers/escape_parse.h"
+#include "../parsers/entity_parse.h"
+#include "../parsers/xml_parse.h"
+#include "../http/http_param.h"
+#include "../encoders/xml_encode.h"
+#include "../text/text_base64.h"
+#include "../hash/hash_fnv.h"
+
+#include "wbxml_types.h"
+#include "wbxml_decoder.h"
+#include "wbxml_encoder.h"
+#include "wbxml_transcode.h"
+
+/*----------------------------------------------------------------------*/
+
+/* minimum name index size (must be power of two) */
+#define WBXML_TRANSCODE_INDEX_SIZE          64
+
+/* opaque data is encoded to base64 in blocks (must be multiple of 3) */
+#define WBXML_TRANSCODE_BASE64_BLOCK        48
+
+/* transcoder flags */
+#define WBXML_TRANSCODE_FLAG_ATTRIBUTE      0x0001
+
+/*----------------------------------------------------------------------*/
+/* worker methods */
+ELIBC_FORCE_INLINE size_t _wbxml_transcode_index_slot(const char* name, size_t name_length, euint8_t is_attribute, size_t index_size)
+{
+    return ((size_t)hash_fnv32((const unsigned char*)name, (unsigned long)name_length) + is_attribute) & (index_size - 1);
+}
+
+ELIBC_FORCE_INLINE const char* _wbxml_transcode_table_name(const char* const* names, size_t names_count, size_t idx)
+{
+    return (names != 0 && idx < names_count) ? names[idx] : 0;
+}
+
+ELIBC_FORCE_INLINE const wbxml_codepage_t* _wbxml_transcode_codepage(const wbxml_codepage_t* codepages, size_t codepage_count, euint8_t codepage)
+{
+    return (codepage < codepage_count) ? codepages + codepage : 0;
+}
+
+/*----------------------------------------------------------------------*/
+/* xml to wbxml */
+int _wbxml_from_xml_index_add(wbxml_from_xml_t* transcoder, const char* name, euint8_t codepage, euint8_t token, euint8_t is_attribute)
+{
+    wbxml_transcode_name_t* entry;
+    size_t slot;
+
+    /* ignore empty entries and attribute names with value prefix */
+    if(name == 0 || name[0] == 0 || (is_attribute && estrchr(name, '=') != 0)) return ELIBC_SUCCESS;
+
+    /* find empty slot (index is never full) */
+    slot = _wbxml_transcode_index_slot(name, estrlen(name), is_attribute, transcoder->index_size);
+    while(transcoder->name_index[slot].name != 0)
+    {
+        slot = (slot + 1) & (transcoder->index_size - 1);
+    }
+
+    entry = transcoder->name_index + slot;
+    entry->name = name;
+    entry->name_length = estrlen(name);
+    entry->codepage = codepage;
+    entry->token = token;
+    entry->is_attribute = is_attribute;
+
+    return ELIBC_SUCCESS;
+}
+
+ebool_t _wbxml_from_xml_lookup(wbxml_from_xml_t* transcoder, const char* name, size_t name_length, euint8_t is_attribute,
+                               euint8_t current_codepage, euint8_t* codepage, euint8_t* token)
+{
+    const wbxml_transcode_name_t* entry;
+    const wbxml_transcode_name_t* found = 0;
+    size_t slot;
+
+    if(transcoder->index_size == 0) return ELIBC_FALSE;
+
+    /* check all entries with the same name */
+    slot = _wbxml_transcode_index_slot(name, name_length, is_attribute, transcoder->index_size);
+    for(entry = transcoder->name_index + slot; entry->name != 0; entry = transcoder->name_index + slot)
+    {
+        if(entry->is_attribute == is_attribute && entry->name_length == name_length &&
+           ememcmp(entry->name, name, name_length) == 0)
+        {
+            /* current code page is preferred */
+            if(entry->codepage == current_codepage)
+            {
+                found = entry;
+                break;
+            }
+
+            if(found == 0) found = entry;
+        }
+
+        slot = (slot + 1) & (transcoder->index_size - 1);
+    }
+
+    if(found == 0) return ELIBC_FALSE;
+
+    *codepage = found->codepage;
+    *token = found->token;
+
+    return ELIBC_TRUE;
+}
+
+int _wbxml_from_xml_event(wbxml_from_xml_t* transcoder, xml_event_t xml_event, const char* data, size_t length)
+{
+    wbxml_encoder_t* wbxml_encoder = &transcoder->wbxml_encoder;
+    euint8_t codepage, token;
+
+    switch(xml_event)
+    {
+    case xml_tag_begin:
+        if(_wbxml_from_xml_lookup(transcoder, data, length, 0, wbxml_encoder->tag_codepage, &codepage, &token))
+        {
+            return wbxml_encode_tag_begin(wbxml_encoder, codepage, token);
+        }
+
+        return wbxml_encode_tag_begin_literal(wbxml_encoder, data, length);
+        break;
+
+    case xml_tag_end:
+        return wbxml_encode_tag_end(wbxml_encoder);
+        break;
+
+    case xml_tag_content:
+        return wbxml_encode_content(wbxml_encoder, data, length);
+        break;
+
+    case xml_attribute_name:
+        if(_wbxml_from_xml_lookup(transcoder, data, length, 1, wbxml_encoder->attribute_codepage, &codepage, &token))
+        {
+            return wbxml_encode_attribute(wbxml_encoder, codepage, token);
+        }
+
+        return wbxml_encode_attribute_literal(wbxml_encoder, data, length);
+        break;
+
+    case xml_attribute_value:
+        return wbxml_encode_attribute_value(wbxml_encoder, data, length);
+        break;
+
+    default:
+        /* declaration, processing instructions, comments and dtd are not transcoded */
+        break;
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+int _wbxml_from_xml_callback(void* user_data, xml_event_t xml_event, const void* data, size_t length)
+{
+    wbxml_from_xml_t* transcoder = (wbxml_from_xml_t*)user_data;
+
+    /* parser ignores return value for some events, so check previous error as well */
+    if(transcoder->encode_error != ELIBC_SUCCESS || xml_event == xml_parse_error) return ELIBC_STOP;
+
+    transcoder->encode_error = _wbxml_from_xml_event(transcoder, xml_event, (const char*)data, length);
+
+    return (transcoder->encode_error == ELIBC_SUCCESS) ? ELIBC_CONTINUE : ELIBC_STOP;
+}
+
+/*----------------------------------------------------------------------*/
+/* wbxml to xml */
+int _wbxml_to_xml_opaque(wbxml_to_xml_t* transcoder, const euint8_t* data, size_t data_size)
+{
+    euint8_t buffer[base64_encoded_size(WBXML_TRANSCODE_BASE64_BLOCK)];
+    size_t block_size, output_size;
+    int err;
+
+    /* make sure tag begin is finished even for empty data */
+    if(data_size == 0 && (transcoder->flags & WBXML_TRANSCODE_FLAG_ATTRIBUTE) == 0)
+    {
+        return xml_encode_content(&transcoder->xml_encoder, 0, 0);
+    }
+
+    /* encode in blocks */
+    while(data_size > 0)
+    {
+        block_size = (data_size < WBXML_TRANSCODE_BASE64_BLOCK) ? data_size : WBXML_TRANSCODE_BASE64_BLOCK;
+        output_size = sizeof(buffer);
+
+        base64_encode(data, block_size, buffer, &output_size);
+
+        if(transcoder->flags & WBXML_TRANSCODE_FLAG_ATTRIBUTE)
+            err = xml_encode_attribute_value(&transcoder->xml_encoder, (const char*)buffer, output_size);
+        else
+            err = xml_encode_content(&transcoder->xml_encoder, (const char*)buffer, output_size);
+
+        if(err != ELIBC_SUCCESS) return err;
+
+        data += block_size;
+        data_size -= block_size;
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+int _wbxml_to_xml_attribute(wbxml_to_xml_t* transcoder, euint8_t attribute)
+{
+    const wbxml_codepage_t* codepage;
+    const char* name;
+    const char* prefix;
+    int err;
+
+    /* attribute name */
+    codepage = _wbxml_transcode_codepage(transcoder->codepages, transcoder->codepage_count, transcoder->attribute_codepage);
+    name = codepage ? _wbxml_transcode_table_name(codepage->attribute_names, codepage->attribute_names_count, attribute) : 0;
+    if(name == 0)
+    {
+        ETRACE("wbxml_transcode: attribute name not found in code page");
+        return ELIBC_ERROR_NOT_FOUND;
+    }
+
+    /* name may contain value prefix */
+    prefix = estrchr(name, '=');
+
+    err = xml_encode_attribute_begin(&transcoder->xml_encoder, name, prefix ? (size_t)(prefix - name) : estrlen(name));
+    if(err != ELIBC_SUCCESS) return err;
+
+    if(prefix)
+    {
+        err = xml_encode_attribute_value(&transcoder->xml_encoder, prefix + 1, estrlen(prefix + 1));
+        if(err != ELIBC_SUCCESS) return err;
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+int _wbxml_to_xml_event(wbxml_to_xml_t* transcoder, wbxml_event_t wbxml_event, const char* data, size_t length)
+{
+    xml_encoder_t* xml_encoder = &transcoder->xml_encoder;
+    const wbxml_codepage_t* codepage;
+    const char* name;
+
+    switch(wbxml_event)
+    {
+    case wbxml_document_version:
+    case wbxml_document_public_id:
+    case wbxml_document_public_id_string:
+        /* not used in xml */
+        break;
+
+    case wbxml_document_charset:
+        /* strings are passed as is (zero for unknown, 3 for US-ASCII) */
+        if(length != 0 && length != 3 && length != WBXML_ENCODER_CHARSET_UTF8)
+        {
+            ETRACE("wbxml_transcode: only utf-8 documents are supported");
+            return ELIBC_ERROR_NOT_SUPPORTED;
+        }
+        break;
+
+    case wbxml_document_codepage:
+        transcoder->tag_codepage = (euint8_t)length;
+        break;
+
+    case wbxml_document_attribute_codepage:
+        transcoder->attribute_codepage = (euint8_t)length;
+        break;
+
+    case wbxml_tag_begin:
+        codepage = _wbxml_transcode_codepage(transcoder->codepages, transcoder->codepage_count, transcoder->tag_codepage);
+        name = codepage ? _wbxml_transcode_table_name(codepage->tag_names, codepage->tag_names_count, length) : 0;
+        if(name == 0)
+        {
+            ETRACE("wbxml_transcode: tag name not found in code page");
+            return ELIBC_ERROR_NOT_FOUND;
+        }
+
+        return xml_encode_tag_begin(xml_encoder, name, estrlen(name));
+        break;
+
+    case wbxml_tag_begin_string:
+        return xml_encode_tag_begin(xml_encoder, data, length);
+        break;
+
+    case wbxml_tag_end:
+    case wbxml_tag_end_string:
+        return xml_encode_tag_end(xml_encoder);
+        break;
+
+    case wbxml_tag_content_string:
+        return xml_encode_content(xml_encoder, data, length);
+        break;
+
+    case wbxml_tag_content_entity:
+    case wbxml_attribute_value_entity:
+        return xml_encode_entity(xml_encoder, (euint32_t)length);
+        break;
+
+    case wbxml_attribute_begin:
+        transcoder->flags |= WBXML_TRANSCODE_FLAG_ATTRIBUTE;
+        return _wbxml_to_xml_attribute(transcoder, (euint8_t)length);
+        break;
+
+    case wbxml_attribute_begin_string:
+        transcoder->flags |= WBXML_TRANSCODE_FLAG_ATTRIBUTE;
+        return xml_encode_attribute_begin(xml_encoder, data, length);
+        break;
+
+    case wbxml_attribute_value_string:
+        return xml_encode_attribute_value(xml_encoder, data, length);
+        break;
+
+    case wbxml_attribute_value_token:
+        codepage = _wbxml_transcode_codepage(transcoder->codepages, transcoder->codepage_count, transcoder->attribute_codepage);
+        name = codepage ? _wbxml_transcode_table_name(codepage->attribute_values, codepage->attribute_values_count,
+                                                      length - WBXML_ATTRIBUTE_VALUE) : 0;
+        if(name == 0)
+        {
+            ETRACE("wbxml_transcode: attribute value not found in code page");
+            return ELIBC_ERROR_NOT_FOUND;
+        }
+
+        return xml_encode_attribute_value(xml_encoder, name, estrlen(name));
+        break;
+
+    case wbxml_attribute_end:
+    case wbxml_attribute_end_string:
+        transcoder->flags &= ~WBXML_TRANSCODE_FLAG_ATTRIBUTE;
+        break;
+
+    case wbxml_decoder_opaque_data:
+        return _wbxml_to_xml_opaque(transcoder, (const euint8_t*)data, length);
+        break;
+
+    default:
+        /* processing instructions and extensions have no xml representation */
+        ETRACE("wbxml_transcode: wbxml token is not supported");
+        return ELIBC_ERROR_NOT_SUPPORTED;
+        break;
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+int _wbxml_to_xml_callback(void* user_data, wbxml_event_t wbxml_event, const void* data, size_t length)
+{
+    wbxml_to_xml_t* transcoder = (wbxml_to_xml_t*)user_data;
+
+    /* stop on syntax errors */
+    if(wbxml_event == wbxml_decoder_error) return ELIBC_STOP;
+
+    transcoder->encode_error = _wbxml_to_xml_event(transcoder, wbxml_event, (const char*)data, length);
+
+    return (transcoder->encode_error == ELIBC_SUCCESS) ? ELIBC_CONTINUE : ELIBC_STOP;
+}
+
+/*----------------------------------------------------------------------*/
+
+/* xml to wbxml */
+int wbxml_from_xml_init(wbxml_from_xml_t* transcoder, const wbxml_codepage_t* codepages, size_t codepage_count)
+{
+    size_t name_count, idx, token;
+    const wbxml_codepage_t* codepage;
+    int err;
+
+    EASSERT(transcoder);
+    EASSERT(codepages || codepage_count == 0);
+    if(transcoder == 0 || (codepages == 0 && codepage_count > 0)) return ELIBC_ERROR_ARGUMENT;
+
+    /* code page number is single byte */
+    if(codepage_count > 256) return ELIBC_ERROR_ARGUMENT;
+
+    /* reset all fields */
+    ememset(transcoder, 0, sizeof(wbxml_from_xml_t));
+
+    /* init parser and encoder */
+    xml_init(&transcoder->xml_parser, _wbxml_from_xml_callback, transcoder);
+    wbxml_encode_init(&transcoder->wbxml_encoder);
+
+    /* entities must be decoded to get original text */
+    xml_decode_escapes(&transcoder->xml_parser, 1);
+
+    transcoder->codepages = codepages;
+    transcoder->codepage_count = codepage_count;
+
+    /* count names */
+    for(idx = 0, name_count = 0; idx < codepage_count; ++idx)
+    {
+        name_count += (codepages[idx].tag_names ? codepages[idx].tag_names_count : 0) +
+                      (codepages[idx].attribute_names ? codepages[idx].attribute_names_count : 0);
+    }
+
+    if(name_count == 0) return ELIBC_SUCCESS;
+
+    /* index is kept at most half full */
+    for(transcoder->index_size = WBXML_TRANSCODE_INDEX_SIZE; transcoder->index_size < name_count * 2; transcoder->index_size *= 2);
+
+    transcoder->name_index = (wbxml_transcode_name_t*)emalloc(transcoder->index_size * sizeof(wbxml_transcode_name_t));
+    if(transcoder->name_index == 0)
+    {
+        wbxml_from_xml_close(transcoder);
+        return ELIBC_ERROR_NOT_ENOUGH_MEMORY;
+    }
+
+    ememset(transcoder->name_index, 0, transcoder->index_size * sizeof(wbxml_transcode_name_t));
+
+    /* build index */
+    for(idx = 0; idx < codepage_count; ++idx)
+    {
+        codepage = codepages + idx;
+
+        for(token = 0; codepage->tag_names && token < codepage->tag_names_count && token <= WBXML_TAG_MASK; ++token)
+        {
+            err = _wbxml_from_xml_index_add(transcoder, codepage->tag_names[token], (euint8_t)idx, (euint8_t)token, 0);
+            if(err != ELIBC_SUCCESS) return err;
+        }
+
+        for(token = 0; codepage->attribute_names && token < codepage->attribute_names_count && token < WBXML_ATTRIBUTE_VALUE; ++token)
+        {
+            /* global token codes can't be used for attributes */
+            if(!wbxml_is_attribute_start(token)) continue;
+
+            err = _wbxml_from_xml_index_add(transcoder, codepage->attribute_names[token], (euint8_t)idx, (euint8_t)token, 1);
+            if(err != ELIBC_SUCCESS) return err;
+        }
+    }
+
+    return ELIBC_SUCCESS;
+}
+
+void wbxml_from_xml_close(wbxml_from_xml_t* transcoder)
+{
+    if(transcoder)
+    {
+        xml_close(&transcoder->xml_parser);
+        wbxml_encode_close(&transcoder->wbxml_encoder);
+
+        efree(transcoder->name_index);
+        transcoder->name_index = 0;
+        transcoder->index_size = 0;
+    }
+}
+
+int wbxml_from_xml_begin(wbxml_from_xml_t* transcoder, ebuffer_t* encode_buffer, ebuffer_t* parse_buffer, euint32_t public_id)
+{
+    int err;
+
+    EASSERT(transcoder);
+    if(transcoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    transcoder->encode_error = ELIBC_SUCCESS;
+
+    err = wbxml_encode_begin(&transcoder->wbxml_encoder, encode_buffer, public_id, WBXML_ENCODER_CHARSET_UTF8);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return xml_begin(&transcoder->xml_parser, parse_buffer);
+}
+
+int wbxml_from_xml_transcode(wbxml_from_xml_t* transcoder, const char* text, size_t text_size)
+{
+    int err;
+
+    EASSERT(transcoder);
+    if(transcoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    err = xml_parse(&transcoder->xml_parser, text, text_size);
+
+    /* encoder error stops parser */
+    return (transcoder->encode_error != ELIBC_SUCCESS) ? transcoder->encode_error : err;
+}
+
+int wbxml_from_xml_end(wbxml_from_xml_t* transcoder)
+{
+    int err;
+
+    EASSERT(transcoder);
+    if(transcoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    if(transcoder->encode_error != ELIBC_SUCCESS) return transcoder->encode_error;
+
+    err = xml_end(&transcoder->xml_parser);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return wbxml_encode_end(&transcoder->wbxml_encoder);
+}
+
+/* wbxml to xml */
+int wbxml_to_xml_init(wbxml_to_xml_t* transcoder, const wbxml_codepage_t* codepages, size_t codepage_count)
+{
+    EASSERT(transcoder);
+    EASSERT(codepages || codepage_count == 0);
+    if(transcoder == 0 || (codepages == 0 && codepage_count > 0)) return ELIBC_ERROR_ARGUMENT;
+
+    /* reset all fields */
+    ememset(transcoder, 0, sizeof(wbxml_to_xml_t));
+
+    /* init decoder and encoder */
+    wbxml_init(&transcoder->wbxml_decoder, _wbxml_to_xml_callback, transcoder);
+    xml_encode_init(&transcoder->xml_encoder);
+
+    transcoder->codepages = codepages;
+    transcoder->codepage_count = codepage_count;
+
+    return ELIBC_SUCCESS;
+}
+
+void wbxml_to_xml_close(wbxml_to_xml_t* transcoder)
+{
+    if(transcoder)
+    {
+        wbxml_close(&transcoder->wbxml_decoder);
+        xml_encode_close(&transcoder->xml_encoder);
+    }
+}
+
+int wbxml_to_xml_begin(wbxml_to_xml_t* transcoder, ebuffer_t* encode_buffer, ebuffer_t* decode_buffer)
+{
+    int err;
+
+    EASSERT(transcoder);
+    if(transcoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    /* reset state */
+    transcoder->tag_codepage = 0;
+    transcoder->attribute_codepage = 0;
+    transcoder->flags = 0;
+    transcoder->encode_error = ELIBC_SUCCESS;
+
+    err = xml_encode_begin(&transcoder->xml_encoder, encode_buffer);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return wbxml_begin(&transcoder->wbxml_decoder, decode_buffer);
+}
+
+int wbxml_to_xml_transcode(wbxml_to_xml_t* transcoder, const euint8_t* input, size_t input_size)
+{
+    int err;
+
+    EASSERT(transcoder);
+    if(transcoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    err = wbxml_decode(&transcoder->wbxml_decoder, input, input_size);
+
+    /* encoder error stops decoder */
+    return (transcoder->encode_error != ELIBC_SUCCESS) ? transcoder->encode_error : err;
+}
+
+int wbxml_to_xml_end(wbxml_to_xml_t* transcoder)
+{
+    int err;
+
+    EASSERT(transcoder);
+    if(transcoder == 0) return ELIBC_ERROR_ARGUMENT;
+
+    if(transcoder->encode_error != ELIBC_SUCCESS) return transcoder->encode_error;
+
+    err = wbxml_end(&transcoder->wbxml_decoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return xml_encode_end(&transcoder->xml_encoder);
+}
+
+/*----------------------------------------------------------------------*/
@@ -0,0 +1,113 @@
+/*
+    XML to WBXML and WBXML to XML transcoders
+    Refer to WBXML documentation: http://www.w3.org/1999/06/NOTE-wbxml-19990624/
+*/
+
+#ifndef _WBXML_TRANSCODE_H_
+#define _WBXML_TRANSCODE_H_
+
+/*----------------------------------------------------------------------*/
+
+/*
+    NOTE: - transcoders pass parser events directly to encoder in one pass, document
+            tree is never built and only names of currently open tags are kept
+          - code pages are indexed by code page number, their name tables are used
+            to map xml names to wbxml tokens and back
+          - xml names not found in code pages are encoded as wbxml literals
+          - xml namespaces are not mapped to code pages, if the same name is found in
+            several code pages the current code page is preferred
+          - opaque data is encoded to xml as base64 text
+*/
+
+/*----------------------------------------------------------------------*/
+
+/* name lookup entry */
+typedef struct {
+
+    const char*             name;
+    size_t                  name_length;
+    euint8_t                codepage;
+    euint8_t                token;
+    euint8_t                is_attribute;
+
+} wbxml_transcode_name_t;
+
+/*----------------------------------------------------------------------*/
+/* xml to wbxml transcoder */
+typedef struct {
+
+    /* parser and encoder */
+    xml_parser_t                xml_parser;
+    wbxml_encoder_t             wbxml_encoder;
+
+    /* code pages */
+    const wbxml_codepage_t*     codepages;
+    size_t                      codepage_count;
+
+    /* name lookup index (open addressing, size is power of two) */
+    wbxml_transcode_name_t*     name_index;
+    size_t                      index_size;
+
+    /* encoder error */
+    int                         encode_error;
+
+} wbxml_from_xml_t;
+
+/*----------------------------------------------------------------------*/
+/* wbxml to xml transcoder */
+typedef struct {
+
+    /* decoder and encoder */
+    wbxml_decoder_t             wbxml_decoder;
+    xml_encoder_t               xml_encoder;
+
+    /* code pages */
+    const wbxml_codepage_t*     codepages;
+    size_t                      codepage_count;
+
+    /* current code pages */
+    euint8_t                    tag_codepage;
+    euint8_t                    attribute_codepage;
+
+    /* transcoder state */
+    unsigned short              flags;
+
+    /* encoder error */
+    int                         encode_error;
+
+} wbxml_to_xml_t;
+
+/*----------------------------------------------------------------------*/
+
+/*
+    NOTE: wbxml encoder options (e.g. flush callback) can be set directly on
+          wbxml_encoder member before wbxml_from_xml_begin is called
+*/
+
+/* xml to wbxml */
+int     wbxml_from_xml_init(wbxml_from_xml_t* transcoder, const wbxml_codepage_t* codepages, size_t codepage_count);
+void    wbxml_from_xml_close(wbxml_from_xml_t* transcoder);
+
+int     wbxml_from_xml_begin(wbxml_from_xml_t* transcoder, ebuffer_t* encode_buffer, ebuffer_t* parse_buffer, euint32_t public_id);
+int     wbxml_from_xml_transcode(wbxml_from_xml_t* transcoder, const char* text, size_t text_size);
+int     wbxml_from_xml_end(wbxml_from_xml_t* transcoder);
+
+/*
+    NOTE: - xml is appended to encode_buffer as soon as it is decoded, so it can be consumed
+            and buffer reset between wbxml_to_xml_transcode calls
+          - wbxml decoder options (e.g. zero copy mode) can be set directly on
+            wbxml_decoder member before wbxml_to_xml_begin is called
+*/
+
+/* wbxml to xml */
+int     wbxml_to_xml_init(wbxml_to_xml_t* transcoder, const wbxml_codepage_t* codepages, size_t codepage_count);
+void    wbxml_to_xml_close(wbxml_to_xml_t* transcoder);
+
+int     wbxml_to_xml_begin(wbxml_to_xml_t* transcoder, ebuffer_t* encode_buffer, ebuffer_t* decode_buffer);
+int     wbxml_to_xml_transcode(wbxml_to_xml_t* transcoder, const euint8_t* input, size_t input_size);
+int     wbxml_to_xml_end(wbxml_to_xml_t* transcoder);
+
+/*----------------------------------------------------------------------*/
+
+#endif /* _WBXML_TRANSCODE_H_ */
+
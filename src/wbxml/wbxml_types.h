@@ -16,9 +16,13 @@
                                                        If this bit is zero, the tag contains no content and no end tag.
                                                        If this bit is one, the tag is followed by any content it contains and
                                                        is terminated by an END token.*/
-#define WBXML_TAG_MASK                  0x1F        /* bits 5-0 indicate the tag identity.*/
+#define WBXML_TAG_MASK                  0x3F        /* bits 5-0 indicate the tag identity.*/
 
-/* tag flags */
+/* attribute flags */
+#define WBXML_ATTRIBUTE_VALUE           0x80        /* attribute value tokens are 128 and greater,
+                                                       attribute start tokens are less than 128 */
+
+/* multibyte integer flags */
 #define WBXML_MULTIBYTE_CONTINUE        0x80        /* multibyte continuation flag */
 #define WBXML_MULTIBYTE_CONTENT_MASK    0x7F        /* byte content mask */
 
@@ -34,6 +38,19 @@ typedef struct {
     const euint8_t*     codes_table;
     size_t              codes_count;
 
+    /* tag names indexed by tag identity (optional, used for xml transcoding) */
+    const char* const*  tag_names;
+    size_t              tag_names_count;
+
+    /* attribute start names indexed by attribute token (optional, used for xml transcoding),
+       name may be followed by '=' and value prefix, e.g. "href=http://" */
+    const char* const*  attribute_names;
+    size_t              attribute_names_count;
+
+    /* attribute value strings indexed by value token minus WBXML_ATTRIBUTE_VALUE (optional) */
+    const char* const*  attribute_values;
+    size_t              attribute_values_count;
+
 } wbxml_codepage_t;
 
 /*----------------------------------------------------------------------*/
@@ -61,6 +78,9 @@ typedef struct {
 #define WBXML_TOKEN_OPAQUE              0xC3    /* Opaque document-type-specific data.*/
 #define WBXML_TOKEN_LITERAL_AC          0xC4    /* Unknown tag, with content and attributes.*/
 
+/* attribute start token (0x05-0x3F and 0x45-0x7F, other codes below 128 are global tokens) */
+#define wbxml_is_attribute_start(token) (((token) & WBXML_TAG_MASK) > WBXML_TOKEN_LITERAL && (token) < WBXML_ATTRIBUTE_VALUE)
+
 /*----------------------------------------------------------------------*/
 /* public identifiers */
 /*----------------------------------------------------------------------*/
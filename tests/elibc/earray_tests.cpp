@@ -0,0 +1,155 @@
+/*
+    EArray unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+#define EARRAY_TEST_INLINE_SIZE     8
+#define EARRAY_TEST_SIZE            1000
+
+/*----------------------------------------------------------------------*/
+
+/* stack with inline storage */
+typedef struct
+{
+    estack_t    estack;
+    int         estack_items[EARRAY_TEST_INLINE_SIZE];
+
+} earray_test_owner_t;
+
+/* count json values */
+int earray_test_json_callback(void* user_data, json_event_t json_event, const void* data, size_t size)
+{
+    if(json_event == json_value_data) (*(int*)user_data)++;
+    if(json_event == json_parse_error) (*(int*)user_data) = -1000000;
+
+    return ELIBC_CONTINUE;
+}
+
+/*----------------------------------------------------------------------*/
+
+GTEST_TEST(elibc_earray_tests, earray_test_items)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    earray_t earray;
+    int idx, value;
+
+    earray_init(&earray, sizeof(int));
+
+    for(idx = 0; idx < EARRAY_TEST_SIZE; ++idx)
+    {
+        ASSERT_EQ(earray_append(&earray, &idx), ELIBC_SUCCESS);
+    }
+
+    ASSERT_EQ(earray_size(&earray), EARRAY_TEST_SIZE);
+    ASSERT_EQ(earray_is_inline(&earray), ELIBC_FALSE);
+
+    /* remove every second item */
+    for(idx = EARRAY_TEST_SIZE - 2; idx >= 0; idx -= 2)
+    {
+        ASSERT_EQ(earray_remove(&earray, idx), ELIBC_SUCCESS);
+    }
+
+    ASSERT_EQ(earray_size(&earray), EARRAY_TEST_SIZE / 2);
+    for(idx = 0; idx < EARRAY_TEST_SIZE / 2; ++idx)
+    {
+        value = *(int*)earray_at(&earray, idx);
+        ASSERT_EQ(value, idx * 2 + 1);
+    }
+
+    earray_free(&earray);
+}
+
+GTEST_TEST(elibc_earray_tests, earray_test_inline)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    earray_test_owner_t owner;
+    earray_t earray;
+    int idx, value;
+
+    estack_init_inline(&owner.estack, sizeof(int), owner.estack_items, sizeof(owner.estack_items));
+
+    /* inline items */
+    for(idx = 0; idx < EARRAY_TEST_INLINE_SIZE; ++idx)
+    {
+        ASSERT_EQ(estack_push(&owner.estack, idx), ELIBC_SUCCESS);
+    }
+
+    ASSERT_EQ(estack_is_inline(&owner.estack), ELIBC_TRUE);
+    ASSERT_TRUE(estack_top(&owner.estack) == (char*)&owner.estack_items[EARRAY_TEST_INLINE_SIZE - 1]);
+
+    /* items move to heap */
+    for(; idx < EARRAY_TEST_SIZE; ++idx)
+    {
+        ASSERT_EQ(estack_push(&owner.estack, idx), ELIBC_SUCCESS);
+    }
+
+    ASSERT_EQ(estack_is_inline(&owner.estack), ELIBC_FALSE);
+
+    for(idx = EARRAY_TEST_SIZE - 1; idx >= 0; --idx)
+    {
+        value = *(int*)estack_top(&owner.estack);
+        ASSERT_EQ(value, idx);
+        ASSERT_EQ(estack_pop(&owner.estack), ELIBC_SUCCESS);
+    }
+
+    /* heap memory is kept after reset */
+    estack_reset(&owner.estack);
+    ASSERT_EQ(estack_size(&owner.estack), 0);
+    ASSERT_EQ(estack_is_inline(&owner.estack), ELIBC_FALSE);
+
+    /* inline storage stays with owner after swap */
+    earray_init(&earray, sizeof(int));
+    ASSERT_EQ(earray_append(&earray, &idx), ELIBC_SUCCESS);
+
+    earray_swap(&owner.estack, &earray);
+    ASSERT_EQ(estack_size(&owner.estack), 1);
+    ASSERT_TRUE(owner.estack.inline_items == (char*)owner.estack_items);
+    ASSERT_TRUE(earray.inline_items == 0);
+
+    earray_free(&earray);
+    estack_free(&owner.estack);
+}
+
+GTEST_TEST(elibc_earray_tests, earray_test_inline_parser)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    json_parser_t json_parser;
+    ebuffer_t parse_buffer;
+    const char* shallow = "{\"a\":[1,{\"b\":[2]}]}";
+    char deep[200];
+    int values = 0, idx;
+
+    ebuffer_init(&parse_buffer);
+    json_init(&json_parser, earray_test_json_callback, &values);
+
+    /* shallow document uses inline stack */
+    ASSERT_EQ(json_begin(&json_parser, &parse_buffer), ELIBC_SUCCESS);
+    ASSERT_EQ(json_parse(&json_parser, shallow, strlen(shallow)), ELIBC_SUCCESS);
+    ASSERT_EQ(json_end(&json_parser), ELIBC_SUCCESS);
+    ASSERT_EQ(estack_is_inline(&json_parser.state_stack), ELIBC_TRUE);
+    ASSERT_EQ(values, 2);
+
+    /* deep document moves stack to heap */
+    for(idx = 0; idx < 100; ++idx)
+    {
+        deep[idx] = '[';
+        deep[199 - idx] = ']';
+    }
+
+    ASSERT_EQ(json_begin(&json_parser, &parse_buffer), ELIBC_SUCCESS);
+    ASSERT_EQ(json_parse(&json_parser, deep, sizeof(deep)), ELIBC_SUCCESS);
+    ASSERT_EQ(json_end(&json_parser), ELIBC_SUCCESS);
+    ASSERT_EQ(estack_is_inline(&json_parser.state_stack), ELIBC_FALSE);
+    ASSERT_EQ(values, 2);
+
+    json_close(&json_parser);
+    ebuffer_free(&parse_buffer);
+}
+
+/*----------------------------------------------------------------------*/
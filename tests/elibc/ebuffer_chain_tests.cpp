@@ -0,0 +1,261 @@
+/*
+    EBuffer chain unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+#define EBUFFER_CHAIN_TEST_SEGMENT_SIZE     64
+#define EBUFFER_CHAIN_TEST_SIZE             20000
+#define EBUFFER_CHAIN_TEST_IOVEC_COUNT      1024
+
+/*----------------------------------------------------------------------*/
+
+/* test data */
+void ebuffer_chain_test_fill(char* data, size_t data_size)
+{
+    size_t idx;
+
+    for(idx = 0; idx < data_size; ++idx)
+    {
+        data[idx] = (char)(idx * 7 + idx / 251);
+    }
+}
+
+/* compare chain with flat data using all access methods */
+void ebuffer_chain_test_check(ebuffer_chain_t* chain, const char* data, size_t data_size)
+{
+    ebuffer_iovec_t iovec[EBUFFER_CHAIN_TEST_IOVEC_COUNT];
+    ebuffer_t ebuff;
+    size_t idx, count, offset = 0;
+
+    ASSERT_EQ(ebuffer_chain_size(chain), data_size);
+
+    /* iovec */
+    count = ebuffer_chain_iovec(chain, iovec, EBUFFER_CHAIN_TEST_IOVEC_COUNT);
+    ASSERT_TRUE(count <= ebuffer_chain_view_count(chain));
+
+    for(idx = 0; idx < count; ++idx)
+    {
+        ASSERT_TRUE(iovec[idx].size > 0);
+        ASSERT_TRUE(offset + iovec[idx].size <= data_size);
+        ASSERT_BINARY_EQ(iovec[idx].base, data + offset, iovec[idx].size);
+
+        offset += iovec[idx].size;
+    }
+
+    ASSERT_EQ(offset, data_size);
+
+    /* flatten after existing data */
+    ebuffer_init(&ebuff);
+    ASSERT_EQ(ebuffer_append(&ebuff, "prefix", 6), ELIBC_SUCCESS);
+    ASSERT_EQ(ebuffer_chain_flatten(chain, &ebuff), ELIBC_SUCCESS);
+    ASSERT_EQ(ebuffer_pos(&ebuff), data_size + 6);
+    ASSERT_BINARY_EQ(ebuffer_data(&ebuff) + 6, data, data_size);
+    ebuffer_free(&ebuff);
+}
+
+/*----------------------------------------------------------------------*/
+/* chain tests */
+/*----------------------------------------------------------------------*/
+GTEST_TEST(elibc_ebuffer_chain_tests, ebuffer_chain_test_append)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    ebuffer_chain_t chain;
+    char* data;
+    char* ptr;
+    const char* first_segment;
+    ebuffer_iovec_t iovec;
+    size_t pos, part;
+
+    data = (char*)emalloc(EBUFFER_CHAIN_TEST_SIZE);
+    ASSERT_TRUE(data != 0);
+    ebuffer_chain_test_fill(data, EBUFFER_CHAIN_TEST_SIZE);
+
+    ebuffer_chain_init(&chain, EBUFFER_CHAIN_TEST_SEGMENT_SIZE);
+    ASSERT_EQ(ebuffer_chain_size(&chain), 0);
+    ASSERT_EQ(ebuffer_chain_iovec(&chain, &iovec, 1), 0);
+
+    /* different append sizes */
+    for(pos = 0, part = 0; pos < EBUFFER_CHAIN_TEST_SIZE; pos += part)
+    {
+        part = (pos * 13) % 151 + 1;
+        if(pos + part > EBUFFER_CHAIN_TEST_SIZE) part = EBUFFER_CHAIN_TEST_SIZE - pos;
+
+        if(part % 3 == 0)
+        {
+            ptr = ebuffer_chain_append_ptr(&chain, part);
+            ASSERT_TRUE(ptr != 0);
+            ememcpy(ptr, data + pos, part);
+
+        } else
+        {
+            ASSERT_EQ(ebuffer_chain_append(&chain, data + pos, part), ELIBC_SUCCESS);
+        }
+    }
+
+    ebuffer_chain_test_check(&chain, data, EBUFFER_CHAIN_TEST_SIZE);
+
+    /* appended data is never moved */
+    ASSERT_EQ(ebuffer_chain_iovec(&chain, &iovec, 1), 1);
+    first_segment = (const char*)iovec.base;
+    ASSERT_EQ(ebuffer_chain_append(&chain, data, EBUFFER_CHAIN_TEST_SIZE), ELIBC_SUCCESS);
+    ASSERT_EQ(ebuffer_chain_iovec(&chain, &iovec, 1), 1);
+    ASSERT_TRUE(first_segment == iovec.base);
+    ASSERT_EQ(ebuffer_chain_size(&chain), 2 * EBUFFER_CHAIN_TEST_SIZE);
+
+    /* reset and reuse */
+    ebuffer_chain_reset(&chain);
+    ASSERT_EQ(ebuffer_chain_size(&chain), 0);
+    ASSERT_EQ(ebuffer_chain_append(&chain, data, 100), ELIBC_SUCCESS);
+    ebuffer_chain_test_check(&chain, data, 100);
+
+    ebuffer_chain_free(&chain);
+    efree(data);
+}
+
+GTEST_TEST(elibc_ebuffer_chain_tests, ebuffer_chain_test_slice)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    ebuffer_chain_t chain;
+    ebuffer_chain_t slice;
+    ebuffer_chain_t joined;
+    char* data;
+    char read_buffer[300];
+    size_t offset, consumed;
+
+    data = (char*)emalloc(EBUFFER_CHAIN_TEST_SIZE);
+    ASSERT_TRUE(data != 0);
+    ebuffer_chain_test_fill(data, EBUFFER_CHAIN_TEST_SIZE);
+
+    ebuffer_chain_init(&chain, EBUFFER_CHAIN_TEST_SEGMENT_SIZE);
+    for(offset = 0; offset < 4000; offset += 100)
+    {
+        ASSERT_EQ(ebuffer_chain_append(&chain, data + offset, 100), ELIBC_SUCCESS);
+    }
+
+    /* slices and reads at every offset */
+    for(offset = 0; offset + sizeof(read_buffer) <= 4000; offset += 37)
+    {
+        ASSERT_EQ(ebuffer_chain_read(&chain, offset, read_buffer, sizeof(read_buffer)), ELIBC_SUCCESS);
+        ASSERT_BINARY_EQ(read_buffer, data + offset, sizeof(read_buffer));
+
+        ASSERT_EQ(ebuffer_chain_slice(&chain, offset, sizeof(read_buffer), &slice), ELIBC_SUCCESS);
+        ebuffer_chain_test_check(&slice, data + offset, sizeof(read_buffer));
+        ebuffer_chain_free(&slice);
+    }
+
+    ASSERT_EQ(ebuffer_chain_slice(&chain, 3990, 11, &slice), ELIBC_ERROR_ARGUMENT);
+    ASSERT_EQ(ebuffer_chain_read(&chain, 3990, read_buffer, 11), ELIBC_ERROR_ARGUMENT);
+
+    /* slice outlives chain */
+    ASSERT_EQ(ebuffer_chain_slice(&chain, 1000, 2000, &slice), ELIBC_SUCCESS);
+    ebuffer_chain_free(&chain);
+    ebuffer_chain_test_check(&slice, data + 1000, 2000);
+
+    /* appending to slice does not overwrite shared segments */
+    ASSERT_EQ(ebuffer_chain_slice(&slice, 0, 500, &chain), ELIBC_SUCCESS);
+    ASSERT_EQ(ebuffer_chain_append(&chain, data + 1500, 1000), ELIBC_SUCCESS);
+    ebuffer_chain_test_check(&chain, data + 1000, 1500);
+    ebuffer_chain_test_check(&slice, data + 1000, 2000);
+
+    /* join shares segments */
+    ebuffer_chain_init(&joined, 0);
+    ASSERT_EQ(ebuffer_chain_append_chain(&joined, &chain), ELIBC_SUCCESS);
+    ASSERT_EQ(ebuffer_chain_append_chain(&joined, &slice), ELIBC_SUCCESS);
+    ebuffer_chain_free(&chain);
+    ASSERT_EQ(ebuffer_chain_size(&joined), 3500);
+    ASSERT_EQ(ebuffer_chain_read(&joined, 1500, read_buffer, sizeof(read_buffer)), ELIBC_SUCCESS);
+    ASSERT_BINARY_EQ(read_buffer, data + 1000, sizeof(read_buffer));
+    ebuffer_chain_free(&joined);
+
+    /* consume from front */
+    for(consumed = 0; consumed < 2000; consumed += 77)
+    {
+        ebuffer_chain_test_check(&slice, data + 1000 + consumed, 2000 - consumed);
+        ASSERT_EQ(ebuffer_chain_consume(&slice, (consumed + 77 <= 2000) ? 77 : 2000 - consumed), ELIBC_SUCCESS);
+    }
+
+    ASSERT_EQ(ebuffer_chain_size(&slice), 0);
+    ASSERT_EQ(ebuffer_chain_view_count(&slice), 0);
+    ASSERT_EQ(ebuffer_chain_consume(&slice, 1), ELIBC_ERROR_ARGUMENT);
+
+    ebuffer_chain_free(&slice);
+    efree(data);
+}
+
+GTEST_TEST(elibc_ebuffer_chain_tests, ebuffer_chain_test_adopt)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    ebuffer_chain_t chain;
+    ebuffer_t ebuff;
+    char* data;
+    char* adopted;
+    json_encoder_t json_encoder;
+    ebuffer_iovec_t iovec[2];
+    int idx;
+
+    data = (char*)emalloc(1000);
+    ASSERT_TRUE(data != 0);
+    ebuffer_chain_test_fill(data, 1000);
+
+    ebuffer_chain_init(&chain, 0);
+
+    /* caller memory */
+    adopted = (char*)emalloc(400);
+    ASSERT_TRUE(adopted != 0);
+    ememcpy(adopted, data, 400);
+    ASSERT_EQ(ebuffer_chain_adopt(&chain, adopted, 400), ELIBC_SUCCESS);
+
+    /* ebuffer memory, free space is used for following appends */
+    ebuffer_init(&ebuff);
+    ASSERT_EQ(ebuffer_reserve(&ebuff, 1000), ELIBC_SUCCESS);
+    ASSERT_EQ(ebuffer_append(&ebuff, data + 400, 300), ELIBC_SUCCESS);
+    adopted = ebuffer_data(&ebuff);
+
+    ASSERT_EQ(ebuffer_chain_append_ebuffer(&chain, &ebuff), ELIBC_SUCCESS);
+    ASSERT_TRUE(ebuffer_data(&ebuff) == 0);
+    ASSERT_EQ(ebuffer_chain_append(&chain, data + 700, 300), ELIBC_SUCCESS);
+
+    ASSERT_EQ(ebuffer_chain_iovec(&chain, iovec, 2), 2);
+    ASSERT_TRUE(iovec[0].size == 400);
+    ASSERT_TRUE(iovec[1].base == adopted);
+    ebuffer_chain_test_check(&chain, data, 1000);
+
+    ebuffer_chain_reset(&chain);
+
+    /* encoder output moved to chain between calls */
+    json_encode_init(&json_encoder);
+    ASSERT_EQ(json_encode_begin(&json_encoder, &ebuff), ELIBC_SUCCESS);
+    ASSERT_EQ(json_encode_array_begin(&json_encoder, 0), ELIBC_SUCCESS);
+
+    for(idx = 0; idx < 100; ++idx)
+    {
+        ASSERT_EQ(json_encode_value_int(&json_encoder, 0, idx), ELIBC_SUCCESS);
+        if(idx % 10 == 9)
+        {
+            ASSERT_EQ(ebuffer_chain_append_ebuffer(&chain, &ebuff), ELIBC_SUCCESS);
+        }
+    }
+
+    ASSERT_EQ(json_encode_array_end(&json_encoder), ELIBC_SUCCESS);
+    ASSERT_EQ(json_encode_end(&json_encoder), ELIBC_SUCCESS);
+    ASSERT_EQ(ebuffer_chain_append_ebuffer(&chain, &ebuff), ELIBC_SUCCESS);
+    json_encode_close(&json_encoder);
+
+    ASSERT_EQ(ebuffer_chain_flatten(&chain, &ebuff), ELIBC_SUCCESS);
+    ASSERT_EQ(ebuffer_append_char(&ebuff, 0), ELIBC_SUCCESS);
+    ASSERT_EQ(ememcmp(ebuffer_data(&ebuff), "[0,1,2,3,4,5,6,7,8,9,10,", 24), 0);
+    ASSERT_EQ(ebuffer_pos(&ebuff), 292);
+    ASSERT_EQ(ebuffer_data(&ebuff)[290], ']');
+
+    ebuffer_free(&ebuff);
+    ebuffer_chain_free(&chain);
+    efree(data);
+}
+
+/*----------------------------------------------------------------------*/
@@ -0,0 +1,285 @@
+/*
+    EHashMap unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+#define EHASHMAP_TEST_SIZE          20000
+#define EHASHMAP_TEST_KEY_SIZE      32
+
+/*----------------------------------------------------------------------*/
+
+/* value stored in map */
+typedef struct
+{
+    euint32_t   key;
+    euint32_t   counter;
+    char        check[7];
+
+} ehashmap_test_value_t;
+
+/* hash with many collisions and long probe runs */
+euint64_t ehashmap_test_bad_hash(const euint8_t* key, size_t key_size, euint64_t seed)
+{
+    euint32_t value;
+
+    ememcpy(&value, key, sizeof(euint32_t));
+
+    return (euint64_t)(value % 61) << 7 | (value & 3);
+}
+
+/* byte string key from number */
+size_t ehashmap_test_key(euint32_t value, char* key)
+{
+    size_t key_size = value % EHASHMAP_TEST_KEY_SIZE;
+    size_t idx;
+
+    for(idx = 0; idx < key_size; ++idx)
+    {
+        key[idx] = (char)(value >> (idx % 4 * 8)) + (char)idx;
+    }
+
+    /* make key unique */
+    ememcpy(key + key_size, &value, sizeof(euint32_t));
+
+    return key_size + sizeof(euint32_t);
+}
+
+/* random inserts and removals compared with presence array */
+void ehashmap_test_random(ehashmap_t* ehashmap, ebool_t string_keys)
+{
+    ebool_t present[EHASHMAP_TEST_SIZE / 4];
+    ehashmap_test_value_t value;
+    ehashmap_test_value_t* stored;
+    char key_buffer[EHASHMAP_TEST_KEY_SIZE + sizeof(euint32_t)];
+    euint32_t state = 12345;
+    euint32_t key;
+    size_t key_size, count = 0;
+    ebool_t created;
+    int idx;
+
+    ememset(present, 0, sizeof(present));
+
+    for(idx = 0; idx < EHASHMAP_TEST_SIZE * 4; ++idx)
+    {
+        state = state * 1103515245 + 12345;
+        key = (state >> 8) % (EHASHMAP_TEST_SIZE / 4);
+
+        if(string_keys)
+        {
+            key_size = ehashmap_test_key(key, key_buffer);
+
+        } else
+        {
+            ememcpy(key_buffer, &key, sizeof(euint32_t));
+            key_size = sizeof(euint32_t);
+        }
+
+        switch((state >> 4) % 3)
+        {
+        case 0:
+            /* set */
+            value.key = key;
+            value.counter = 1;
+            ememset(value.check, (char)key, sizeof(value.check));
+
+            ASSERT_EQ(ehashmap_set(ehashmap, key_buffer, key_size, &value), ELIBC_SUCCESS);
+            if(!present[key]) count++;
+            present[key] = ELIBC_TRUE;
+            break;
+
+        case 1:
+            /* update in place */
+            stored = (ehashmap_test_value_t*)ehashmap_set_ptr(ehashmap, key_buffer, key_size, &created);
+            ASSERT_TRUE(stored != 0);
+            ASSERT_EQ(created, present[key] ? ELIBC_FALSE : ELIBC_TRUE);
+
+            if(created)
+            {
+                ASSERT_EQ(stored->key, 0);
+                ASSERT_EQ(stored->counter, 0);
+
+                stored->key = key;
+                ememset(stored->check, (char)key, sizeof(stored->check));
+                count++;
+            }
+
+            stored->counter++;
+            present[key] = ELIBC_TRUE;
+            break;
+
+        default:
+            /* remove */
+            ASSERT_EQ(ehashmap_remove(ehashmap, key_buffer, key_size), present[key] ? ELIBC_SUCCESS : ELIBC_ERROR_NOT_FOUND);
+            if(present[key]) count--;
+            present[key] = ELIBC_FALSE;
+            break;
+        }
+
+        ASSERT_EQ(ehashmap_size(ehashmap), count);
+    }
+
+    /* check all keys */
+    for(key = 0; key < EHASHMAP_TEST_SIZE / 4; ++key)
+    {
+        if(string_keys)
+        {
+            key_size = ehashmap_test_key(key, key_buffer);
+
+        } else
+        {
+            ememcpy(key_buffer, &key, sizeof(euint32_t));
+            key_size = sizeof(euint32_t);
+        }
+
+        stored = (ehashmap_test_value_t*)ehashmap_get(ehashmap, key_buffer, key_size);
+        ASSERT_EQ(stored != 0, present[key] ? true : false);
+        ASSERT_EQ(ehashmap_has_key(ehashmap, key_buffer, key_size), present[key]);
+
+        if(stored)
+        {
+            ASSERT_EQ(stored->key, key);
+            ASSERT_TRUE(stored->counter > 0);
+            ASSERT_EQ(stored->check[6], (char)key);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------*/
+/* hash map tests */
+/*----------------------------------------------------------------------*/
+GTEST_TEST(elibc_ehashmap_tests, ehashmap_test_fixed_keys)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    ehashmap_t ehashmap;
+
+    ehashmap_init(&ehashmap, sizeof(euint32_t), sizeof(ehashmap_test_value_t));
+    ASSERT_EQ(ehashmap_size(&ehashmap), 0);
+    ASSERT_TRUE(ehashmap_get(&ehashmap, "abcd", 4) == 0);
+    ASSERT_EQ(ehashmap_remove(&ehashmap, "abcd", 4), ELIBC_ERROR_NOT_FOUND);
+
+    ehashmap_test_random(&ehashmap, ELIBC_FALSE);
+
+    /* reset keeps memory */
+    ehashmap_reset(&ehashmap);
+    ASSERT_EQ(ehashmap_size(&ehashmap), 0);
+    ehashmap_test_random(&ehashmap, ELIBC_FALSE);
+
+    ehashmap_free(&ehashmap);
+
+    /* colliding hashes */
+    ehashmap_init(&ehashmap, sizeof(euint32_t), sizeof(ehashmap_test_value_t));
+    ehashmap_set_hash(&ehashmap, ehashmap_test_bad_hash, 0);
+
+    ehashmap_test_random(&ehashmap, ELIBC_FALSE);
+
+    ehashmap_free(&ehashmap);
+}
+
+GTEST_TEST(elibc_ehashmap_tests, ehashmap_test_string_keys)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    ehashmap_t ehashmap;
+    int value;
+
+    ehashmap_init(&ehashmap, 0, sizeof(ehashmap_test_value_t));
+    ehashmap_test_random(&ehashmap, ELIBC_TRUE);
+    ehashmap_free(&ehashmap);
+
+    /* seed changes hash but not content */
+    ehashmap_init(&ehashmap, 0, sizeof(int));
+    ehashmap_set_hash(&ehashmap, hash_fast64_seed, 0x1234567890ULL);
+
+    value = 1;
+    ASSERT_EQ(ehashmap_set(&ehashmap, "key", 3, &value), ELIBC_SUCCESS);
+    value = 2;
+    ASSERT_EQ(ehashmap_set(&ehashmap, "key2", 4, &value), ELIBC_SUCCESS);
+    value = 3;
+    ASSERT_EQ(ehashmap_set(&ehashmap, 0, 0, &value), ELIBC_SUCCESS);
+
+    /* prefixes are different keys */
+    ASSERT_TRUE(ehashmap_get(&ehashmap, "ke", 2) == 0);
+    ASSERT_EQ(*(int*)ehashmap_get(&ehashmap, "key", 3), 1);
+    ASSERT_EQ(*(int*)ehashmap_get(&ehashmap, "key2", 4), 2);
+    ASSERT_EQ(*(int*)ehashmap_get(&ehashmap, "", 0), 3);
+
+    /* replace */
+    value = 4;
+    ASSERT_EQ(ehashmap_set(&ehashmap, "key", 3, &value), ELIBC_SUCCESS);
+    ASSERT_EQ(*(int*)ehashmap_get(&ehashmap, "key", 3), 4);
+    ASSERT_EQ(ehashmap_size(&ehashmap), 3);
+
+    ehashmap_free(&ehashmap);
+}
+
+GTEST_TEST(elibc_ehashmap_tests, ehashmap_test_iterate)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    ehashmap_t ehashmap;
+    ehashmap_iter_t iter;
+    euint32_t* visits;
+    euint32_t key, value;
+    size_t count;
+    int round, has_item;
+
+    visits = (euint32_t*)emalloc(EHASHMAP_TEST_SIZE * sizeof(euint32_t));
+    ASSERT_TRUE(visits != 0);
+
+    for(round = 0; round < 2; ++round)
+    {
+        ehashmap_init(&ehashmap, sizeof(euint32_t), sizeof(euint32_t));
+        if(round > 0) ehashmap_set_hash(&ehashmap, ehashmap_test_bad_hash, 0);
+
+        /* empty map */
+        ASSERT_EQ(ehashmap_first(&ehashmap, &iter), ELIBC_FALSE);
+
+        ASSERT_EQ(ehashmap_reserve(&ehashmap, EHASHMAP_TEST_SIZE), ELIBC_SUCCESS);
+
+        for(key = 0; key < EHASHMAP_TEST_SIZE; ++key)
+        {
+            value = key * 3;
+            ASSERT_EQ(ehashmap_set(&ehashmap, &key, sizeof(key), &value), ELIBC_SUCCESS);
+        }
+
+        /* every item once, remove even keys while iterating */
+        ememset(visits, 0, EHASHMAP_TEST_SIZE * sizeof(euint32_t));
+        count = 0;
+
+        has_item = ehashmap_first(&ehashmap, &iter);
+        while(has_item)
+        {
+            ASSERT_EQ(ehashmap_iter_key_size(&ehashmap, &iter), sizeof(euint32_t));
+            key = *(const euint32_t*)ehashmap_iter_key(&ehashmap, &iter);
+            ASSERT_TRUE(key < EHASHMAP_TEST_SIZE);
+            ASSERT_EQ(*(euint32_t*)ehashmap_iter_value(&ehashmap, &iter), key * 3);
+
+            visits[key]++;
+            count++;
+
+            if(key % 2 == 0)
+                has_item = ehashmap_remove_iter(&ehashmap, &iter);
+            else
+                has_item = ehashmap_next(&ehashmap, &iter);
+        }
+
+        ASSERT_EQ(count, EHASHMAP_TEST_SIZE);
+        ASSERT_EQ(ehashmap_size(&ehashmap), EHASHMAP_TEST_SIZE / 2);
+
+        for(key = 0; key < EHASHMAP_TEST_SIZE; ++key)
+        {
+            ASSERT_EQ(visits[key], 1);
+            ASSERT_EQ(ehashmap_has_key(&ehashmap, &key, sizeof(key)), (key % 2) ? ELIBC_TRUE : ELIBC_FALSE);
+        }
+
+        ehashmap_free(&ehashmap);
+    }
+
+    efree(visits);
+}
+
+/*----------------------------------------------------------------------*/
@@ -438,3 +438,95 @@ GTEST_TEST(elibc_elist_tests, elist_test_sort)
     elist_free(&elist);
 }
 
+
+GTEST_TEST(elibc_elist_tests, elist_test_sort_stable)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    elist_t elist;
+    eliter_t iter = ELIST_NULL_ITERATOR;
+    eliter_t first_iter, last_iter;
+    int item_data[2];
+    int* first_item;
+    int* last_item;
+    size_t idx, item_count;
+    int err;
+
+    /* items with key and insertion order */
+    elist_init(&elist, sizeof(item_data));
+
+    for(idx = 0; idx < ELIST_TEST_SIZE; ++idx)
+    {
+        /* few distinct keys */
+        item_data[0] = (int)((idx * 7919) % 13);
+        item_data[1] = (int)idx;
+
+        /* append item */
+        err = elist_append(&elist, iter, item_data, &iter);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+
+        if(idx == 0) first_iter = iter;
+    }
+
+    last_iter = iter;
+
+    /* item pointers before sort */
+    first_item = (int*)elist_item(&elist, first_iter);
+    last_item = (int*)elist_item(&elist, last_iter);
+
+    /* sort by key */
+    err = esort_list(&elist, eless_int_func);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    /* items are not moved */
+    ASSERT_TRUE(elist_item(&elist, first_iter) == first_item);
+    ASSERT_TRUE(elist_item(&elist, last_iter) == last_item);
+    ASSERT_EQ(first_item[1], 0);
+    ASSERT_EQ(last_item[1], (int)(ELIST_TEST_SIZE - 1));
+
+    /* validate order, equal keys keep insertion order */
+    err = elist_head(&elist, &iter);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    item_count = 0;
+    while(iter != ELIST_NULL_ITERATOR)
+    {
+        ememcpy(item_data, elist_item(&elist, iter), sizeof(item_data));
+
+        /* next item */
+        err = elist_next(&elist, iter, &iter);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+
+        item_count++;
+
+        /* validate order */
+        if(iter != ELIST_NULL_ITERATOR)
+        {
+            int* next_data = (int*)elist_item(&elist, iter);
+
+            ASSERT_TRUE(item_data[0] <= next_data[0]);
+            if(item_data[0] == next_data[0])
+            {
+                ASSERT_TRUE(item_data[1] < next_data[1]);
+            }
+        }
+    }
+
+    ASSERT_EQ(item_count, ELIST_TEST_SIZE);
+
+    /* validate backward links */
+    err = elist_tail(&elist, &iter);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    item_count = 0;
+    while(iter != ELIST_NULL_ITERATOR)
+    {
+        item_count++;
+
+        /* previous item */
+        err = elist_previous(&elist, iter, &iter);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+    }
+
+    ASSERT_EQ(item_count, ELIST_TEST_SIZE);
+
+    elist_free(&elist);
+}
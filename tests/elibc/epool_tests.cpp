@@ -0,0 +1,442 @@
+/*
+    EPool unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+#define EPOOL_TEST_OBJECTS          100
+#define EPOOL_TEST_SLAB             16
+#define EPOOL_TEST_ITEMS            20000
+#define EPOOL_TEST_THREADS          2
+#define EPOOL_TEST_ROUNDS           5
+#define EPOOL_TEST_POOLS            (2 * EPOOL_THREAD_POOLS)
+
+/*----------------------------------------------------------------------*/
+
+/* odd sized object */
+typedef struct
+{
+    euint32_t   producer;
+    euint32_t   value;
+    char        check[13];
+
+} epool_test_object_t;
+
+/* count object init and free calls */
+int epool_test_object_init(void* object, void* arg)
+{
+    ememset(object, 0, sizeof(epool_test_object_t));
+    eatomic_add((eatomic_t*)arg, 1);
+
+    return ELIBC_SUCCESS;
+}
+
+void epool_test_object_free(void* object, void* arg)
+{
+    eatomic_add((eatomic_t*)arg, -1);
+}
+
+/* producer thread sending pool objects to other thread */
+typedef struct
+{
+    epool_t*        epool;
+    equeue_mpmc_t*  equeue;
+    euint32_t       producer;
+    int             failed;
+
+} epool_test_producer_t;
+
+void epool_test_producer(void* arg)
+{
+    epool_test_producer_t* test = (epool_test_producer_t*)arg;
+    epool_test_object_t* object;
+    euint32_t value;
+
+    for(value = 0; value < EPOOL_TEST_ITEMS; ++value)
+    {
+        object = (epool_test_object_t*)epool_alloc(test->epool);
+        if(object == 0)
+        {
+            test->failed = 1;
+            break;
+        }
+
+        object->producer = test->producer;
+        object->value = value;
+        ememset(object->check, (char)value, sizeof(object->check));
+
+        while(!equeue_mpmc_push(test->equeue, &object))
+        {
+            ethread_yield();
+        }
+    }
+
+    epool_thread_detach(test->epool);
+}
+
+/* free pool from other thread */
+void epool_test_free(void* arg)
+{
+    epool_free((epool_t*)arg);
+}
+
+/* parser callbacks */
+int epool_test_json_callback(void* user_data, json_event_t json_event, const void* data, size_t size)
+{
+    if(json_event == json_value_data || json_event == json_value_string) (*(int*)user_data)++;
+    if(json_event == json_parse_error) (*(int*)user_data) = -1000;
+
+    return ELIBC_CONTINUE;
+}
+
+int epool_test_xml_callback(void* user_data, xml_event_t xml_event, const void* data, size_t size)
+{
+    if(xml_event == xml_tag_begin) (*(int*)user_data)++;
+    if(xml_event == xml_parse_error) (*(int*)user_data) = -1000;
+
+    return ELIBC_CONTINUE;
+}
+
+int epool_test_http_callback(void* user_data, http_event_t http_event, const void* data, size_t size)
+{
+    if(http_event == http_event_header_name) (*(int*)user_data)++;
+    if(http_event == http_event_syntax_error) (*(int*)user_data) = -1000;
+
+    return ELIBC_CONTINUE;
+}
+
+/*----------------------------------------------------------------------*/
+/* pool tests */
+/*----------------------------------------------------------------------*/
+GTEST_TEST(elibc_epool_tests, epool_test_objects)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    epool_test_object_t* objects[EPOOL_TEST_OBJECTS];
+    epool_test_object_t* object;
+    epool_t epool;
+    eatomic_t count = 0;
+    int idx, other;
+
+    ASSERT_EQ(epool_init(&epool, sizeof(epool_test_object_t), EPOOL_TEST_SLAB), ELIBC_SUCCESS);
+    ASSERT_EQ(epool_object_size(&epool), sizeof(epool_test_object_t));
+    ASSERT_EQ(epool_set_object_funcs(&epool, epool_test_object_init, epool_test_object_free, (void*)&count), ELIBC_SUCCESS);
+
+    /* objects are aligned and don't overlap */
+    for(idx = 0; idx < EPOOL_TEST_OBJECTS; ++idx)
+    {
+        objects[idx] = (epool_test_object_t*)epool_alloc(&epool);
+        ASSERT_TRUE(objects[idx] != 0);
+        ASSERT_EQ(((size_t)objects[idx]) % 16, 0);
+
+        objects[idx]->value = (euint32_t)idx;
+        ememset(objects[idx]->check, (char)idx, sizeof(objects[idx]->check));
+    }
+
+    for(idx = 0; idx < EPOOL_TEST_OBJECTS; ++idx)
+    {
+        ASSERT_EQ(objects[idx]->value, (euint32_t)idx);
+        ASSERT_EQ(objects[idx]->check[12], (char)idx);
+
+        for(other = idx + 1; other < EPOOL_TEST_OBJECTS; ++other)
+        {
+            ASSERT_TRUE(objects[idx] != objects[other]);
+        }
+    }
+
+    /* whole slabs are initialized */
+    ASSERT_EQ(eatomic_load(&count), ((EPOOL_TEST_OBJECTS + EPOOL_TEST_SLAB - 1) / EPOOL_TEST_SLAB) * EPOOL_TEST_SLAB);
+    ASSERT_EQ(epool_set_object_funcs(&epool, 0, 0, 0), ELIBC_ERROR_INVALID_STATE);
+
+    /* released object is reused with its content */
+    epool_release(&epool, objects[7]);
+    object = (epool_test_object_t*)epool_alloc(&epool);
+    ASSERT_TRUE(object == objects[7]);
+    ASSERT_EQ(object->value, 7);
+
+    /* no new slabs after all objects are released */
+    for(idx = 0; idx < EPOOL_TEST_OBJECTS; ++idx)
+    {
+        epool_release(&epool, objects[idx]);
+    }
+
+    for(idx = 0; idx < EPOOL_TEST_OBJECTS; ++idx)
+    {
+        objects[idx] = (epool_test_object_t*)epool_alloc(&epool);
+        ASSERT_TRUE(objects[idx] != 0);
+    }
+
+    ASSERT_EQ(eatomic_load(&count), ((EPOOL_TEST_OBJECTS + EPOOL_TEST_SLAB - 1) / EPOOL_TEST_SLAB) * EPOOL_TEST_SLAB);
+
+    for(idx = 0; idx < EPOOL_TEST_OBJECTS; ++idx)
+    {
+        epool_release(&epool, objects[idx]);
+    }
+
+    /* all objects are freed with pool */
+    epool_free(&epool);
+    ASSERT_EQ(eatomic_load(&count), 0);
+}
+
+GTEST_TEST(elibc_epool_tests, epool_test_many_pools)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    epool_t pools[EPOOL_TEST_POOLS];
+    epool_t freed;
+    void* objects[EPOOL_TEST_POOLS];
+    void* object;
+    eatomic_t count = 0;
+    ethread_t thread;
+    int idx, evicted;
+
+    for(idx = 0; idx < EPOOL_TEST_POOLS; ++idx)
+    {
+        ASSERT_EQ(epool_init(&pools[idx], sizeof(epool_test_object_t), EPOOL_TEST_SLAB), ELIBC_SUCCESS);
+        ASSERT_EQ(epool_set_object_funcs(&pools[idx], epool_test_object_init, epool_test_object_free, (void*)&count), ELIBC_SUCCESS);
+    }
+
+    /* pool freed by other thread while current thread still remembers its heap */
+    ASSERT_EQ(epool_init(&freed, sizeof(epool_test_object_t), EPOOL_TEST_SLAB), ELIBC_SUCCESS);
+    object = epool_alloc(&freed);
+    ASSERT_TRUE(object != 0);
+    epool_release(&freed, object);
+
+    ASSERT_EQ(ethread_create(&thread, epool_test_free, &freed), ELIBC_SUCCESS);
+    ASSERT_EQ(ethread_join(thread), ELIBC_SUCCESS);
+
+    /* twice as many pools as thread remembers, every heap is replaced */
+    for(idx = 0; idx < EPOOL_TEST_POOLS; ++idx)
+    {
+        objects[idx] = epool_alloc(&pools[idx]);
+        ASSERT_TRUE(objects[idx] != 0);
+        epool_release(&pools[idx], objects[idx]);
+    }
+
+    /* replaced heaps of live pools are given to other threads */
+    for(idx = 0, evicted = -1; idx < EPOOL_TEST_POOLS && evicted == -1; ++idx)
+    {
+        if(pools[idx].detached != 0) evicted = idx;
+    }
+
+    ASSERT_NE(evicted, -1);
+
+    /* its objects are reused without new slab */
+    object = epool_alloc(&pools[evicted]);
+    ASSERT_TRUE(object == objects[evicted]);
+    ASSERT_TRUE(pools[evicted].detached == 0);
+    ASSERT_EQ(eatomic_load(&count), EPOOL_TEST_POOLS * EPOOL_TEST_SLAB);
+    epool_release(&pools[evicted], object);
+
+    for(idx = 0; idx < EPOOL_TEST_POOLS; ++idx)
+    {
+        epool_free(&pools[idx]);
+    }
+
+    ASSERT_EQ(eatomic_load(&count), 0);
+}
+
+GTEST_TEST(elibc_epool_tests, epool_test_threads)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    epool_test_producer_t producers[EPOOL_TEST_THREADS];
+    ethread_t threads[EPOOL_TEST_THREADS];
+    euint32_t last[EPOOL_TEST_THREADS];
+    epool_test_object_t* object;
+    equeue_mpmc_t equeue;
+    epool_t epool;
+    eatomic_t count = 0;
+    int idx, received = 0, failed = 0;
+
+    ASSERT_EQ(epool_init(&epool, sizeof(epool_test_object_t), EPOOL_TEST_SLAB), ELIBC_SUCCESS);
+    ASSERT_EQ(epool_set_object_funcs(&epool, epool_test_object_init, epool_test_object_free, (void*)&count), ELIBC_SUCCESS);
+    ASSERT_EQ(equeue_mpmc_init(&equeue, sizeof(void*), 64), ELIBC_SUCCESS);
+
+    for(idx = 0; idx < EPOOL_TEST_THREADS; ++idx)
+    {
+        producers[idx].epool = &epool;
+        producers[idx].equeue = &equeue;
+        producers[idx].producer = (euint32_t)idx;
+        producers[idx].failed = 0;
+        last[idx] = 0;
+
+        ASSERT_EQ(ethread_create(&threads[idx], epool_test_producer, &producers[idx]), ELIBC_SUCCESS);
+    }
+
+    /* objects are released by consumer thread */
+    while(received < EPOOL_TEST_ITEMS * EPOOL_TEST_THREADS)
+    {
+        if(!equeue_mpmc_pop(&equeue, &object))
+        {
+            ethread_yield();
+            continue;
+        }
+
+        if(object->producer >= EPOOL_TEST_THREADS || object->check[0] != (char)object->value ||
+           object->check[12] != (char)object->value || (received > 0 && object->value < last[object->producer])) failed = 1;
+
+        last[object->producer] = object->value;
+        received++;
+
+        epool_release(&epool, object);
+    }
+
+    for(idx = 0; idx < EPOOL_TEST_THREADS; ++idx)
+    {
+        ASSERT_EQ(ethread_join(threads[idx]), ELIBC_SUCCESS);
+        ASSERT_EQ(producers[idx].failed, 0);
+    }
+
+    ASSERT_EQ(failed, 0);
+
+    /* released objects went back to producers */
+    ASSERT_TRUE(eatomic_load(&count) < EPOOL_TEST_ITEMS / 10);
+
+    /* heaps left by producers are reused */
+    object = (epool_test_object_t*)epool_alloc(&epool);
+    ASSERT_TRUE(object != 0);
+    epool_release(&epool, object);
+
+    equeue_mpmc_free(&equeue);
+    epool_free(&epool);
+    ASSERT_EQ(eatomic_load(&count), 0);
+}
+
+/*----------------------------------------------------------------------*/
+/* parser pools */
+/*----------------------------------------------------------------------*/
+GTEST_TEST(elibc_epool_tests, epool_test_json_pool)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    const char json[] = "{\"a\":[1,2,{\"b\":\"text\"}],\"c\":true}";
+    json_parser_t* json_parser;
+    json_parser_t* first = 0;
+    void* stack = 0;
+    epool_t epool;
+    int round, values;
+
+    ASSERT_EQ(json_pool_init(&epool, 4), ELIBC_SUCCESS);
+
+    for(round = 0; round < EPOOL_TEST_ROUNDS; ++round)
+    {
+        values = 0;
+
+        json_parser = json_pool_get(&epool, epool_test_json_callback, &values);
+        ASSERT_TRUE(json_parser != 0);
+
+        /* the same parser and memory are reused */
+        if(round == 0)
+        {
+            first = json_parser;
+            stack = json_parser->state_stack.items;
+        }
+
+        ASSERT_TRUE(json_parser == first);
+        ASSERT_TRUE(json_parser->state_stack.items == stack);
+
+        ASSERT_EQ(json_parse(json_parser, json, sizeof(json) - 1), ELIBC_SUCCESS);
+        ASSERT_EQ(json_end(json_parser), ELIBC_SUCCESS);
+        ASSERT_EQ(values, 4);
+
+        /* leave parser in the middle of document */
+        ASSERT_EQ(json_parse(json_parser, json, 10), ELIBC_SUCCESS);
+
+        json_pool_put(&epool, json_parser);
+    }
+
+    epool_free(&epool);
+}
+
+GTEST_TEST(elibc_epool_tests, epool_test_xml_pool)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    const char xml[] = "<?xml version=\"1.0\"?><root><a x=\"1\">text</a><b/></root>";
+    xml_parser_t* xml_parsers[EPOOL_TEST_ROUNDS];
+    epool_t epool;
+    int idx, tags[EPOOL_TEST_ROUNDS];
+
+    ASSERT_EQ(xml_pool_init(&epool, 2), ELIBC_SUCCESS);
+
+    /* parsers from few slabs used at the same time */
+    for(idx = 0; idx < EPOOL_TEST_ROUNDS; ++idx)
+    {
+        tags[idx] = 0;
+        xml_parsers[idx] = xml_pool_get(&epool, epool_test_xml_callback, &tags[idx]);
+        ASSERT_TRUE(xml_parsers[idx] != 0);
+        ASSERT_EQ(xml_parse(xml_parsers[idx], xml, 20), ELIBC_SUCCESS);
+    }
+
+    for(idx = 0; idx < EPOOL_TEST_ROUNDS; ++idx)
+    {
+        ASSERT_EQ(xml_parse(xml_parsers[idx], xml + 20, sizeof(xml) - 21), ELIBC_SUCCESS);
+        ASSERT_EQ(xml_end(xml_parsers[idx]), ELIBC_SUCCESS);
+        ASSERT_EQ(tags[idx], 3);
+
+        xml_pool_put(&epool, xml_parsers[idx]);
+    }
+
+    epool_free(&epool);
+}
+
+GTEST_TEST(elibc_epool_tests, epool_test_http_pool)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    const char request[] = "GET /index.html HTTP/1.1\r\nHost: example.com\r\nX-Test: 1\r\n\r\n";
+    http_param_t parameters[2];
+    http_parser_t* http_parser;
+    http_form_t* http_form;
+    epool_t parser_pool, form_pool;
+    int round, headers;
+    size_t used;
+
+    ASSERT_EQ(http_parse_pool_init(&parser_pool, 0), ELIBC_SUCCESS);
+    ASSERT_EQ(http_form_pool_init(&form_pool, 0), ELIBC_SUCCESS);
+
+    for(round = 0; round < EPOOL_TEST_ROUNDS; ++round)
+    {
+        headers = 0;
+
+        http_parser = http_parse_pool_get(&parser_pool, http_parse_request, epool_test_http_callback, &headers);
+        ASSERT_TRUE(http_parser != 0);
+
+        ASSERT_EQ(http_parse(http_parser, request, sizeof(request) - 1, &used), ELIBC_SUCCESS);
+        ASSERT_EQ(http_parse_ready(http_parser), ELIBC_TRUE);
+        ASSERT_EQ(headers, 2);
+
+        http_parse_pool_put(&parser_pool, http_parser);
+    }
+
+    /* form encodes to pooled buffer */
+    http_param_init(&parameters[0]);
+    parameters[0].name = "a";
+    parameters[0].value = "1";
+    parameters[0].value_size = 1;
+
+    http_param_init(&parameters[1]);
+    parameters[1].name = "b";
+    parameters[1].value = "text";
+    parameters[1].value_size = 4;
+
+    for(round = 0; round < EPOOL_TEST_ROUNDS; ++round)
+    {
+        http_form = http_form_pool_get(&form_pool);
+        ASSERT_TRUE(http_form != 0);
+        ASSERT_EQ(http_form->parameter_count, 0);
+
+        ASSERT_EQ(http_form_pool_encode_init(http_form, parameters, 2), ELIBC_SUCCESS);
+        ASSERT_EQ(http_form_content_size(http_form), 10);
+
+        http_form_pool_put(&form_pool, http_form);
+    }
+
+    epool_free(&form_pool);
+    epool_free(&parser_pool);
+}
+
+/*----------------------------------------------------------------------*/
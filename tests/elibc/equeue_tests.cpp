@@ -0,0 +1,296 @@
+/*
+    EQueue unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+#define EQUEUE_TEST_CAPACITY        64
+#define EQUEUE_TEST_ITEMS           200000
+#define EQUEUE_TEST_THREADS         3
+
+/*----------------------------------------------------------------------*/
+
+/* odd sized item */
+typedef struct
+{
+    euint32_t   producer;
+    euint32_t   value;
+    char        check[5];
+
+} equeue_test_item_t;
+
+void equeue_test_item_set(equeue_test_item_t* item, euint32_t producer, euint32_t value)
+{
+    item->producer = producer;
+    item->value = value;
+    ememset(item->check, (char)value, sizeof(item->check));
+}
+
+bool equeue_test_item_check(const equeue_test_item_t* item)
+{
+    size_t idx;
+
+    for(idx = 0; idx < sizeof(item->check); ++idx)
+    {
+        if(item->check[idx] != (char)item->value) return false;
+    }
+
+    return true;
+}
+
+/* spsc producer thread */
+void equeue_test_spsc_producer(void* arg)
+{
+    equeue_spsc_t* equeue = (equeue_spsc_t*)arg;
+    equeue_test_item_t item;
+    euint32_t value;
+
+    for(value = 0; value < EQUEUE_TEST_ITEMS; ++value)
+    {
+        equeue_test_item_set(&item, 0, value);
+
+        while(!equeue_spsc_push(equeue, &item))
+        {
+            ethread_yield();
+        }
+    }
+}
+
+/* mpmc producer and consumer threads */
+typedef struct
+{
+    equeue_mpmc_t*  equeue;
+    euint32_t       producer;
+    eatomic_t*      popped;
+    euint64_t       sum;
+    int             failed;
+
+} equeue_test_mpmc_t;
+
+void equeue_test_mpmc_producer(void* arg)
+{
+    equeue_test_mpmc_t* test = (equeue_test_mpmc_t*)arg;
+    equeue_test_item_t item;
+    euint32_t value;
+
+    for(value = 0; value < EQUEUE_TEST_ITEMS; ++value)
+    {
+        equeue_test_item_set(&item, test->producer, value);
+
+        while(!equeue_mpmc_push(test->equeue, &item))
+        {
+            ethread_yield();
+        }
+    }
+}
+
+void equeue_test_mpmc_consumer(void* arg)
+{
+    equeue_test_mpmc_t* test = (equeue_test_mpmc_t*)arg;
+    equeue_test_item_t item;
+    euint32_t last[EQUEUE_TEST_THREADS];
+    int idx;
+
+    for(idx = 0; idx < EQUEUE_TEST_THREADS; ++idx)
+    {
+        last[idx] = 0;
+    }
+
+    while(eatomic_load(test->popped) < EQUEUE_TEST_ITEMS * EQUEUE_TEST_THREADS)
+    {
+        if(!equeue_mpmc_pop(test->equeue, &item))
+        {
+            ethread_yield();
+            continue;
+        }
+
+        eatomic_add(test->popped, 1);
+
+        /* items from the same producer keep order */
+        if(!equeue_test_item_check(&item) || item.producer >= EQUEUE_TEST_THREADS ||
+           (last[item.producer] > 0 && item.value < last[item.producer])) test->failed = 1;
+
+        last[item.producer] = item.value;
+        test->sum += item.value;
+    }
+}
+
+/*----------------------------------------------------------------------*/
+/* queue tests */
+/*----------------------------------------------------------------------*/
+GTEST_TEST(elibc_equeue_tests, equeue_test_spsc)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    equeue_spsc_t equeue;
+    equeue_test_item_t item;
+    euint32_t idx, round;
+
+    ASSERT_EQ(equeue_spsc_init(&equeue, sizeof(equeue_test_item_t), EQUEUE_TEST_CAPACITY - 3), ELIBC_SUCCESS);
+    ASSERT_EQ(equeue_spsc_capacity(&equeue), EQUEUE_TEST_CAPACITY);
+    ASSERT_EQ(equeue_spsc_item_size(&equeue), sizeof(equeue_test_item_t));
+
+    /* wrap around few times */
+    for(round = 0; round < 3; ++round)
+    {
+        ASSERT_EQ(equeue_spsc_size(&equeue), 0);
+        ASSERT_TRUE(equeue_spsc_front(&equeue) == 0);
+        ASSERT_EQ(equeue_spsc_pop(&equeue, &item), ELIBC_FALSE);
+
+        /* fill */
+        for(idx = 0; idx < EQUEUE_TEST_CAPACITY; ++idx)
+        {
+            equeue_test_item_set(&item, round, idx);
+            ASSERT_EQ(equeue_spsc_push(&equeue, &item), ELIBC_TRUE);
+        }
+
+        ASSERT_EQ(equeue_spsc_push(&equeue, &item), ELIBC_FALSE);
+        ASSERT_EQ(equeue_spsc_size(&equeue), EQUEUE_TEST_CAPACITY);
+
+        /* first item can be dropped without copy */
+        ASSERT_TRUE(equeue_spsc_front(&equeue) != 0);
+        ASSERT_EQ(((equeue_test_item_t*)equeue_spsc_front(&equeue))->value, 0);
+        ASSERT_EQ(equeue_spsc_pop(&equeue, 0), ELIBC_TRUE);
+
+        /* drain in order */
+        for(idx = 1; idx < EQUEUE_TEST_CAPACITY; ++idx)
+        {
+            ASSERT_EQ(equeue_spsc_pop(&equeue, &item), ELIBC_TRUE);
+            ASSERT_EQ(item.producer, round);
+            ASSERT_EQ(item.value, idx);
+            ASSERT_TRUE(equeue_test_item_check(&item));
+        }
+
+        /* shift start position */
+        for(idx = 0; idx <= round; ++idx)
+        {
+            ASSERT_EQ(equeue_spsc_push(&equeue, &item), ELIBC_TRUE);
+            ASSERT_EQ(equeue_spsc_pop(&equeue, &item), ELIBC_TRUE);
+        }
+    }
+
+    equeue_spsc_free(&equeue);
+}
+
+GTEST_TEST(elibc_equeue_tests, equeue_test_spsc_threads)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    equeue_spsc_t equeue;
+    equeue_test_item_t item;
+    ethread_t producer;
+    euint32_t value = 0;
+    int failed = 0;
+
+    ASSERT_EQ(equeue_spsc_init(&equeue, sizeof(equeue_test_item_t), EQUEUE_TEST_CAPACITY), ELIBC_SUCCESS);
+    ASSERT_EQ(ethread_create(&producer, equeue_test_spsc_producer, &equeue), ELIBC_SUCCESS);
+
+    /* all items in order */
+    while(value < EQUEUE_TEST_ITEMS)
+    {
+        if(!equeue_spsc_pop(&equeue, &item))
+        {
+            ethread_yield();
+            continue;
+        }
+
+        if(item.value != value || !equeue_test_item_check(&item)) failed = 1;
+        value++;
+    }
+
+    ethread_join(producer);
+
+    ASSERT_EQ(failed, 0);
+    ASSERT_EQ(equeue_spsc_size(&equeue), 0);
+
+    equeue_spsc_free(&equeue);
+}
+
+GTEST_TEST(elibc_equeue_tests, equeue_test_mpmc)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    equeue_mpmc_t equeue;
+    equeue_test_item_t item;
+    euint32_t idx, round;
+
+    ASSERT_EQ(equeue_mpmc_init(&equeue, sizeof(equeue_test_item_t), EQUEUE_TEST_CAPACITY), ELIBC_SUCCESS);
+    ASSERT_EQ(equeue_mpmc_capacity(&equeue), EQUEUE_TEST_CAPACITY);
+    ASSERT_EQ(equeue_mpmc_item_size(&equeue), sizeof(equeue_test_item_t));
+
+    for(round = 0; round < 3; ++round)
+    {
+        ASSERT_EQ(equeue_mpmc_size(&equeue), 0);
+        ASSERT_EQ(equeue_mpmc_pop(&equeue, &item), ELIBC_FALSE);
+
+        /* fill */
+        for(idx = 0; idx < EQUEUE_TEST_CAPACITY; ++idx)
+        {
+            equeue_test_item_set(&item, round, idx);
+            ASSERT_EQ(equeue_mpmc_push(&equeue, &item), ELIBC_TRUE);
+        }
+
+        ASSERT_EQ(equeue_mpmc_push(&equeue, &item), ELIBC_FALSE);
+        ASSERT_EQ(equeue_mpmc_size(&equeue), EQUEUE_TEST_CAPACITY);
+
+        /* drain in order */
+        for(idx = 0; idx < EQUEUE_TEST_CAPACITY; ++idx)
+        {
+            ASSERT_EQ(equeue_mpmc_pop(&equeue, &item), ELIBC_TRUE);
+            ASSERT_EQ(item.producer, round);
+            ASSERT_EQ(item.value, idx);
+            ASSERT_TRUE(equeue_test_item_check(&item));
+        }
+    }
+
+    equeue_mpmc_free(&equeue);
+}
+
+GTEST_TEST(elibc_equeue_tests, equeue_test_mpmc_threads)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    equeue_mpmc_t equeue;
+    equeue_test_mpmc_t producers[EQUEUE_TEST_THREADS];
+    equeue_test_mpmc_t consumers[EQUEUE_TEST_THREADS];
+    ethread_t threads[2 * EQUEUE_TEST_THREADS];
+    eatomic_t popped = 0;
+    euint64_t sum = 0;
+    int idx;
+
+    ASSERT_EQ(equeue_mpmc_init(&equeue, sizeof(equeue_test_item_t), EQUEUE_TEST_CAPACITY), ELIBC_SUCCESS);
+
+    for(idx = 0; idx < EQUEUE_TEST_THREADS; ++idx)
+    {
+        producers[idx].equeue = consumers[idx].equeue = &equeue;
+        producers[idx].producer = consumers[idx].producer = idx;
+        producers[idx].popped = consumers[idx].popped = &popped;
+        producers[idx].sum = consumers[idx].sum = 0;
+        producers[idx].failed = consumers[idx].failed = 0;
+
+        ASSERT_EQ(ethread_create(threads + idx, equeue_test_mpmc_consumer, consumers + idx), ELIBC_SUCCESS);
+        ASSERT_EQ(ethread_create(threads + EQUEUE_TEST_THREADS + idx, equeue_test_mpmc_producer, producers + idx), ELIBC_SUCCESS);
+    }
+
+    for(idx = 0; idx < 2 * EQUEUE_TEST_THREADS; ++idx)
+    {
+        ethread_join(threads[idx]);
+    }
+
+    /* every item popped once */
+    for(idx = 0; idx < EQUEUE_TEST_THREADS; ++idx)
+    {
+        ASSERT_EQ(consumers[idx].failed, 0);
+        sum += consumers[idx].sum;
+    }
+
+    ASSERT_EQ(eatomic_load(&popped), EQUEUE_TEST_ITEMS * EQUEUE_TEST_THREADS);
+    ASSERT_EQ(sum, (euint64_t)EQUEUE_TEST_THREADS * EQUEUE_TEST_ITEMS * (EQUEUE_TEST_ITEMS - 1) / 2);
+    ASSERT_EQ(equeue_mpmc_size(&equeue), 0);
+
+    equeue_mpmc_free(&equeue);
+}
+
+/*----------------------------------------------------------------------*/
@@ -0,0 +1,225 @@
+/*
+    ERing unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+#define ERING_TEST_CAPACITY         1000
+#define ERING_TEST_SIZE             100000
+
+/*----------------------------------------------------------------------*/
+
+/* stream byte at position */
+#define ERING_TEST_BYTE(pos)        ((char)((pos) * 31 + (pos) / 253))
+
+/* count json values */
+int ering_test_json_callback(void* user_data, json_event_t json_event, const void* data, size_t size)
+{
+    if(json_event == json_value_data) (*(int*)user_data)++;
+    if(json_event == json_parse_error) (*(int*)user_data) = -1000000;
+
+    return ELIBC_CONTINUE;
+}
+
+/* stream data through ring in uneven parts and check order */
+void ering_test_stream(ering_t* ering)
+{
+    char buffer[700];
+    char* ptr;
+    size_t written = 0, read = 0;
+    size_t size, part, idx;
+    int step = 0;
+
+    while(read < ERING_TEST_SIZE)
+    {
+        step++;
+
+        /* write */
+        part = (step * 37) % sizeof(buffer);
+        if(part > ERING_TEST_SIZE - written) part = ERING_TEST_SIZE - written;
+
+        if(step % 2)
+        {
+            for(idx = 0; idx < part; ++idx) buffer[idx] = ERING_TEST_BYTE(written + idx);
+            written += ering_write(ering, buffer, part);
+
+        } else
+        {
+            ptr = ering_write_ptr(ering, &size);
+            ASSERT_TRUE(size <= ering_space(ering));
+            if(part > size) part = size;
+
+            for(idx = 0; idx < part; ++idx) ptr[idx] = ERING_TEST_BYTE(written + idx);
+            ASSERT_EQ(ering_commit(ering, part), ELIBC_SUCCESS);
+            written += part;
+        }
+
+        ASSERT_TRUE(ering_size(ering) <= ering_capacity(ering));
+
+        /* read */
+        part = (step * 53) % sizeof(buffer);
+
+        if(step % 3)
+        {
+            part = ering_read(ering, buffer, part);
+            for(idx = 0; idx < part; ++idx) ASSERT_EQ(buffer[idx], ERING_TEST_BYTE(read + idx));
+            read += part;
+
+        } else
+        {
+            ptr = ering_read_ptr(ering, &size);
+            if(part > size) part = size;
+
+            for(idx = 0; idx < part; ++idx) ASSERT_EQ(ptr[idx], ERING_TEST_BYTE(read + idx));
+            ASSERT_EQ(ering_consume(ering, part), ELIBC_SUCCESS);
+            read += part;
+        }
+    }
+
+    ASSERT_EQ(written, ERING_TEST_SIZE);
+    ASSERT_EQ(ering_size(ering), 0);
+}
+
+/*----------------------------------------------------------------------*/
+/* ring tests */
+/*----------------------------------------------------------------------*/
+GTEST_TEST(elibc_ering_tests, ering_test_ring)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    ering_t ering;
+    char data[8];
+    char* ptr;
+    size_t size;
+
+    ASSERT_EQ(ering_init(&ering, ERING_TEST_CAPACITY), ELIBC_SUCCESS);
+    ASSERT_EQ(ering_capacity(&ering), 1024);
+    ASSERT_EQ(ering_is_mirrored(&ering), ELIBC_FALSE);
+
+    ering_test_stream(&ering);
+
+    /* regions are split at the end of buffer */
+    ering_reset(&ering);
+    ASSERT_EQ(ering_commit(&ering, 1020), ELIBC_SUCCESS);
+    ASSERT_EQ(ering_consume(&ering, 1016), ELIBC_SUCCESS);
+    ASSERT_EQ(ering_write(&ering, "abcdefgh", 8), 8);
+
+    ptr = ering_read_ptr(&ering, &size);
+    ASSERT_EQ(size, 8);
+    ASSERT_TRUE(ptr == ering.data + 1016);
+    ASSERT_EQ(ering_consume(&ering, 4), ELIBC_SUCCESS);
+
+    ptr = ering_read_ptr(&ering, &size);
+    ASSERT_EQ(size, 4);
+    ASSERT_BINARY_EQ(ptr, "abcd", 4);
+    ASSERT_EQ(ering_read(&ering, data, sizeof(data)), 8);
+    ASSERT_BINARY_EQ(data, "abcdefgh", 8);
+
+    /* empty ring starts from the beginning */
+    ptr = ering_write_ptr(&ering, &size);
+    ASSERT_TRUE(ptr == ering.data);
+    ASSERT_EQ(size, 1024);
+
+    /* full ring */
+    ASSERT_EQ(ering_commit(&ering, 1025), ELIBC_ERROR_ARGUMENT);
+    ASSERT_EQ(ering_commit(&ering, 1024), ELIBC_SUCCESS);
+    ASSERT_EQ(ering_write(&ering, "a", 1), 0);
+    ASSERT_EQ(ering_consume(&ering, 1025), ELIBC_ERROR_ARGUMENT);
+
+    ering_free(&ering);
+}
+
+GTEST_TEST(elibc_ering_tests, ering_test_mirrored)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    ering_t ering;
+    char* ptr;
+    size_t size, capacity;
+
+    ASSERT_EQ(ering_init_mirrored(&ering, ERING_TEST_CAPACITY), ELIBC_SUCCESS);
+    ASSERT_EQ(ering_is_mirrored(&ering), ELIBC_TRUE);
+    ASSERT_TRUE(ering_capacity(&ering) >= 1024);
+
+    capacity = ering_capacity(&ering);
+    ASSERT_EQ(capacity & (capacity - 1), 0);
+
+    ering_test_stream(&ering);
+
+    /* data across the end of buffer is continuous */
+    ering_reset(&ering);
+    ASSERT_EQ(ering_commit(&ering, capacity - 4), ELIBC_SUCCESS);
+    ASSERT_EQ(ering_consume(&ering, capacity - 8), ELIBC_SUCCESS);
+    ASSERT_EQ(ering_write(&ering, "0123456789", 10), 10);
+
+    ptr = ering_read_ptr(&ering, &size);
+    ASSERT_EQ(size, 14);
+    ASSERT_BINARY_EQ(ptr + 4, "0123456789", 10);
+
+    /* the same memory is mapped twice */
+    ASSERT_BINARY_EQ(ering.data, "456789", 6);
+
+    ptr = ering_write_ptr(&ering, &size);
+    ASSERT_EQ(size, capacity - 14);
+
+    ering_free(&ering);
+}
+
+GTEST_TEST(elibc_ering_tests, ering_test_parser)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    ering_t ering;
+    json_parser_t json_parser;
+    ebuffer_t parse_buffer;
+    char* ptr;
+    size_t size, pos = 0, part;
+    int values = 0, idx, step = 0;
+    char text[16];
+    ebuffer_t json;
+
+    /* json array of numbers */
+    ebuffer_init(&json);
+    ASSERT_EQ(ebuffer_append_char(&json, '['), ELIBC_SUCCESS);
+    for(idx = 0; idx < 2000; ++idx)
+    {
+        size = (size_t)esnprintf(text, sizeof(text), "%s%d", idx ? "," : "", idx);
+        ASSERT_EQ(ebuffer_append(&json, text, size), ELIBC_SUCCESS);
+    }
+    ASSERT_EQ(ebuffer_append_char(&json, ']'), ELIBC_SUCCESS);
+
+    ebuffer_init(&parse_buffer);
+    json_init(&json_parser, ering_test_json_callback, &values);
+    ASSERT_EQ(json_begin(&json_parser, &parse_buffer), ELIBC_SUCCESS);
+
+    /* network reads of different sizes, parser works on ring memory */
+    ASSERT_EQ(ering_init_mirrored(&ering, 256), ELIBC_SUCCESS);
+
+    while(pos < ebuffer_pos(&json) || ering_size(&ering) > 0)
+    {
+        step++;
+
+        part = (step * 41) % 300;
+        if(part > ebuffer_pos(&json) - pos) part = ebuffer_pos(&json) - pos;
+        pos += ering_write(&ering, ebuffer_data(&json) + pos, part);
+
+        /* parse part of available data */
+        ptr = ering_read_ptr(&ering, &size);
+        if(step % 4 && size > 1) size = size * 3 / 4;
+
+        ASSERT_EQ(json_parse(&json_parser, ptr, size), ELIBC_SUCCESS);
+        ASSERT_EQ(ering_consume(&ering, size), ELIBC_SUCCESS);
+    }
+
+    ASSERT_EQ(json_end(&json_parser), ELIBC_SUCCESS);
+    ASSERT_EQ(values, 2000);
+
+    json_close(&json_parser);
+    ering_free(&ering);
+    ebuffer_free(&parse_buffer);
+    ebuffer_free(&json);
+}
+
+/*----------------------------------------------------------------------*/
@@ -11,6 +11,53 @@
 
 /*----------------------------------------------------------------------*/
 
+/* record sorted by key only */
+typedef struct
+{
+    euint32_t   key;
+    euint32_t   value;
+    euint32_t   check;
+
+} esort_test_record_t;
+
+#define ESORT_TYPED_NAME            esort_test_record
+#define ESORT_TYPED_TYPE            esort_test_record_t
+#define ESORT_TYPED_LESS(l, r)      ((l).key < (r).key)
+#include "../../src/elibc/core/esort_typed.h"
+
+int esort_test_record_less(const void* left_item, const void* right_item)
+{
+    return ((const esort_test_record_t*)left_item)->key < ((const esort_test_record_t*)right_item)->key;
+}
+
+/* fill test pattern */
+void esort_test_pattern(int* items, size_t item_count, int pattern)
+{
+    euint32_t state = 12345;
+    size_t idx;
+
+    for(idx = 0; idx < item_count; ++idx)
+    {
+        state = state * 1103515245 + 12345;
+
+        switch(pattern)
+        {
+        case 0: items[idx] = (int)(state >> 1); break;                                  /* random */
+        case 1: items[idx] = (int)idx; break;                                           /* sorted */
+        case 2: items[idx] = (int)(item_count - idx); break;                            /* reverse */
+        case 3: items[idx] = 7; break;                                                  /* equal */
+        case 4: items[idx] = (int)(state >> 16) % 4; break;                             /* few unique */
+        case 5: items[idx] = (int)((idx < item_count / 2) ? idx : item_count - idx); break; /* organ pipe */
+        case 6: items[idx] = (int)(idx % 64); break;                                    /* sawtooth */
+        default: items[idx] = (int)((idx % 100 == 0) ? (state >> 1) : idx); break;      /* almost sorted */
+        }
+    }
+}
+
+#define ESORT_TEST_PATTERNS         8
+
+/*----------------------------------------------------------------------*/
+
 GTEST_TEST(elibc_esort_tests, esort_test_reverse)
 {
     ELIB_GTEST_MEMORY_LEAK_DETECTOR;
@@ -83,6 +130,7 @@ GTEST_TEST(elibc_esort_tests, esort_test_strings)
     ELIB_GTEST_MEMORY_LEAK_DETECTOR;
 
     char** sort_buffer;
+    char** typed_buffer;
     size_t idx;
     int err;
 
@@ -105,9 +153,16 @@ GTEST_TEST(elibc_esort_tests, esort_test_strings)
         sort_buffer[idx][ESORT_TEST_STRING_SIZE-1] = 0;
     }
 
+    /* copy for typed sort */
+    typed_buffer = (char**)emalloc(sizeof(char*)*ESORT_TEST_SIZE);
+    ASSERT_TRUE(typed_buffer != 0);
+    ememcpy(typed_buffer, sort_buffer, sizeof(char*)*ESORT_TEST_SIZE);
+
     /* sort */
     err = esort((char*)sort_buffer, sizeof(char*), ESORT_TEST_SIZE, eless_str_func, 0);
     ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = esort_str(typed_buffer, ESORT_TEST_SIZE);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
 
     /* validate and free */
     for(idx = 0; idx < ESORT_TEST_SIZE; ++idx)
@@ -118,11 +173,255 @@ GTEST_TEST(elibc_esort_tests, esort_test_strings)
             ASSERT_TRUE(err <= 0);
         }
 
+        ASSERT_TRUE(sort_buffer[idx] == typed_buffer[idx]);
+
         efree(sort_buffer[idx]);
     }
 
-    /* release buffer */
+    /* release buffers */
+    efree(sort_buffer);
+    efree(typed_buffer);
+}
+
+GTEST_TEST(elibc_esort_tests, esort_test_patterns)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    int* sort_buffer;
+    int* typed_buffer;
+    size_t idx, item_count;
+    int pattern, err;
+
+    /* reserve arrays */
+    sort_buffer = (int*)emalloc(sizeof(int)*ESORT_TEST_SIZE);
+    ASSERT_TRUE(sort_buffer != 0);
+    typed_buffer = (int*)emalloc(sizeof(int)*ESORT_TEST_SIZE);
+    ASSERT_TRUE(typed_buffer != 0);
+
+    for(pattern = 0; pattern < ESORT_TEST_PATTERNS; ++pattern)
+    {
+        for(item_count = 0; item_count <= ESORT_TEST_SIZE; item_count = item_count * 3 + 1)
+        {
+            esort_test_pattern(sort_buffer, item_count, pattern);
+            ememcpy(typed_buffer, sort_buffer, sizeof(int)*item_count);
+
+            /* generic and typed sorts */
+            err = esort((char*)sort_buffer, sizeof(int), item_count, eless_int_func, 0);
+            ASSERT_EQ(err, ELIBC_SUCCESS);
+            err = esort_int(typed_buffer, item_count);
+            ASSERT_EQ(err, ELIBC_SUCCESS);
+
+            /* validate */
+            for(idx = 0; idx + 1 < item_count; ++idx)
+            {
+                ASSERT_TRUE(sort_buffer[idx] <= sort_buffer[idx + 1]);
+            }
+
+            ASSERT_BINARY_EQ(sort_buffer, typed_buffer, sizeof(int)*item_count);
+        }
+    }
+
+    /* release buffers */
+    efree(sort_buffer);
+    efree(typed_buffer);
+}
+
+GTEST_TEST(elibc_esort_tests, esort_test_typed)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    esort_test_record_t* records;
+    esort_test_record_t* typed_records;
+    euint64_t* values64;
+    double* values_double;
+    void** values_ptr;
+    euint32_t sum, typed_sum;
+    size_t idx;
+    int err;
+
+    /* reserve arrays */
+    records = (esort_test_record_t*)emalloc(sizeof(esort_test_record_t)*ESORT_TEST_SIZE);
+    ASSERT_TRUE(records != 0);
+    typed_records = (esort_test_record_t*)emalloc(sizeof(esort_test_record_t)*ESORT_TEST_SIZE);
+    ASSERT_TRUE(typed_records != 0);
+    values64 = (euint64_t*)emalloc(sizeof(euint64_t)*ESORT_TEST_SIZE);
+    ASSERT_TRUE(values64 != 0);
+    values_double = (double*)emalloc(sizeof(double)*ESORT_TEST_SIZE);
+    ASSERT_TRUE(values_double != 0);
+    values_ptr = (void**)emalloc(sizeof(void*)*ESORT_TEST_SIZE);
+    ASSERT_TRUE(values_ptr != 0);
+
+    /* fill items, many duplicate keys */
+    for(idx = 0; idx < ESORT_TEST_SIZE; ++idx)
+    {
+        records[idx].key = (euint32_t)((idx * 2654435761u) % 1000);
+        records[idx].value = (euint32_t)idx;
+        records[idx].check = records[idx].key ^ records[idx].value;
+
+        values64[idx] = (euint64_t)records[idx].key << 40 | (euint64_t)(ESORT_TEST_SIZE - idx);
+        values_double[idx] = (double)records[idx].key - 0.5 * (double)idx;
+        values_ptr[idx] = (char*)records + records[idx].key;
+    }
+
+    ememcpy(typed_records, records, sizeof(esort_test_record_t)*ESORT_TEST_SIZE);
+
+    /* 12 bytes items */
+    err = esort((char*)records, sizeof(esort_test_record_t), ESORT_TEST_SIZE, esort_test_record_less, 0);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = esort_test_record(typed_records, ESORT_TEST_SIZE);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = esort_uint64(values64, ESORT_TEST_SIZE);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = esort_double(values_double, ESORT_TEST_SIZE);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = esort_ptr(values_ptr, ESORT_TEST_SIZE);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    /* validate order and that records are moved as a whole */
+    sum = typed_sum = 0;
+    for(idx = 0; idx < ESORT_TEST_SIZE; ++idx)
+    {
+        ASSERT_EQ(records[idx].check, records[idx].key ^ records[idx].value);
+        ASSERT_EQ(typed_records[idx].check, typed_records[idx].key ^ typed_records[idx].value);
+        ASSERT_EQ(records[idx].key, typed_records[idx].key);
+
+        sum += records[idx].value;
+        typed_sum += typed_records[idx].value;
+
+        if(idx + 1 < ESORT_TEST_SIZE)
+        {
+            ASSERT_TRUE(records[idx].key <= records[idx + 1].key);
+            ASSERT_TRUE(values64[idx] < values64[idx + 1]);
+            ASSERT_TRUE(values_double[idx] <= values_double[idx + 1]);
+            ASSERT_TRUE((char*)values_ptr[idx] <= (char*)values_ptr[idx + 1]);
+        }
+    }
+
+    ASSERT_EQ(sum, typed_sum);
+
+    /* release buffers */
+    efree(records);
+    efree(typed_records);
+    efree(values64);
+    efree(values_double);
+    efree(values_ptr);
+}
+
+
+GTEST_TEST(elibc_esort_tests, esort_test_radix)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    euint32_t* values32;
+    euint64_t* values64;
+    euint64_t* records;
+    euint64_t state = 88172645463325252ULL;
+    size_t idx, item_count;
+    int err;
+
+    /* reserve arrays, records are key and insertion order pairs */
+    values32 = (euint32_t*)emalloc(sizeof(euint32_t)*ESORT_TEST_SIZE);
+    ASSERT_TRUE(values32 != 0);
+    values64 = (euint64_t*)emalloc(sizeof(euint64_t)*ESORT_TEST_SIZE);
+    ASSERT_TRUE(values64 != 0);
+    records = (euint64_t*)emalloc(2*sizeof(euint64_t)*ESORT_TEST_SIZE);
+    ASSERT_TRUE(records != 0);
+
+    for(item_count = 0; item_count <= ESORT_TEST_SIZE; item_count = item_count * 5 + 1)
+    {
+        for(idx = 0; idx < item_count; ++idx)
+        {
+            /* xorshift */
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+
+            values32[idx] = (euint32_t)(state >> 32);
+            values64[idx] = (idx % 3 == 0) ? (state & 0xFF00FF) : state;
+
+            /* few distinct keys for stability check */
+            records[2 * idx] = (state % 17) << 48;
+            records[2 * idx + 1] = idx;
+        }
+
+        err = esort_radix32(values32, item_count, 0);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+        err = esort_radix64(values64, item_count, 0);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+        err = esort_radix_records((char*)records, 2*sizeof(euint64_t), item_count, 0, sizeof(euint64_t), 0);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+
+        /* validate */
+        for(idx = 0; idx + 1 < item_count; ++idx)
+        {
+            ASSERT_TRUE(values32[idx] <= values32[idx + 1]);
+            ASSERT_TRUE(values64[idx] <= values64[idx + 1]);
+            ASSERT_TRUE(records[2 * idx] <= records[2 * idx + 2]);
+
+            if(records[2 * idx] == records[2 * idx + 2])
+            {
+                ASSERT_TRUE(records[2 * idx + 1] < records[2 * idx + 3]);
+            }
+        }
+    }
+
+    /* release buffers */
+    efree(values32);
+    efree(values64);
+    efree(records);
+}
+
+GTEST_TEST(elibc_esort_tests, esort_test_parallel)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    int* sort_buffer;
+    int* typed_buffer;
+    size_t idx, item_count;
+    unsigned int thread_count;
+    int pattern, err;
+
+    /* large enough to be split */
+    item_count = 16 * ESORT_TEST_SIZE;
+
+    /* reserve arrays */
+    sort_buffer = (int*)emalloc(sizeof(int)*item_count);
+    ASSERT_TRUE(sort_buffer != 0);
+    typed_buffer = (int*)emalloc(sizeof(int)*item_count);
+    ASSERT_TRUE(typed_buffer != 0);
+
+    for(pattern = 0; pattern < ESORT_TEST_PATTERNS; ++pattern)
+    {
+        for(thread_count = 0; thread_count <= 7; thread_count += (thread_count < 4) ? 1 : 3)
+        {
+            esort_test_pattern(sort_buffer, item_count, pattern);
+            ememcpy(typed_buffer, sort_buffer, sizeof(int)*item_count);
+
+            /* sort */
+            err = esort_parallel((char*)sort_buffer, sizeof(int), item_count, eless_int_func, thread_count);
+            ASSERT_EQ(err, ELIBC_SUCCESS);
+            err = esort_int(typed_buffer, item_count);
+            ASSERT_EQ(err, ELIBC_SUCCESS);
+
+            /* the same result as single threaded sort */
+            ASSERT_BINARY_EQ(sort_buffer, typed_buffer, sizeof(int)*item_count);
+        }
+    }
+
+    /* small arrays are sorted in calling thread */
+    esort_test_pattern(sort_buffer, ESORT_TEST_SIZE, 0);
+    err = esort_parallel((char*)sort_buffer, sizeof(int), ESORT_TEST_SIZE, eless_int_func, 4);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    for(idx = 0; idx + 1 < ESORT_TEST_SIZE; ++idx)
+    {
+        ASSERT_TRUE(sort_buffer[idx] <= sort_buffer[idx + 1]);
+    }
+
+    /* release buffers */
     efree(sort_buffer);
+    efree(typed_buffer);
 }
 
 /*----------------------------------------------------------------------*/
@@ -0,0 +1,220 @@
+/*
+    EThreadPool unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+#define ETHREADPOOL_TEST_TASKS          2000
+#define ETHREADPOOL_TEST_RANGE          100000
+
+/*----------------------------------------------------------------------*/
+
+/* task counting calls */
+void ethreadpool_test_count(void* arg)
+{
+    eatomic_add((eatomic_t*)arg, 1);
+}
+
+/* task squaring its slot */
+typedef struct
+{
+    eint64_t    value;
+    eint64_t    result;
+
+} ethreadpool_test_item_t;
+
+void ethreadpool_test_square(void* arg)
+{
+    ethreadpool_test_item_t* item = (ethreadpool_test_item_t*)arg;
+
+    item->result = item->value * item->value;
+}
+
+/* range marking visited indexes */
+void ethreadpool_test_range(void* arg, size_t begin, size_t end)
+{
+    euint32_t* visits = (euint32_t*)arg;
+    size_t idx;
+
+    for(idx = begin; idx < end; ++idx)
+    {
+        visits[idx]++;
+    }
+}
+
+/* recursive fibonacci with nested groups */
+typedef struct
+{
+    ethreadpool_t*  ethreadpool;
+    int             n;
+    eint64_t        result;
+
+} ethreadpool_test_fib_t;
+
+void ethreadpool_test_fib(void* arg)
+{
+    ethreadpool_test_fib_t* fib = (ethreadpool_test_fib_t*)arg;
+    ethreadpool_test_fib_t left, right;
+    ethreadpool_group_t group;
+
+    if(fib->n < 2)
+    {
+        fib->result = fib->n;
+        return;
+    }
+
+    left.ethreadpool = right.ethreadpool = fib->ethreadpool;
+    left.n = fib->n - 1;
+    right.n = fib->n - 2;
+
+    ethreadpool_group_init(&group, fib->ethreadpool);
+    ethreadpool_group_run(&group, ethreadpool_test_fib, &left);
+    ethreadpool_test_fib(&right);
+    ethreadpool_group_wait(&group);
+
+    fib->result = left.result + right.result;
+}
+
+/*----------------------------------------------------------------------*/
+/* thread pool tests */
+/*----------------------------------------------------------------------*/
+GTEST_TEST(elibc_ethreadpool_tests, ethreadpool_test_submit)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    ethreadpool_t ethreadpool;
+    eatomic_t counter;
+    unsigned int thread_count;
+    int idx;
+
+    for(thread_count = 0; thread_count <= 4; ++thread_count)
+    {
+        ASSERT_EQ(ethreadpool_init(&ethreadpool, thread_count), ELIBC_SUCCESS);
+        ASSERT_TRUE(ethreadpool_thread_count(&ethreadpool) > 0);
+
+        counter = 0;
+        for(idx = 0; idx < ETHREADPOOL_TEST_TASKS; ++idx)
+        {
+            ASSERT_EQ(ethreadpool_submit(&ethreadpool, ethreadpool_test_count, (void*)&counter), ELIBC_SUCCESS);
+        }
+
+        /* free waits for submitted tasks */
+        ethreadpool_free(&ethreadpool);
+
+        ASSERT_EQ(eatomic_load(&counter), ETHREADPOOL_TEST_TASKS);
+    }
+}
+
+GTEST_TEST(elibc_ethreadpool_tests, ethreadpool_test_group)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    ethreadpool_t ethreadpool;
+    ethreadpool_group_t group;
+    ethreadpool_test_item_t* items;
+    int idx, round;
+
+    items = (ethreadpool_test_item_t*)emalloc(ETHREADPOOL_TEST_TASKS * sizeof(ethreadpool_test_item_t));
+    ASSERT_TRUE(items != 0);
+
+    ASSERT_EQ(ethreadpool_init(&ethreadpool, 4), ELIBC_SUCCESS);
+    ASSERT_EQ(ethreadpool_thread_count(&ethreadpool), 4);
+
+    /* group can be reused after wait */
+    ethreadpool_group_init(&group, &ethreadpool);
+    for(round = 0; round < 3; ++round)
+    {
+        for(idx = 0; idx < ETHREADPOOL_TEST_TASKS; ++idx)
+        {
+            items[idx].value = idx + round;
+            items[idx].result = 0;
+
+            ASSERT_EQ(ethreadpool_group_run(&group, ethreadpool_test_square, items + idx), ELIBC_SUCCESS);
+        }
+
+        ethreadpool_group_wait(&group);
+
+        for(idx = 0; idx < ETHREADPOOL_TEST_TASKS; ++idx)
+        {
+            ASSERT_EQ(items[idx].result, (eint64_t)(idx + round) * (idx + round));
+        }
+    }
+
+    /* waiting for empty group */
+    ethreadpool_group_wait(&group);
+
+    ethreadpool_free(&ethreadpool);
+    efree(items);
+}
+
+GTEST_TEST(elibc_ethreadpool_tests, ethreadpool_test_nested)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    ethreadpool_t ethreadpool;
+    ethreadpool_test_fib_t fib;
+    unsigned int thread_count;
+
+    /* nested waits must not block even with single worker */
+    for(thread_count = 1; thread_count <= 4; thread_count += 3)
+    {
+        ASSERT_EQ(ethreadpool_init(&ethreadpool, thread_count), ELIBC_SUCCESS);
+
+        fib.ethreadpool = &ethreadpool;
+        fib.n = 20;
+        fib.result = 0;
+
+        ethreadpool_test_fib(&fib);
+        ASSERT_EQ(fib.result, 6765);
+
+        ethreadpool_free(&ethreadpool);
+    }
+}
+
+GTEST_TEST(elibc_ethreadpool_tests, ethreadpool_test_parallel_for)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    static const size_t grain_sizes[] = { 0, 1, 7, 1000, ETHREADPOOL_TEST_RANGE * 2 };
+
+    ethreadpool_t ethreadpool;
+    euint32_t* visits;
+    size_t idx, grain;
+
+    visits = (euint32_t*)emalloc(ETHREADPOOL_TEST_RANGE * sizeof(euint32_t));
+    ASSERT_TRUE(visits != 0);
+
+    ASSERT_EQ(ethreadpool_init(&ethreadpool, 4), ELIBC_SUCCESS);
+
+    for(grain = 0; grain < sizeof(grain_sizes) / sizeof(grain_sizes[0]); ++grain)
+    {
+        ememset(visits, 0, ETHREADPOOL_TEST_RANGE * sizeof(euint32_t));
+
+        /* every index exactly once */
+        ethreadpool_parallel_for(&ethreadpool, 0, ETHREADPOOL_TEST_RANGE, grain_sizes[grain], ethreadpool_test_range, visits);
+
+        for(idx = 0; idx < ETHREADPOOL_TEST_RANGE; ++idx)
+        {
+            ASSERT_EQ(visits[idx], 1);
+        }
+
+        /* sub range */
+        ethreadpool_parallel_for(&ethreadpool, 10, 20, grain_sizes[grain], ethreadpool_test_range, visits);
+
+        for(idx = 0; idx < ETHREADPOOL_TEST_RANGE; ++idx)
+        {
+            ASSERT_EQ(visits[idx], (idx >= 10 && idx < 20) ? 2u : 1u);
+        }
+    }
+
+    /* empty range */
+    ethreadpool_parallel_for(&ethreadpool, 5, 5, 0, ethreadpool_test_range, visits);
+    ASSERT_EQ(visits[5], 1);
+
+    ethreadpool_free(&ethreadpool);
+    efree(visits);
+}
+
+/*----------------------------------------------------------------------*/
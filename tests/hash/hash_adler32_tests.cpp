@@ -0,0 +1,75 @@
+/*
+    Adler-32 unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+GTEST_TEST(hash_adler32_tests, hash_adler32_vectors_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    euint8_t data[20000];
+    size_t idx;
+    int impl;
+
+    for(idx = 0; idx < sizeof(data); ++idx)
+    {
+        data[idx] = (euint8_t)(255 - (idx * 31 + 7) % 7);
+    }
+
+    /* all implementations supported by cpu */
+    for(impl = hash_adler32_impl_portable; impl <= hash_adler32_impl_avx2; ++impl)
+    {
+        if(hash_adler32_set_impl((hash_adler32_impl_t)impl) != ELIBC_SUCCESS) continue;
+        ASSERT_EQ(hash_adler32_get_impl(), (hash_adler32_impl_t)impl);
+
+        ASSERT_EQ(hash_adler32((const euint8_t*)"Wikipedia", 9), 0x11E60398);
+        ASSERT_EQ(hash_adler32(0, 0), 1);
+
+        /* long input with large bytes, reductions are needed (zlib adler32 result) */
+        ASSERT_EQ(hash_adler32(data, sizeof(data)), 0x19B8EBF8);
+    }
+
+    ASSERT_EQ(hash_adler32_set_impl(hash_adler32_impl_auto), ELIBC_SUCCESS);
+    ASSERT_NE(hash_adler32_get_impl(), hash_adler32_impl_auto);
+}
+
+GTEST_TEST(hash_adler32_tests, hash_adler32_impl_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    euint8_t data[12000];
+    euint32_t expected;
+    adler32_context_t adler32_context;
+    size_t data_size, split;
+    int impl;
+
+    /* worst case for sums */
+    ememset(data, 0xFF, sizeof(data));
+
+    /* compare with portable implementation for all lengths */
+    for(data_size = 0; data_size < sizeof(data) - 1; data_size += (data_size < 300) ? 1 : 293)
+    {
+        ASSERT_EQ(hash_adler32_set_impl(hash_adler32_impl_portable), ELIBC_SUCCESS);
+        expected = hash_adler32(data + 1, data_size);
+
+        for(impl = hash_adler32_impl_ssse3; impl <= hash_adler32_impl_avx2; ++impl)
+        {
+            if(hash_adler32_set_impl((hash_adler32_impl_t)impl) != ELIBC_SUCCESS) continue;
+
+            /* unaligned input split in two parts */
+            split = data_size / 3;
+            hash_adler32_begin(&adler32_context);
+            hash_adler32_update(&adler32_context, data + 1, split);
+            hash_adler32_update(&adler32_context, data + 1 + split, data_size - split);
+
+            ASSERT_EQ(hash_adler32_end(&adler32_context), expected);
+        }
+    }
+
+    ASSERT_EQ(hash_adler32_set_impl(hash_adler32_impl_auto), ELIBC_SUCCESS);
+}
+
+/*----------------------------------------------------------------------*/
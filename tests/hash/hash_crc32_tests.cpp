@@ -0,0 +1,87 @@
+/*
+    CRC32 and CRC32C unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+GTEST_TEST(hash_crc32_tests, hash_crc32_vectors_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    euint8_t data[5000];
+    size_t idx;
+    int impl;
+
+    for(idx = 0; idx < sizeof(data); ++idx)
+    {
+        data[idx] = (euint8_t)(idx * 31 + 7);
+    }
+
+    /* all implementations supported by cpu */
+    for(impl = hash_crc32_impl_portable; impl <= hash_crc32_impl_pclmul; ++impl)
+    {
+        if(hash_crc32_set_impl((hash_crc32_impl_t)impl) != ELIBC_SUCCESS) continue;
+        ASSERT_EQ(hash_crc32_get_impl(), (hash_crc32_impl_t)impl);
+
+        /* check values */
+        ASSERT_EQ(hash_crc32((const euint8_t*)"123456789", 9), 0xCBF43926);
+        ASSERT_EQ(hash_crc32c((const euint8_t*)"123456789", 9), 0xE3069283);
+        ASSERT_EQ(hash_crc32(0, 0), 0);
+        ASSERT_EQ(hash_crc32c(0, 0), 0);
+
+        /* long input (zlib crc32 and iSCSI results) */
+        ASSERT_EQ(hash_crc32(data, sizeof(data)), 0x8AD9F129);
+        ASSERT_EQ(hash_crc32c(data, sizeof(data)), 0x2B79D61E);
+    }
+
+    ASSERT_EQ(hash_crc32_set_impl(hash_crc32_impl_auto), ELIBC_SUCCESS);
+    ASSERT_NE(hash_crc32_get_impl(), hash_crc32_impl_auto);
+}
+
+GTEST_TEST(hash_crc32_tests, hash_crc32_impl_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    euint8_t data[1500];
+    euint32_t expected, expected_c;
+    crc32_context_t crc32_context, crc32c_context;
+    size_t data_size, split;
+    int impl;
+
+    for(data_size = 0; data_size < sizeof(data); ++data_size)
+    {
+        data[data_size] = (euint8_t)((data_size * 131 + 7) ^ (data_size >> 3));
+    }
+
+    /* compare with portable implementation for all lengths */
+    for(data_size = 0; data_size < sizeof(data) - 1; data_size += (data_size < 300) ? 1 : 37)
+    {
+        ASSERT_EQ(hash_crc32_set_impl(hash_crc32_impl_portable), ELIBC_SUCCESS);
+        expected = hash_crc32(data + 1, data_size);
+        expected_c = hash_crc32c(data + 1, data_size);
+
+        for(impl = hash_crc32_impl_sse42; impl <= hash_crc32_impl_pclmul; ++impl)
+        {
+            if(hash_crc32_set_impl((hash_crc32_impl_t)impl) != ELIBC_SUCCESS) continue;
+
+            /* unaligned input split in two parts */
+            split = data_size / 3;
+            hash_crc32_begin(&crc32_context);
+            hash_crc32c_begin(&crc32c_context);
+
+            hash_crc32_update(&crc32_context, data + 1, split);
+            hash_crc32_update(&crc32_context, data + 1 + split, data_size - split);
+            hash_crc32c_update(&crc32c_context, data + 1, split);
+            hash_crc32c_update(&crc32c_context, data + 1 + split, data_size - split);
+
+            ASSERT_EQ(hash_crc32_end(&crc32_context), expected);
+            ASSERT_EQ(hash_crc32c_end(&crc32c_context), expected_c);
+        }
+    }
+
+    ASSERT_EQ(hash_crc32_set_impl(hash_crc32_impl_auto), ELIBC_SUCCESS);
+}
+
+/*----------------------------------------------------------------------*/
@@ -0,0 +1,158 @@
+/*
+    Fast non cryptographic hash unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+/* test data */
+void _hash_fast_test_data(euint8_t* data, size_t data_size)
+{
+    size_t idx;
+
+    for(idx = 0; idx < data_size; ++idx)
+    {
+        data[idx] = (euint8_t)(idx * 31 + 7);
+    }
+}
+
+/*----------------------------------------------------------------------*/
+
+GTEST_TEST(hash_fast_tests, hash_fast_values_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    /* values must never change, they may be stored by users */
+    static const struct
+    {
+        size_t      data_size;
+        euint64_t   hash;
+        euint64_t   hash_seed;
+        euint64_t   hash_high_seed;
+
+    } expected[] = {
+        { 0,    0x0409638ee2bde459ULL, 0xfe71846ec21fdd78ULL, 0xe3f2065089cc622eULL },
+        { 3,    0xaa4dada6d17eebb0ULL, 0xf7eeb3d35ba12178ULL, 0x0014a730b88a260bULL },
+        { 8,    0x9654832f28858268ULL, 0x848e6dfad8a2757dULL, 0x2121f1684ae02e56ULL },
+        { 16,   0x36b53f8551944db0ULL, 0x993b41ca423ee837ULL, 0x06956a5dd118ad61ULL },
+        { 17,   0x904849bdd1e93c7cULL, 0x4ceaeedf6062bf92ULL, 0x2adbfdfe27a8044cULL },
+        { 100,  0xe0c3d79ee1609ba9ULL, 0x818f97108c4c86a8ULL, 0xd459dd659b1be4d0ULL },
+        { 240,  0xa3f1383b3c5c55b0ULL, 0xef2305596096b6d0ULL, 0xae424a67fbc77462ULL },
+        { 241,  0x2ad36867b03695f2ULL, 0x0af8fdaeb64fb476ULL, 0xd16de01f6c7c1b65ULL },
+        { 1024, 0xcb4ca864da7f7b68ULL, 0x51521dda3232037aULL, 0x16f960fe5df822c6ULL },
+        { 1025, 0x735843b46f2a670cULL, 0xc78b35f61e27beb8ULL, 0x9189faa4135548dbULL },
+        { 5000, 0xc2e0afeafb8f487aULL, 0x00382b17faa13831ULL, 0x287b3c441ce62fb6ULL }
+    };
+
+    euint8_t data[5000];
+    hash_fast128_t hash128;
+    size_t idx;
+    int impl;
+
+    _hash_fast_test_data(data, sizeof(data));
+
+    /* all implementations supported by cpu */
+    for(impl = hash_fast_impl_portable; impl <= hash_fast_impl_avx2; ++impl)
+    {
+        if(hash_fast_set_impl((hash_fast_impl_t)impl) != ELIBC_SUCCESS) continue;
+        ASSERT_EQ(hash_fast_get_impl(), (hash_fast_impl_t)impl);
+
+        for(idx = 0; idx < sizeof(expected) / sizeof(expected[0]); ++idx)
+        {
+            ASSERT_EQ(hash_fast64(data, expected[idx].data_size), expected[idx].hash);
+            ASSERT_EQ(hash_fast64_seed(data, expected[idx].data_size, 12345), expected[idx].hash_seed);
+
+            hash_fast128_seed(data, expected[idx].data_size, 12345, &hash128);
+            ASSERT_EQ(hash128.low, expected[idx].hash_seed);
+            ASSERT_EQ(hash128.high, expected[idx].hash_high_seed);
+
+            hash_fast128(data, expected[idx].data_size, &hash128);
+            ASSERT_EQ(hash128.low, expected[idx].hash);
+        }
+    }
+
+    ASSERT_EQ(hash_fast_set_impl(hash_fast_impl_auto), ELIBC_SUCCESS);
+    ASSERT_NE(hash_fast_get_impl(), hash_fast_impl_auto);
+}
+
+GTEST_TEST(hash_fast_tests, hash_fast_stream_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    static const size_t chunk_sizes[] = { 1, 7, 63, 64, 65, 255, 256, 257, 1000 };
+    static const euint64_t seeds[] = { 0, 0x123456789abcdefULL };
+
+    euint8_t data[4111];
+    hash_fast_context_t fast_context;
+    hash_fast128_t expected128, hash128;
+    euint64_t expected;
+    size_t data_size, chunk_idx, seed_idx, offset, count;
+
+    _hash_fast_test_data(data, sizeof(data));
+
+    for(seed_idx = 0; seed_idx < sizeof(seeds) / sizeof(seeds[0]); ++seed_idx)
+    {
+        for(data_size = 0; data_size <= sizeof(data); data_size += (data_size < 600) ? 13 : 301)
+        {
+            expected = hash_fast64_seed(data, data_size, seeds[seed_idx]);
+            hash_fast128_seed(data, data_size, seeds[seed_idx], &expected128);
+
+            for(chunk_idx = 0; chunk_idx < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); ++chunk_idx)
+            {
+                hash_fast_begin(&fast_context, seeds[seed_idx]);
+
+                for(offset = 0; offset < data_size; offset += count)
+                {
+                    count = (data_size - offset < chunk_sizes[chunk_idx]) ? data_size - offset : chunk_sizes[chunk_idx];
+                    hash_fast_update(&fast_context, data + offset, count);
+                }
+
+                ASSERT_EQ(hash_fast_end64(&fast_context), expected);
+
+                hash_fast_end128(&fast_context, &hash128);
+                ASSERT_EQ(hash128.low, expected128.low);
+                ASSERT_EQ(hash128.high, expected128.high);
+            }
+        }
+    }
+}
+
+GTEST_TEST(hash_fast_tests, hash_fast_collisions_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    static const size_t key_count = 4096;
+
+    euint64_t* hashes;
+    euint32_t key;
+    size_t idx;
+    int buckets[256];
+
+    hashes = (euint64_t*)emalloc(key_count * sizeof(euint64_t));
+    ASSERT_TRUE(hashes != 0);
+
+    ememset(buckets, 0, sizeof(buckets));
+
+    /* sequential keys must not collide and low bits must be spread evenly */
+    for(key = 0; key < key_count; ++key)
+    {
+        hashes[key] = hash_fast64((const euint8_t*)&key, sizeof(key));
+        buckets[hashes[key] & 0xFF]++;
+
+        for(idx = 0; idx < key; ++idx)
+        {
+            ASSERT_NE(hashes[idx], hashes[key]);
+        }
+    }
+
+    for(idx = 0; idx < 256; ++idx)
+    {
+        EXPECT_GT(buckets[idx], 0);
+        EXPECT_LT(buckets[idx], 48);
+    }
+
+    efree(hashes);
+}
+
+/*----------------------------------------------------------------------*/
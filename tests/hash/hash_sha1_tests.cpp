@@ -0,0 +1,236 @@
+/*
+    SHA1 and HMAC-SHA1 unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+/* convert digest to hex string */
+void _hash_sha1_test_hex(const euint8_t* digest, char* hex_out)
+{
+    static const char hex[] = "0123456789abcdef";
+    int idx;
+
+    for(idx = 0; idx < HASH_SHA1_DIGEST_SIZE; ++idx)
+    {
+        hex_out[2 * idx] = hex[digest[idx] >> 4];
+        hex_out[2 * idx + 1] = hex[digest[idx] & 0x0F];
+    }
+    hex_out[2 * HASH_SHA1_DIGEST_SIZE] = 0;
+}
+
+/* check test vectors with currently selected implementation */
+void _hash_sha1_test_vectors()
+{
+    euint8_t digest[HASH_SHA1_DIGEST_SIZE];
+    char hex[2 * HASH_SHA1_DIGEST_SIZE + 1];
+    euint8_t million[1000];
+    sha1_context_t sha1_context;
+    int idx;
+
+    /* FIPS 180 examples */
+    ASSERT_EQ(hash_sha1((const euint8_t*)"abc", 3, digest), ELIBC_SUCCESS);
+    _hash_sha1_test_hex(digest, hex);
+    ASSERT_STRING_EQ(hex, "a9993e364706816aba3e25717850c26c9cd0d89d");
+
+    ASSERT_EQ(hash_sha1((const euint8_t*)"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56, digest), ELIBC_SUCCESS);
+    _hash_sha1_test_hex(digest, hex);
+    ASSERT_STRING_EQ(hex, "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+
+    ememset(million, 'a', sizeof(million));
+    hash_sha1_begin(&sha1_context);
+    for(idx = 0; idx < 1000; ++idx)
+    {
+        hash_sha1_update(&sha1_context, million, sizeof(million));
+    }
+    hash_sha1_end(&sha1_context, digest);
+    _hash_sha1_test_hex(digest, hex);
+    ASSERT_STRING_EQ(hex, "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+
+    /* RFC 2202 test cases 1 and 6 */
+    ememset(million, 0x0b, 20);
+    ASSERT_EQ(hash_hmac_sha1((const euint8_t*)"Hi There", 8, million, 20, digest), ELIBC_SUCCESS);
+    _hash_sha1_test_hex(digest, hex);
+    ASSERT_STRING_EQ(hex, "b617318655057264e28bc0b6fb378c8ef146be00");
+
+    ememset(million, 0xaa, 80);
+    ASSERT_EQ(hash_hmac_sha1((const euint8_t*)"Test Using Larger Than Block-Size Key - Hash Key First", 54, million, 80, digest), ELIBC_SUCCESS);
+    _hash_sha1_test_hex(digest, hex);
+    ASSERT_STRING_EQ(hex, "aa4ae5e15272d00e95705637ce8a3b55ed402112");
+}
+
+/*----------------------------------------------------------------------*/
+
+GTEST_TEST(hash_sha1_tests, hash_sha1_vectors_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    int impl;
+
+    /* all implementations supported by cpu */
+    for(impl = hash_sha1_impl_portable; impl <= hash_sha1_impl_shani; ++impl)
+    {
+        if(hash_sha1_set_impl((hash_sha1_impl_t)impl) != ELIBC_SUCCESS) continue;
+        ASSERT_EQ(hash_sha1_get_impl(), (hash_sha1_impl_t)impl);
+
+        _hash_sha1_test_vectors();
+    }
+
+    ASSERT_EQ(hash_sha1_set_impl(hash_sha1_impl_auto), ELIBC_SUCCESS);
+    ASSERT_NE(hash_sha1_get_impl(), hash_sha1_impl_auto);
+}
+
+GTEST_TEST(hash_sha1_tests, hash_sha1_impl_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    euint8_t data[777], data_copy[777];
+    euint8_t expected[HASH_SHA1_DIGEST_SIZE], digest[HASH_SHA1_DIGEST_SIZE];
+    sha1_context_t sha1_context;
+    size_t data_size, split;
+    int impl;
+
+    for(data_size = 0; data_size < sizeof(data); ++data_size)
+    {
+        data[data_size] = (euint8_t)((data_size * 131 + 7) ^ (data_size >> 3));
+    }
+    ememcpy(data_copy, data, sizeof(data));
+
+    /* compare with portable implementation for all lengths */
+    for(data_size = 1; data_size < sizeof(data); data_size += 7)
+    {
+        ASSERT_EQ(hash_sha1_set_impl(hash_sha1_impl_portable), ELIBC_SUCCESS);
+        ASSERT_EQ(hash_sha1(data + 1, (euint32_t)data_size, expected), ELIBC_SUCCESS);
+
+        for(impl = hash_sha1_impl_ssse3; impl <= hash_sha1_impl_shani; ++impl)
+        {
+            if(hash_sha1_set_impl((hash_sha1_impl_t)impl) != ELIBC_SUCCESS) continue;
+
+            /* unaligned input split in two parts */
+            split = data_size / 3;
+            hash_sha1_begin(&sha1_context);
+            if(split > 0) hash_sha1_update(&sha1_context, data + 1, (euint32_t)split);
+            hash_sha1_update(&sha1_context, data + 1 + split, (euint32_t)(data_size - split));
+            hash_sha1_end(&sha1_context, digest);
+
+            ASSERT_BINARY_EQ(digest, expected, HASH_SHA1_DIGEST_SIZE);
+        }
+    }
+
+    /* input must not be modified */
+    ASSERT_BINARY_EQ(data, data_copy, sizeof(data));
+
+    ASSERT_EQ(hash_sha1_set_impl(hash_sha1_impl_auto), ELIBC_SUCCESS);
+}
+
+GTEST_TEST(hash_sha1_tests, hash_hmac_sha1_key_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    euint8_t key[100], data[200];
+    euint8_t expected[HASH_SHA1_DIGEST_SIZE], digest[HASH_SHA1_DIGEST_SIZE];
+    hmac_sha1_context_t hmac_sha1_context;
+    hmac_sha1_key_t hmac_sha1_key;
+    euint32_t key_length, data_size;
+
+    for(data_size = 0; data_size < sizeof(data); ++data_size)
+    {
+        data[data_size] = (euint8_t)(data_size * 7 + 3);
+    }
+    for(key_length = 0; key_length < sizeof(key); ++key_length)
+    {
+        key[key_length] = (euint8_t)(key_length * 13 + 1);
+    }
+
+    /* short and long keys, precomputed key must give the same result */
+    for(key_length = 1; key_length < sizeof(key); key_length += 33)
+    {
+        ASSERT_EQ(hash_hmac_sha1_key(&hmac_sha1_key, key, key_length), ELIBC_SUCCESS);
+
+        for(data_size = 1; data_size < sizeof(data); data_size += 17)
+        {
+            ASSERT_EQ(hash_hmac_sha1(data, data_size, key, key_length, expected), ELIBC_SUCCESS);
+
+            ASSERT_EQ(hash_hmac_sha1_with_key(data, data_size, &hmac_sha1_key, digest), ELIBC_SUCCESS);
+            ASSERT_BINARY_EQ(digest, expected, HASH_SHA1_DIGEST_SIZE);
+
+            /* streaming */
+            hash_hmac_sha1_begin_key(&hmac_sha1_context, &hmac_sha1_key);
+            hash_hmac_sha1_update(&hmac_sha1_context, data, 1);
+            if(data_size > 1) hash_hmac_sha1_update(&hmac_sha1_context, data + 1, data_size - 1);
+            hash_hmac_sha1_end(&hmac_sha1_context, digest);
+            ASSERT_BINARY_EQ(digest, expected, HASH_SHA1_DIGEST_SIZE);
+        }
+    }
+}
+
+GTEST_TEST(hash_sha1_tests, hash_sha1_multi_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    static const size_t lanes_list[] = { 1, 4, 8, 16 };
+    static const size_t message_count = 37;
+
+    euint8_t data[300], key[40];
+    const euint8_t* messages[message_count];
+    euint32_t message_sizes[message_count];
+    euint8_t expected[message_count * HASH_SHA1_DIGEST_SIZE];
+    euint8_t digests[message_count * HASH_SHA1_DIGEST_SIZE];
+    hmac_sha1_key_t hmac_sha1_key;
+    size_t idx, lanes;
+
+    for(idx = 0; idx < sizeof(data); ++idx)
+    {
+        data[idx] = (euint8_t)(idx * 29 + 5);
+    }
+    for(idx = 0; idx < sizeof(key); ++idx)
+    {
+        key[idx] = (euint8_t)(idx * 3 + 11);
+    }
+    ASSERT_EQ(hash_hmac_sha1_key(&hmac_sha1_key, key, sizeof(key)), ELIBC_SUCCESS);
+
+    /* messages of different length (including empty and padding edge cases) */
+    for(idx = 0; idx < message_count; ++idx)
+    {
+        messages[idx] = data + idx;
+        message_sizes[idx] = (euint32_t)((idx * 41) % 200);
+    }
+    message_sizes[1] = 55;
+    message_sizes[2] = 56;
+    message_sizes[3] = 64;
+    message_sizes[4] = 0;
+
+    for(idx = 0; idx < sizeof(lanes_list) / sizeof(lanes_list[0]); ++idx)
+    {
+        lanes = lanes_list[idx];
+        if(hash_sha1_multi_set_lanes(lanes) != ELIBC_SUCCESS) continue;
+        ASSERT_EQ(hash_sha1_multi_lanes(), lanes);
+
+        /* plain hash */
+        ASSERT_EQ(hash_sha1_multi(messages, message_sizes, message_count, digests), ELIBC_SUCCESS);
+        for(size_t msg = 0; msg < message_count; ++msg)
+        {
+            sha1_context_t sha1_context;
+
+            hash_sha1_begin(&sha1_context);
+            if(message_sizes[msg] > 0) hash_sha1_update(&sha1_context, messages[msg], message_sizes[msg]);
+            hash_sha1_end(&sha1_context, expected + msg * HASH_SHA1_DIGEST_SIZE);
+        }
+        ASSERT_BINARY_EQ(digests, expected, sizeof(digests));
+
+        /* hmac (skip empty message) */
+        ASSERT_EQ(hash_hmac_sha1_multi(messages, message_sizes, message_count, &hmac_sha1_key, digests), ELIBC_SUCCESS);
+        for(size_t msg = 0; msg < message_count; ++msg)
+        {
+            if(message_sizes[msg] == 0) continue;
+
+            ASSERT_EQ(hash_hmac_sha1(messages[msg], message_sizes[msg], key, sizeof(key), expected), ELIBC_SUCCESS);
+            ASSERT_BINARY_EQ(digests + msg * HASH_SHA1_DIGEST_SIZE, expected, HASH_SHA1_DIGEST_SIZE);
+        }
+    }
+
+    ASSERT_EQ(hash_sha1_multi_set_lanes(0), ELIBC_SUCCESS);
+}
+
+/*----------------------------------------------------------------------*/
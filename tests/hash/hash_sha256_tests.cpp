@@ -0,0 +1,172 @@
+/*
+    SHA256 and HMAC-SHA256 unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+/* convert digest to hex string */
+void _hash_sha256_test_hex(const euint8_t* digest, char* hex_out)
+{
+    static const char hex[] = "0123456789abcdef";
+    int idx;
+
+    for(idx = 0; idx < HASH_SHA256_DIGEST_SIZE; ++idx)
+    {
+        hex_out[2 * idx] = hex[digest[idx] >> 4];
+        hex_out[2 * idx + 1] = hex[digest[idx] & 0x0F];
+    }
+    hex_out[2 * HASH_SHA256_DIGEST_SIZE] = 0;
+}
+
+/* check test vectors with currently selected implementation */
+void _hash_sha256_test_vectors()
+{
+    euint8_t digest[HASH_SHA256_DIGEST_SIZE];
+    char hex[2 * HASH_SHA256_DIGEST_SIZE + 1];
+    euint8_t million[1000];
+    sha256_context_t sha256_context;
+    int idx;
+
+    /* FIPS 180 examples */
+    ASSERT_EQ(hash_sha256((const euint8_t*)"abc", 3, digest), ELIBC_SUCCESS);
+    _hash_sha256_test_hex(digest, hex);
+    ASSERT_STRING_EQ(hex, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+
+    ASSERT_EQ(hash_sha256((const euint8_t*)"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56, digest), ELIBC_SUCCESS);
+    _hash_sha256_test_hex(digest, hex);
+    ASSERT_STRING_EQ(hex, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    ememset(million, 'a', sizeof(million));
+    hash_sha256_begin(&sha256_context);
+    for(idx = 0; idx < 1000; ++idx)
+    {
+        hash_sha256_update(&sha256_context, million, sizeof(million));
+    }
+    hash_sha256_end(&sha256_context, digest);
+    _hash_sha256_test_hex(digest, hex);
+    ASSERT_STRING_EQ(hex, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+    /* RFC 4231 test cases 1, 2 and 6 */
+    ememset(million, 0x0b, 20);
+    ASSERT_EQ(hash_hmac_sha256((const euint8_t*)"Hi There", 8, million, 20, digest), ELIBC_SUCCESS);
+    _hash_sha256_test_hex(digest, hex);
+    ASSERT_STRING_EQ(hex, "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+
+    ASSERT_EQ(hash_hmac_sha256((const euint8_t*)"what do ya want for nothing?", 28, (const euint8_t*)"Jefe", 4, digest), ELIBC_SUCCESS);
+    _hash_sha256_test_hex(digest, hex);
+    ASSERT_STRING_EQ(hex, "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+    ememset(million, 0xaa, 131);
+    ASSERT_EQ(hash_hmac_sha256((const euint8_t*)"Test Using Larger Than Block-Size Key - Hash Key First", 54, million, 131, digest), ELIBC_SUCCESS);
+    _hash_sha256_test_hex(digest, hex);
+    ASSERT_STRING_EQ(hex, "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+}
+
+/*----------------------------------------------------------------------*/
+
+GTEST_TEST(hash_sha256_tests, hash_sha256_vectors_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    int impl;
+
+    /* all implementations supported by cpu */
+    for(impl = hash_sha256_impl_portable; impl <= hash_sha256_impl_shani; ++impl)
+    {
+        if(hash_sha256_set_impl((hash_sha256_impl_t)impl) != ELIBC_SUCCESS) continue;
+        ASSERT_EQ(hash_sha256_get_impl(), (hash_sha256_impl_t)impl);
+
+        _hash_sha256_test_vectors();
+    }
+
+    ASSERT_EQ(hash_sha256_set_impl(hash_sha256_impl_auto), ELIBC_SUCCESS);
+    ASSERT_NE(hash_sha256_get_impl(), hash_sha256_impl_auto);
+}
+
+GTEST_TEST(hash_sha256_tests, hash_sha256_impl_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    euint8_t data[777], data_copy[777];
+    euint8_t expected[HASH_SHA256_DIGEST_SIZE], digest[HASH_SHA256_DIGEST_SIZE];
+    sha256_context_t sha256_context;
+    size_t data_size, split;
+    int impl;
+
+    for(data_size = 0; data_size < sizeof(data); ++data_size)
+    {
+        data[data_size] = (euint8_t)((data_size * 131 + 7) ^ (data_size >> 3));
+    }
+    ememcpy(data_copy, data, sizeof(data));
+
+    /* compare with portable implementation for all lengths */
+    for(data_size = 1; data_size < sizeof(data); data_size += 7)
+    {
+        ASSERT_EQ(hash_sha256_set_impl(hash_sha256_impl_portable), ELIBC_SUCCESS);
+        ASSERT_EQ(hash_sha256(data + 1, (euint32_t)data_size, expected), ELIBC_SUCCESS);
+
+        for(impl = hash_sha256_impl_ssse3; impl <= hash_sha256_impl_shani; ++impl)
+        {
+            if(hash_sha256_set_impl((hash_sha256_impl_t)impl) != ELIBC_SUCCESS) continue;
+
+            /* unaligned input split in two parts */
+            split = data_size / 3;
+            hash_sha256_begin(&sha256_context);
+            if(split > 0) hash_sha256_update(&sha256_context, data + 1, (euint32_t)split);
+            hash_sha256_update(&sha256_context, data + 1 + split, (euint32_t)(data_size - split));
+            hash_sha256_end(&sha256_context, digest);
+
+            ASSERT_BINARY_EQ(digest, expected, HASH_SHA256_DIGEST_SIZE);
+        }
+    }
+
+    /* input must not be modified */
+    ASSERT_BINARY_EQ(data, data_copy, sizeof(data));
+
+    ASSERT_EQ(hash_sha256_set_impl(hash_sha256_impl_auto), ELIBC_SUCCESS);
+}
+
+GTEST_TEST(hash_sha256_tests, hash_hmac_sha256_key_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    euint8_t key[150], data[200];
+    euint8_t expected[HASH_SHA256_DIGEST_SIZE], digest[HASH_SHA256_DIGEST_SIZE];
+    hmac_sha256_context_t hmac_sha256_context;
+    hmac_sha256_key_t hmac_sha256_key;
+    euint32_t key_length, data_size;
+
+    for(data_size = 0; data_size < sizeof(data); ++data_size)
+    {
+        data[data_size] = (euint8_t)(data_size * 7 + 3);
+    }
+    for(key_length = 0; key_length < sizeof(key); ++key_length)
+    {
+        key[key_length] = (euint8_t)(key_length * 13 + 1);
+    }
+
+    /* short and long keys, precomputed key must give the same result */
+    for(key_length = 1; key_length < sizeof(key); key_length += 33)
+    {
+        ASSERT_EQ(hash_hmac_sha256_key(&hmac_sha256_key, key, key_length), ELIBC_SUCCESS);
+
+        for(data_size = 1; data_size < sizeof(data); data_size += 17)
+        {
+            ASSERT_EQ(hash_hmac_sha256(data, data_size, key, key_length, expected), ELIBC_SUCCESS);
+
+            ASSERT_EQ(hash_hmac_sha256_with_key(data, data_size, &hmac_sha256_key, digest), ELIBC_SUCCESS);
+            ASSERT_BINARY_EQ(digest, expected, HASH_SHA256_DIGEST_SIZE);
+
+            /* streaming */
+            hash_hmac_sha256_begin_key(&hmac_sha256_context, &hmac_sha256_key);
+            hash_hmac_sha256_update(&hmac_sha256_context, data, 1);
+            if(data_size > 1) hash_hmac_sha256_update(&hmac_sha256_context, data + 1, data_size - 1);
+            hash_hmac_sha256_end(&hmac_sha256_context, digest);
+            ASSERT_BINARY_EQ(digest, expected, HASH_SHA256_DIGEST_SIZE);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------*/
@@ -81,5 +81,241 @@ GTEST_TEST(datetome_parse_tests, date_parse_test_rss)
     ASSERT_EQ(unixtime, 1500985532);
 }
 
-/*----------------------------------------------------------------------*/
+GTEST_TEST(datetome_parse_tests, datetime_unixtime_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    datetime_t datetime;
+    datetime_t datetimes[4];
+    etime_t unixtimes[4];
+    etime_t unixtime;
+    int idx, err;
+
+    /* epoch */
+    err = unixtime_to_datetime(0, &datetime);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_EQ(datetime.year, 1970);
+    ASSERT_EQ(datetime.month, 0);
+    ASSERT_EQ(datetime.day, 1);
+    ASSERT_EQ(datetime.weekday, 4);
+
+    /* leap day */
+    err = unixtime_to_datetime(951782400, &datetime);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_EQ(datetime.year, 2000);
+    ASSERT_EQ(datetime.month, 1);
+    ASSERT_EQ(datetime.day, 29);
+    ASSERT_EQ(datetime.weekday, 2);
+
+    err = datetime_to_unixtime(&datetime, &unixtime);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_EQ(unixtime, 951782400);
+
+    /* before epoch */
+    err = unixtime_to_datetime(-1, &datetime);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_EQ(datetime.year, 1969);
+    ASSERT_EQ(datetime.month, 11);
+    ASSERT_EQ(datetime.day, 31);
+    ASSERT_EQ(datetime.hours, 23);
+    ASSERT_EQ(datetime.minutes, 59);
+    ASSERT_EQ(datetime.seconds, 59);
+
+    /* batch conversion */
+    unixtimes[0] = 1500985532;
+    unixtimes[1] = 1500985533;
+    unixtimes[2] = 1501027199;
+    unixtimes[3] = 1501027200;
+
+    err = unixtime_to_datetime_batch(unixtimes, datetimes, 4);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    for(idx = 0; idx < 4; ++idx)
+    {
+        err = unixtime_to_datetime(unixtimes[idx], &datetime);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+        ASSERT_BINARY_EQ(&datetime, datetimes + idx, sizeof(datetime_t));
+    }
+
+    err = datetime_to_unixtime_batch(datetimes, unixtimes, 4);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_EQ(unixtimes[0], 1500985532);
+    ASSERT_EQ(unixtimes[3], 1501027200);
+}
+
+GTEST_TEST(datetome_parse_tests, datetime_fixed_layout_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    const char* iso_dates[] = { "2016-04-29T18:31:37Z", "2016-04-29T18:31:37+03:30", "1994-11-06T08:49:37-05:00" };
+    const char* rfc_dates[] = { "Sun, 06 Nov 1994 08:49:37 GMT", "Thu, 01 Dec 1994 16:00:00 GMT" };
+    datetime_t datetime, generic;
+    datetime_t datetimes[3];
+    etime_t unixtimes[3];
+    char buffer[64];
+    int idx, err;
+
+    /* fixed layout */
+    err = datetime_parse(DATETIME_FORMAT_ISO8601, iso_dates[0], 0, &datetime);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_EQ(datetime.year, 2016);
+    ASSERT_EQ(datetime.month, 3);
+    ASSERT_EQ(datetime.day, 29);
+    ASSERT_EQ(datetime.hours, 18);
+    ASSERT_EQ(datetime.minutes, 31);
+    ASSERT_EQ(datetime.seconds, 37);
+    ASSERT_EQ(datetime.offset, 0);
+
+    err = datetime_parse(DATETIME_FORMAT_RFC1123, rfc_dates[0], 0, &datetime);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_EQ(datetime.year, 1994);
+    ASSERT_EQ(datetime.month, 10);
+    ASSERT_EQ(datetime.day, 6);
+    ASSERT_EQ(datetime.hours, 8);
+    ASSERT_EQ(datetime.minutes, 49);
+    ASSERT_EQ(datetime.seconds, 37);
+    ASSERT_EQ(datetime.weekday, 0);
+
+    /* leading space forces generic parser, results must be the same */
+    for(idx = 0; idx < 3; ++idx)
+    {
+        err = datetime_parse(DATETIME_FORMAT_ISO8601, iso_dates[idx], 0, &datetime);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+
+        buffer[0] = ' ';
+        estrcpy(buffer + 1, iso_dates[idx]);
+
+        err = datetime_parse(DATETIME_FORMAT_ISO8601, buffer, 0, &generic);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+        ASSERT_BINARY_EQ(&datetime, &generic, sizeof(datetime_t));
+    }
+
+    for(idx = 0; idx < 2; ++idx)
+    {
+        err = datetime_parse(DATETIME_FORMAT_RFC1123, rfc_dates[idx], 0, &datetime);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+
+        buffer[0] = ' ';
+        estrcpy(buffer + 1, rfc_dates[idx]);
+
+        err = datetime_parse(DATETIME_FORMAT_RFC1123, buffer, 0, &generic);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+        ASSERT_BINARY_EQ(&datetime, &generic, sizeof(datetime_t));
+    }
+
+    /* other layouts go to generic parser */
+    err = datetime_parse(DATETIME_FORMAT_ISO8601, "2016-04-29t18:31:37z", 0, &datetime);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_EQ(datetime.hours, 18);
+
+    err = datetime_parse(DATETIME_FORMAT_RFC1123, "SUN, 06 NOV 1994 08:49:37 gmt", 0, &datetime);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_EQ(datetime.month, 10);
+
+    /* invalid values */
+    err = datetime_parse(DATETIME_FORMAT_ISO8601, "2016-13-29T18:31:37Z", 0, &datetime);
+    ASSERT_EQ(err, ELIBC_ERROR_PARSER_INVALID_INPUT);
+
+    err = datetime_parse(DATETIME_FORMAT_ISO8601, "2016-04-29T18:3a:37Z", 0, &datetime);
+    ASSERT_EQ(err, ELIBC_ERROR_PARSER_INVALID_INPUT);
 
+    err = datetime_parse(DATETIME_FORMAT_RFC1123, "Sun, 06 Nov 1994 25:49:37 GMT", 0, &datetime);
+    ASSERT_EQ(err, ELIBC_ERROR_PARSER_INVALID_INPUT);
+
+    /* batch */
+    err = datetime_parse_batch(DATETIME_FORMAT_ISO8601, iso_dates, 0, datetimes, 3);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_EQ(datetimes[1].offset, 210);
+    ASSERT_EQ(datetimes[2].offset, -300);
+
+    err = datetime_parse_unixtime_batch(DATETIME_FORMAT_ISO8601, iso_dates, 0, unixtimes, 3);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_EQ(unixtimes[0], 1461954697);
+    ASSERT_EQ(unixtimes[1], 1461954697 - 210 * 60);
+
+    err = datetime_parse_unixtime_batch(DATETIME_FORMAT_RFC1123, rfc_dates, 0, unixtimes, 2);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_EQ(unixtimes[0], 784111777);
+    ASSERT_EQ(unixtimes[1], 786297600);
+}
+
+GTEST_TEST(datetome_parse_tests, http_date_format_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    char date[HTTP_DATE_LENGTH + 1];
+    http_response_t http_response;
+    ebuffer_t encode_buffer;
+    datetime_t datetime;
+    etime_t unixtime;
+    int err;
+
+    err = http_format_date(784111777, date);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_STRING_EQ(date, "Sun, 06 Nov 1994 08:49:37 GMT");
+
+    err = http_format_date(0, date);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_STRING_EQ(date, "Thu, 01 Jan 1970 00:00:00 GMT");
+
+    /* cached current date */
+    unixtime = etime(0);
+
+    err = http_format_date_current(date);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_EQ(estrlen(date), HTTP_DATE_LENGTH);
+
+    err = datetime_parse(DATETIME_FORMAT_RFC1123, date, HTTP_DATE_LENGTH, &datetime);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = datetime_to_unixtime(&datetime, &unixtime);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_LE(etime(0) - unixtime, 1);
+
+    /* response header */
+    ebuffer_init(&encode_buffer);
+    http_response_init(&http_response);
+
+    err = http_response_set_status(&http_response, 200, 0);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = http_response_set_date(&http_response, ELIBC_TRUE);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = http_response_format_header(&http_response, &encode_buffer);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    ASSERT_EQ(ememcmp(ebuffer_data(&encode_buffer) + 17, "Date: ", 6), 0);
+    ASSERT_EQ(ememcmp(ebuffer_data(&encode_buffer) + 17 + 6 + HTTP_DATE_LENGTH, "\r\n", 2), 0);
+
+    http_response_close(&http_response);
+    ebuffer_free(&encode_buffer);
+}
+
+GTEST_TEST(datetome_parse_tests, timestamp_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    eint64_t timestamp, timestamp_next, realtime;
+
+    /* monotonic */
+    timestamp = timestamp_current();
+    timestamp_next = timestamp_current();
+    ASSERT_NE(timestamp, 0);
+    ASSERT_GE(timestamp_next, timestamp);
+
+    /* units */
+    ASSERT_EQ(timestamp_append_sec(timestamp, 1.5) - timestamp, TIMESTAMP_TICKS_PER_SEC + TIMESTAMP_TICKS_PER_SEC / 2);
+
+    /* coarse clock may lag behind but not for long */
+    timestamp = timestamp_current_coarse();
+    ASSERT_NE(timestamp, 0);
+    ASSERT_LE(timestamp, timestamp_append_sec(timestamp_current(), 0.1));
+    ASSERT_GE(timestamp, timestamp_append_sec(timestamp_next, -0.1));
+
+    /* wall clock */
+    realtime = timestamp_realtime_ns() / 1000000000;
+    ASSERT_LE(etime(0) - realtime, 1);
+}
+
+/*----------------------------------------------------------------------*/
@@ -0,0 +1,715 @@
+/*
+    WBXML unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+#define WBXML_TEST_PUBLIC_ID        0x01
+#define WBXML_TEST_FLUSH_SIZE       4
+
+/* flush callback collecting output */
+int _wbxml_test_flush_callback(void* user_data, const euint8_t* data, size_t data_size)
+{
+    return ebuffer_append((ebuffer_t*)user_data, data, data_size);
+}
+
+/* encode test document */
+int _wbxml_test_encode_document(wbxml_encoder_t* wbxml_encoder, ebuffer_t* encode_buffer)
+{
+    static const euint8_t opaque[] = { 0x00, 0x01, 0x02 };
+    int err;
+
+    err = wbxml_encode_begin(wbxml_encoder, encode_buffer, WBXML_TEST_PUBLIC_ID, WBXML_ENCODER_CHARSET_UTF8);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* <FolderSync><SyncKey>0</SyncKey> */
+    err = wbxml_encode_tag_begin(wbxml_encoder, 7, 0x16);
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_tag_begin(wbxml_encoder, 7, 0x12);
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_content(wbxml_encoder, "0", 1);
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_tag_end(wbxml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* repeated long strings go to string table */
+    err = wbxml_encode_tag_begin(wbxml_encoder, 0, 0x05);
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_content(wbxml_encoder, "repeated string", 15);
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_tag_end(wbxml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    err = wbxml_encode_tag_begin(wbxml_encoder, 0, 0x05);
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_content(wbxml_encoder, "repeated string", 15);
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_tag_end(wbxml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* empty tag with attributes */
+    err = wbxml_encode_tag_begin(wbxml_encoder, 0, 0x06);
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_attribute(wbxml_encoder, 0, 0x07);
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_attribute_value(wbxml_encoder, "x", 1);
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_tag_end(wbxml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* literal tag with opaque data and entity */
+    err = wbxml_encode_tag_begin_literal(wbxml_encoder, "custom", 6);
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_opaque(wbxml_encoder, opaque, sizeof(opaque));
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_entity(wbxml_encoder, 160);
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_tag_end(wbxml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* empty tag */
+    err = wbxml_encode_tag_begin(wbxml_encoder, 0, 0x3F);
+    if(err != ELIBC_SUCCESS) return err;
+    err = wbxml_encode_tag_end(wbxml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    /* </FolderSync> */
+    err = wbxml_encode_tag_end(wbxml_encoder);
+    if(err != ELIBC_SUCCESS) return err;
+
+    return wbxml_encode_end(wbxml_encoder);
+}
+
+/*----------------------------------------------------------------------*/
+
+/* transcoder code pages */
+static const char* _wbxml_test_tags0[] = {
+    0, 0, 0, 0, 0, "Item", "Link", 0, 0, 0, 0, 0, 0, 0, 0, 0, "SyncKey",
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, "Empty"
+};
+
+static const char* _wbxml_test_tags7[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, "SyncKey", 0, 0, 0, "FolderSync"
+};
+
+static const char* _wbxml_test_attributes0[] = {
+    0, 0, 0, 0, 0, 0, 0, "href", "href=http://"
+};
+
+static const char* _wbxml_test_values0[] = {
+    0, 0, 0, 0, 0, ".com"
+};
+
+static wbxml_codepage_t _wbxml_test_codepages[8];
+
+/* init transcoder code pages */
+void _wbxml_test_init_codepages()
+{
+    ememset(_wbxml_test_codepages, 0, sizeof(_wbxml_test_codepages));
+
+    _wbxml_test_codepages[0].tag_names = _wbxml_test_tags0;
+    _wbxml_test_codepages[0].tag_names_count = sizeof(_wbxml_test_tags0) / sizeof(_wbxml_test_tags0[0]);
+    _wbxml_test_codepages[0].attribute_names = _wbxml_test_attributes0;
+    _wbxml_test_codepages[0].attribute_names_count = sizeof(_wbxml_test_attributes0) / sizeof(_wbxml_test_attributes0[0]);
+    _wbxml_test_codepages[0].attribute_values = _wbxml_test_values0;
+    _wbxml_test_codepages[0].attribute_values_count = sizeof(_wbxml_test_values0) / sizeof(_wbxml_test_values0[0]);
+
+    _wbxml_test_codepages[7].tag_names = _wbxml_test_tags7;
+    _wbxml_test_codepages[7].tag_names_count = sizeof(_wbxml_test_tags7) / sizeof(_wbxml_test_tags7[0]);
+}
+
+/* transcode wbxml to xml string, input is split to blocks of block_size */
+int _wbxml_test_to_xml(wbxml_to_xml_t* transcoder, const euint8_t* input, size_t input_size, size_t block_size, ebuffer_t* xml)
+{
+    ebuffer_t decode_buffer;
+    size_t pos, size;
+    int err;
+
+    ebuffer_init(&decode_buffer);
+    ebuffer_reset(xml);
+
+    err = wbxml_to_xml_begin(transcoder, xml, &decode_buffer);
+
+    for(pos = 0; pos < input_size && err == ELIBC_SUCCESS; pos += size)
+    {
+        size = (input_size - pos < block_size) ? input_size - pos : block_size;
+        err = wbxml_to_xml_transcode(transcoder, input + pos, size);
+    }
+
+    if(err == ELIBC_SUCCESS) err = wbxml_to_xml_end(transcoder);
+    if(err == ELIBC_SUCCESS) err = ebuffer_append_char(xml, 0);
+
+    ebuffer_free(&decode_buffer);
+
+    return err;
+}
+
+/* transcode xml to wbxml, input is split to blocks of block_size */
+int _wbxml_test_from_xml(wbxml_from_xml_t* transcoder, const char* input, size_t block_size, ebuffer_t* wbxml)
+{
+    ebuffer_t parse_buffer;
+    size_t pos, size, input_size;
+    int err;
+
+    ebuffer_init(&parse_buffer);
+    ebuffer_reset(wbxml);
+
+    err = wbxml_from_xml_begin(transcoder, wbxml, &parse_buffer, WBXML_TEST_PUBLIC_ID);
+
+    input_size = estrlen(input);
+    for(pos = 0; pos < input_size && err == ELIBC_SUCCESS; pos += size)
+    {
+        size = (input_size - pos < block_size) ? input_size - pos : block_size;
+        err = wbxml_from_xml_transcode(transcoder, input + pos, size);
+    }
+
+    if(err == ELIBC_SUCCESS) err = wbxml_from_xml_end(transcoder);
+
+    ebuffer_free(&parse_buffer);
+
+    return err;
+}
+
+/* decoder callback counting string events pointing to input */
+typedef struct {
+
+    const euint8_t*     input;
+    size_t              input_size;
+    int                 in_input;
+    int                 copied;
+
+} _wbxml_test_zero_copy_t;
+
+int _wbxml_test_zero_copy_callback(void* user_data, wbxml_event_t wbxml_event, const void* data, size_t length)
+{
+    _wbxml_test_zero_copy_t* zero_copy = (_wbxml_test_zero_copy_t*)user_data;
+
+    switch(wbxml_event)
+    {
+    case wbxml_tag_begin_string:
+    case wbxml_tag_end_string:
+    case wbxml_tag_content_string:
+    case wbxml_attribute_value_string:
+    case wbxml_decoder_opaque_data:
+        if((const euint8_t*)data >= zero_copy->input && (const euint8_t*)data + length <= zero_copy->input + zero_copy->input_size)
+        {
+            zero_copy->in_input++;
+        } else
+        {
+            zero_copy->copied++;
+        }
+        break;
+
+    case wbxml_decoder_error:
+        return ELIBC_STOP;
+        break;
+
+    default:
+        break;
+    }
+
+    return ELIBC_CONTINUE;
+}
+
+/*----------------------------------------------------------------------*/
+
+GTEST_TEST(wbxml_tests, wbxml_encode_mb_uint32_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    euint8_t buffer[8];
+    size_t size;
+
+    size = wbxml_encode_mb_uint32(0, buffer);
+    ASSERT_EQ(size, 1);
+    ASSERT_EQ(buffer[0], 0x00);
+
+    size = wbxml_encode_mb_uint32(0xA0, buffer);
+    ASSERT_EQ(size, 2);
+    ASSERT_BINARY_EQ(buffer, "\x81\x20", 2);
+
+    size = wbxml_encode_mb_uint32(0xFFFFFFFF, buffer);
+    ASSERT_EQ(size, 5);
+    ASSERT_BINARY_EQ(buffer, "\x8F\xFF\xFF\xFF\x7F", 5);
+}
+
+GTEST_TEST(wbxml_tests, wbxml_encode_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    static const euint8_t expected[] = {
+        /* version, public id, charset */
+        0x03, 0x01, 0x6A,
+        /* string table */
+        0x17, 'r', 'e', 'p', 'e', 'a', 't', 'e', 'd', ' ', 's', 't', 'r', 'i', 'n', 'g', 0x00,
+              'c', 'u', 's', 't', 'o', 'm', 0x00,
+        /* FolderSync, SyncKey */
+        0x00, 0x07, 0x56, 0x52, 0x03, '0', 0x00, 0x01,
+        /* repeated strings */
+        0x00, 0x00, 0x45, 0x83, 0x00, 0x01, 0x45, 0x83, 0x00, 0x01,
+        /* tag with attribute */
+        0x86, 0x07, 0x03, 'x', 0x00, 0x01,
+        /* literal */
+        0x44, 0x10, 0xC3, 0x03, 0x00, 0x01, 0x02, 0x02, 0x81, 0x20, 0x01,
+        /* empty tag */
+        0x3F,
+        /* end */
+        0x01
+    };
+
+    wbxml_encoder_t wbxml_encoder;
+    ebuffer_t encode_buffer;
+    int err;
+
+    ebuffer_init(&encode_buffer);
+    wbxml_encode_init(&wbxml_encoder);
+
+    err = _wbxml_test_encode_document(&wbxml_encoder, &encode_buffer);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    ASSERT_EQ(ebuffer_pos(&encode_buffer), sizeof(expected));
+    ASSERT_BINARY_EQ(ebuffer_data(&encode_buffer), expected, sizeof(expected));
+
+    /* encoder can be reused */
+    ebuffer_reset(&encode_buffer);
+
+    err = _wbxml_test_encode_document(&wbxml_encoder, &encode_buffer);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    ASSERT_EQ(ebuffer_pos(&encode_buffer), sizeof(expected));
+    ASSERT_BINARY_EQ(ebuffer_data(&encode_buffer), expected, sizeof(expected));
+
+    /* invalid state */
+    err = wbxml_encode_begin(&wbxml_encoder, &encode_buffer, WBXML_TEST_PUBLIC_ID, WBXML_ENCODER_CHARSET_UTF8);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = wbxml_encode_content(&wbxml_encoder, "content", 7);
+    ASSERT_EQ(err, ELIBC_ERROR_INVALID_STATE);
+
+    err = wbxml_encode_tag_begin(&wbxml_encoder, 0, 0x05);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = wbxml_encode_end(&wbxml_encoder);
+    ASSERT_EQ(err, ELIBC_ERROR_INVALID_STATE);
+
+    wbxml_encode_close(&wbxml_encoder);
+    ebuffer_free(&encode_buffer);
+}
+
+GTEST_TEST(wbxml_tests, wbxml_encode_flush_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    wbxml_encoder_t wbxml_encoder;
+    ebuffer_t encode_buffer, flush_buffer;
+    int err;
+
+    ebuffer_init(&encode_buffer);
+    ebuffer_init(&flush_buffer);
+    wbxml_encode_init(&wbxml_encoder);
+
+    /* without string table */
+    err = wbxml_encode_set_string_table(&wbxml_encoder, 0);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = _wbxml_test_encode_document(&wbxml_encoder, &encode_buffer);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    /* flush at the end only, output must be the same */
+    err = wbxml_encode_set_flush(&wbxml_encoder, _wbxml_test_flush_callback, &flush_buffer, 1024);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = _wbxml_test_encode_document(&wbxml_encoder, 0);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    ASSERT_EQ(ebuffer_pos(&flush_buffer), ebuffer_pos(&encode_buffer));
+    ASSERT_BINARY_EQ(ebuffer_data(&flush_buffer), ebuffer_data(&encode_buffer), ebuffer_pos(&encode_buffer));
+
+    /* literal tag can't be added after string table is flushed */
+    err = wbxml_encode_set_flush(&wbxml_encoder, _wbxml_test_flush_callback, &flush_buffer, WBXML_TEST_FLUSH_SIZE);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = _wbxml_test_encode_document(&wbxml_encoder, 0);
+    ASSERT_EQ(err, ELIBC_ERROR_INVALID_STATE);
+
+    /* small blocks */
+    ebuffer_reset(&flush_buffer);
+
+    err = wbxml_encode_begin(&wbxml_encoder, 0, WBXML_TEST_PUBLIC_ID, WBXML_ENCODER_CHARSET_UTF8);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = wbxml_encode_tag_begin_literal(&wbxml_encoder, "custom", 6);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = wbxml_encode_content(&wbxml_encoder, "content", 7);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = wbxml_encode_tag_end(&wbxml_encoder);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = wbxml_encode_end(&wbxml_encoder);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    ASSERT_EQ(ebuffer_pos(&flush_buffer), 23);
+    ASSERT_BINARY_EQ(ebuffer_data(&flush_buffer), "\x03\x01\x6A\x07" "custom\0" "\x44\x00\x03" "content\0" "\x01", 23);
+
+    wbxml_encode_close(&wbxml_encoder);
+    ebuffer_free(&encode_buffer);
+    ebuffer_free(&flush_buffer);
+}
+
+GTEST_TEST(wbxml_tests, wbxml_to_xml_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    static const char expected[] =
+        "<FolderSync><SyncKey>0</SyncKey><Item>repeated string</Item><Item>repeated string</Item>"
+        "<Link href=\"x\"/><custom>AAEC&#160;</custom><Empty/></FolderSync>";
+
+    wbxml_encoder_t wbxml_encoder;
+    wbxml_to_xml_t transcoder;
+    ebuffer_t encode_buffer, xml;
+    size_t block_size;
+    int err;
+
+    _wbxml_test_init_codepages();
+
+    ebuffer_init(&encode_buffer);
+    ebuffer_init(&xml);
+    wbxml_encode_init(&wbxml_encoder);
+
+    err = wbxml_to_xml_init(&transcoder, _wbxml_test_codepages, 8);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    /* encoded document */
+    err = _wbxml_test_encode_document(&wbxml_encoder, &encode_buffer);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    /* result must not depend on how input is split */
+    for(block_size = 1; block_size <= ebuffer_pos(&encode_buffer); block_size *= 2)
+    {
+        err = _wbxml_test_to_xml(&transcoder, (const euint8_t*)ebuffer_data(&encode_buffer), ebuffer_pos(&encode_buffer), block_size, &xml);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+        ASSERT_STRING_EQ(ebuffer_data(&xml), expected);
+    }
+
+    /* zero copy mode must give the same result */
+    err = wbxml_set_zero_copy(&transcoder.wbxml_decoder, 1);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    for(block_size = 1; block_size <= ebuffer_pos(&encode_buffer) * 2; block_size *= 2)
+    {
+        err = _wbxml_test_to_xml(&transcoder, (const euint8_t*)ebuffer_data(&encode_buffer), ebuffer_pos(&encode_buffer), block_size, &xml);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+        ASSERT_STRING_EQ(ebuffer_data(&xml), expected);
+    }
+
+    err = wbxml_set_zero_copy(&transcoder.wbxml_decoder, 0);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    /* attribute value prefix and value tokens */
+    ebuffer_reset(&encode_buffer);
+
+    err = wbxml_encode_begin(&wbxml_encoder, &encode_buffer, WBXML_TEST_PUBLIC_ID, WBXML_ENCODER_CHARSET_UTF8);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_encode_tag_begin(&wbxml_encoder, 0, 0x06);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_encode_attribute(&wbxml_encoder, 0, 0x08);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_encode_attribute_value(&wbxml_encoder, "example", 7);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_encode_attribute_value_token(&wbxml_encoder, 0, 0x85);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_encode_attribute_literal(&wbxml_encoder, "title", 5);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_encode_attribute_value(&wbxml_encoder, "<\"&\">", 4);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_encode_content(&wbxml_encoder, "a < b", 5);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_encode_tag_end(&wbxml_encoder);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_encode_end(&wbxml_encoder);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = _wbxml_test_to_xml(&transcoder, (const euint8_t*)ebuffer_data(&encode_buffer), ebuffer_pos(&encode_buffer), 3, &xml);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_STRING_EQ(ebuffer_data(&xml), "<Link href=\"http://example.com\" title=\"&lt;&quot;&amp;&quot;\">a &lt; b</Link>");
+
+    /* unknown tag */
+    err = wbxml_encode_begin(&wbxml_encoder, &encode_buffer, WBXML_TEST_PUBLIC_ID, WBXML_ENCODER_CHARSET_UTF8);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ebuffer_reset(&encode_buffer);
+    err = wbxml_encode_tag_begin(&wbxml_encoder, 1, 0x05);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_encode_tag_end(&wbxml_encoder);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_encode_end(&wbxml_encoder);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = _wbxml_test_to_xml(&transcoder, (const euint8_t*)ebuffer_data(&encode_buffer), ebuffer_pos(&encode_buffer), 16, &xml);
+    ASSERT_EQ(err, ELIBC_ERROR_NOT_FOUND);
+
+    wbxml_to_xml_close(&transcoder);
+    wbxml_encode_close(&wbxml_encoder);
+    ebuffer_free(&encode_buffer);
+    ebuffer_free(&xml);
+}
+
+GTEST_TEST(wbxml_tests, wbxml_decode_zero_copy_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    wbxml_encoder_t wbxml_encoder;
+    wbxml_decoder_t wbxml_decoder;
+    _wbxml_test_zero_copy_t zero_copy;
+    ebuffer_t encode_buffer, decode_buffer;
+    int err;
+
+    ebuffer_init(&encode_buffer);
+    ebuffer_init(&decode_buffer);
+    wbxml_encode_init(&wbxml_encoder);
+
+    err = _wbxml_test_encode_document(&wbxml_encoder, &encode_buffer);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    ememset(&zero_copy, 0, sizeof(zero_copy));
+    zero_copy.input = (const euint8_t*)ebuffer_data(&encode_buffer);
+    zero_copy.input_size = ebuffer_pos(&encode_buffer);
+
+    wbxml_init(&wbxml_decoder, _wbxml_test_zero_copy_callback, &zero_copy);
+
+    /* string table is copied by default */
+    err = wbxml_begin(&wbxml_decoder, &decode_buffer);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_decode(&wbxml_decoder, zero_copy.input, zero_copy.input_size);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_end(&wbxml_decoder);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_TRUE(zero_copy.in_input > 0);
+    ASSERT_TRUE(zero_copy.copied > 0);
+
+    /* all strings and data point to input in zero copy mode */
+    zero_copy.in_input = 0;
+    zero_copy.copied = 0;
+
+    err = wbxml_set_zero_copy(&wbxml_decoder, 1);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_begin(&wbxml_decoder, &decode_buffer);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_decode(&wbxml_decoder, zero_copy.input, zero_copy.input_size);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_end(&wbxml_decoder);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_TRUE(zero_copy.in_input > 0);
+    ASSERT_EQ(zero_copy.copied, 0);
+
+    wbxml_close(&wbxml_decoder);
+    wbxml_encode_close(&wbxml_encoder);
+    ebuffer_free(&encode_buffer);
+    ebuffer_free(&decode_buffer);
+}
+
+GTEST_TEST(wbxml_tests, wbxml_decode_reset_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    wbxml_encoder_t wbxml_encoder;
+    wbxml_decoder_t wbxml_decoder;
+    _wbxml_test_zero_copy_t zero_copy;
+    ebuffer_t encode_buffer, decode_buffer;
+    euint8_t* string_table;
+    size_t pos;
+    int err, round;
+
+    ebuffer_init(&encode_buffer);
+    ebuffer_init(&decode_buffer);
+    wbxml_encode_init(&wbxml_encoder);
+
+    err = _wbxml_test_encode_document(&wbxml_encoder, &encode_buffer);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    ememset(&zero_copy, 0, sizeof(zero_copy));
+    zero_copy.input = (const euint8_t*)ebuffer_data(&encode_buffer);
+    zero_copy.input_size = ebuffer_pos(&encode_buffer);
+
+    wbxml_init(&wbxml_decoder, _wbxml_test_zero_copy_callback, &zero_copy);
+    err = wbxml_set_zero_copy(&wbxml_decoder, 1);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    /* leave document unfinished */
+    err = wbxml_begin(&wbxml_decoder, &decode_buffer);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_decode(&wbxml_decoder, zero_copy.input, zero_copy.input_size / 2);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    for(round = 0; round < 3; ++round)
+    {
+        /* reset drops zero copy option and keeps memory */
+        wbxml_reset(&wbxml_decoder, _wbxml_test_zero_copy_callback, &zero_copy);
+        zero_copy.in_input = 0;
+        zero_copy.copied = 0;
+
+        err = wbxml_begin(&wbxml_decoder, &decode_buffer);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+
+        /* byte by byte, string table is copied */
+        for(pos = 0; pos < zero_copy.input_size; ++pos)
+        {
+            err = wbxml_decode(&wbxml_decoder, zero_copy.input + pos, 1);
+            ASSERT_EQ(err, ELIBC_SUCCESS);
+        }
+
+        err = wbxml_end(&wbxml_decoder);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+        ASSERT_TRUE(zero_copy.copied > 0);
+
+        /* string table memory is reused */
+        if(round == 0) string_table = wbxml_decoder.string_table;
+        ASSERT_TRUE(wbxml_decoder.string_table != 0);
+        ASSERT_TRUE(wbxml_decoder.string_table == string_table);
+    }
+
+    wbxml_close(&wbxml_decoder);
+    wbxml_encode_close(&wbxml_encoder);
+    ebuffer_free(&encode_buffer);
+    ebuffer_free(&decode_buffer);
+}
+
+GTEST_TEST(wbxml_tests, wbxml_from_xml_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    static const char input[] =
+        "<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+        "<!-- comment -->\n"
+        "<FolderSync>\n"
+        "  <SyncKey>0</SyncKey>\n"
+        "  <Item>repeated string</Item>\n"
+        "  <Item>repeated string</Item>\n"
+        "  <SyncKey>1</SyncKey>\n"
+        "  <Link href=\"x\"/>\n"
+        "  <custom a=\"1 &amp; 2\">text &lt;3</custom>\n"
+        "  <Empty></Empty>\n"
+        "</FolderSync>\n";
+
+    static const char expected[] =
+        "<FolderSync><SyncKey>0</SyncKey><Item>repeated string</Item><Item>repeated string</Item>"
+        "<SyncKey>1</SyncKey><Link href=\"x\"/><custom a=\"1 &amp; 2\">text &lt;3</custom><Empty/></FolderSync>";
+
+    static const euint8_t expected_body[] = {
+        /* FolderSync, SyncKey from current code page */
+        0x00, 0x07, 0x56, 0x52, 0x03, '0', 0x00, 0x01
+    };
+
+    wbxml_from_xml_t from_xml;
+    wbxml_to_xml_t to_xml;
+    ebuffer_t wbxml, xml, reference;
+    size_t block_size;
+    int err;
+
+    _wbxml_test_init_codepages();
+
+    ebuffer_init(&wbxml);
+    ebuffer_init(&xml);
+    ebuffer_init(&reference);
+
+    err = wbxml_from_xml_init(&from_xml, _wbxml_test_codepages, 8);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = wbxml_to_xml_init(&to_xml, _wbxml_test_codepages, 8);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    /* transcode in one block */
+    err = _wbxml_test_from_xml(&from_xml, input, sizeof(input), &reference);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    /* header, string table with literals and long strings */
+    ASSERT_BINARY_EQ(ebuffer_data(&reference), "\x03\x01\x6A\x19" "repeated string\0" "custom\0" "a\0", 29);
+    ASSERT_BINARY_EQ(ebuffer_data(&reference) + 29, expected_body, sizeof(expected_body));
+
+    /* back to xml */
+    err = _wbxml_test_to_xml(&to_xml, (const euint8_t*)ebuffer_data(&reference), ebuffer_pos(&reference), 64, &xml);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_STRING_EQ(ebuffer_data(&xml), expected);
+
+    /* result must not depend on how input is split */
+    for(block_size = 1; block_size < sizeof(input); block_size *= 2)
+    {
+        err = _wbxml_test_from_xml(&from_xml, input, block_size, &wbxml);
+        ASSERT_EQ(err, ELIBC_SUCCESS);
+
+        ASSERT_EQ(ebuffer_pos(&wbxml), ebuffer_pos(&reference));
+        ASSERT_BINARY_EQ(ebuffer_data(&wbxml), ebuffer_data(&reference), ebuffer_pos(&reference));
+    }
+
+    /* invalid xml */
+    err = _wbxml_test_from_xml(&from_xml, "<FolderSync></SyncKey>", 64, &wbxml);
+    ASSERT_NE(err, ELIBC_SUCCESS);
+
+    wbxml_from_xml_close(&from_xml);
+    wbxml_to_xml_close(&to_xml);
+    ebuffer_free(&wbxml);
+    ebuffer_free(&xml);
+    ebuffer_free(&reference);
+}
+
+GTEST_TEST(wbxml_tests, wbxml_global_attribute_token_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    /* LITERAL_C in attribute list */
+    static const euint8_t literal_c[] = {
+        0x03, 0x01, 0x6A, 0x02, 'a', 0x00, 0x85, 0x44, 0x00, 0x01
+    };
+
+    static const char input[] = "<Item bad=\"1\" good=\"2\"/>";
+
+    static const char* attributes[0x46];
+    wbxml_codepage_t codepage;
+    wbxml_from_xml_t from_xml;
+    wbxml_to_xml_t to_xml;
+    ebuffer_t wbxml, xml;
+    int err;
+
+    /* attribute names on global token codes are ignored */
+    ememset(attributes, 0, sizeof(attributes));
+    attributes[0x44] = "bad";
+    attributes[0x45] = "good";
+
+    ememset(&codepage, 0, sizeof(codepage));
+    codepage.tag_names = _wbxml_test_tags0;
+    codepage.tag_names_count = sizeof(_wbxml_test_tags0) / sizeof(_wbxml_test_tags0[0]);
+    codepage.attribute_names = attributes;
+    codepage.attribute_names_count = sizeof(attributes) / sizeof(attributes[0]);
+
+    ebuffer_init(&wbxml);
+    ebuffer_init(&xml);
+
+    err = wbxml_from_xml_init(&from_xml, &codepage, 1);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    err = wbxml_to_xml_init(&to_xml, &codepage, 1);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    /* "bad" is encoded as literal */
+    err = _wbxml_test_from_xml(&from_xml, input, 64, &wbxml);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_TRUE(ememchr(ebuffer_data(&wbxml), WBXML_TOKEN_LITERAL_C, ebuffer_pos(&wbxml)) == 0);
+
+    err = _wbxml_test_to_xml(&to_xml, (const euint8_t*)ebuffer_data(&wbxml), ebuffer_pos(&wbxml), 64, &xml);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+    ASSERT_STRING_EQ(ebuffer_data(&xml), input);
+
+    /* LITERAL_C can't start attribute */
+    err = _wbxml_test_to_xml(&to_xml, literal_c, sizeof(literal_c), 64, &xml);
+    ASSERT_NE(err, ELIBC_SUCCESS);
+
+    wbxml_from_xml_close(&from_xml);
+    wbxml_to_xml_close(&to_xml);
+    ebuffer_free(&wbxml);
+    ebuffer_free(&xml);
+}
+
+/*----------------------------------------------------------------------*/
@@ -222,5 +222,51 @@ GTEST_TEST(xml_parse_tests, xml_parse_test_rss)
     read_buffer = 0;
 }
 
+GTEST_TEST(xml_parse_tests, xml_parse_test_reset)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    xml_parser_t xml_parser;
+    ebuffer_t parse_buffer;
+    char* tag_stack;
+
+    char* read_buffer = 0;
+    efilesize_t buffer_size = 0;
+
+    int ret;
+
+    /* load input file */
+    read_buffer = elib_tests_load_file("data/books.xml", &buffer_size);
+    ASSERT_TRUE(read_buffer);
+
+    /* init parser */
+    xml_init(&xml_parser, _xml_parse_silent_callback, 0);
+    tag_stack = xml_parser.tag_stack.items;
+
+    /* leave document unfinished */
+    ebuffer_init(&parse_buffer);
+    ASSERT_EQ(xml_begin(&xml_parser, &parse_buffer), ELIBC_SUCCESS);
+    ASSERT_EQ(xml_parse(&xml_parser, read_buffer, (size_t)buffer_size / 2), ELIBC_SUCCESS);
+    ASSERT_EQ(xml_end(&xml_parser), ELIBC_ERROR_PARSER_INVALID_INPUT);
+    ebuffer_free(&parse_buffer);
+
+    /* reused parser keeps its memory */
+    xml_reset(&xml_parser, _xml_parse_silent_callback, 0);
+    ASSERT_TRUE(xml_parser.tag_stack.items == tag_stack);
+    ASSERT_EQ(estack_size(&xml_parser.tag_stack), 0);
+
+    xml_decode_escapes(&xml_parser, ELIBC_TRUE);
+
+    ret = _xml_parse_buffer(&xml_parser, read_buffer, buffer_size);
+    ASSERT_EQ(ret, ELIBC_SUCCESS);
+
+    /* close parser */
+    xml_close(&xml_parser);
+
+    /* free buffer */
+    efree(read_buffer);
+    read_buffer = 0;
+}
+
 /*----------------------------------------------------------------------*/
 
@@ -0,0 +1,167 @@
+/*
+    Number formatting unit tests
+*/
+
+#include "../elib_tests_config.h"
+
+/*----------------------------------------------------------------------*/
+
+#define TEXT_NUMBER_TEST_SIZE       100000
+
+/*----------------------------------------------------------------------*/
+
+GTEST_TEST(text_number_tests, integer_format_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    char buffer[TEXT_NUMBER_BUFFER_SIZE];
+    size_t length;
+
+    length = int32_to_str(0, buffer);
+    ASSERT_EQ(length, 1);
+    ASSERT_STRING_EQ(buffer, "0");
+
+    length = int32_to_str(-2147483647 - 1, buffer);
+    ASSERT_EQ(length, 11);
+    ASSERT_STRING_EQ(buffer, "-2147483648");
+
+    length = uint32_to_str(4294967295u, buffer);
+    ASSERT_EQ(length, 10);
+    ASSERT_STRING_EQ(buffer, "4294967295");
+
+    length = int64_to_str(-9223372036854775807LL - 1, buffer);
+    ASSERT_EQ(length, 20);
+    ASSERT_STRING_EQ(buffer, "-9223372036854775808");
+
+    length = uint64_to_str(18446744073709551615ULL, buffer);
+    ASSERT_EQ(length, 20);
+    ASSERT_STRING_EQ(buffer, "18446744073709551615");
+
+    length = uint64_to_str(4294967296ULL, buffer);
+    ASSERT_EQ(length, 10);
+    ASSERT_STRING_EQ(buffer, "4294967296");
+
+    length = uint64_to_str(100000000ULL, buffer);
+    ASSERT_EQ(length, 9);
+    ASSERT_STRING_EQ(buffer, "100000000");
+}
+
+GTEST_TEST(text_number_tests, double_format_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    char buffer[TEXT_NUMBER_BUFFER_SIZE];
+
+    double_to_str(0.0, buffer);
+    ASSERT_STRING_EQ(buffer, "0");
+
+    double_to_str(-0.0, buffer);
+    ASSERT_STRING_EQ(buffer, "-0");
+
+    double_to_str(0.1, buffer);
+    ASSERT_STRING_EQ(buffer, "0.1");
+
+    double_to_str(-2.5, buffer);
+    ASSERT_STRING_EQ(buffer, "-2.5");
+
+    double_to_str(1.0 / 3.0, buffer);
+    ASSERT_STRING_EQ(buffer, "0.3333333333333333");
+
+    double_to_str(100.0, buffer);
+    ASSERT_STRING_EQ(buffer, "100");
+
+    double_to_str(1e20, buffer);
+    ASSERT_STRING_EQ(buffer, "100000000000000000000");
+
+    double_to_str(1e21, buffer);
+    ASSERT_STRING_EQ(buffer, "1e+21");
+
+    double_to_str(0.000001, buffer);
+    ASSERT_STRING_EQ(buffer, "0.000001");
+
+    double_to_str(1.5e-7, buffer);
+    ASSERT_STRING_EQ(buffer, "1.5e-7");
+
+    double_to_str(5e-324, buffer);
+    ASSERT_STRING_EQ(buffer, "5e-324");
+
+    double_to_str(1.7976931348623157e308, buffer);
+    ASSERT_STRING_EQ(buffer, "1.7976931348623157e+308");
+
+    double_to_str(2.2250738585072014e-308, buffer);
+    ASSERT_STRING_EQ(buffer, "2.2250738585072014e-308");
+}
+
+GTEST_TEST(text_number_tests, double_round_trip_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    char buffer[TEXT_NUMBER_BUFFER_SIZE];
+    euint64_t bits, state;
+    double number, parsed;
+    size_t idx, length;
+
+    /* xorshift generator for random bit patterns */
+    state = 88172645463325252ULL;
+
+    for(idx = 0; idx < TEXT_NUMBER_TEST_SIZE; ++idx)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        /* ignore not finite numbers */
+        bits = state;
+        if(((bits >> 52) & 0x7FF) == 0x7FF) continue;
+
+        ememcpy(&number, &bits, sizeof(double));
+
+        /* format */
+        length = double_to_str(number, buffer);
+        ASSERT_EQ(length, estrlen(buffer));
+
+        /* must parse back to the same number */
+        parsed = strtod(buffer, 0);
+        ASSERT_BINARY_EQ(&parsed, &number, sizeof(double));
+    }
+}
+
+GTEST_TEST(text_number_tests, json_number_test)
+{
+    ELIB_GTEST_MEMORY_LEAK_DETECTOR;
+
+    json_encoder_t json_encoder;
+    ebuffer_t encode_buffer;
+    int err;
+
+    ebuffer_init(&encode_buffer);
+    json_encode_init(&json_encoder);
+
+    err = json_encode_begin(&json_encoder, &encode_buffer);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = json_encode_object_begin(&json_encoder, 0);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = json_encode_value_int(&json_encoder, "int", -42);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = json_encode_value_uint(&json_encoder, "uint", 18446744073709551615ULL);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = json_encode_value_double(&json_encoder, "double", 0.1);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = json_encode_end(&json_encoder);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    err = ebuffer_append_char(&encode_buffer, 0);
+    ASSERT_EQ(err, ELIBC_SUCCESS);
+
+    ASSERT_STRING_EQ(ebuffer_data(&encode_buffer), "{\"int\":-42,\"uint\":18446744073709551615,\"double\":0.1}");
+
+    json_encode_close(&json_encoder);
+    ebuffer_free(&encode_buffer);
+}
+
+/*----------------------------------------------------------------------*/